@@ -22,7 +22,8 @@
 ########################################################################################################################
 
 TEMPLATE = subdirs
-SUBDIRS = inecbe build_cbe_error_codes test
+SUBDIRS = inecbe build_cbe_error_codes inecbe_worker test
 
 inecbe.depends = build_cbe_error_codes
-test.depends = inecbe
+inecbe_worker.depends = inecbe
+test.depends = inecbe inecbe_worker
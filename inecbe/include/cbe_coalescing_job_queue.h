@@ -0,0 +1,389 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::CoalescingJobQueue template class along with the
+* \ref Cbe::CoalescingCompilerJobQueue and \ref Cbe::CoalescingLinkerJobQueue classes.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_COALESCING_JOB_QUEUE_H
+#define CBE_COALESCING_JOB_QUEUE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QChar>
+#include <QSharedPointer>
+#include <QList>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+
+#include "cbe_common.h"
+#include "cbe_job_queue.h"
+#include "cbe_compiler_context.h"
+#include "cbe_compiler_notifier.h"
+#include "cbe_linker_context.h"
+#include "cbe_linker_notifier.h"
+
+namespace Cbe {
+    /**
+     * Template class that instantiates a first-in, first-out job queue that coalesces jobs by key.  Enqueuing a job
+     * whose key matches a pending job replaces the pending job in place, retaining its position in the queue.  Jobs
+     * with different keys are never discarded.
+     *
+     * Derived classes must overload \ref Cbe::CoalescingJobQueue::jobKey and may overload
+     * \ref Cbe::CoalescingJobQueue::jobSuperseded to notify superseded jobs.
+     *
+     * \param[in] T The class being used for job contexts.
+     *
+     * \param[in] K The type used for job keys.  The type must be usable as a QHash key.
+     */
+    template<typename T, typename K = QString> class CBE_PUBLIC_API CoalescingJobQueue:public JobQueue<T> {
+        public:
+            ~CoalescingJobQueue() override {}
+
+            /**
+             * Method you can use to determine the number of pending jobs.
+             *
+             * \return Returns the current number of pending jobs.
+             */
+            unsigned numberPendingJobs() const final {
+                return static_cast<unsigned>(pendingKeys.size());
+            }
+
+            /**
+             * Method you can use to enqueue a job.  A pending job with the same key will be replaced and notified.
+             *
+             * \param[in] newJob A shared pointer to the job to be enqueued.
+             */
+            void enqueue(QSharedPointer<T> newJob) final {
+                K key = jobKey(newJob);
+
+                typename QHash<K, QSharedPointer<T>>::iterator it = pendingJobs.find(key);
+                if (it != pendingJobs.end()) {
+                    QSharedPointer<T> supersededJob = it.value();
+                    it.value() = newJob;
+
+                    if (supersededJob != newJob) {
+                        jobSuperseded(supersededJob, newJob);
+                    }
+                } else {
+                    pendingKeys.append(key);
+                    pendingJobs.insert(key, newJob);
+                }
+            }
+
+            /**
+             * Method you can use to dequeue a job.
+             *
+             * \return Returns a shared pointer to the dequeued job.  A null pointer is returned if the queue is empty.
+             */
+            QSharedPointer<T> dequeue() final {
+                QSharedPointer<T> result;
+
+                if (!pendingKeys.isEmpty()) {
+                    result = pendingJobs.take(pendingKeys.takeFirst());
+                }
+
+                return result;
+            }
+
+        protected:
+            /**
+             * Method you must overload to determine the key used to coalesce a job.
+             *
+             * \param[in] job The job to determine the key for.
+             *
+             * \return Returns the job's key.
+             */
+            virtual K jobKey(const QSharedPointer<T>& job) const = 0;
+
+            /**
+             * Method you can overload to receive notification that a pending job was replaced.  This method is called
+             * from the thread enqueueing the new job, typically while the queue is locked.  Overloads that call into
+             * client code should hold the notification and deliver it from \ref Cbe::JobQueue::deliverNotifications.
+             *
+             * The default implementation simply returns.
+             *
+             * \param[in] supersededJob The job that was removed from the queue.
+             *
+             * \param[in] newJob        The job that replaced the superseded job.
+             */
+            virtual void jobSuperseded(QSharedPointer<T> supersededJob, QSharedPointer<T> newJob) {
+                (void) supersededJob;
+                (void) newJob;
+            }
+
+        private:
+            /**
+             * Keys of the pending jobs, oldest first.
+             */
+            QList<K> pendingKeys;
+
+            /**
+             * Pending jobs, by key.
+             */
+            QHash<K, QSharedPointer<T>> pendingJobs;
+    };
+
+    /**
+     * Compiler job queue that coalesces contexts by action and object file.  Contexts using
+     * \ref Cbe::CompilerContext::ObjectDestination::MEMORY have no meaningful object file and are coalesced only with
+     * themselves.  Superseded contexts receive a call to \ref Cbe::CompilerContext::compilerJobSuperseded and, if a
+     * notifier is set, the notifier receives a call to \ref Cbe::CompilerNotifier::compilerJobSuperseded.
+     *
+     * Notifications are held until \ref Cbe::CoalescingCompilerJobQueue::deliverNotifications is called, which the
+     * compiler does once the job queue is unlocked, so a notification can safely submit new contexts.
+     */
+    class CBE_PUBLIC_API CoalescingCompilerJobQueue:public CoalescingJobQueue<CompilerContext> {
+        public:
+            /**
+             * Constructor
+             *
+             * \param[in] newNotifier Optional notifier to receive supersession notifications.  The queue does not take
+             *                        ownership of the notifier.
+             */
+            CoalescingCompilerJobQueue(CompilerNotifier* newNotifier = nullptr):currentNotifier(newNotifier) {}
+
+            ~CoalescingCompilerJobQueue() override {}
+
+            /**
+             * Method you can use to set the notifier that receives supersession notifications.
+             *
+             * \param[in] newNotifier The new notifier.  A null pointer disables notifications.  The queue does not take
+             *                        ownership of the notifier.
+             */
+            void setNotifier(CompilerNotifier* newNotifier) {
+                currentNotifier = newNotifier;
+            }
+
+            /**
+             * Method you can use to obtain the notifier that receives supersession notifications.
+             *
+             * \return Returns a pointer to the current notifier.  A null pointer is returned if no notifier is set.
+             */
+            CompilerNotifier* notifier() const {
+                return currentNotifier;
+            }
+
+            /**
+             * Method that delivers the supersession notifications held since the last call.
+             */
+            void deliverNotifications() override {
+                notificationMutex.lock();
+                QList<QPair<QSharedPointer<CompilerContext>, QSharedPointer<CompilerContext>>> notifications =
+                    pendingNotifications;
+                pendingNotifications.clear();
+                notificationMutex.unlock();
+
+                for (  QList<QPair<QSharedPointer<CompilerContext>, QSharedPointer<CompilerContext>>>::const_iterator
+                           notificationIterator    = notifications.constBegin(),
+                           notificationEndIterator = notifications.constEnd()
+                     ; notificationIterator != notificationEndIterator
+                     ; ++notificationIterator
+                    ) {
+                    notificationIterator->first->compilerJobSuperseded();
+
+                    if (currentNotifier != nullptr) {
+                        currentNotifier->compilerJobSuperseded(
+                            notificationIterator->first,
+                            notificationIterator->second
+                        );
+                    }
+                }
+            }
+
+        protected:
+            /**
+             * Method that determines the key used to coalesce a context.
+             *
+             * \param[in] job The context to determine the key for.
+             *
+             * \return Returns the context's action followed by the context's object file so a check never replaces a
+             *         compilation.  Contexts compiled to memory use a key derived from the context's identity in place
+             *         of the object file.  The identity starts with a NUL character so it can not match an object file.
+             */
+            QString jobKey(const QSharedPointer<CompilerContext>& job) const override {
+                QString result = QString::number(static_cast<int>(job->action())) + QChar(':');
+
+                if (job->objectDestination() == CompilerContext::ObjectDestination::MEMORY) {
+                    result += QChar(0) + QString::number(reinterpret_cast<quintptr>(job.data()), 16);
+                } else {
+                    result += job->objectFile();
+                }
+
+                return result;
+            }
+
+            /**
+             * Method that holds the notification for a superseded context until
+             * \ref Cbe::CoalescingCompilerJobQueue::deliverNotifications is called.
+             *
+             * \param[in] supersededJob The context that was removed from the queue.
+             *
+             * \param[in] newJob        The context that replaced the superseded context.
+             */
+            void jobSuperseded(
+                    QSharedPointer<CompilerContext> supersededJob,
+                    QSharedPointer<CompilerContext> newJob
+                ) override {
+                supersededJob->clearQueued();
+
+                notificationMutex.lock();
+                pendingNotifications.append(qMakePair(supersededJob, newJob));
+                notificationMutex.unlock();
+            }
+
+        private:
+            /**
+             * The notifier receiving supersession notifications.
+             */
+            CompilerNotifier* currentNotifier;
+
+            /**
+             * Mutex guarding the held notifications.  Notifications are delivered without the job queue lock.
+             */
+            QMutex notificationMutex;
+
+            /**
+             * Superseded and replacement contexts awaiting notification, oldest first.
+             */
+            QList<QPair<QSharedPointer<CompilerContext>, QSharedPointer<CompilerContext>>> pendingNotifications;
+    };
+
+    /**
+     * Linker job queue that coalesces contexts by output file.  Superseded contexts receive a call to
+     * \ref Cbe::LinkerContext::linkerJobSuperseded and, if a notifier is set, the notifier receives a call to
+     * \ref Cbe::LinkerNotifier::linkerJobSuperseded.
+     *
+     * Notifications are held until \ref Cbe::CoalescingLinkerJobQueue::deliverNotifications is called, which the
+     * linker does once the job queue is unlocked, so a notification can safely submit new contexts.
+     */
+    class CBE_PUBLIC_API CoalescingLinkerJobQueue:public CoalescingJobQueue<LinkerContext> {
+        public:
+            /**
+             * Constructor
+             *
+             * \param[in] newNotifier Optional notifier to receive supersession notifications.  The queue does not take
+             *                        ownership of the notifier.
+             */
+            CoalescingLinkerJobQueue(LinkerNotifier* newNotifier = nullptr):currentNotifier(newNotifier) {}
+
+            ~CoalescingLinkerJobQueue() override {}
+
+            /**
+             * Method you can use to set the notifier that receives supersession notifications.
+             *
+             * \param[in] newNotifier The new notifier.  A null pointer disables notifications.  The queue does not take
+             *                        ownership of the notifier.
+             */
+            void setNotifier(LinkerNotifier* newNotifier) {
+                currentNotifier = newNotifier;
+            }
+
+            /**
+             * Method you can use to obtain the notifier that receives supersession notifications.
+             *
+             * \return Returns a pointer to the current notifier.  A null pointer is returned if no notifier is set.
+             */
+            LinkerNotifier* notifier() const {
+                return currentNotifier;
+            }
+
+            /**
+             * Method that delivers the supersession notifications held since the last call.
+             */
+            void deliverNotifications() override {
+                notificationMutex.lock();
+                QList<QPair<QSharedPointer<LinkerContext>, QSharedPointer<LinkerContext>>> notifications =
+                    pendingNotifications;
+                pendingNotifications.clear();
+                notificationMutex.unlock();
+
+                for (  QList<QPair<QSharedPointer<LinkerContext>, QSharedPointer<LinkerContext>>>::const_iterator
+                           notificationIterator    = notifications.constBegin(),
+                           notificationEndIterator = notifications.constEnd()
+                     ; notificationIterator != notificationEndIterator
+                     ; ++notificationIterator
+                    ) {
+                    notificationIterator->first->linkerJobSuperseded();
+
+                    if (currentNotifier != nullptr) {
+                        currentNotifier->linkerJobSuperseded(
+                            notificationIterator->first,
+                            notificationIterator->second
+                        );
+                    }
+                }
+            }
+
+        protected:
+            /**
+             * Method that determines the key used to coalesce a context.
+             *
+             * \param[in] job The context to determine the key for.
+             *
+             * \return Returns the context's output file.
+             */
+            QString jobKey(const QSharedPointer<LinkerContext>& job) const override {
+                return job->outputFile();
+            }
+
+            /**
+             * Method that holds the notification for a superseded context until
+             * \ref Cbe::CoalescingLinkerJobQueue::deliverNotifications is called.
+             *
+             * \param[in] supersededJob The context that was removed from the queue.
+             *
+             * \param[in] newJob        The context that replaced the superseded context.
+             */
+            void jobSuperseded(
+                    QSharedPointer<LinkerContext> supersededJob,
+                    QSharedPointer<LinkerContext> newJob
+                ) override {
+                notificationMutex.lock();
+                pendingNotifications.append(qMakePair(supersededJob, newJob));
+                notificationMutex.unlock();
+            }
+
+        private:
+            /**
+             * The notifier receiving supersession notifications.
+             */
+            LinkerNotifier* currentNotifier;
+
+            /**
+             * Mutex guarding the held notifications.  Notifications are delivered without the job queue lock.
+             */
+            QMutex notificationMutex;
+
+            /**
+             * Superseded and replacement contexts awaiting notification, oldest first.
+             */
+            QList<QPair<QSharedPointer<LinkerContext>, QSharedPointer<LinkerContext>>> pendingNotifications;
+    };
+};
+
+#endif
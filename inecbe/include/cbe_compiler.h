@@ -34,6 +34,7 @@
 #include <QList>
 #include <QByteArray>
 #include <QSharedPointer>
+#include <QThread>
 
 #include "cbe_common.h"
 #include "cbe_source_range.h"
@@ -75,6 +76,7 @@ namespace Cbe {
      */
     class CBE_PUBLIC_API Compiler {
         friend class CompilerNotifier;
+        friend class CompilerPool;
 
         public:
             /**
@@ -87,6 +89,24 @@ namespace Cbe {
              */
             static constexpr unsigned badColumnNumber = static_cast<unsigned>(-1);
 
+            /**
+             * Enumeration of policies used to initialize the LLVM code generation targets.
+             */
+            enum class TargetInitialization {
+                /**
+                 * Indicates every target built into LLVM should be initialized when the first compiler is constructed.
+                 */
+                ALL,
+
+                /**
+                 * Indicates only the native target, and any targets listed using \ref Compiler::setInitialTargets,
+                 * should be initialized when the first compiler is constructed.  Other targets are initialized the
+                 * first time a compiler is configured to generate code for them, for example by
+                 * \ref Compiler::setTargetTriple.
+                 */
+                ON_DEMAND
+            };
+
             /**
              * Constructor
              *
@@ -97,6 +117,39 @@ namespace Cbe {
 
             virtual ~Compiler();
 
+            /**
+             * Method you can use to select how LLVM code generation targets are initialized.  Initializing every
+             * target is a noticeable part of constructing the first compiler.  The policy is process wide and must be
+             * selected before the first compiler is constructed.  By default, every target is initialized.
+             *
+             * \param[in] newTargetInitialization The new target initialization policy.
+             */
+            static void setTargetInitialization(TargetInitialization newTargetInitialization);
+
+            /**
+             * Method you can use to determine how LLVM code generation targets are initialized.
+             *
+             * \return Returns the target initialization policy.
+             */
+            static TargetInitialization targetInitialization();
+
+            /**
+             * Method you can use to list targets to be initialized along with the native target when the target
+             * initialization policy is \ref Compiler::TargetInitialization::ON_DEMAND.  The list must be set before
+             * the first compiler is constructed.
+             *
+             * \param[in] newInitialTargets The LLVM backend names of the targets, for example "X86", "AArch64", or
+             *                              "WebAssembly".  Unknown names are ignored.
+             */
+            static void setInitialTargets(const QList<QString>& newInitialTargets);
+
+            /**
+             * Method you can use to obtain the targets to be initialized along with the native target.
+             *
+             * \return Returns the LLVM backend names of the targets.
+             */
+            static QList<QString> initialTargets();
+
             /**
              * Method you can use to enable or disable debug output.
              *
@@ -169,21 +222,67 @@ namespace Cbe {
             bool isExternal() const;
 
             /**
-             * Method you can use to set the executable directory.  Call to this function will be ignored if the
-             * compiler is an internal function.  If the compiler is external, you must call this function prior to
-             * invoking the compiler.
+             * Method you can use to run contexts in a separate worker process rather than in this process.  When
+             * enabled, the compiler becomes external.  The compiler starts a worker process the first time it is
+             * needed and keeps the worker, and its configured compiler instance, alive between contexts.  Source,
+             * configuration, objects, and diagnostics are exchanged over the worker's standard input and output.
+             *
+             * A crash inside clang or LLVM only terminates the worker.  The context being compiled is reported
+             * through \ref CompilerNotifier::fatalCompilerError and finishes with a failure status.  A replacement
+             * worker is started immediately.  Cancelling a context being compiled stops the worker.
+             *
+             * Each compiler owns one worker so a \ref Cbe::CompilerPool with worker processes enabled compiles
+             * contexts in parallel across processes.  The worker executable, \ref CompilerWorker::executableName,
+             * is located in the directory reported by \ref Compiler::executableDirectory.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowEnabled If true, worker processes will be used.  If false, contexts will be compiled in
+             *                       this process.
+             */
+            void setWorkerProcessEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to disable or enable worker processes.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowDisabled If true, contexts will be compiled in this process.  If false, worker processes
+             *                        will be used.
+             */
+            void setWorkerProcessDisabled(bool nowDisabled = true);
+
+            /**
+             * Method you can use to determine if worker processes are enabled.
+             *
+             * \return Returns true if worker processes are enabled.  Returns false if contexts are compiled in this
+             *         process.
+             */
+            bool workerProcessEnabled() const;
+
+            /**
+             * Method you can use to determine if worker processes are disabled.
+             *
+             * \return Returns true if contexts are compiled in this process.  Returns false if worker processes are
+             *         enabled.
+             */
+            bool workerProcessDisabled() const;
+
+            /**
+             * Method you can use to set the executable directory.  The directory is only used when the compiler is
+             * external.  By default, the directory holding the application executable is used.
              *
              * This method may block until all pending contexts have been processed by the compiler.
              *
              * \param[in] newExecutableDirectory The directory where the compiler executable is expected to be found.
+             *                                   An empty string selects the default.
              */
             void setExecutableDirectory(const QString& newExecutableDirectory);
 
             /**
              * Method you can use to determine the current executable directory.
              *
-             * \return Returns the path to the executable directory.  An empty string will be returned if the compiler
-             *         is an internal function.
+             * \return Returns the path to the executable directory.
              */
             QString executableDirectory() const;
 
@@ -280,6 +379,28 @@ namespace Cbe {
              */
             void setPrecompiledHeaders(const QList<QString>& newPrecompiledHeaders);
 
+            /**
+             * Method you can use to obtain the current list of runtime bitcode modules.
+             *
+             * \return Returns a list of the runtime bitcode modules linked into each compiled module.
+             */
+            QList<QString> runtimeBitcodeModules() const;
+
+            /**
+             * Method you can use to change the list of runtime bitcode modules.  Each module is linked into every
+             * compiled module before optimization, similar to the clang -mlink-builtin-bitcode switch.  Only the
+             * functions referenced by the compiled module are linked.  Linked functions are internalized so they can
+             * be inlined into generated code and are discarded if unused after optimization.
+             *
+             * Runtime bitcode modules are typically built from the same sources as the runtime support libraries
+             * passed to the linker so small helper functions can be inlined rather than called.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] newRuntimeBitcodeModules the new list of runtime bitcode modules.
+             */
+            void setRuntimeBitcodeModules(const QList<QString>& newRuntimeBitcodeModules);
+
             /**
              * Method you can use to obtain the current resource directory.
              *
@@ -331,21 +452,370 @@ namespace Cbe {
             void setTargetTriple(const QString& newTargetTriple);
 
             /**
-             * Method that can be called to run the compiler on a context.
+             * Method you can use to enable or disable automatic precompiled headers.  When enabled, the headers
+             * supplied through \ref Cbe::Compiler::setHeaders are compiled into a precompiled header the first time
+             * they are used and the precompiled header is reused for later compilations.  The precompiled header is
+             * rebuilt when the switches, search paths, or any of the headers change.  If the precompiled header can not
+             * be built, the headers are included directly.
+             *
+             * Automatic precompiled headers are not used if explicit precompiled headers have been supplied through
+             * \ref Cbe::Compiler::setPrecompiledHeaders.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowEnabled If true, automatic precompiled headers will be enabled.  If false, automatic
+             *                       precompiled headers will be disabled.
+             */
+            void setAutomaticPchEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to disable or enable automatic precompiled headers.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowDisabled If true, automatic precompiled headers will be disabled.  If false, automatic
+             *                        precompiled headers will be enabled.
+             */
+            void setAutomaticPchDisabled(bool nowDisabled = true);
+
+            /**
+             * Method you can use to determine if automatic precompiled headers are enabled.
+             *
+             * \return Returns true if automatic precompiled headers are enabled.  Returns false if automatic
+             *         precompiled headers are disabled.
+             */
+            bool automaticPchEnabled() const;
+
+            /**
+             * Method you can use to determine if automatic precompiled headers are disabled.
+             *
+             * \return Returns true if automatic precompiled headers are disabled.  Returns false if automatic
+             *         precompiled headers are enabled.
+             */
+            bool automaticPchDisabled() const;
+
+            /**
+             * Method you can use to set the directory used to cache automatically generated precompiled headers.  The
+             * directory can be shared by several compilers.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] newPchCacheDirectory The new cache directory.  An empty string will select a directory under
+             *                                 the system temporary directory.
+             */
+            void setPchCacheDirectory(const QString& newPchCacheDirectory);
+
+            /**
+             * Method you can use to determine the directory used to cache automatically generated precompiled headers.
+             *
+             * \return Returns the cache directory.
+             */
+            QString pchCacheDirectory() const;
+
+            /**
+             * Method you can use to enable or disable implicit clang modules.  When enabled, an \#include of a header
+             * covered by a module map is replaced by an import of the module.  Module maps, named "module.modulemap",
+             * are found in the directories supplied through \ref Cbe::Compiler::setHeaderSearchPaths and in the
+             * directories of included headers.  Each module is compiled the first time it is imported and is then
+             * reused from the module cache.
+             *
+             * Unlike a precompiled header, each module is cached and invalidated independently.  Jobs that use
+             * different subsets of the headers therefore share the modules they have in common.  Automatic precompiled
+             * headers are not used while modules are enabled.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowEnabled If true, modules will be enabled.  If false, modules will be disabled.
+             */
+            void setModulesEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to disable or enable implicit clang modules.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowDisabled If true, modules will be disabled.  If false, modules will be enabled.
+             */
+            void setModulesDisabled(bool nowDisabled = true);
+
+            /**
+             * Method you can use to determine if implicit clang modules are enabled.
+             *
+             * \return Returns true if modules are enabled.  Returns false if modules are disabled.
+             */
+            bool modulesEnabled() const;
+
+            /**
+             * Method you can use to determine if implicit clang modules are disabled.
+             *
+             * \return Returns true if modules are disabled.  Returns false if modules are enabled.
+             */
+            bool modulesDisabled() const;
+
+            /**
+             * Method you can use to set the directory used to cache compiled modules.  By default, every compiler in
+             * the process shares a single directory.  The directory can also be shared by compilers in other
+             * processes.  Clang locks each module while building it, and a module built with a different
+             * configuration is stored separately.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] newModuleCacheDirectory The new cache directory.  An empty string will select a directory
+             *                                    under the system temporary directory.
+             */
+            void setModuleCacheDirectory(const QString& newModuleCacheDirectory);
+
+            /**
+             * Method you can use to determine the directory used to cache compiled modules.
+             *
+             * \return Returns the cache directory.
+             */
+            QString moduleCacheDirectory() const;
+
+            /**
+             * Method you can use to enable or disable the compile cache.  When enabled, the object generated for each
+             * context is stored in a content addressed cache keyed on the source, the effective command line, and
+             * the contents of every header read during compilation.  Later compilations with the same inputs copy the
+             * cached object rather than invoking the compiler.  Only compilations that succeed without diagnostics
+             * are cached.
+             *
+             * The cache directory can be safely shared by several compilers and by several processes.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowEnabled If true, the compile cache will be enabled.  If false, the compile cache will be
+             *                       disabled.
+             */
+            void setCompileCacheEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to disable or enable the compile cache.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowDisabled If true, the compile cache will be disabled.  If false, the compile cache will be
+             *                        enabled.
+             */
+            void setCompileCacheDisabled(bool nowDisabled = true);
+
+            /**
+             * Method you can use to determine if the compile cache is enabled.
+             *
+             * \return Returns true if the compile cache is enabled.  Returns false if the compile cache is disabled.
+             */
+            bool compileCacheEnabled() const;
+
+            /**
+             * Method you can use to determine if the compile cache is disabled.
+             *
+             * \return Returns true if the compile cache is disabled.  Returns false if the compile cache is enabled.
+             */
+            bool compileCacheDisabled() const;
+
+            /**
+             * Method you can use to set the directory holding the compile cache.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] newCompileCacheDirectory The new cache directory.  An empty string will select a directory
+             *                                     under the system temporary directory.
+             */
+            void setCompileCacheDirectory(const QString& newCompileCacheDirectory);
+
+            /**
+             * Method you can use to determine the directory holding the compile cache.
+             *
+             * \return Returns the cache directory.
+             */
+            QString compileCacheDirectory() const;
+
+            /**
+             * Method you can use to set the maximum size of the compile cache.  The least recently used objects are
+             * removed once the cache exceeds this size.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] newMaximumSize The new maximum cache size, in bytes.
+             */
+            void setCompileCacheMaximumSize(unsigned long long newMaximumSize);
+
+            /**
+             * Method you can use to determine the maximum size of the compile cache.
+             *
+             * \return Returns the maximum cache size, in bytes.
+             */
+            unsigned long long compileCacheMaximumSize() const;
+
+            /**
+             * Method you can use to determine the number of contexts satisfied from the compile cache.
+             *
+             * \return Returns the number of compile cache hits.
+             */
+            unsigned long long compileCacheHits() const;
+
+            /**
+             * Method you can use to determine the number of contexts that had to be compiled while the compile cache
+             * was enabled.
+             *
+             * \return Returns the number of compile cache misses.
+             */
+            unsigned long long compileCacheMisses() const;
+
+            /**
+             * Method you can use to enable or disable preamble reuse.  When enabled, the compiler tracks the leading
+             * block of preprocessor directives, such as includes and macro definitions, in each context's source.  Once
+             * two consecutive contexts start with the same block, the block is compiled into a precompiled preamble
+             * that later contexts starting with the same block reuse.  The preamble is rebuilt when the block or any
+             * file it includes changes.
+             *
+             * Preambles are not used when the compiler is configured to use a precompiled header.  Preamble reuse is
+             * enabled by default.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowEnabled If true, preamble reuse will be enabled.  If false, preamble reuse will be
+             *                       disabled.
+             */
+            void setPreambleReuseEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to disable or enable preamble reuse.
+             *
+             * This method will block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] nowDisabled If true, preamble reuse will be disabled.  If false, preamble reuse will be
+             *                        enabled.
+             */
+            void setPreambleReuseDisabled(bool nowDisabled = true);
+
+            /**
+             * Method you can use to determine if preamble reuse is enabled.
+             *
+             * \return Returns true if preamble reuse is enabled.  Returns false if preamble reuse is disabled.
+             */
+            bool preambleReuseEnabled() const;
+
+            /**
+             * Method you can use to determine if preamble reuse is disabled.
+             *
+             * \return Returns true if preamble reuse is disabled.  Returns false if preamble reuse is enabled.
+             */
+            bool preambleReuseDisabled() const;
+
+            /**
+             * Method you can use to set the priority of the compiler thread.  A reduced priority is useful for
+             * background builds that should not compete with interactive, latency sensitive, compilations.  By
+             * default the compiler thread inherits the priority of the thread that starts it.
+             *
+             * \param[in] newThreadPriority The new thread priority.
+             */
+            void setThreadPriority(QThread::Priority newThreadPriority);
+
+            /**
+             * Method you can use to obtain the priority of the compiler thread.
+             *
+             * \return Returns the thread priority.
+             */
+            QThread::Priority threadPriority() const;
+
+            /**
+             * Method that can be called to run the compiler on a context.  A context that is already queued to be
+             * checked is rejected and remains queued to be checked.
              *
              * \param[in] context The compile context to be executed.
+             *
+             * \return Returns true if the context was queued.  Returns false if the context was rejected.
              */
-            void compile(QSharedPointer<CompilerContext> context);
+            bool compile(QSharedPointer<CompilerContext> context);
 
             /**
              * Convenience method that can be called to run the compiler on a context.
              *
              * \param[in] context The compile context to be executed.  This method will take ownership of the context.
              *
-             * \return Returns true if the context was queued and the compiler was successfully started, returns false
-             *         if the compiler could not be successfully started.
+             * \return Returns true if the context was queued.  Returns false if the context was rejected.
+             */
+            bool compile(CompilerContext* context);
+
+            /**
+             * Method that can be called to check a context without generating code.  The source is parsed and
+             * semantically analyzed, equivalent to "-fsyntax-only", using the same configured compiler instance used
+             * for compilation.  Diagnostics are reported through the notifier and the context exactly as they are for
+             * \ref Compiler::compile.  No object is generated, the object file is not touched, and the compile cache is
+             * neither consulted nor updated.
+             *
+             * Checks are queued with, and processed in order with, other contexts.  To validate source as it is edited
+             * without waiting behind full compilations, use a separate compiler instance dedicated to checks.  A
+             * context that is already queued to be compiled is rejected and remains queued to be compiled.
+             *
+             * \param[in] context The context to be checked.
+             *
+             * \return Returns true if the context was queued.  Returns false if the context was rejected.
+             */
+            bool check(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Convenience method that can be called to check a context without generating code.
+             *
+             * \param[in] context The context to be checked.  This method will take ownership of the context.
+             *
+             * \return Returns true if the context was queued.  Returns false if the context was rejected.
+             */
+            bool check(CompilerContext* context);
+
+            /**
+             * Method that can be called to compile many small contexts together.  Contexts with the same object format
+             * are combined into a single translation unit so header parsing and code generator setup are paid once
+             * per batch rather than once per context.
+             *
+             * Only contexts using \ref CompilerContext::ObjectDestination::MEMORY are combined.  The batch produces one
+             * object, delivered through the first context in the batch.  The other contexts report success but receive
+             * no object data.  Contexts writing their object to a file, requesting a time trace, or supplying virtual
+             * headers are compiled individually.
+             *
+             * Every context is reported through the notifier and the context, in order, with diagnostics located
+             * relative to the context's own source.
+             *
+             * Each context's source is placed ahead of the sources that follow it in the batch so sources must not
+             * change the meaning of later sources.  Contexts whose source defines or undefines macros, uses pragmas, or
+             * contains using declarations or directives are therefore compiled individually.  Combined contexts must
+             * also not define the same internal names.  If a batch fails, it is split and each context is compiled
+             * individually so errors are reported against only the contexts containing them.  Cancelling a context
+             * after the batch is queued does not stop the batch but the context is reported as failed.
+             *
+             * Batches, and the contexts of a split batch, are queued ahead of the compiler's job queue so every context
+             * is compiled regardless of the job queue's policy.  Contexts that are already queued to be checked are
+             * rejected and left out of the batch.
+             *
+             * \param[in] contexts The contexts to be compiled.
+             *
+             * \return Returns true if every context was queued.  Returns false if any context was rejected.
+             */
+            bool compileBatch(const QList<QSharedPointer<CompilerContext>>& contexts);
+
+            /**
+             * Method that can be called to cancel a context.  Queued contexts are skipped and a context being compiled
+             * is aborted cooperatively.  Either way, the context is reported as cancelled and then as finished with a
+             * failure status.  The context can be submitted again once it is reported finished.  This method does not
+             * block.
+             *
+             * \param[in] context The context to be cancelled.
+             */
+            void cancel(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Method you can call after configuring the compiler to prepare it in the background.  The compiler thread
+             * runs the clang driver, creates the compiler instance, and builds any automatic precompiled header so the
+             * first context does not pay for them.  The configured headers are only parsed ahead of time when the
+             * automatic precompiled header is enabled; otherwise they are parsed by every context as usual.  When the
+             * worker process is enabled, the worker is started instead.
+             *
+             * Warming up is queued ahead of pending contexts, reports nothing to the notifier, and does nothing if the
+             * compiler is already configured.  Configuration errors are left for the next context to report.  Changing
+             * the compiler's configuration discards the prepared compiler instance so call this method again after
+             * the last change.  Use \ref Compiler::waitComplete to wait for the warm-up to finish.
              */
-            void compile(CompilerContext* context);
+            void warmUp();
 
             /**
              * Method that can be called to stall this thread until the compiler finishes all outstanding contexts.
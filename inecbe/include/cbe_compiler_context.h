@@ -33,13 +33,19 @@
 #include <QString>
 #include <QList>
 #include <QByteArray>
+#include <QMap>
 #include <QSharedDataPointer>
 
 #include <cstdint>
 
 #include "cbe_common.h"
+#include "cbe_compiler_timing.h"
+
+class CompilerImpl;
 
 namespace Cbe {
+    class CoalescingCompilerJobQueue;
+
     /**
      * Class that provides information about a build of a single source implementation.
      *
@@ -47,6 +53,90 @@ namespace Cbe {
      */
     class CBE_PUBLIC_API CompilerContext {
         public:
+            /**
+             * Enumeration of supported destinations for the generated object.
+             */
+            enum class ObjectDestination {
+                /**
+                 * Indicates the object should be written to the file reported by \ref CompilerContext::objectFile.
+                 */
+                FILE,
+
+                /**
+                 * Indicates the object should be kept in memory and made available through
+                 * \ref CompilerContext::objectData.  No file will be written.
+                 */
+                MEMORY
+            };
+
+            /**
+             * Enumeration of supported object formats.
+             */
+            enum class ObjectFormat {
+                /**
+                 * Indicates the compiler should generate a native object.
+                 */
+                NATIVE,
+
+                /**
+                 * Indicates the compiler should generate optimized LLVM bitcode.  Bitcode can be loaded by the
+                 * \ref Cbe::JitEngine class.
+                 */
+                BITCODE,
+
+                /**
+                 * Indicates the compiler should generate LLVM bitcode with a ThinLTO summary.  Optimization is
+                 * deferred to link time so functions can be inlined and dead code removed across contexts linked
+                 * into the same library by the \ref Cbe::Linker class.  The bitcode can also be loaded by the
+                 * \ref Cbe::JitEngine class.
+                 */
+                THIN_LTO
+            };
+
+            /**
+             * Enumeration of actions the compiler can perform on a context.
+             */
+            enum class Action {
+                /**
+                 * Indicates the context should be compiled to an object.
+                 */
+                COMPILE,
+
+                /**
+                 * Indicates the context should only be parsed and semantically analyzed.  Diagnostics are reported
+                 * but no code is generated and no object is produced.  See \ref Cbe::Compiler::check.
+                 */
+                CHECK
+            };
+
+            /**
+             * Enumeration of supported destinations for the clang time trace.  The time trace is a Chrome trace event
+             * JSON document covering header parsing, template instantiation, code generation, and optimization.
+             */
+            enum class TimeTraceDestination {
+                /**
+                 * Indicates no time trace should be generated.
+                 */
+                NONE,
+
+                /**
+                 * Indicates the time trace should be written to the file reported by
+                 * \ref CompilerContext::timeTraceFile.
+                 */
+                FILE,
+
+                /**
+                 * Indicates the time trace should be kept in memory and made available through
+                 * \ref CompilerContext::timeTraceData.  No file will be written.
+                 */
+                MEMORY
+            };
+
+            /**
+             * The default time trace granularity, in microseconds.  This value matches clang's default.
+             */
+            static constexpr unsigned defaultTimeTraceGranularity = 500;
+
             /**
              * Constructor
              *
@@ -79,6 +169,174 @@ namespace Cbe {
              */
             QString objectFile() const;
 
+            /**
+             * Method you can use to specify where the compiler should place the generated object.  By default, the
+             * object is written to the file reported by \ref CompilerContext::objectFile.
+             *
+             * \param[in] newObjectDestination The new object destination.
+             */
+            void setObjectDestination(ObjectDestination newObjectDestination);
+
+            /**
+             * Method you can use to determine where the compiler will place the generated object.
+             *
+             * \return Returns the current object destination.
+             */
+            ObjectDestination objectDestination() const;
+
+            /**
+             * Method you can use to specify the format of the generated object.  By default, a native object is
+             * generated.
+             *
+             * \param[in] newObjectFormat The new object format.
+             */
+            void setObjectFormat(ObjectFormat newObjectFormat);
+
+            /**
+             * Method you can use to determine the format of the generated object.
+             *
+             * \return Returns the current object format.
+             */
+            ObjectFormat objectFormat() const;
+
+            /**
+             * Method you can use to specify the action the compiler should perform on this context.  The action is set
+             * for you by \ref Cbe::Compiler::compile and \ref Cbe::Compiler::check.  Do not change the action of a
+             * queued context.
+             *
+             * \param[in] newAction The new action.
+             */
+            void setAction(Action newAction);
+
+            /**
+             * Method you can use to determine the action the compiler will perform on this context.
+             *
+             * \return Returns the current action.
+             */
+            Action action() const;
+
+            /**
+             * Method that is called by the compiler to record the generated object when the object destination is
+             * \ref CompilerContext::ObjectDestination::MEMORY.  You should not normally need to call this method.
+             *
+             * \param[in] newObjectData The generated object.
+             */
+            void setObjectData(const QByteArray& newObjectData);
+
+            /**
+             * Method you can use to obtain the generated object when the object destination is
+             * \ref CompilerContext::ObjectDestination::MEMORY.
+             *
+             * \return Returns the generated object.  An empty byte array is returned if the object was written to a
+             *         file or if the compiler reported an error.
+             */
+            QByteArray objectData() const;
+
+            /**
+             * Method you can use to request a clang time trace for this context.  By default, no time trace is
+             * generated.
+             *
+             * Note that the LLVM time trace profiler is process wide.  Compilations that generate a time trace are
+             * serialized against all other compilations in the process.
+             *
+             * \param[in] newTimeTraceDestination The new time trace destination.
+             */
+            void setTimeTraceDestination(TimeTraceDestination newTimeTraceDestination);
+
+            /**
+             * Method you can use to determine where the compiler will place the time trace.
+             *
+             * \return Returns the current time trace destination.
+             */
+            TimeTraceDestination timeTraceDestination() const;
+
+            /**
+             * Method you can use to set the minimum duration of events included in the time trace.
+             *
+             * \param[in] newTimeTraceGranularity The new granularity, in microseconds.
+             */
+            void setTimeTraceGranularity(unsigned newTimeTraceGranularity);
+
+            /**
+             * Method you can use to obtain the minimum duration of events included in the time trace.
+             *
+             * \return Returns the granularity, in microseconds.
+             */
+            unsigned timeTraceGranularity() const;
+
+            /**
+             * Method you can use to obtain the name of the file the time trace is written to when the time trace
+             * destination is \ref CompilerContext::TimeTraceDestination::FILE.  The file is placed next to the object
+             * file using the object file's base name and a ".json" suffix.
+             *
+             * \return Returns the time trace filename.
+             */
+            QString timeTraceFile() const;
+
+            /**
+             * Method that is called by the compiler to record the time trace when the time trace destination is
+             * \ref CompilerContext::TimeTraceDestination::MEMORY.  You should not normally need to call this method.
+             *
+             * \param[in] newTimeTraceData The time trace JSON document.
+             */
+            void setTimeTraceData(const QByteArray& newTimeTraceData);
+
+            /**
+             * Method you can use to obtain the time trace when the time trace destination is
+             * \ref CompilerContext::TimeTraceDestination::MEMORY.
+             *
+             * \return Returns the time trace JSON document.  An empty byte array is returned if no time trace was
+             *         generated or if the time trace was written to a file.
+             */
+            QByteArray timeTraceData() const;
+
+            /**
+             * Method that is called by the compiler to record the time spent in each phase of the most recent
+             * compilation of this context.  You should not normally need to call this method.
+             *
+             * \param[in] newTiming The timing record.
+             */
+            void setTiming(const CompilerTiming& newTiming);
+
+            /**
+             * Method you can use to obtain the time spent in each phase of the most recent compilation of this
+             * context.  The timing is recorded before \ref CompilerContext::compilerFinished is triggered.
+             *
+             * \return Returns the timing record.  All times are zero if the context has not been compiled.
+             */
+            CompilerTiming timing() const;
+
+            /**
+             * Method you can use to request that compilation of this context be cancelled.  A context that has not
+             * yet started will be skipped.  A context that is being compiled is aborted at the next top level
+             * declaration or before code generation.  Cancelled contexts are reported through
+             * \ref CompilerContext::compilerCancelled and then through \ref CompilerContext::compilerFinished with a
+             * failure status and will report no diagnostics.
+             *
+             * The request applies to the pending or current compilation of this context.  The request is cleared once
+             * the context is reported finished so the context can be submitted again.
+             *
+             * The method is thread safe and may be called at any time.  Copies of this context share the cancellation
+             * state.
+             */
+            void cancel() const;
+
+            /**
+             * Method you can use to determine if cancellation of this context has been requested.
+             *
+             * \return Returns true if this context was cancelled.  Returns false if this context was not cancelled.
+             */
+            bool cancelled() const;
+
+            /**
+             * Method you can use to determine if this context is waiting in a job queue.  A queued context can be
+             * queued again only for the same action.  The context is no longer queued once a compiler takes it from
+             * the queue or it is superseded.  Copies of this context share the queued state.
+             *
+             * \return Returns true if this context is queued.  Returns false if this context is not queued.
+             */
+            bool queued() const;
+
             /**
              * Method you can use to obtain access to the raw data contained in this class.
              *
@@ -93,6 +351,28 @@ namespace Cbe {
              */
             virtual unsigned long byteOffset() const = 0;
 
+            /**
+             * Method you can overload to supply in-memory headers for this context.  The headers are visible to
+             * \#include directives only while this context is being compiled.
+             *
+             * The default implementation returns an empty map.  Headers whose names are not valid, see
+             * \ref CompilerContext::validVirtualHeaderName, are ignored by the compiler with a warning.
+             *
+             * \return Returns a map of header contents keyed by the header's relative path.
+             */
+            virtual QMap<QString, QByteArray> virtualHeaders() const;
+
+            /**
+             * Method you can use to determine if a name can be used for an in-memory header.  Names must be non-empty
+             * relative paths that stay below the directory holding the in-memory headers so absolute paths, drive
+             * specifications, and names leading out of the directory with ".." are not valid.
+             *
+             * \param[in] name The proposed header name.
+             *
+             * \return Returns true if the name is valid.  Returns false if the name is not valid.
+             */
+            static bool validVirtualHeaderName(const QString& name);
+
             /**
              * Method that can be called from derived classes to append source code data to the internal buffer.
              *
@@ -135,7 +415,51 @@ namespace Cbe {
              */
             virtual void compilerFinished(bool success);
 
+            /**
+             * Virtual method you can overload to receive notification that compilation of this context was cancelled.
+             * The method is called just before \ref CompilerContext::compilerFinished reports the failure.  Note that
+             * the method may be called from a different thread than the one used to invoke the compiler.
+             *
+             * The default implementation simply returns.
+             */
+            virtual void compilerCancelled();
+
+            /**
+             * Virtual method you can overload to receive notification when this context was removed from a job queue
+             * because a newer context targeting the same object file was enqueued.  The compiler will not be invoked
+             * on this context.  Note that the method is called from the thread enqueueing the newer context after the
+             * job queue is unlocked.
+             *
+             * The default implementation simply returns.
+             */
+            virtual void compilerJobSuperseded();
+
         private:
+            friend class Compiler;
+            friend class CompilerPool;
+            friend class CoalescingCompilerJobQueue;
+            friend class ::CompilerImpl;
+
+            /**
+             * Method that marks this context as queued for an action and sets the action.
+             *
+             * \param[in] newAction The action the context is queued for.
+             *
+             * \return Returns true on success.  Returns false if the context is already queued for a different action,
+             *         in which case the action is not changed.
+             */
+            bool markQueued(Action newAction);
+
+            /**
+             * Method that marks this context as no longer queued.
+             */
+            void clearQueued() const;
+
+            /**
+             * Method that clears any cancellation request.
+             */
+            void clearCancellation() const;
+
             class CBE_PUBLIC_API Private;
 
             QSharedDataPointer<Private> impl;
@@ -31,8 +31,10 @@
 #define CBE_COMPILER_NOTIFIER_H
 
 #include <QString>
+#include <QSharedPointer>
 
 #include "cbe_common.h"
+#include "cbe_compiler_context.h"
 #include "cbe_compiler.h"
 
 namespace Cbe {
@@ -67,6 +69,54 @@ namespace Cbe {
              */
             virtual void fatalCompilerError(const QString& reason, bool generateCrashDiagnostics);
 
+            /**
+             * Virtual method that is called each time the compile cache is consulted.  The method is only called when
+             * the compile cache is enabled.  Note that the method may be called from a different thread than the one
+             * used to invoke the compiler.
+             *
+             * The default implementation simply returns.
+             *
+             * \param[in] cacheHit     If true, the object was supplied by the compile cache.  If false, the object was
+             *                         compiled.
+             *
+             * \param[in] numberHits   The total number of compile cache hits reported by the compiler.
+             *
+             * \param[in] numberMisses The total number of compile cache misses reported by the compiler.
+             */
+            virtual void compileCacheAccessed(
+                bool               cacheHit,
+                unsigned long long numberHits,
+                unsigned long long numberMisses
+            );
+
+            /**
+             * Virtual method that is called when compilation of a context was cancelled.  The method is called just
+             * before the context is reported as finished with a failure status.  Note that the method may be called
+             * from a different thread than the one used to invoke the compiler.
+             *
+             * The default implementation simply returns.
+             *
+             * \param[in] context The context that was cancelled.
+             */
+            virtual void compilerCancelled(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Virtual method that is called when a pending context is replaced in a
+             * \ref Cbe::CoalescingCompilerJobQueue that uses this notifier.  The superseded context will not be
+             * compiled.  The method is called from the thread enqueueing the new context after the job queue is
+             * unlocked so the method may safely submit new contexts.
+             *
+             * The default implementation simply returns.
+             *
+             * \param[in] supersededContext The context that was removed from the job queue.
+             *
+             * \param[in] newContext        The context that replaced the superseded context.
+             */
+            virtual void compilerJobSuperseded(
+                QSharedPointer<CompilerContext> supersededContext,
+                QSharedPointer<CompilerContext> newContext
+            );
+
         private:
             Compiler* currentCompiler;
     };
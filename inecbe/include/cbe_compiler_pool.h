@@ -0,0 +1,402 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::CompilerPool class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_COMPILER_POOL_H
+#define CBE_COMPILER_POOL_H
+
+#include <QString>
+#include <QList>
+#include <QSharedPointer>
+
+#include "cbe_common.h"
+#include "cbe_compiler_context.h"
+#include "cbe_job_queue.h"
+#include "cbe_compiler.h"
+
+namespace Cbe {
+    /**
+     * Class that manages a pool of compilers, all draining a single, shared, job queue.  Each compiler in the pool
+     * runs in its own background thread and maintains its own configured compiler instance so independent contexts
+     * can be compiled concurrently.
+     *
+     * By default the pool uses a \ref Cbe::FifoJobQueue so that every submitted context is compiled.  Configuration
+     * changes made through the pool are applied to every compiler in the pool.
+     *
+     * Note that notifiers and contexts will receive notifications from several threads, potentially at the same time.
+     */
+    class CBE_PUBLIC_API CompilerPool {
+        public:
+            CompilerPool();
+
+            virtual ~CompilerPool();
+
+            /**
+             * Method you can use to add a compiler to the pool.  The compiler will be reconfigured to use the pool's
+             * job queue.  You should not submit contexts directly to the compiler once it has been added to the pool.
+             *
+             * This method may block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] compiler The compiler to be added to the pool.
+             */
+            void addCompiler(QSharedPointer<Compiler> compiler);
+
+            /**
+             * Convenience method you can use to add a compiler to the pool.  The compiler will be reconfigured to use
+             * the pool's job queue.
+             *
+             * This method may block until all pending contexts have been processed by the compiler.
+             *
+             * \param[in] compiler The compiler to be added to the pool.  The pool will take ownership of the compiler.
+             */
+            void addCompiler(Compiler* compiler);
+
+            /**
+             * Method you can use to determine the number of compilers in the pool.
+             *
+             * \return Returns the number of compilers in the pool.
+             */
+            unsigned numberCompilers() const;
+
+            /**
+             * Method you can use to obtain a compiler in the pool.
+             *
+             * \param[in] index The zero based index of the desired compiler.
+             *
+             * \return Returns a shared pointer to the requested compiler.  A null pointer is returned if the index is
+             *         invalid.
+             */
+            QSharedPointer<Compiler> compiler(unsigned index) const;
+
+            /**
+             * Method you can use to change the job queue shared by the compilers in the pool.  Note that, by default,
+             * a \ref Cbe::FifoJobQueue will be used.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newJobQueue The new job queue used to track jobs.  Any previously registered job queue will be
+             *                        destroyed.
+             */
+            void setJobQueue(QSharedPointer<JobQueue<CompilerContext>> newJobQueue);
+
+            /**
+             * Convenience method you can use to change the job queue shared by the compilers in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newJobQueue A pointer to the job queue used to track jobs.  Note that this class will take
+             *                        ownership of the job queue.  Any previously registered job queue will be
+             *                        destroyed.
+             */
+            void setJobQueue(JobQueue<CompilerContext>* newJobQueue);
+
+            /**
+             * Method you can use to enable or disable debug output on every compiler in the pool.
+             *
+             * \param[in] enableDebugOutput If true, debug output will be enabled.  If false, debug output will be
+             *                              disabled.
+             */
+            void setDebugOutputEnabled(bool enableDebugOutput = true);
+
+            /**
+             * Method you can use to change the command line switches used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newCompilerSwitches the updated list of compiler switches.
+             */
+            void setCompilerSwitches(const QList<QString>& newCompilerSwitches);
+
+            /**
+             * Method you can use to set the system root directory used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newSystemRoot The new system root directory.
+             */
+            void setSystemRoot(const QString& newSystemRoot);
+
+            /**
+             * Method you can use to change the header search paths used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newHeaderSearchPaths the new list of header search paths.
+             */
+            void setHeaderSearchPaths(const QList<QString>& newHeaderSearchPaths);
+
+            /**
+             * Method you can use to change the explicitly included headers used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newHeaders the new list of headers.
+             */
+            void setHeaders(const QList<QString>& newHeaders);
+
+            /**
+             * Method you can use to change the explicitly included precompiled headers used by every compiler in the
+             * pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newPrecompiledHeaders the new list of precompiled headers.
+             */
+            void setPrecompiledHeaders(const QList<QString>& newPrecompiledHeaders);
+
+            /**
+             * Method you can use to change the runtime bitcode modules used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newRuntimeBitcodeModules the new list of runtime bitcode modules.
+             */
+            void setRuntimeBitcodeModules(const QList<QString>& newRuntimeBitcodeModules);
+
+            /**
+             * Method you can use to change the resource directory used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newResourceDirectory The new resource directory to be used.
+             */
+            void setResourceDirectory(const QString& newResourceDirectory);
+
+            /**
+             * Method you can use to change the GCC toolchain prefix directory used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newGccToolchainPrefix The new directory for the GCC toolchain.
+             */
+            void setGccToolchain(const QString& newGccToolchainPrefix);
+
+            /**
+             * Method you can use to change the target triple used by every compiler in the pool.
+             *
+             * \param[in] newTargetTriple The new target triple to be used by the compiler.  An empty string will cause the
+             *                            compiler to guess the correct target triple for the system.
+             */
+            void setTargetTriple(const QString& newTargetTriple);
+
+            /**
+             * Method you can use to enable or disable automatic precompiled headers on every compiler in the pool.
+             * Compilers sharing a cache directory will share the generated precompiled headers.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] nowEnabled If true, automatic precompiled headers will be enabled.  If false, automatic
+             *                       precompiled headers will be disabled.
+             */
+            void setAutomaticPchEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to set the precompiled header cache directory used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newPchCacheDirectory The new cache directory.  An empty string will select a directory under
+             *                                 the system temporary directory.
+             */
+            void setPchCacheDirectory(const QString& newPchCacheDirectory);
+
+            /**
+             * Method you can use to enable or disable implicit clang modules on every compiler in the pool.  See
+             * \ref Compiler::setModulesEnabled.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] nowEnabled If true, modules will be enabled.  If false, modules will be disabled.
+             */
+            void setModulesEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to set the module cache directory used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newModuleCacheDirectory The new cache directory.  An empty string will select a directory
+             *                                    under the system temporary directory.
+             */
+            void setModuleCacheDirectory(const QString& newModuleCacheDirectory);
+
+            /**
+             * Method you can use to enable or disable the compile cache on every compiler in the pool.  Compilers
+             * sharing a cache directory will share cached objects.  See \ref Compiler::setCompileCacheEnabled.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] nowEnabled If true, the compile cache will be enabled.  If false, the compile cache will be
+             *                       disabled.
+             */
+            void setCompileCacheEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to set the compile cache directory used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newCompileCacheDirectory The new cache directory.  An empty string will select a directory
+             *                                     under the system temporary directory.
+             */
+            void setCompileCacheDirectory(const QString& newCompileCacheDirectory);
+
+            /**
+             * Method you can use to set the maximum size of the compile cache used by every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newMaximumSize The new maximum cache size, in bytes.
+             */
+            void setCompileCacheMaximumSize(unsigned long long newMaximumSize);
+
+            /**
+             * Method you can use to enable or disable preamble reuse on every compiler in the pool.  Each compiler
+             * tracks its own preamble.  See \ref Compiler::setPreambleReuseEnabled.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] nowEnabled If true, preamble reuse will be enabled.  If false, preamble reuse will be
+             *                       disabled.
+             */
+            void setPreambleReuseEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to enable or disable worker processes for every compiler in the pool.  Each compiler
+             * owns one worker process.  See \ref Compiler::setWorkerProcessEnabled.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] nowEnabled If true, worker processes will be used.  If false, contexts will be compiled in
+             *                       this process.
+             */
+            void setWorkerProcessEnabled(bool nowEnabled = true);
+
+            /**
+             * Method you can use to set the directory holding the worker executable for every compiler in the pool.
+             *
+             * This method will block until all pending contexts have been processed.
+             *
+             * \param[in] newExecutableDirectory The directory where the worker executable is expected to be found.
+             *                                   An empty string selects the default.
+             */
+            void setExecutableDirectory(const QString& newExecutableDirectory);
+
+            /**
+             * Method that can be called to queue a context for compilation.  The context will be processed by the
+             * first available compiler in the pool.  A context that is already queued to be checked is rejected.
+             *
+             * \param[in] context The compile context to be executed.
+             *
+             * \return Returns true if the context was queued.  Returns false if the context was rejected.
+             */
+            bool compile(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Convenience method that can be called to queue a context for compilation.
+             *
+             * \param[in] context The compile context to be executed.  This method will take ownership of the context.
+             *
+             * \return Returns true if the context was queued.  Returns false if the context was rejected.
+             */
+            bool compile(CompilerContext* context);
+
+            /**
+             * Method that can be called to queue a context to be checked without generating code.  See
+             * \ref Compiler::check.  A context that is already queued to be compiled is rejected.
+             *
+             * \param[in] context The context to be checked.
+             *
+             * \return Returns true if the context was queued.  Returns false if the context was rejected.
+             */
+            bool check(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Convenience method that can be called to queue a context to be checked without generating code.
+             *
+             * \param[in] context The context to be checked.  This method will take ownership of the context.
+             *
+             * \return Returns true if the context was queued.  Returns false if the context was rejected.
+             */
+            bool check(CompilerContext* context);
+
+            /**
+             * Method that can be called to queue many small contexts to be compiled together.  Batches are assigned to
+             * the compilers in the pool in turn and bypass the pool's job queue.  See \ref Compiler::compileBatch.
+             *
+             * \param[in] contexts The contexts to be compiled.
+             *
+             * \return Returns true if every context was queued.  Returns false if any context was rejected.
+             */
+            bool compileBatch(const QList<QSharedPointer<CompilerContext>>& contexts);
+
+            /**
+             * Method that can be called to cancel a context queued on, or being compiled by, the pool.  This method
+             * does not block.
+             *
+             * \param[in] context The context to be cancelled.
+             */
+            void cancel(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Method you can call after configuring the pool to prepare every compiler in the background.  See
+             * \ref Compiler::warmUp.
+             */
+            void warmUp();
+
+            /**
+             * Method that can be called to stall this thread until every compiler in the pool finishes all outstanding
+             * contexts.
+             */
+            void waitComplete();
+
+            /**
+             * Method that can be called to stall this thread until every compiler in the pool finishes all outstanding
+             * contexts.
+             *
+             * \param[in] maximumTimeInMilliseconds The maximum time to wait, in milliseconds.
+             *
+             * \return Returns true on success, returns false if the pool timed out.
+             */
+            bool waitComplete(unsigned long maximumTimeInMilliseconds);
+
+            /**
+             * Method you can call to determine if any compiler in the pool is running in the background.
+             *
+             * \return Returns true if the pool is active.  Returns false if the pool is not active.
+             */
+            bool active() const;
+
+        private:
+            class CBE_PUBLIC_API Private;
+
+            QSharedPointer<Private> impl;
+    };
+};
+
+#endif
@@ -0,0 +1,151 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::CompilerTiming class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_COMPILER_TIMING_H
+#define CBE_COMPILER_TIMING_H
+
+#include <QSharedDataPointer>
+
+#include "cbe_common.h"
+
+namespace Cbe {
+    /**
+     * Class that holds the time spent in each phase of a single compilation.  Wall clock time and the CPU time
+     * consumed by the compiler thread are both recorded.
+     *
+     * The class uses a pimpl implementation allowing you to pass the object, by value, with minimal overhead.
+     */
+    class CBE_PUBLIC_API CompilerTiming {
+        public:
+            /**
+             * Enumeration of compilation phases.
+             */
+            enum class Phase {
+                /**
+                 * Compiler configuration, compile cache lookup, and preamble and virtual header setup.
+                 */
+                PREPARATION,
+
+                /**
+                 * Preprocessing, parsing, and semantic analysis.  Clang performs these steps incrementally, one top
+                 * level declaration at a time, so they are reported together.
+                 */
+                FRONTEND,
+
+                /**
+                 * Generation of LLVM IR for each top level declaration as it is parsed.
+                 */
+                IR_GENERATION,
+
+                /**
+                 * Emission of deferred declarations, LLVM optimization, and object emission.
+                 */
+                BACKEND
+            };
+
+            /**
+             * The number of phases.
+             */
+            static constexpr unsigned numberPhases = 4;
+
+            /**
+             * Constructor.  All times are initialized to zero.
+             */
+            CompilerTiming();
+
+            /**
+             * Copy constructor.
+             *
+             * \param[in] other The instance to be copied.
+             */
+            CompilerTiming(const CompilerTiming& other);
+
+            ~CompilerTiming();
+
+            /**
+             * Method you can use to obtain the wall clock time spent in a phase.
+             *
+             * \param[in] phase The phase of interest.
+             *
+             * \return Returns the wall clock time, in seconds.
+             */
+            double wallTime(Phase phase) const;
+
+            /**
+             * Method you can use to obtain the compiler thread's CPU time spent in a phase.
+             *
+             * \param[in] phase The phase of interest.
+             *
+             * \return Returns the CPU time, in seconds.
+             */
+            double cpuTime(Phase phase) const;
+
+            /**
+             * Method you can use to obtain the total wall clock time across all phases.
+             *
+             * \return Returns the total wall clock time, in seconds.
+             */
+            double totalWallTime() const;
+
+            /**
+             * Method you can use to obtain the total CPU time across all phases.
+             *
+             * \return Returns the total CPU time, in seconds.
+             */
+            double totalCpuTime() const;
+
+            /**
+             * Method that is called by the compiler to record the time spent in a phase.  You should not normally
+             * need to call this method.
+             *
+             * \param[in] phase       The phase of interest.
+             *
+             * \param[in] newWallTime The wall clock time, in seconds.
+             *
+             * \param[in] newCpuTime  The CPU time, in seconds.
+             */
+            void setTime(Phase phase, double newWallTime, double newCpuTime);
+
+            /**
+             * Assignment operator.
+             *
+             * \param[in] other The instance to be copied.
+             *
+             * \return Returns a reference to this instance.
+             */
+            CompilerTiming& operator=(const CompilerTiming& other);
+
+        private:
+            class CBE_PUBLIC_API Private;
+
+            QSharedDataPointer<Private> impl;
+    };
+};
+
+#endif
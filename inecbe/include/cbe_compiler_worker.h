@@ -0,0 +1,70 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::CompilerWorker class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_COMPILER_WORKER_H
+#define CBE_COMPILER_WORKER_H
+
+#include <QString>
+
+#include "cbe_common.h"
+
+namespace Cbe {
+    /**
+     * Class that implements the worker process used by compilers with worker processes enabled.  See
+     * \ref Cbe::Compiler::setWorkerProcessEnabled.
+     *
+     * The worker reads requests from its standard input, compiles each one using a persistent compiler instance, and
+     * writes the results to its standard output.  The worker exits when its standard input is closed.  The
+     * inecbe_worker executable shipped with this library simply calls \ref CompilerWorker::exec from its main
+     * function.  Applications that build their own worker executable should do the same and should not write to
+     * standard output.
+     */
+    class CBE_PUBLIC_API CompilerWorker {
+        public:
+            /**
+             * Method you can use to obtain the filename of the worker executable, without a directory.
+             *
+             * \return Returns the worker executable filename.
+             */
+            static QString executableName();
+
+            /**
+             * Method that services requests until the worker's standard input is closed.
+             *
+             * \return Returns the process exit code.  A value of 0 is returned when standard input is closed.  A
+             *         non-zero value is returned if a malformed request is received or the host can not be reached.
+             */
+            static int exec();
+
+        private:
+            class Private;
+    };
+};
+
+#endif
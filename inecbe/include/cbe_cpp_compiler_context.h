@@ -33,6 +33,7 @@
 #include <QString>
 #include <QList>
 #include <QByteArray>
+#include <QMap>
 #include <QSharedDataPointer>
 
 #include "cbe_common.h"
@@ -120,6 +121,54 @@ namespace Cbe {
              */
             unsigned long columnNumber() const;
 
+            /**
+             * Method you can use to determine the line number holding a byte offset into the source data.  The lookup
+             * is a binary search over the line starts recorded as the source was appended.
+             *
+             * \param[in] byteOffset The zero based byte offset into the source data.
+             *
+             * \return Returns the one-based line number.
+             */
+            unsigned long lineNumber(unsigned long byteOffset) const;
+
+            /**
+             * Method you can use to determine the column number of a byte offset into the source data.
+             *
+             * \param[in] byteOffset The zero based byte offset into the source data.
+             *
+             * \return Returns the zero-based column number.
+             */
+            unsigned long columnNumber(unsigned long byteOffset) const;
+
+            /**
+             * Method you can use to attach an in-memory header to this context.  The header can be included by name
+             * using either quoted or angle bracket \#include directives.  The header takes precedence over files of
+             * the same name in the header search paths and is only visible while this context is being compiled.
+             *
+             * \param[in] name     The header's relative path, for example "generated/helpers.h".  An existing header
+             *                     with the same name is replaced.  Absolute paths and paths leading out of the
+             *                     header directory are rejected.  See \ref CompilerContext::validVirtualHeaderName.
+             *
+             * \param[in] contents The header's contents.
+             *
+             * \return Returns true if the header was added.  Returns false if the name is not valid.
+             */
+            bool addVirtualHeader(const QString& name, const QByteArray& contents);
+
+            /**
+             * Method you can use to remove an in-memory header from this context.
+             *
+             * \param[in] name The header's relative path.
+             */
+            void removeVirtualHeader(const QString& name);
+
+            /**
+             * Method you can use to obtain the in-memory headers attached to this context.
+             *
+             * \return Returns a map of header contents keyed by the header's relative path.
+             */
+            QMap<QString, QByteArray> virtualHeaders() const final;
+
             /**
              * Method that can be called from derived classes to append source code data to the internal buffer.
              *
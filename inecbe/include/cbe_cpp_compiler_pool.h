@@ -0,0 +1,60 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::CppCompilerPool class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_CPP_COMPILER_POOL_H
+#define CBE_CPP_COMPILER_POOL_H
+
+#include "cbe_common.h"
+#include "cbe_compiler_pool.h"
+
+namespace Cbe {
+    class CppCompilerNotifier;
+
+    /**
+     * Convenience class that populates a \ref Cbe::CompilerPool with \ref Cbe::CppCompiler instances.
+     */
+    class CBE_PUBLIC_API CppCompilerPool:public CompilerPool {
+        public:
+            /**
+             * Constructor
+             *
+             * \param[in] numberCompilers The number of compilers to place in the pool.  A value of 0 will create one
+             *                            compiler per available processor thread.
+             *
+             * \param[in] newNotifier     A pointer to the notifier instance every compiler should send notification
+             *                            data to.  A null pointer will disable notifications.  The notifier must
+             *                            remain valid for the lifetime of the pool.
+             */
+            CppCompilerPool(unsigned numberCompilers = 0, CppCompilerNotifier* newNotifier = nullptr);
+
+            ~CppCompilerPool() override;
+    };
+};
+
+#endif
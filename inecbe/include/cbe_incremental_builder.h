@@ -0,0 +1,190 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::IncrementalBuilder class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_INCREMENTAL_BUILDER_H
+#define CBE_INCREMENTAL_BUILDER_H
+
+#include <QString>
+#include <QSharedPointer>
+
+#include "cbe_common.h"
+
+namespace Cbe {
+    class CppCompilerPool;
+    class CppCompilerContext;
+    class DynamicLibraryLinker;
+
+    /**
+     * Class that builds dynamic libraries from large generated sources, recompiling only the parts of the source that
+     * changed since the previous build.
+     *
+     * The source is split into a prologue and a sequence of chunks.  The prologue is the text up to and including the
+     * first line holding only \ref Cbe::IncrementalBuilder::chunkMarker.  Each chunk is compiled, together with the
+     * prologue, into its own object.  Chunks whose text and prologue are unchanged reuse the object from the previous
+     * build.  The objects are then linked into a single library.
+     *
+     * Because chunks are compiled separately, the prologue should only hold declarations, type definitions, inline
+     * functions, templates, and macros.  Each chunk may only reference entities defined in other chunks through
+     * declarations in the prologue and should not define functions or variables with internal linkage that are used
+     * by other chunks.  With \ref Partitioning::TOP_LEVEL_DECLARATIONS, a source that fails to compile as chunks is
+     * compiled again as a single unit.  If that succeeds, the library is built from the single unit and a warning is
+     * reported at the first error seen while compiling the chunks, typically a use of an entity declared in another
+     * chunk.
+     *
+     * The builder owns its compiler pool and linker.  You can use the accessor methods to configure them.  Call
+     * \ref Cbe::IncrementalBuilder::clear after changing the compiler configuration so objects built with the previous
+     * configuration are not reused.
+     */
+    class CBE_PUBLIC_API IncrementalBuilder {
+        public:
+            /**
+             * Line used to mark the end of the prologue and, with \ref Partitioning::MARKERS, the boundary between
+             * chunks.  The marker is a C++ comment so it has no effect on the compiled code.  You can insert it
+             * using "*context << Cbe::IncrementalBuilder::chunkMarker << Cbe::endl".
+             */
+            static constexpr const char* chunkMarker = "//@inecbe-chunk";
+
+            /**
+             * Value indicating the default target chunk size, in bytes, used with
+             * \ref Partitioning::TOP_LEVEL_DECLARATIONS.
+             */
+            static constexpr unsigned long defaultTargetChunkSize = 16384;
+
+            /**
+             * Enumeration of supported ways to split the source after the prologue into chunks.
+             */
+            enum class Partitioning {
+                /**
+                 * Indicates chunks are delimited by lines holding only \ref Cbe::IncrementalBuilder::chunkMarker.
+                 */
+                MARKERS,
+
+                /**
+                 * Indicates chunks are formed from runs of top-level declarations.  Chunk boundaries are chosen from
+                 * the declarations' content and the chunk sizes.  An edit usually changes only the chunk holding it
+                 * but an edit that moves a boundary also changes the chunks that follow until the boundaries realign.
+                 * Declarations inside namespaces are kept together with the enclosing namespace.
+                 */
+                TOP_LEVEL_DECLARATIONS
+            };
+
+            IncrementalBuilder();
+
+            virtual ~IncrementalBuilder();
+
+            /**
+             * Method you can use to access the compiler pool used to compile the chunks.
+             *
+             * \return Returns a reference to the compiler pool.
+             */
+            CppCompilerPool& compilerPool();
+
+            /**
+             * Method you can use to access the linker used to generate the libraries.
+             *
+             * \return Returns a reference to the linker.
+             */
+            DynamicLibraryLinker& linker();
+
+            /**
+             * Method you can use to set how the source is split into chunks.
+             *
+             * \param[in] newPartitioning The new partitioning.
+             */
+            void setPartitioning(Partitioning newPartitioning);
+
+            /**
+             * Method you can use to determine how the source is split into chunks.
+             *
+             * \return Returns the current partitioning.
+             */
+            Partitioning partitioning() const;
+
+            /**
+             * Method you can use to set the approximate chunk size used with
+             * \ref Partitioning::TOP_LEVEL_DECLARATIONS.
+             *
+             * \param[in] newTargetChunkSize The new target chunk size, in bytes.
+             */
+            void setTargetChunkSize(unsigned long newTargetChunkSize);
+
+            /**
+             * Method you can use to determine the approximate chunk size used with
+             * \ref Partitioning::TOP_LEVEL_DECLARATIONS.
+             *
+             * \return Returns the target chunk size, in bytes.
+             */
+            unsigned long targetChunkSize() const;
+
+            /**
+             * Method you can use to build a library.  The method blocks until the library has been linked.
+             *
+             * The supplied context receives a single compiler started and compiler finished callback covering all the
+             * chunks.  Diagnostics are reported against the supplied context's source.  The object file and object
+             * destination of the supplied context are not used.
+             *
+             * \param[in] context     The context holding the source to be built.
+             *
+             * \param[in] libraryFile The library to be generated.
+             *
+             * \return Returns true on success, returns false if a chunk could not be compiled or the library could
+             *         not be linked.
+             */
+            bool build(QSharedPointer<CppCompilerContext> context, const QString& libraryFile);
+
+            /**
+             * Method you can use to determine the number of chunks in the most recent build.  A value of 1 is returned
+             * if the most recent build fell back to compiling the source as a single unit.
+             *
+             * \return Returns the number of chunks.
+             */
+            unsigned long numberChunks() const;
+
+            /**
+             * Method you can use to determine the number of chunks compiled by the most recent build.  Remaining
+             * chunks reused objects from the previous build.  A compile of the source as a single unit is included.
+             *
+             * \return Returns the number of compiled chunks.
+             */
+            unsigned long numberCompiledChunks() const;
+
+            /**
+             * Method you can use to discard the objects kept from previous builds.  The next build will compile every
+             * chunk.
+             */
+            void clear();
+
+        private:
+            class Private;
+
+            QSharedPointer<Private> impl;
+    };
+};
+
+#endif
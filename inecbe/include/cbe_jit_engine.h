@@ -0,0 +1,177 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::JitEngine class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_JIT_ENGINE_H
+#define CBE_JIT_ENGINE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include "cbe_common.h"
+
+namespace Cbe {
+    class CompilerContext;
+
+    /**
+     * Class that loads compiler output directly into the running process using the LLVM ORC JIT.  You can use this
+     * class in place of the \ref Cbe::Linker and \ref Cbe::DynamicLibraryLoader classes to avoid writing an object
+     * file, running the linker, and loading a dynamic library.
+     *
+     * Contexts compiled with the \ref Cbe::CompilerContext::ObjectFormat::BITCODE object format are preferred.  The
+     * JIT generates machine code for bitcode itself and runs static constructors as each module is added.  Native
+     * objects are linked as-is but their static constructors are not run.
+     *
+     * Symbols defined by the host process are visible to JIT compiled code.  Use \ref Cbe::JitEngine::addLibrary to
+     * make symbols from additional dynamic libraries visible.
+     *
+     * Large generated modules can be compiled lazily.  In \ref Cbe::JitEngine::Compilation::LAZY mode bitcode
+     * modules are not compiled when added.  Each function is compiled to machine code the first time it is called so
+     * functions that are never called are never compiled.
+     *
+     * The class uses a pimpl implementation.  Copies share the same JIT instance.  The class is thread safe.
+     */
+    class CBE_PUBLIC_API JitEngine {
+        public:
+            /**
+             * Enumeration of supported compilation modes.
+             */
+            enum class Compilation {
+                /**
+                 * Indicates that bitcode modules are compiled to machine code when they are added.
+                 */
+                EAGER,
+
+                /**
+                 * Indicates that each function in a bitcode module is compiled to machine code on its first call.
+                 * Native objects are always linked when they are added.
+                 */
+                LAZY
+            };
+
+            /**
+             * Constructor.
+             *
+             * \param[in] compilation The compilation mode used for bitcode modules.
+             */
+            JitEngine(Compilation compilation = Compilation::EAGER);
+
+            virtual ~JitEngine();
+
+            /**
+             * Method you can use to determine if the JIT was successfully created for the host.
+             *
+             * \return Returns true if the JIT is usable.  Returns false if the JIT could not be created.
+             */
+            bool isValid() const;
+
+            /**
+             * Method you can use to obtain a description of the most recent error.
+             *
+             * \return Returns a description of the most recent error.
+             */
+            QString errorString() const;
+
+            /**
+             * Method you can use to determine the compilation mode used for bitcode modules.
+             *
+             * \return Returns the compilation mode.
+             */
+            Compilation compilation() const;
+
+            /**
+             * Method you can use to make the symbols exported by a dynamic library visible to JIT compiled code.
+             *
+             * \param[in] libraryFilename The dynamic library to be searched.  You are strongly advised to use an
+             *                            absolute path.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool addLibrary(const QString& libraryFilename);
+
+            /**
+             * Method you can use to add the output of a successful compilation to the JIT.  The object is taken from
+             * \ref Cbe::CompilerContext::objectData or read from \ref Cbe::CompilerContext::objectFile based on the
+             * context's object destination.
+             *
+             * \param[in] context The compiled context.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool add(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Method you can use to add a native object to the JIT.
+             *
+             * \param[in] objectData The object to be added.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool addObject(const QByteArray& objectData);
+
+            /**
+             * Method you can use to add an LLVM bitcode module to the JIT.  Static constructors defined by the module
+             * are run before this method returns.
+             *
+             * \param[in] bitcodeData The bitcode to be added.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool addBitcode(const QByteArray& bitcodeData);
+
+            /**
+             * Method you can use to obtain the address of a symbol.  In \ref Cbe::JitEngine::Compilation::EAGER mode
+             * machine code for the symbol is generated, if needed, before this method returns.  In
+             * \ref Cbe::JitEngine::Compilation::LAZY mode functions defined in bitcode resolve to a stub that
+             * generates machine code for the function on its first call.
+             *
+             * \param[in] symbolName The unmangled name of the symbol.
+             *
+             * \return Returns the address of the symbol.  A null pointer is returned if the symbol could not be
+             *         found.
+             */
+            void* resolve(const QString& symbolName) const;
+
+            /**
+             * Method you can use to discard everything added to the JIT.  Static destructors are run and a new JIT is
+             * created.  Libraries added with \ref Cbe::JitEngine::addLibrary remain visible.  Addresses previously
+             * obtained from \ref Cbe::JitEngine::resolve become invalid.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool reset();
+
+        private:
+            class Private;
+
+            QSharedPointer<Private> impl;
+    };
+};
+
+#endif
@@ -32,6 +32,7 @@
 
 #include <QMutex>
 #include <QSharedPointer>
+#include <QQueue>
 
 #include <cstdint>
 
@@ -39,8 +40,9 @@
 
 namespace Cbe {
     /**
-     * Pure virtual template base class that can be used to construct compiler and linker job queues.  The calling
-     * function is responsible for guarding against collisions due to concurrency.
+     * Pure virtual template base class that can be used to construct compiler and linker job queues.  Unless the
+     * queue reports that it is thread safe, the calling function is responsible for guarding against collisions due to
+     * concurrency.
      *
      * \param[in] T The class being used for job contexts.
      */
@@ -48,6 +50,17 @@ namespace Cbe {
         public:
             virtual ~JobQueue() {}
 
+            /**
+             * Method you can use to determine if this queue can be safely accessed from multiple threads without
+             * external locking.  Compilers and linkers will skip their internal queue mutex for thread safe queues.
+             *
+             * \return Returns true if the queue is thread safe.  Returns false if the caller must guard the queue.  The
+             *         default implementation returns false.
+             */
+            virtual bool threadSafe() const {
+                return false;
+            }
+
             /**
              * Method you can use to determine the number of pending jobs.
              *
@@ -78,6 +91,15 @@ namespace Cbe {
              *         is empty.
              */
             virtual QSharedPointer<T> dequeue() = 0;
+
+            /**
+             * Method called by compilers and linkers after a job has been enqueued and any queue lock has been
+             * released.  Queues that defer notifications raised while enqueueing can deliver them here, where a
+             * notification can safely submit new work.
+             *
+             * The default implementation simply returns.
+             */
+            virtual void deliverNotifications() {}
     };
 
     /**
@@ -126,6 +148,49 @@ namespace Cbe {
              */
             QSharedPointer<T> pendingJob;
     };
+
+    /**
+     * Template class that instantiates an unbounded first-in, first-out job queue.  Every enqueued job will be
+     * processed in the order it was received.  This queue is well suited to a \ref Cbe::CompilerPool where several
+     * workers drain the same queue.
+     *
+     * \param[in] T The class being used for job contexts.
+     */
+    template<typename T> class CBE_PUBLIC_API FifoJobQueue:public JobQueue<T> {
+        public:
+            /**
+             * Method you can use to determine the number of pending jobs.
+             *
+             * \return Returns the current number of pending jobs.
+             */
+            unsigned numberPendingJobs() const final {
+                return static_cast<unsigned>(pendingJobs.size());
+            }
+
+            /**
+             * Method you can use to enqueue a job.
+             *
+             * \param[in] newJob A shared pointer to the job to be enqueued.
+             */
+            void enqueue(QSharedPointer<T> newJob) final {
+                pendingJobs.enqueue(newJob);
+            }
+
+            /**
+             * Method you can use to dequeue a job.
+             *
+             * \return Returns a shared pointer to the dequeued job.  A null pointer is returned if the queue is empty.
+             */
+            QSharedPointer<T> dequeue() final {
+                return pendingJobs.isEmpty() ? QSharedPointer<T>() : pendingJobs.dequeue();
+            }
+
+        private:
+            /**
+             * The pending jobs, oldest first.
+             */
+            QQueue<QSharedPointer<T>> pendingJobs;
+    };
 };
 
 #endif
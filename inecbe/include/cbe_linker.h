@@ -327,6 +327,23 @@ namespace Cbe {
              */
             void setRunTimeSearchPaths(const QList<QString>& newRunTimeSearchPaths);
 
+            /**
+             * Method you can use to set the directory used to cache ThinLTO results.  Object files generated from
+             * \ref Cbe::CompilerContext::ObjectFormat::THIN_LTO bitcode are optimized and code generated by the
+             * linker.  With a cache directory, code for modules that are unchanged since an earlier link is reused
+             * from the cache.  The cache is not supported by the internal linker on MacOS.
+             *
+             * \param[in] newLtoCacheDirectory The new cache directory.  An empty string disables the cache.
+             */
+            void setLtoCacheDirectory(const QString& newLtoCacheDirectory);
+
+            /**
+             * Method you can use to determine the directory used to cache ThinLTO results.
+             *
+             * \return Returns the cache directory.  An empty string is returned if the cache is disabled.
+             */
+            QString ltoCacheDirectory() const;
+
             /**
              * Method that can be called to run the linker.
              *
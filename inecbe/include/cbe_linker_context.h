@@ -192,6 +192,16 @@ namespace Cbe {
              */
             virtual void handleLinkerDiagnostic(const QString& diagnosticMessage);
 
+            /**
+             * Virtual method you can overload to receive notification when this context was removed from a job queue
+             * because a newer context targeting the same output file was enqueued.  The linker will not be invoked on
+             * this context.  Note that the method is called from the thread enqueueing the newer context after the job
+             * queue is unlocked.
+             *
+             * The default implementation simply returns.
+             */
+            virtual void linkerJobSuperseded();
+
         private:
             class CBE_PUBLIC_API Private;
 
@@ -89,6 +89,22 @@ namespace Cbe {
                 const QString&                diagnosticMessage
             );
 
+            /**
+             * Virtual method that is called when a pending context is replaced in a
+             * \ref Cbe::CoalescingLinkerJobQueue that uses this notifier.  The superseded context will not be linked.
+             * The method is called from the thread enqueueing the new context after the job queue is unlocked.
+             *
+             * The default implementation simply returns.
+             *
+             * \param[in] supersededContext The context that was removed from the job queue.
+             *
+             * \param[in] newContext        The context that replaced the superseded context.
+             */
+            virtual void linkerJobSuperseded(
+                QSharedPointer<LinkerContext> supersededContext,
+                QSharedPointer<LinkerContext> newContext
+            );
+
             /**
              * Method you can use to obtain a pointer to the linker instance providing notifications to this class.
              *
@@ -0,0 +1,453 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::LockFreeJobQueue template class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_LOCK_FREE_JOB_QUEUE_H
+#define CBE_LOCK_FREE_JOB_QUEUE_H
+
+#include <QSharedPointer>
+#include <QThread>
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "cbe_common.h"
+#include "cbe_job_queue.h"
+
+namespace Cbe {
+    /**
+     * Template class that instantiates a bounded, lock-free, multiple-producer/multiple-consumer job queue.  Jobs are
+     * held in one ring buffer per priority level.  Each ring buffer uses a per-slot sequence number so producers and
+     * consumers only contend on a single atomic index each.
+     *
+     * Jobs are dequeued in first-in, first-out order within a priority level.  Higher priority levels are always
+     * drained before lower priority levels.  Overload \ref Cbe::LockFreeJobQueue::jobPriority to assign priorities
+     * to jobs.
+     *
+     * This queue is safe to use from multiple threads without external locking.  Compilers and linkers will skip their
+     * internal queue mutex when this queue is used.
+     *
+     * \param[in] T The class being used for job contexts.
+     */
+    template<typename T> class CBE_PUBLIC_API LockFreeJobQueue:public JobQueue<T> {
+        public:
+            /**
+             * Enumeration of actions to take when a job is enqueued into a full queue.
+             */
+            enum class FullPolicy {
+                /**
+                 * Indicates the caller should wait until space becomes available in the queue.  The caller backs off
+                 * exponentially, from a simple yield up to \ref Cbe::LockFreeJobQueue::maximumBlockingDelay
+                 * microseconds, between attempts.
+                 */
+                BLOCK,
+
+                /**
+                 * Indicates the job should be discarded.  Discarded jobs are counted and can be determined using
+                 * \ref Cbe::LockFreeJobQueue::numberRejectedJobs.  Each discarded job is also passed to
+                 * \ref Cbe::LockFreeJobQueue::jobRejected.
+                 */
+                REJECT
+            };
+
+            /**
+             * The default capacity of each priority level.
+             */
+            static constexpr unsigned defaultCapacity = 256;
+
+            /**
+             * The longest delay, in microseconds, between attempts to enqueue a job into a full queue when the
+             * \ref Cbe::LockFreeJobQueue::FullPolicy::BLOCK policy is used.
+             */
+            static constexpr unsigned long maximumBlockingDelay = 1000;
+
+            /**
+             * Constructor
+             *
+             * \param[in] newCapacity             The maximum number of pending jobs per priority level.  The value
+             *                                    will be rounded up to the next power of two.
+             *
+             * \param[in] newFullPolicy           The action to take when a job is enqueued into a full priority level.
+             *
+             * \param[in] newNumberPriorityLevels The number of distinct priority levels.  A value of 1 yields a simple
+             *                                    FIFO.
+             */
+            LockFreeJobQueue(
+                    unsigned   newCapacity             = defaultCapacity,
+                    FullPolicy newFullPolicy           = FullPolicy::BLOCK,
+                    unsigned   newNumberPriorityLevels = 1
+                ):currentFullPolicy(
+                    newFullPolicy
+                ),currentNumberPriorityLevels(
+                    newNumberPriorityLevels > 0 ? newNumberPriorityLevels : 1
+                ),rings(
+                    new Ring[newNumberPriorityLevels > 0 ? newNumberPriorityLevels : 1]
+                ),rejectedJobs(
+                    0
+                ) {
+                std::size_t ringCapacity = 2;
+                while (ringCapacity < newCapacity) {
+                    ringCapacity <<= 1;
+                }
+
+                for (unsigned level=0 ; level<currentNumberPriorityLevels ; ++level) {
+                    rings[level].initialize(ringCapacity);
+                }
+            }
+
+            ~LockFreeJobQueue() override {}
+
+            /**
+             * Method you can use to determine if this queue can be safely accessed without external locking.
+             *
+             * \return Returns true.
+             */
+            bool threadSafe() const final {
+                return true;
+            }
+
+            /**
+             * Method you can use to determine the capacity of each priority level.
+             *
+             * \return Returns the maximum number of pending jobs per priority level.
+             */
+            unsigned capacity() const {
+                return static_cast<unsigned>(rings[0].capacity());
+            }
+
+            /**
+             * Method you can use to determine the action taken when the queue is full.
+             *
+             * \return Returns the full queue policy.
+             */
+            FullPolicy fullPolicy() const {
+                return currentFullPolicy;
+            }
+
+            /**
+             * Method you can use to determine the number of priority levels.
+             *
+             * \return Returns the number of priority levels.
+             */
+            unsigned numberPriorityLevels() const {
+                return currentNumberPriorityLevels;
+            }
+
+            /**
+             * Method you can use to determine the number of jobs discarded because the queue was full.
+             *
+             * \return Returns the number of discarded jobs.
+             */
+            unsigned long long numberRejectedJobs() const {
+                return rejectedJobs.load();
+            }
+
+            /**
+             * Method you can use to determine the number of pending jobs.  Note that the value is a snapshot and may
+             * be stale by the time it is used.
+             *
+             * \return Returns the current number of pending jobs.
+             */
+            unsigned numberPendingJobs() const final {
+                std::size_t result = 0;
+                for (unsigned level=0 ; level<currentNumberPriorityLevels ; ++level) {
+                    result += rings[level].size();
+                }
+
+                return static_cast<unsigned>(result);
+            }
+
+            /**
+             * Method you can use to enqueue a job.  If the job's priority level is full, the job is either discarded
+             * or this method waits until space is available, based on the full queue policy.
+             *
+             * \param[in] newJob A shared pointer to the job to be enqueued.
+             */
+            void enqueue(QSharedPointer<T> newJob) final {
+                bool success = tryEnqueue(newJob);
+                if (!success) {
+                    if (currentFullPolicy == FullPolicy::BLOCK) {
+                        unsigned long delay = 0;
+                        do {
+                            if (delay == 0) {
+                                QThread::yieldCurrentThread();
+                                delay = 1;
+                            } else {
+                                QThread::usleep(delay);
+                                delay = 2 * delay < maximumBlockingDelay ? 2 * delay : maximumBlockingDelay;
+                            }
+
+                            success = tryEnqueue(newJob);
+                        } while (!success);
+                    } else {
+                        ++rejectedJobs;
+                        jobRejected(newJob);
+                    }
+                }
+            }
+
+            /**
+             * Method you can use to enqueue a job without blocking, regardless of the full queue policy.
+             *
+             * \param[in] newJob A shared pointer to the job to be enqueued.
+             *
+             * \return Returns true if the job was enqueued.  Returns false if the job's priority level is full.
+             */
+            bool tryEnqueue(QSharedPointer<T> newJob) {
+                unsigned level = jobPriority(newJob);
+                if (level >= currentNumberPriorityLevels) {
+                    level = currentNumberPriorityLevels - 1;
+                }
+
+                return rings[level].push(newJob);
+            }
+
+            /**
+             * Method you can use to dequeue a job.  Jobs in higher priority levels are returned first.
+             *
+             * \return Returns a shared pointer to the dequeued job.  A null pointer is returned if the queue is empty.
+             */
+            QSharedPointer<T> dequeue() final {
+                QSharedPointer<T> result;
+
+                unsigned level = currentNumberPriorityLevels;
+                while (result.isNull() && level > 0) {
+                    --level;
+                    result = rings[level].pop();
+                }
+
+                return result;
+            }
+
+        protected:
+            /**
+             * Method you can overload to assign a priority level to a job.  The default implementation places every job
+             * at priority level 0.
+             *
+             * \param[in] job The job to be prioritized.
+             *
+             * \return Returns the zero based priority level.  Higher values are dequeued first.  Values beyond the
+             *         last priority level are clamped to the last priority level.
+             */
+            virtual unsigned jobPriority(const QSharedPointer<T>& job) const {
+                (void) job;
+                return 0;
+            }
+
+            /**
+             * Method you can overload to receive notification that a job was discarded because its priority level
+             * was full.  This method is only called when the \ref Cbe::LockFreeJobQueue::FullPolicy::REJECT policy is
+             * used and is called from the thread enqueueing the job.  Note that the job will never be passed to a
+             * compiler or linker so this is the only notification the job will receive.
+             *
+             * The default implementation simply returns.
+             *
+             * \param[in] rejectedJob The job that was discarded.
+             */
+            virtual void jobRejected(QSharedPointer<T> rejectedJob) {
+                (void) rejectedJob;
+            }
+
+        private:
+            /**
+             * Size used to keep the producer and consumer indexes on separate cache lines.
+             */
+            static constexpr std::size_t cacheLineSize = 64;
+
+            /**
+             * Bounded ring buffer used to track jobs at a single priority level.  Each slot carries a sequence number
+             * indicating whether the slot is available to the next producer or the next consumer.
+             */
+            class Ring {
+                public:
+                    Ring():mask(0),enqueuePosition(0),dequeuePosition(0) {}
+
+                    /**
+                     * Method that allocates the ring's slots.
+                     *
+                     * \param[in] ringCapacity The number of slots.  Must be a power of two.
+                     */
+                    void initialize(std::size_t ringCapacity) {
+                        slotArray.reset(new Slot[ringCapacity]);
+                        mask = ringCapacity - 1;
+
+                        for (std::size_t index=0 ; index<ringCapacity ; ++index) {
+                            slotArray[index].sequence.store(index, std::memory_order_relaxed);
+                        }
+                    }
+
+                    /**
+                     * Method that determines the number of slots in the ring.
+                     *
+                     * \return Returns the ring capacity.
+                     */
+                    std::size_t capacity() const {
+                        return mask + 1;
+                    }
+
+                    /**
+                     * Method that determines the approximate number of jobs in the ring.
+                     *
+                     * \return Returns the number of jobs that have been claimed by producers but not consumers.
+                     */
+                    std::size_t size() const {
+                        std::size_t dequeued = dequeuePosition.load();
+                        std::size_t enqueued = enqueuePosition.load();
+                        return enqueued > dequeued ? enqueued - dequeued : 0;
+                    }
+
+                    /**
+                     * Method that adds a job to the ring.
+                     *
+                     * \param[in] job The job to be added.
+                     *
+                     * \return Returns true on success.  Returns false if the ring is full.
+                     */
+                    bool push(const QSharedPointer<T>& job) {
+                        Slot*       slot     = nullptr;
+                        std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+                        while (slot == nullptr) {
+                            Slot*          candidate  = &slotArray[position & mask];
+                            std::size_t    sequence   = candidate->sequence.load(std::memory_order_acquire);
+                            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+                            if (difference == 0) {
+                                if (enqueuePosition.compare_exchange_weak(position, position + 1)) {
+                                    slot = candidate;
+                                }
+                            } else if (difference < 0) {
+                                return false;
+                            } else {
+                                position = enqueuePosition.load(std::memory_order_relaxed);
+                            }
+                        }
+
+                        slot->job = job;
+                        slot->sequence.store(position + 1, std::memory_order_release);
+
+                        return true;
+                    }
+
+                    /**
+                     * Method that removes the oldest job from the ring.
+                     *
+                     * \return Returns the removed job.  A null pointer is returned if the ring is empty.
+                     */
+                    QSharedPointer<T> pop() {
+                        Slot*       slot     = nullptr;
+                        std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+
+                        while (slot == nullptr) {
+                            Slot*          candidate  = &slotArray[position & mask];
+                            std::size_t    sequence   = candidate->sequence.load(std::memory_order_acquire);
+                            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+                            if (difference == 0) {
+                                if (dequeuePosition.compare_exchange_weak(position, position + 1)) {
+                                    slot = candidate;
+                                }
+                            } else if (difference < 0) {
+                                return QSharedPointer<T>();
+                            } else {
+                                position = dequeuePosition.load(std::memory_order_relaxed);
+                            }
+                        }
+
+                        QSharedPointer<T> result = slot->job;
+                        slot->job.reset();
+                        slot->sequence.store(position + mask + 1, std::memory_order_release);
+
+                        return result;
+                    }
+
+                private:
+                    /**
+                     * A single slot in the ring.
+                     */
+                    struct Slot {
+                        std::atomic<std::size_t> sequence;
+                        QSharedPointer<T>        job;
+                    };
+
+                    /**
+                     * The ring's slots.
+                     */
+                    std::unique_ptr<Slot[]> slotArray;
+
+                    /**
+                     * Mask used to map positions onto slots.
+                     */
+                    std::size_t mask;
+
+                    /**
+                     * Padding used to keep the producer index off the cache line holding the slot pointer.
+                     */
+                    char leadingPadding[cacheLineSize];
+
+                    /**
+                     * The next position to be claimed by a producer.
+                     */
+                    std::atomic<std::size_t> enqueuePosition;
+
+                    /**
+                     * Padding used to keep the producer and consumer indexes on separate cache lines.
+                     */
+                    char centerPadding[cacheLineSize - sizeof(std::atomic<std::size_t>)];
+
+                    /**
+                     * The next position to be claimed by a consumer.
+                     */
+                    std::atomic<std::size_t> dequeuePosition;
+            };
+
+            /**
+             * The action to take when a priority level is full.
+             */
+            FullPolicy currentFullPolicy;
+
+            /**
+             * The number of priority levels.
+             */
+            unsigned currentNumberPriorityLevels;
+
+            /**
+             * One ring per priority level.
+             */
+            std::unique_ptr<Ring[]> rings;
+
+            /**
+             * The number of jobs discarded because the queue was full.
+             */
+            std::atomic<unsigned long long> rejectedJobs;
+    };
+};
+
+#endif
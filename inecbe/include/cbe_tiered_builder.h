@@ -0,0 +1,181 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::TieredBuilder class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_TIERED_BUILDER_H
+#define CBE_TIERED_BUILDER_H
+
+#include <QString>
+#include <QSharedPointer>
+
+#include "cbe_common.h"
+
+namespace Cbe {
+    class TieredBuilderNotifier;
+    class CppCompiler;
+    class CppCompilerContext;
+    class DynamicLibraryLinker;
+    class DynamicLibraryLoader;
+
+    /**
+     * Class that builds and loads dynamic libraries in two tiers to reduce the time to the first usable result.
+     *
+     * Each context is first compiled without optimization, linked, and loaded.  The same source is then compiled
+     * with full optimization by a second compiler running at reduced priority.  When the optimized library is ready it
+     * is loaded by a new \ref Cbe::DynamicLibraryLoader and, only if loading succeeds, replaces the unoptimized
+     * library.  A library that fails to load leaves the previous library in place.
+     *
+     * A newer build supersedes any older build that has not yet been loaded.  Optimized builds of superseded contexts
+     * are cancelled.
+     *
+     * The builder owns its compilers, linker, and loader.  You can use the accessor methods to configure them.  Note
+     * that both compilers must be configured with the same header search paths, system root, and similar settings.
+     *
+     * Libraries are loaded from the linker's thread.  A replaced library, and its file, remain loaded so code already
+     * running in it can finish.  Call \ref Cbe::TieredBuilder::releasePrevious once you no longer call into replaced
+     * libraries to unload them.
+     */
+    class CBE_PUBLIC_API TieredBuilder {
+        public:
+            /**
+             * Enumeration of build tiers.
+             */
+            enum class Tier {
+                /**
+                 * Indicates the library was compiled without optimization.
+                 */
+                QUICK,
+
+                /**
+                 * Indicates the library was compiled with full optimization.
+                 */
+                OPTIMIZED
+            };
+
+            /**
+             * Constructor
+             *
+             * \param[in] newNotifier A pointer to the notifier instance this builder should send notification data
+             *                        to.  A null pointer will disable notifications.
+             */
+            TieredBuilder(TieredBuilderNotifier* newNotifier = nullptr);
+
+            virtual ~TieredBuilder();
+
+            /**
+             * Method you can use to change the notifier receiving notifications from this builder.
+             *
+             * \param[in] newNotifier A pointer to the notifier instance this builder should send notification data
+             *                        to.  A null pointer will disable notifications.
+             */
+            void setNotifier(TieredBuilderNotifier* newNotifier);
+
+            /**
+             * Method you can use to determine the current notifier receiving notifications from this builder.
+             *
+             * \return Returns a pointer to the notifier.
+             */
+            TieredBuilderNotifier* notifier() const;
+
+            /**
+             * Method you can use to access the compiler used to generate unoptimized libraries.  The compiler is
+             * configured with the default C++ switches with "-O0" in place of "-O3".
+             *
+             * \return Returns a reference to the quick compiler.
+             */
+            CppCompiler& quickCompiler();
+
+            /**
+             * Method you can use to access the compiler used to generate optimized libraries.  The compiler thread runs
+             * at low priority.
+             *
+             * \return Returns a reference to the optimizing compiler.
+             */
+            CppCompiler& optimizingCompiler();
+
+            /**
+             * Method you can use to access the linker used to generate the libraries.
+             *
+             * \return Returns a reference to the linker.
+             */
+            DynamicLibraryLinker& linker();
+
+            /**
+             * Method you can use to access the loader holding the most recently loaded library.  Each library is loaded
+             * by its own loader so you should call this method again after each
+             * \ref Cbe::TieredBuilderNotifier::tierLoaded notification.  A replaced loader remains valid until
+             * \ref Cbe::TieredBuilder::releasePrevious is called.
+             *
+             * \return Returns a reference to the loader.
+             */
+            DynamicLibraryLoader& loader();
+
+            /**
+             * Method you can use to unload every library that has been replaced by a newer library and to remove the
+             * library files.  You must not call into a replaced library after calling this method.
+             */
+            void releasePrevious();
+
+            /**
+             * Method you can use to start a tiered build.  The supplied context receives the compiler callbacks and
+             * diagnostics from the quick tier.  The object file and object destination of the supplied context are
+             * not used.
+             *
+             * \param[in] context The context holding the source to be built.
+             */
+            void build(QSharedPointer<CppCompilerContext> context);
+
+            /**
+             * Method you can use to wait until all pending builds, including optimized builds, have been loaded or
+             * discarded.
+             */
+            void waitComplete();
+
+            /**
+             * Method you can use to determine if a library is loaded.
+             *
+             * \return Returns true if a library is loaded.  Returns false if no library is loaded.
+             */
+            bool isLoaded() const;
+
+            /**
+             * Method you can use to determine the tier of the currently loaded library.
+             *
+             * \return Returns the tier of the currently loaded library.  The value is undefined if no library is
+             *         loaded.
+             */
+            Tier loadedTier() const;
+
+        private:
+            class Private;
+
+            QSharedPointer<Private> impl;
+    };
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::TieredBuilderNotifier class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_TIERED_BUILDER_NOTIFIER_H
+#define CBE_TIERED_BUILDER_NOTIFIER_H
+
+#include <QString>
+
+#include "cbe_common.h"
+#include "cbe_tiered_builder.h"
+
+namespace Cbe {
+    /**
+     * Virtual base class that can be used to intercept notifications from a \ref Cbe::TieredBuilder class.  Note that
+     * the methods are called from the builder's compiler and linker threads.
+     */
+    class CBE_PUBLIC_API TieredBuilderNotifier {
+        friend class TieredBuilder;
+
+        public:
+            TieredBuilderNotifier();
+
+            virtual ~TieredBuilderNotifier();
+
+            /**
+             * Method you can use to obtain a pointer to the builder instance providing notifications to this class.
+             *
+             * \return Returns a pointer to the associated \ref Cbe::TieredBuilder class.
+             */
+            TieredBuilder* builder() const;
+
+            /**
+             * Method that is called each time a tier's library has been loaded.  The default implementation simply
+             * returns.
+             *
+             * \param[in] tier            The tier of the newly loaded library.
+             *
+             * \param[in] libraryFilename The name of the newly loaded library.
+             */
+            virtual void tierLoaded(TieredBuilder::Tier tier, const QString& libraryFilename);
+
+            /**
+             * Method that is called when a tier could not be compiled, linked, or loaded.  The default implementation
+             * simply returns.
+             *
+             * \param[in] tier The tier that failed.
+             */
+            virtual void tierFailed(TieredBuilder::Tier tier);
+
+        private:
+            TieredBuilder* currentBuilder;
+    };
+};
+
+#endif
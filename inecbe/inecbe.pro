@@ -60,21 +60,31 @@ INCLUDEPATH += include
 API_HEADERS = include/cbe_common.h \
               include/cbe_source_range.h \
               include/cbe_job_queue.h \
+              include/cbe_lock_free_job_queue.h \
+              include/cbe_coalescing_job_queue.h \
               include/cbe_compiler.h \
               include/cbe_compiler_notifier.h \
               include/cbe_compiler_context.h \
               include/cbe_compiler_diagnostic.h \
+              include/cbe_compiler_timing.h \
               include/cbe_cpp_source_range.h \
               include/cbe_cpp_compiler_notifier.h \
               include/cbe_cpp_compiler_context.h \
               include/cbe_cpp_compiler_diagnostic.h \
               include/cbe_cpp_compiler.h \
+              include/cbe_compiler_pool.h \
+              include/cbe_cpp_compiler_pool.h \
               include/cbe_linker.h \
               include/cbe_linker_notifier.h \
               include/cbe_linker_context.h \
               include/cbe_dynamic_library_linker.h \
               include/cbe_dynamic_library_loader.h \
-              include/cbe_loader_notifier.h
+              include/cbe_loader_notifier.h \
+              include/cbe_tiered_builder.h \
+              include/cbe_tiered_builder_notifier.h \
+              include/cbe_jit_engine.h \
+              include/cbe_incremental_builder.h \
+              include/cbe_compiler_worker.h
 
 ########################################################################################################################
 # Source files
@@ -83,12 +93,19 @@ API_HEADERS = include/cbe_common.h \
 SOURCES = source/cbe_compiler.cpp \
           source/cbe_compiler_private.cpp \
           source/compiler_impl.cpp \
+          source/compile_cache.cpp \
+          source/phase_timer.cpp \
           source/cbe_compiler_notifier.cpp \
           source/cbe_compiler_context.cpp \
           source/cbe_compiler_context_private.cpp \
           source/cbe_compiler_diagnostic.cpp \
           source/cbe_compiler_diagnostic_private.cpp \
+          source/cbe_compiler_timing.cpp \
+          source/cbe_compiler_timing_private.cpp \
           source/cbe_cpp_compiler.cpp \
+          source/cbe_compiler_pool.cpp \
+          source/cbe_compiler_pool_private.cpp \
+          source/cbe_cpp_compiler_pool.cpp \
           source/cbe_cpp_source_range.cpp \
           source/cbe_cpp_source_range_private.cpp \
           source/cbe_cpp_compiler_notifier.cpp \
@@ -106,14 +123,32 @@ SOURCES = source/cbe_compiler.cpp \
           source/cbe_dynamic_library_linker.cpp \
           source/cbe_dynamic_library_loader.cpp \
           source/cbe_dynamic_library_loader_private.cpp \
-          source/cbe_loader_notifier.cpp
+          source/cbe_loader_notifier.cpp \
+          source/cbe_tiered_builder.cpp \
+          source/cbe_tiered_builder_private.cpp \
+          source/cbe_tiered_builder_notifier.cpp \
+          source/cbe_jit_engine.cpp \
+          source/cbe_jit_engine_private.cpp \
+          source/cbe_incremental_builder.cpp \
+          source/cbe_incremental_builder_private.cpp \
+          source/worker_protocol.cpp \
+          source/worker_process.cpp \
+          source/cbe_compiler_worker.cpp \
+          source/cbe_compiler_worker_private.cpp \
+          source/batch_context.cpp
 
 win32 {
-    SOURCES += source/diagnostic_consumer.cpp
+    SOURCES += source/diagnostic_consumer.cpp \
+               source/dependency_collector.cpp \
+               source/instrumented_action.cpp \
+               source/masked_file_system.cpp
 }
 
 unix {
-    SOURCES_NO_RTTI = source/diagnostic_consumer.cpp
+    SOURCES_NO_RTTI = source/diagnostic_consumer.cpp \
+                      source/dependency_collector.cpp \
+                      source/instrumented_action.cpp \
+                      source/masked_file_system.cpp
 }
 
 ########################################################################################################################
@@ -124,17 +159,31 @@ INCLUDEPATH += source
 PRIVATE_HEADERS = source/warnings.h \
                   source/cbe_compiler_private.h \
                   source/compiler_impl.h \
+                  source/cbe_compiler_pool_private.h \
                   source/cbe_compiler_context_private.h \
                   source/cbe_compiler_diagnostic_private.h \
+                  source/cbe_compiler_timing_private.h \
                   source/cbe_cpp_compiler_context_private.h \
                   source/cbe_cpp_compiler_diagnostic_private.h \
                   source/diagnostic_consumer.h \
+                  source/dependency_collector.h \
+                  source/instrumented_action.h \
+                  source/compile_cache.h \
+                  source/phase_timer.h \
                   source/cbe_source_range_private.h \
                   source/cbe_cpp_source_range_private.h \
                   source/cbe_linker_private.h \
                   source/cbe_dynamic_library_loader_private.h \
                   source/linker_impl.h \
-                  source/cbe_linker_context_private.h
+                  source/cbe_linker_context_private.h \
+                  source/cbe_tiered_builder_private.h \
+                  source/cbe_jit_engine_private.h \
+                  source/cbe_incremental_builder_private.h \
+                  source/worker_protocol.h \
+                  source/worker_process.h \
+                  source/cbe_compiler_worker_private.h \
+                  source/batch_context.h \
+                  source/masked_file_system.h
 
 ########################################################################################################################
 # Deal with multiple linker implementations
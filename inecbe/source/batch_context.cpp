@@ -0,0 +1,240 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref BatchContext class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QMap>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include <cstdint>
+#include <cctype>
+#include <algorithm>
+
+#include "cbe_compiler.h"
+#include "cbe_compiler_context.h"
+#include "cbe_source_range.h"
+#include "cbe_compiler_diagnostic.h"
+#include "batch_context.h"
+
+BatchContext::BatchContext(
+        const QList<QSharedPointer<Cbe::CompilerContext>>& newMembers
+    ):Cbe::CompilerContext(
+        newMembers.first()->objectFile()
+    ),currentMembers(
+        newMembers
+    ) {
+    const QSharedPointer<Cbe::CompilerContext>& leadMember = newMembers.first();
+
+    setObjectDestination(leadMember->objectDestination());
+    setObjectFormat(leadMember->objectFormat());
+    setAction(leadMember->action());
+
+    unsigned lineOffset = 0;
+    for (  QList<QSharedPointer<Cbe::CompilerContext>>::const_iterator memberIterator    = newMembers.constBegin(),
+                                                                       memberEndIterator = newMembers.constEnd()
+         ; memberIterator != memberEndIterator
+         ; ++memberIterator
+        ) {
+        const QByteArray& memberSource = (*memberIterator)->sourceData();
+
+        memberByteOffsets.append(static_cast<unsigned long>(currentSourceData.size()));
+        memberLineOffsets.append(lineOffset);
+
+        currentSourceData += memberSource;
+        lineOffset += static_cast<unsigned>(memberSource.count('\n'));
+
+        // Each member must start on a new line for the line numbers, and columns, to be routed correctly.
+        if (!memberSource.isEmpty() && !memberSource.endsWith('\n')) {
+            currentSourceData += '\n';
+            ++lineOffset;
+        }
+    }
+
+    lastMemberIndex = 0;
+}
+
+
+BatchContext::~BatchContext() {}
+
+
+QList<QSharedPointer<Cbe::CompilerContext>> BatchContext::combine(
+        const QList<QSharedPointer<Cbe::CompilerContext>>& contexts
+    ) {
+    QList<QSharedPointer<Cbe::CompilerContext>>                                           result;
+    QMap<Cbe::CompilerContext::ObjectFormat, QList<QSharedPointer<Cbe::CompilerContext>>> groups;
+
+    for (  QList<QSharedPointer<Cbe::CompilerContext>>::const_iterator contextIterator    = contexts.constBegin(),
+                                                                       contextEndIterator = contexts.constEnd()
+         ; contextIterator != contextEndIterator
+         ; ++contextIterator
+        ) {
+        const QSharedPointer<Cbe::CompilerContext>& context = *contextIterator;
+        // Only the first member of a batch receives the object so contexts writing their object to a file are
+        // never batched.
+        if (context->objectDestination() == Cbe::CompilerContext::ObjectDestination::MEMORY     &&
+            context->timeTraceDestination() == Cbe::CompilerContext::TimeTraceDestination::NONE &&
+            context->virtualHeaders().isEmpty()                                                 &&
+            !context->cancelled()                                                               &&
+            isolated(context->sourceData())                                                        ) {
+            groups[context->objectFormat()].append(context);
+        } else {
+            result.append(context);
+        }
+    }
+
+    for (  QMap<Cbe::CompilerContext::ObjectFormat, QList<QSharedPointer<Cbe::CompilerContext>>>::const_iterator
+               groupIterator    = groups.constBegin(),
+               groupEndIterator = groups.constEnd()
+         ; groupIterator != groupEndIterator
+         ; ++groupIterator
+        ) {
+        const QList<QSharedPointer<Cbe::CompilerContext>>& group = groupIterator.value();
+        if (group.size() == 1) {
+            result.append(group.first());
+        } else {
+            result.append(QSharedPointer<Cbe::CompilerContext>(new BatchContext(group)));
+        }
+    }
+
+    return result;
+}
+
+
+const QList<QSharedPointer<Cbe::CompilerContext>>& BatchContext::members() const {
+    return currentMembers;
+}
+
+
+const QByteArray& BatchContext::sourceData() const {
+    return currentSourceData;
+}
+
+
+unsigned long BatchContext::byteOffset() const {
+    return static_cast<unsigned long>(currentSourceData.size());
+}
+
+
+void BatchContext::append(const std::uint8_t data) {
+    currentSourceData.append(static_cast<char>(data));
+}
+
+
+void BatchContext::append(const QByteArray& data) {
+    currentSourceData.append(data);
+}
+
+
+void BatchContext::addDiagnostic(
+        Cbe::CompilerDiagnostic::Level diagnosticLevel,
+        Cbe::CompilerDiagnostic::Code  diagnosticCode,
+        const QString&                 diagnosticMessage,
+        const QString&                 filename,
+        unsigned                       byteOffset,
+        unsigned                       lineNumber,
+        unsigned                       columnNumber
+    ) {
+    Diagnostic diagnostic;
+
+    diagnostic.level        = diagnosticLevel;
+    diagnostic.code         = diagnosticCode;
+    diagnostic.message      = diagnosticMessage;
+    diagnostic.filename     = filename;
+    diagnostic.byteOffset   = byteOffset;
+    diagnostic.lineNumber   = lineNumber;
+    diagnostic.columnNumber = columnNumber;
+
+    if (filename.isEmpty() && byteOffset == Cbe::SourceRange::invalidByteOffset) {
+        // Diagnostics with no location in the combined source, such as error limit notices, are routed unchanged to
+        // the lead member.
+        diagnostic.memberIndex = 0;
+    } else if (filename.isEmpty()) {
+        QVector<unsigned long>::const_iterator memberIterator = std::upper_bound(
+            memberByteOffsets.constBegin(),
+            memberByteOffsets.constEnd(),
+            static_cast<unsigned long>(byteOffset)
+        );
+
+        lastMemberIndex = static_cast<unsigned>(memberIterator - memberByteOffsets.constBegin()) - 1;
+
+        diagnostic.byteOffset = static_cast<unsigned>(byteOffset - memberByteOffsets.at(lastMemberIndex));
+        if (lineNumber != Cbe::Compiler::badLineNumber) {
+            diagnostic.lineNumber = lineNumber - memberLineOffsets.at(lastMemberIndex);
+        }
+
+        diagnostic.memberIndex = lastMemberIndex;
+    } else {
+        diagnostic.memberIndex = lastMemberIndex;
+    }
+
+    currentDiagnostics.append(diagnostic);
+}
+
+
+const QList<BatchContext::Diagnostic>& BatchContext::diagnostics() const {
+    return currentDiagnostics;
+}
+
+
+bool BatchContext::isolated(const QByteArray& source) {
+    bool        result  = true;
+    const char* current = source.constData();
+    const char* end     = current + source.size();
+
+    while (result && current != end) {
+        while (current != end && (*current == ' ' || *current == '\t')) {
+            ++current;
+        }
+
+        const char* lineStart = current;
+        while (current != end && *current != '\n') {
+            ++current;
+        }
+
+        QByteArray line = QByteArray::fromRawData(lineStart, static_cast<int>(current - lineStart));
+        if (line.startsWith('#')) {
+            QByteArray directive = line.mid(1).trimmed();
+            result = (
+                   !directive.startsWith("define")
+                && !directive.startsWith("undef")
+                && !directive.startsWith("pragma")
+            );
+        } else if (line.startsWith("using")) {
+            // Ignore identifiers that merely start with "using".
+            char next = line.size() > 5 ? line.at(5) : ' ';
+            result = (std::isalnum(static_cast<unsigned char>(next)) || next == '_');
+        }
+
+        if (current != end) {
+            ++current;
+        }
+    }
+
+    return result;
+}
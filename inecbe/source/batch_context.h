@@ -0,0 +1,237 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref BatchContext class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef BATCH_CONTEXT_H
+#define BATCH_CONTEXT_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include <cstdint>
+
+#include "cbe_compiler_context.h"
+#include "cbe_compiler_diagnostic.h"
+
+/**
+ * Context that compiles the source of several contexts as a single translation unit.  Each member's source starts on
+ * a new line of the combined source so diagnostics can be routed back to the member by byte offset.
+ *
+ * Only contexts compiled to memory are batched.  The batch produces a single object using the object file and format
+ * of the first member, which receives the object.
+ */
+class BatchContext:public Cbe::CompilerContext {
+    public:
+        /**
+         * Structure holding a diagnostic routed to a member of the batch.
+         */
+        struct Diagnostic {
+            /**
+             * The zero based index of the member the diagnostic applies to.
+             */
+            unsigned memberIndex;
+
+            /**
+             * The diagnostic level.
+             */
+            Cbe::CompilerDiagnostic::Level level;
+
+            /**
+             * The compiler specific diagnostic code.
+             */
+            Cbe::CompilerDiagnostic::Code code;
+
+            /**
+             * The diagnostic message.
+             */
+            QString message;
+
+            /**
+             * The file the diagnostic was found in.  An empty string indicates the member's source.
+             */
+            QString filename;
+
+            /**
+             * The zero based byte offset into the member's source.
+             */
+            unsigned byteOffset;
+
+            /**
+             * The one based line number into the member's source.
+             */
+            unsigned lineNumber;
+
+            /**
+             * The column number.
+             */
+            unsigned columnNumber;
+        };
+
+        /**
+         * Constructor
+         *
+         * \param[in] newMembers The contexts to be compiled together.  The list must not be empty.
+         */
+        BatchContext(const QList<QSharedPointer<Cbe::CompilerContext>>& newMembers);
+
+        ~BatchContext() override;
+
+        /**
+         * Method that groups contexts that can share a translation unit into batches.  Contexts writing their object
+         * to a file, requesting a time trace, supplying virtual headers, already cancelled, or whose source is not
+         * isolated are left to be compiled individually.  The remaining contexts are grouped by object format.
+         *
+         * \param[in] contexts The contexts to be grouped.
+         *
+         * \return Returns the jobs to be queued.  Groups of two or more contexts are returned as batches.  All other
+         *         contexts are returned unchanged.
+         */
+        static QList<QSharedPointer<Cbe::CompilerContext>> combine(
+            const QList<QSharedPointer<Cbe::CompilerContext>>& contexts
+        );
+
+        /**
+         * Method you can use to obtain the members of the batch.
+         *
+         * \return Returns the members, in the order their source appears in the batch.
+         */
+        const QList<QSharedPointer<Cbe::CompilerContext>>& members() const;
+
+        /**
+         * Method you can use to obtain the combined source.
+         *
+         * \return Returns the combined source of every member.
+         */
+        const QByteArray& sourceData() const override;
+
+        /**
+         * Method you can use to determine the current byte offset into the combined source.
+         *
+         * \return Returns the size of the combined source.
+         */
+        unsigned long byteOffset() const override;
+
+        /**
+         * Method that appends a byte to the combined source.
+         *
+         * \param[in] data The byte to be appended.
+         */
+        void append(const std::uint8_t data) override;
+
+        /**
+         * Method that appends data to the combined source.
+         *
+         * \param[in] data The data to be appended.
+         */
+        void append(const QByteArray& data) override;
+
+        /**
+         * Method that records a diagnostic reported against the combined source, routing it to the member holding
+         * the location.  Diagnostics in other files are routed to the member that received the previous diagnostic.
+         * Diagnostics without a location in the combined source are routed, unchanged, to the lead member.
+         *
+         * \param[in] diagnosticLevel   The diagnostic level.
+         *
+         * \param[in] diagnosticCode    The compiler specific diagnostic code.
+         *
+         * \param[in] diagnosticMessage The diagnostic message.
+         *
+         * \param[in] filename          The file the diagnostic was found in.  An empty string indicates the combined
+         *                              source.
+         *
+         * \param[in] byteOffset        The zero based byte offset into the combined source.
+         *
+         * \param[in] lineNumber        The one based line number into the combined source.
+         *
+         * \param[in] columnNumber      The column number.
+         */
+        void addDiagnostic(
+            Cbe::CompilerDiagnostic::Level diagnosticLevel,
+            Cbe::CompilerDiagnostic::Code  diagnosticCode,
+            const QString&                 diagnosticMessage,
+            const QString&                 filename,
+            unsigned                       byteOffset,
+            unsigned                       lineNumber,
+            unsigned                       columnNumber
+        );
+
+        /**
+         * Method you can use to obtain the diagnostics routed to the members.
+         *
+         * \return Returns the routed diagnostics in the order they were reported.
+         */
+        const QList<Diagnostic>& diagnostics() const;
+
+    private:
+        /**
+         * Method that determines if a context's source can be placed ahead of other sources in a translation unit
+         * without changing their meaning.  Sources that define or undefine macros, use pragmas, or contain using
+         * declarations or directives are not isolated.  The check is lexical and conservative: a using declaration
+         * in a function body also marks the source as not isolated.
+         *
+         * \param[in] source The source to be checked.
+         *
+         * \return Returns true if the source is isolated.  Returns false if the source must be compiled alone.
+         */
+        static bool isolated(const QByteArray& source);
+
+        /**
+         * The members of the batch.
+         */
+        QList<QSharedPointer<Cbe::CompilerContext>> currentMembers;
+
+        /**
+         * The combined source.
+         */
+        QByteArray currentSourceData;
+
+        /**
+         * The byte offset where each member's source starts in the combined source.
+         */
+        QVector<unsigned long> memberByteOffsets;
+
+        /**
+         * The number of lines preceding each member's source in the combined source.
+         */
+        QVector<unsigned> memberLineOffsets;
+
+        /**
+         * The index of the member that received the last diagnostic.
+         */
+        unsigned lastMemberIndex;
+
+        /**
+         * The routed diagnostics.
+         */
+        QList<Diagnostic> currentDiagnostics;
+};
+
+#endif
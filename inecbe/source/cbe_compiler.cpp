@@ -28,11 +28,14 @@
 #include <QString>
 #include <QList>
 #include <QByteArray>
+#include <QThread>
+#include <QSharedPointer>
 
 #include "cbe_compiler_context.h"
 #include "cbe_job_queue.h"
 #include "cbe_compiler_notifier.h"
 #include "cbe_compiler_private.h"
+#include "batch_context.h"
 #include "cbe_compiler.h"
 
 namespace Cbe {
@@ -50,6 +53,26 @@ namespace Cbe {
     }
 
 
+    void Compiler::setTargetInitialization(Compiler::TargetInitialization newTargetInitialization) {
+        CompilerImpl::setTargetInitialization(newTargetInitialization);
+    }
+
+
+    Compiler::TargetInitialization Compiler::targetInitialization() {
+        return CompilerImpl::targetInitialization();
+    }
+
+
+    void Compiler::setInitialTargets(const QList<QString>& newInitialTargets) {
+        CompilerImpl::setInitialTargets(newInitialTargets);
+    }
+
+
+    QList<QString> Compiler::initialTargets() {
+        return CompilerImpl::initialTargets();
+    }
+
+
     void Compiler::setDebugOutputEnabled(bool enableDebugOutput) {
         impl->setDebugOutputEnabled(enableDebugOutput);
     }
@@ -90,6 +113,26 @@ namespace Cbe {
     }
 
 
+    void Compiler::setWorkerProcessEnabled(bool nowEnabled) {
+        impl->setWorkerProcessEnabled(nowEnabled);
+    }
+
+
+    void Compiler::setWorkerProcessDisabled(bool nowDisabled) {
+        setWorkerProcessEnabled(!nowDisabled);
+    }
+
+
+    bool Compiler::workerProcessEnabled() const {
+        return impl->workerProcessEnabled();
+    }
+
+
+    bool Compiler::workerProcessDisabled() const {
+        return !workerProcessEnabled();
+    }
+
+
     void Compiler::setExecutableDirectory(const QString& newExecutableDirectory) {
         impl->setExecutableDirectory(newExecutableDirectory);
     }
@@ -150,6 +193,16 @@ namespace Cbe {
     }
 
 
+    QList<QString> Compiler::runtimeBitcodeModules() const {
+        return impl->runtimeBitcodeModules();
+    }
+
+
+    void Compiler::setRuntimeBitcodeModules(const QList<QString>& newRuntimeBitcodeModules) {
+        impl->setRuntimeBitcodeModules(newRuntimeBitcodeModules);
+    }
+
+
     QString Compiler::resourceDirectory() const {
         return impl->resourceDirectory();
     }
@@ -180,13 +233,206 @@ namespace Cbe {
     }
 
 
-    void Compiler::compile(QSharedPointer<CompilerContext> context) {
-        return impl->compile(context);
+    void Compiler::setAutomaticPchEnabled(bool nowEnabled) {
+        impl->setAutomaticPchEnabled(nowEnabled);
+    }
+
+
+    void Compiler::setAutomaticPchDisabled(bool nowDisabled) {
+        setAutomaticPchEnabled(!nowDisabled);
+    }
+
+
+    bool Compiler::automaticPchEnabled() const {
+        return impl->automaticPchEnabled();
+    }
+
+
+    bool Compiler::automaticPchDisabled() const {
+        return !automaticPchEnabled();
+    }
+
+
+    void Compiler::setPchCacheDirectory(const QString& newPchCacheDirectory) {
+        impl->setPchCacheDirectory(newPchCacheDirectory);
+    }
+
+
+    QString Compiler::pchCacheDirectory() const {
+        return impl->pchCacheDirectory();
+    }
+
+
+    void Compiler::setModulesEnabled(bool nowEnabled) {
+        impl->setModulesEnabled(nowEnabled);
+    }
+
+
+    void Compiler::setModulesDisabled(bool nowDisabled) {
+        setModulesEnabled(!nowDisabled);
+    }
+
+
+    bool Compiler::modulesEnabled() const {
+        return impl->modulesEnabled();
+    }
+
+
+    bool Compiler::modulesDisabled() const {
+        return !modulesEnabled();
+    }
+
+
+    void Compiler::setModuleCacheDirectory(const QString& newModuleCacheDirectory) {
+        impl->setModuleCacheDirectory(newModuleCacheDirectory);
+    }
+
+
+    QString Compiler::moduleCacheDirectory() const {
+        return impl->moduleCacheDirectory();
+    }
+
+
+    void Compiler::setCompileCacheEnabled(bool nowEnabled) {
+        impl->setCompileCacheEnabled(nowEnabled);
+    }
+
+
+    void Compiler::setCompileCacheDisabled(bool nowDisabled) {
+        setCompileCacheEnabled(!nowDisabled);
+    }
+
+
+    bool Compiler::compileCacheEnabled() const {
+        return impl->compileCacheEnabled();
+    }
+
+
+    bool Compiler::compileCacheDisabled() const {
+        return !compileCacheEnabled();
+    }
+
+
+    void Compiler::setCompileCacheDirectory(const QString& newCompileCacheDirectory) {
+        impl->setCompileCacheDirectory(newCompileCacheDirectory);
+    }
+
+
+    QString Compiler::compileCacheDirectory() const {
+        return impl->compileCacheDirectory();
+    }
+
+
+    void Compiler::setCompileCacheMaximumSize(unsigned long long newMaximumSize) {
+        impl->setCompileCacheMaximumSize(newMaximumSize);
+    }
+
+
+    unsigned long long Compiler::compileCacheMaximumSize() const {
+        return impl->compileCacheMaximumSize();
+    }
+
+
+    unsigned long long Compiler::compileCacheHits() const {
+        return impl->compileCacheHits();
+    }
+
+
+    unsigned long long Compiler::compileCacheMisses() const {
+        return impl->compileCacheMisses();
+    }
+
+
+    void Compiler::setPreambleReuseEnabled(bool nowEnabled) {
+        impl->setPreambleReuseEnabled(nowEnabled);
+    }
+
+
+    void Compiler::setPreambleReuseDisabled(bool nowDisabled) {
+        setPreambleReuseEnabled(!nowDisabled);
+    }
+
+
+    bool Compiler::preambleReuseEnabled() const {
+        return impl->preambleReuseEnabled();
+    }
+
+
+    bool Compiler::preambleReuseDisabled() const {
+        return !preambleReuseEnabled();
+    }
+
+
+    void Compiler::setThreadPriority(QThread::Priority newThreadPriority) {
+        impl->setThreadPriority(newThreadPriority);
+    }
+
+
+    QThread::Priority Compiler::threadPriority() const {
+        return impl->threadPriority();
+    }
+
+
+    bool Compiler::compile(QSharedPointer<CompilerContext> context) {
+        bool success = context->markQueued(CompilerContext::Action::COMPILE);
+        if (success) {
+            impl->compile(context);
+        }
+
+        return success;
+    }
+
+
+    bool Compiler::compile(CompilerContext* context) {
+        return compile(QSharedPointer<CompilerContext>(context));
+    }
+
+
+    bool Compiler::check(QSharedPointer<CompilerContext> context) {
+        bool success = context->markQueued(CompilerContext::Action::CHECK);
+        if (success) {
+            impl->compile(context);
+        }
+
+        return success;
+    }
+
+
+    bool Compiler::check(CompilerContext* context) {
+        return check(QSharedPointer<CompilerContext>(context));
+    }
+
+
+    bool Compiler::compileBatch(const QList<QSharedPointer<CompilerContext>>& contexts) {
+        bool                                   success = true;
+        QList<QSharedPointer<CompilerContext>> queuedContexts;
+
+        for (  QList<QSharedPointer<CompilerContext>>::const_iterator contextIterator    = contexts.constBegin(),
+                                                                      contextEndIterator = contexts.constEnd()
+             ; contextIterator != contextEndIterator
+             ; ++contextIterator
+            ) {
+            if ((*contextIterator)->markQueued(CompilerContext::Action::COMPILE)) {
+                queuedContexts.append(*contextIterator);
+            } else {
+                success = false;
+            }
+        }
+
+        // Batches bypass the job queue so every job is kept regardless of the job queue's policy.
+        impl->enqueueBatchJobs(BatchContext::combine(queuedContexts));
+
+        return success;
+    }
+
+
+    void Compiler::cancel(QSharedPointer<CompilerContext> context) {
+        context->cancel();
     }
 
 
-    void Compiler::compile(CompilerContext* context) {
-        impl->compile(QSharedPointer<CompilerContext>(context));
+    void Compiler::warmUp() {
+        impl->warmUp();
     }
 
 
@@ -28,10 +28,13 @@
 #include <QString>
 #include <QList>
 #include <QByteArray>
+#include <QMap>
+#include <QDir>
 #include <QSharedDataPointer>
 #include <QSharedData>
 
 #include "cbe_common.h"
+#include "cbe_compiler_timing.h"
 
 #include "cbe_compiler_context_private.h"
 #include "cbe_compiler_context.h"
@@ -63,6 +66,147 @@ namespace Cbe {
     }
 
 
+    void CompilerContext::setObjectDestination(CompilerContext::ObjectDestination newObjectDestination) {
+        impl->setObjectDestination(newObjectDestination);
+    }
+
+
+    CompilerContext::ObjectDestination CompilerContext::objectDestination() const {
+        return impl->objectDestination();
+    }
+
+
+    void CompilerContext::setObjectFormat(CompilerContext::ObjectFormat newObjectFormat) {
+        impl->setObjectFormat(newObjectFormat);
+    }
+
+
+    CompilerContext::ObjectFormat CompilerContext::objectFormat() const {
+        return impl->objectFormat();
+    }
+
+
+    void CompilerContext::setAction(CompilerContext::Action newAction) {
+        impl->setAction(newAction);
+    }
+
+
+    CompilerContext::Action CompilerContext::action() const {
+        return impl->action();
+    }
+
+
+    void CompilerContext::setObjectData(const QByteArray& newObjectData) {
+        impl->setObjectData(newObjectData);
+    }
+
+
+    QByteArray CompilerContext::objectData() const {
+        return impl->objectData();
+    }
+
+
+    void CompilerContext::setTimeTraceDestination(CompilerContext::TimeTraceDestination newTimeTraceDestination) {
+        impl->setTimeTraceDestination(newTimeTraceDestination);
+    }
+
+
+    CompilerContext::TimeTraceDestination CompilerContext::timeTraceDestination() const {
+        return impl->timeTraceDestination();
+    }
+
+
+    void CompilerContext::setTimeTraceGranularity(unsigned newTimeTraceGranularity) {
+        impl->setTimeTraceGranularity(newTimeTraceGranularity);
+    }
+
+
+    unsigned CompilerContext::timeTraceGranularity() const {
+        return impl->timeTraceGranularity();
+    }
+
+
+    QString CompilerContext::timeTraceFile() const {
+        return impl->timeTraceFile();
+    }
+
+
+    void CompilerContext::setTimeTraceData(const QByteArray& newTimeTraceData) {
+        impl->setTimeTraceData(newTimeTraceData);
+    }
+
+
+    QByteArray CompilerContext::timeTraceData() const {
+        return impl->timeTraceData();
+    }
+
+
+    void CompilerContext::setTiming(const CompilerTiming& newTiming) {
+        impl->setTiming(newTiming);
+    }
+
+
+    CompilerTiming CompilerContext::timing() const {
+        return impl->timing();
+    }
+
+
+    void CompilerContext::cancel() const {
+        impl->cancel();
+    }
+
+
+    bool CompilerContext::cancelled() const {
+        return impl->cancelled();
+    }
+
+
+    bool CompilerContext::queued() const {
+        return impl->queued();
+    }
+
+
+    bool CompilerContext::markQueued(CompilerContext::Action newAction) {
+        bool success = impl->markQueued(newAction);
+        if (success) {
+            impl->setAction(newAction);
+        }
+
+        return success;
+    }
+
+
+    void CompilerContext::clearQueued() const {
+        impl->clearQueued();
+    }
+
+
+    void CompilerContext::clearCancellation() const {
+        impl->clearCancellation();
+    }
+
+
+    QMap<QString, QByteArray> CompilerContext::virtualHeaders() const {
+        return QMap<QString, QByteArray>();
+    }
+
+
+    bool CompilerContext::validVirtualHeaderName(const QString& name) {
+        QString cleanName = QDir::cleanPath(QDir::fromNativeSeparators(name));
+
+        bool result = (
+            !name.isEmpty()                          &&
+            QDir::isRelativePath(cleanName)          &&
+            !cleanName.contains(QChar(':'))          &&
+            cleanName != QString(".")                &&
+            cleanName != QString("..")               &&
+            !cleanName.startsWith(QString("../"))
+        );
+
+        return result;
+    }
+
+
     CompilerContext& CompilerContext::operator=(const CompilerContext& other) {
         impl = other.impl;
         return *this;
@@ -73,4 +217,10 @@ namespace Cbe {
 
 
     void CompilerContext::compilerFinished(bool) {}
+
+
+    void CompilerContext::compilerCancelled() {}
+
+
+    void CompilerContext::compilerJobSuperseded() {}
 }
@@ -29,7 +29,13 @@
 #include <QList>
 #include <QByteArray>
 #include <QSharedData>
+#include <QFileInfo>
+#include <QDir>
 
+#include <memory>
+#include <atomic>
+
+#include "cbe_compiler_timing.h"
 #include "cbe_compiler_context.h"
 #include "cbe_compiler_context_private.h"
 
@@ -40,12 +46,29 @@ namespace Cbe {
         ) {
         currentObjectFile = newObjectFile;
         currentPchFiles = newPchFiles;
+        currentObjectDestination = ObjectDestination::FILE;
+        currentObjectFormat = ObjectFormat::NATIVE;
+        currentAction = Action::COMPILE;
+        currentTimeTraceDestination = TimeTraceDestination::NONE;
+        currentTimeTraceGranularity = defaultTimeTraceGranularity;
+        currentCancellationFlag = std::make_shared<std::atomic<bool>>(false);
+        currentQueuedAction = std::make_shared<std::atomic<int>>(static_cast<int>(notQueued));
     }
 
 
     CompilerContext::Private::Private(const CompilerContext::Private& other):QSharedData(other) {
         currentObjectFile = other.currentObjectFile;
         currentPchFiles = other.currentPchFiles;
+        currentObjectDestination = other.currentObjectDestination;
+        currentObjectFormat = other.currentObjectFormat;
+        currentAction = other.currentAction;
+        currentObjectData = other.currentObjectData;
+        currentTimeTraceDestination = other.currentTimeTraceDestination;
+        currentTimeTraceGranularity = other.currentTimeTraceGranularity;
+        currentTimeTraceData = other.currentTimeTraceData;
+        currentTiming = other.currentTiming;
+        currentCancellationFlag = other.currentCancellationFlag;
+        currentQueuedAction = other.currentQueuedAction;
     }
 
 
@@ -60,4 +83,125 @@ namespace Cbe {
     QString CompilerContext::Private::objectFile() const {
         return currentObjectFile;
     }
+
+
+    void CompilerContext::Private::setObjectDestination(CompilerContext::ObjectDestination newObjectDestination) {
+        currentObjectDestination = newObjectDestination;
+    }
+
+
+    CompilerContext::ObjectDestination CompilerContext::Private::objectDestination() const {
+        return currentObjectDestination;
+    }
+
+
+    void CompilerContext::Private::setObjectFormat(CompilerContext::ObjectFormat newObjectFormat) {
+        currentObjectFormat = newObjectFormat;
+    }
+
+
+    CompilerContext::ObjectFormat CompilerContext::Private::objectFormat() const {
+        return currentObjectFormat;
+    }
+
+
+    void CompilerContext::Private::setAction(CompilerContext::Action newAction) {
+        currentAction = newAction;
+    }
+
+
+    CompilerContext::Action CompilerContext::Private::action() const {
+        return currentAction;
+    }
+
+
+    void CompilerContext::Private::setObjectData(const QByteArray& newObjectData) {
+        currentObjectData = newObjectData;
+    }
+
+
+    QByteArray CompilerContext::Private::objectData() const {
+        return currentObjectData;
+    }
+
+
+    void CompilerContext::Private::setTimeTraceDestination(
+            CompilerContext::TimeTraceDestination newTimeTraceDestination
+        ) {
+        currentTimeTraceDestination = newTimeTraceDestination;
+    }
+
+
+    CompilerContext::TimeTraceDestination CompilerContext::Private::timeTraceDestination() const {
+        return currentTimeTraceDestination;
+    }
+
+
+    void CompilerContext::Private::setTimeTraceGranularity(unsigned newTimeTraceGranularity) {
+        currentTimeTraceGranularity = newTimeTraceGranularity;
+    }
+
+
+    unsigned CompilerContext::Private::timeTraceGranularity() const {
+        return currentTimeTraceGranularity;
+    }
+
+
+    QString CompilerContext::Private::timeTraceFile() const {
+        QFileInfo objectFileInformation(currentObjectFile);
+        return objectFileInformation.dir().filePath(objectFileInformation.completeBaseName() + ".json");
+    }
+
+
+    void CompilerContext::Private::setTimeTraceData(const QByteArray& newTimeTraceData) {
+        currentTimeTraceData = newTimeTraceData;
+    }
+
+
+    QByteArray CompilerContext::Private::timeTraceData() const {
+        return currentTimeTraceData;
+    }
+
+
+    void CompilerContext::Private::setTiming(const CompilerTiming& newTiming) {
+        currentTiming = newTiming;
+    }
+
+
+    CompilerTiming CompilerContext::Private::timing() const {
+        return currentTiming;
+    }
+
+
+    void CompilerContext::Private::cancel() const {
+        *currentCancellationFlag = true;
+    }
+
+
+    bool CompilerContext::Private::cancelled() const {
+        return *currentCancellationFlag;
+    }
+
+
+    void CompilerContext::Private::clearCancellation() const {
+        *currentCancellationFlag = false;
+    }
+
+
+    bool CompilerContext::Private::markQueued(CompilerContext::Action newAction) const {
+        int expected = notQueued;
+        int action   = static_cast<int>(newAction);
+
+        return currentQueuedAction->compare_exchange_strong(expected, action) || expected == action;
+    }
+
+
+    void CompilerContext::Private::clearQueued() const {
+        *currentQueuedAction = notQueued;
+    }
+
+
+    bool CompilerContext::Private::queued() const {
+        return *currentQueuedAction != notQueued;
+    }
 }
@@ -35,7 +35,11 @@
 #include <QByteArray>
 #include <QSharedData>
 
+#include <memory>
+#include <atomic>
+
 #include "cbe_common.h"
+#include "cbe_compiler_timing.h"
 #include "cbe_compiler_context.h"
 
 namespace Cbe {
@@ -76,7 +80,169 @@ namespace Cbe {
              */
             QString objectFile() const;
 
+            /**
+             * Method you can use to specify where the compiler should place the generated object.
+             *
+             * \param[in] newObjectDestination The new object destination.
+             */
+            void setObjectDestination(ObjectDestination newObjectDestination);
+
+            /**
+             * Method you can use to determine where the compiler will place the generated object.
+             *
+             * \return Returns the current object destination.
+             */
+            ObjectDestination objectDestination() const;
+
+            /**
+             * Method you can use to specify the format of the generated object.
+             *
+             * \param[in] newObjectFormat The new object format.
+             */
+            void setObjectFormat(ObjectFormat newObjectFormat);
+
+            /**
+             * Method you can use to determine the format of the generated object.
+             *
+             * \return Returns the current object format.
+             */
+            ObjectFormat objectFormat() const;
+
+            /**
+             * Method you can use to specify the action the compiler should perform on this context.
+             *
+             * \param[in] newAction The new action.
+             */
+            void setAction(Action newAction);
+
+            /**
+             * Method you can use to determine the action the compiler will perform on this context.
+             *
+             * \return Returns the current action.
+             */
+            Action action() const;
+
+            /**
+             * Method that is called to record the generated object.
+             *
+             * \param[in] newObjectData The generated object.
+             */
+            void setObjectData(const QByteArray& newObjectData);
+
+            /**
+             * Method you can use to obtain the generated object.
+             *
+             * \return Returns the generated object.
+             */
+            QByteArray objectData() const;
+
+            /**
+             * Method you can use to request a clang time trace.
+             *
+             * \param[in] newTimeTraceDestination The new time trace destination.
+             */
+            void setTimeTraceDestination(TimeTraceDestination newTimeTraceDestination);
+
+            /**
+             * Method you can use to determine where the compiler will place the time trace.
+             *
+             * \return Returns the current time trace destination.
+             */
+            TimeTraceDestination timeTraceDestination() const;
+
+            /**
+             * Method you can use to set the minimum duration of events included in the time trace.
+             *
+             * \param[in] newTimeTraceGranularity The new granularity, in microseconds.
+             */
+            void setTimeTraceGranularity(unsigned newTimeTraceGranularity);
+
+            /**
+             * Method you can use to obtain the minimum duration of events included in the time trace.
+             *
+             * \return Returns the granularity, in microseconds.
+             */
+            unsigned timeTraceGranularity() const;
+
+            /**
+             * Method you can use to obtain the name of the file the time trace is written to.
+             *
+             * \return Returns the time trace filename.
+             */
+            QString timeTraceFile() const;
+
+            /**
+             * Method that is called to record the time trace.
+             *
+             * \param[in] newTimeTraceData The time trace JSON document.
+             */
+            void setTimeTraceData(const QByteArray& newTimeTraceData);
+
+            /**
+             * Method you can use to obtain the time trace.
+             *
+             * \return Returns the time trace JSON document.
+             */
+            QByteArray timeTraceData() const;
+
+            /**
+             * Method that is called to record the time spent in each phase of the most recent compilation.
+             *
+             * \param[in] newTiming The timing record.
+             */
+            void setTiming(const CompilerTiming& newTiming);
+
+            /**
+             * Method you can use to obtain the time spent in each phase of the most recent compilation.
+             *
+             * \return Returns the timing record.
+             */
+            CompilerTiming timing() const;
+
+            /**
+             * Method you can use to request that compilation be cancelled.
+             */
+            void cancel() const;
+
+            /**
+             * Method you can use to determine if cancellation has been requested.
+             *
+             * \return Returns true if cancellation was requested.
+             */
+            bool cancelled() const;
+
+            /**
+             * Method you can use to clear a cancellation request.
+             */
+            void clearCancellation() const;
+
+            /**
+             * Method you can use to mark the context as queued for an action.
+             *
+             * \param[in] newAction The action the context is queued for.
+             *
+             * \return Returns true on success.  Returns false if the context is already queued for a different action.
+             */
+            bool markQueued(Action newAction) const;
+
+            /**
+             * Method you can use to mark the context as no longer queued.
+             */
+            void clearQueued() const;
+
+            /**
+             * Method you can use to determine if the context is queued.
+             *
+             * \return Returns true if the context is queued.
+             */
+            bool queued() const;
+
         private:
+            /**
+             * Value held by the queued action when the context is not queued.
+             */
+            static constexpr int notQueued = -1;
+
             /**
              * The name of the object file to be generated.
              */
@@ -86,6 +252,57 @@ namespace Cbe {
              * List of PCH files.
              */
             QList<QString> currentPchFiles;
+
+            /**
+             * The current object destination.
+             */
+            ObjectDestination currentObjectDestination;
+
+            /**
+             * The current object format.
+             */
+            ObjectFormat currentObjectFormat;
+
+            /**
+             * The current action.
+             */
+            Action currentAction;
+
+            /**
+             * The generated object, when held in memory.
+             */
+            QByteArray currentObjectData;
+
+            /**
+             * The current time trace destination.
+             */
+            TimeTraceDestination currentTimeTraceDestination;
+
+            /**
+             * The current time trace granularity, in microseconds.
+             */
+            unsigned currentTimeTraceGranularity;
+
+            /**
+             * The generated time trace, when held in memory.
+             */
+            QByteArray currentTimeTraceData;
+
+            /**
+             * The timing of the most recent compilation.
+             */
+            CompilerTiming currentTiming;
+
+            /**
+             * Flag indicating if cancellation was requested.  The flag is shared by all copies of the context.
+             */
+            std::shared_ptr<std::atomic<bool>> currentCancellationFlag;
+
+            /**
+             * The action the context is queued for, or \ref CompilerContext::Private::notQueued.  The value is shared
+             * by all copies of the context.
+             */
+            std::shared_ptr<std::atomic<int>> currentQueuedAction;
     };
 };
 
@@ -26,7 +26,9 @@
 ***********************************************************************************************************************/
 
 #include <QString>
+#include <QSharedPointer>
 
+#include "cbe_compiler_context.h"
 #include "cbe_compiler.h"
 #include "cbe_source_range.h"
 #include "cbe_compiler_notifier.h"
@@ -50,4 +52,13 @@ namespace Cbe {
 
 
     void CompilerNotifier::fatalCompilerError(const QString&, bool) {}
+
+
+    void CompilerNotifier::compileCacheAccessed(bool, unsigned long long, unsigned long long) {}
+
+
+    void CompilerNotifier::compilerCancelled(QSharedPointer<CompilerContext>) {}
+
+
+    void CompilerNotifier::compilerJobSuperseded(QSharedPointer<CompilerContext>, QSharedPointer<CompilerContext>) {}
 }
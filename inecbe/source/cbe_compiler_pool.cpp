@@ -0,0 +1,252 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::CompilerPool class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QList>
+#include <QSharedPointer>
+
+#include "cbe_compiler_context.h"
+#include "cbe_job_queue.h"
+#include "cbe_compiler.h"
+#include "cbe_compiler_pool_private.h"
+#include "batch_context.h"
+#include "cbe_compiler_pool.h"
+
+namespace Cbe {
+    CompilerPool::CompilerPool():impl(new CompilerPool::Private) {}
+
+
+    CompilerPool::~CompilerPool() {}
+
+
+    void CompilerPool::addCompiler(QSharedPointer<Compiler> compiler) {
+        impl->addCompiler(compiler);
+    }
+
+
+    void CompilerPool::addCompiler(Compiler* compiler) {
+        impl->addCompiler(QSharedPointer<Compiler>(compiler));
+    }
+
+
+    unsigned CompilerPool::numberCompilers() const {
+        return static_cast<unsigned>(impl->compilers().size());
+    }
+
+
+    QSharedPointer<Compiler> CompilerPool::compiler(unsigned index) const {
+        const QList<QSharedPointer<Compiler>>& compilers = impl->compilers();
+        return index < static_cast<unsigned>(compilers.size()) ? compilers.at(index) : QSharedPointer<Compiler>();
+    }
+
+
+    void CompilerPool::setJobQueue(QSharedPointer<JobQueue<CompilerContext>> newJobQueue) {
+        impl->setJobQueue(newJobQueue);
+    }
+
+
+    void CompilerPool::setJobQueue(JobQueue<CompilerContext>* newJobQueue) {
+        impl->setJobQueue(QSharedPointer<JobQueue<CompilerContext>>(newJobQueue));
+    }
+
+
+    void CompilerPool::setDebugOutputEnabled(bool enableDebugOutput) {
+        impl->forEachCompiler(&Compiler::setDebugOutputEnabled, enableDebugOutput);
+    }
+
+
+    void CompilerPool::setCompilerSwitches(const QList<QString>& newCompilerSwitches) {
+        impl->forEachCompiler(&Compiler::setCompilerSwitches, newCompilerSwitches);
+    }
+
+
+    void CompilerPool::setSystemRoot(const QString& newSystemRoot) {
+        impl->forEachCompiler(&Compiler::setSystemRoot, newSystemRoot);
+    }
+
+
+    void CompilerPool::setHeaderSearchPaths(const QList<QString>& newHeaderSearchPaths) {
+        impl->forEachCompiler(&Compiler::setHeaderSearchPaths, newHeaderSearchPaths);
+    }
+
+
+    void CompilerPool::setHeaders(const QList<QString>& newHeaders) {
+        impl->forEachCompiler(&Compiler::setHeaders, newHeaders);
+    }
+
+
+    void CompilerPool::setPrecompiledHeaders(const QList<QString>& newPrecompiledHeaders) {
+        impl->forEachCompiler(&Compiler::setPrecompiledHeaders, newPrecompiledHeaders);
+    }
+
+
+    void CompilerPool::setRuntimeBitcodeModules(const QList<QString>& newRuntimeBitcodeModules) {
+        impl->forEachCompiler(&Compiler::setRuntimeBitcodeModules, newRuntimeBitcodeModules);
+    }
+
+
+    void CompilerPool::setResourceDirectory(const QString& newResourceDirectory) {
+        impl->forEachCompiler(&Compiler::setResourceDirectory, newResourceDirectory);
+    }
+
+
+    void CompilerPool::setGccToolchain(const QString& newGccToolchainPrefix) {
+        impl->forEachCompiler(&Compiler::setGccToolchain, newGccToolchainPrefix);
+    }
+
+
+    void CompilerPool::setTargetTriple(const QString& newTargetTriple) {
+        impl->forEachCompiler(&Compiler::setTargetTriple, newTargetTriple);
+    }
+
+
+    void CompilerPool::setAutomaticPchEnabled(bool nowEnabled) {
+        impl->forEachCompiler(&Compiler::setAutomaticPchEnabled, nowEnabled);
+    }
+
+
+    void CompilerPool::setPchCacheDirectory(const QString& newPchCacheDirectory) {
+        impl->forEachCompiler(&Compiler::setPchCacheDirectory, newPchCacheDirectory);
+    }
+
+
+    void CompilerPool::setModulesEnabled(bool nowEnabled) {
+        impl->forEachCompiler(&Compiler::setModulesEnabled, nowEnabled);
+    }
+
+
+    void CompilerPool::setModuleCacheDirectory(const QString& newModuleCacheDirectory) {
+        impl->forEachCompiler(&Compiler::setModuleCacheDirectory, newModuleCacheDirectory);
+    }
+
+
+    void CompilerPool::setCompileCacheEnabled(bool nowEnabled) {
+        impl->forEachCompiler(&Compiler::setCompileCacheEnabled, nowEnabled);
+    }
+
+
+    void CompilerPool::setCompileCacheDirectory(const QString& newCompileCacheDirectory) {
+        impl->forEachCompiler(&Compiler::setCompileCacheDirectory, newCompileCacheDirectory);
+    }
+
+
+    void CompilerPool::setCompileCacheMaximumSize(unsigned long long newMaximumSize) {
+        impl->forEachCompiler(&Compiler::setCompileCacheMaximumSize, newMaximumSize);
+    }
+
+
+    void CompilerPool::setPreambleReuseEnabled(bool nowEnabled) {
+        impl->forEachCompiler(&Compiler::setPreambleReuseEnabled, nowEnabled);
+    }
+
+
+    void CompilerPool::setWorkerProcessEnabled(bool nowEnabled) {
+        impl->forEachCompiler(&Compiler::setWorkerProcessEnabled, nowEnabled);
+    }
+
+
+    void CompilerPool::setExecutableDirectory(const QString& newExecutableDirectory) {
+        impl->forEachCompiler(&Compiler::setExecutableDirectory, newExecutableDirectory);
+    }
+
+
+    bool CompilerPool::compile(QSharedPointer<CompilerContext> context) {
+        bool success = context->markQueued(CompilerContext::Action::COMPILE);
+        if (success) {
+            impl->compile(context);
+        }
+
+        return success;
+    }
+
+
+    bool CompilerPool::compile(CompilerContext* context) {
+        return compile(QSharedPointer<CompilerContext>(context));
+    }
+
+
+    bool CompilerPool::check(QSharedPointer<CompilerContext> context) {
+        bool success = context->markQueued(CompilerContext::Action::CHECK);
+        if (success) {
+            impl->compile(context);
+        }
+
+        return success;
+    }
+
+
+    bool CompilerPool::check(CompilerContext* context) {
+        return check(QSharedPointer<CompilerContext>(context));
+    }
+
+
+    bool CompilerPool::compileBatch(const QList<QSharedPointer<CompilerContext>>& contexts) {
+        bool                                   success = true;
+        QList<QSharedPointer<CompilerContext>> queuedContexts;
+
+        for (  QList<QSharedPointer<CompilerContext>>::const_iterator contextIterator    = contexts.constBegin(),
+                                                                      contextEndIterator = contexts.constEnd()
+             ; contextIterator != contextEndIterator
+             ; ++contextIterator
+            ) {
+            if ((*contextIterator)->markQueued(CompilerContext::Action::COMPILE)) {
+                queuedContexts.append(*contextIterator);
+            } else {
+                success = false;
+            }
+        }
+
+        impl->compileBatch(BatchContext::combine(queuedContexts));
+
+        return success;
+    }
+
+
+    void CompilerPool::cancel(QSharedPointer<CompilerContext> context) {
+        context->cancel();
+    }
+
+
+    void CompilerPool::warmUp() {
+        impl->forEachCompiler(&Compiler::warmUp);
+    }
+
+
+    void CompilerPool::waitComplete() {
+        impl->waitComplete();
+    }
+
+
+    bool CompilerPool::waitComplete(unsigned long maximumTimeInMilliseconds) {
+        return impl->waitComplete(maximumTimeInMilliseconds);
+    }
+
+
+    bool CompilerPool::active() const {
+        return impl->active();
+    }
+}
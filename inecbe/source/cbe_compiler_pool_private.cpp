@@ -0,0 +1,187 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::CompilerPool::Private class.
+***********************************************************************************************************************/
+
+#include <QList>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QElapsedTimer>
+
+#include "cbe_compiler_context.h"
+#include "cbe_job_queue.h"
+#include "cbe_compiler.h"
+#include "cbe_compiler_private.h"
+#include "cbe_compiler_pool.h"
+#include "cbe_compiler_pool_private.h"
+
+namespace Cbe {
+    CompilerPool::Private::Private():jobQueue(
+            new FifoJobQueue<CompilerContext>
+        ),jobQueueMutex(
+            new QMutex
+        ),nextBatchCompiler(
+            0
+        ) {}
+
+
+    CompilerPool::Private::~Private() {
+        waitComplete();
+    }
+
+
+    void CompilerPool::Private::addCompiler(QSharedPointer<Compiler> compiler) {
+        compiler->impl->setJobQueue(jobQueue, jobQueueMutex);
+        currentCompilers.append(compiler);
+
+        jobQueueMutex->lock();
+        bool jobsPending = jobQueue->numberPendingJobs() > 0;
+        jobQueueMutex->unlock();
+
+        if (jobsPending) {
+            compiler->impl->startIfIdle();
+        }
+    }
+
+
+    const QList<QSharedPointer<Compiler>>& CompilerPool::Private::compilers() const {
+        return currentCompilers;
+    }
+
+
+    void CompilerPool::Private::setJobQueue(QSharedPointer<JobQueue<CompilerContext>> newJobQueue) {
+        waitComplete();
+
+        jobQueue = newJobQueue;
+        for (  QList<QSharedPointer<Compiler>>::const_iterator compilerIterator    = currentCompilers.constBegin(),
+                                                               compilerEndIterator = currentCompilers.constEnd()
+             ; compilerIterator != compilerEndIterator
+             ; ++compilerIterator
+            ) {
+            (*compilerIterator)->impl->setJobQueue(jobQueue, jobQueueMutex);
+        }
+    }
+
+
+    void CompilerPool::Private::compile(QSharedPointer<CompilerContext> context) {
+        // Flatten any chunked source on the submitting thread.  See CompilerImpl::compile.
+        context->sourceData();
+
+        if (jobQueue->threadSafe()) {
+            jobQueue->enqueue(context);
+        } else {
+            jobQueueMutex->lock();
+            jobQueue->enqueue(context);
+            jobQueueMutex->unlock();
+        }
+
+        jobQueue->deliverNotifications();
+
+        startIdleCompiler();
+    }
+
+
+    void CompilerPool::Private::compileBatch(const QList<QSharedPointer<CompilerContext>>& jobs) {
+        unsigned numberCompilers = static_cast<unsigned>(currentCompilers.size());
+
+        for (  QList<QSharedPointer<CompilerContext>>::const_iterator jobIterator    = jobs.constBegin(),
+                                                                      jobEndIterator = jobs.constEnd()
+             ; jobIterator != jobEndIterator
+             ; ++jobIterator
+            ) {
+            if (numberCompilers > 0) {
+                nextBatchCompiler = nextBatchCompiler % numberCompilers;
+                currentCompilers.at(nextBatchCompiler)->impl->enqueueBatchJobs(
+                    QList<QSharedPointer<CompilerContext>>() << *jobIterator
+                );
+
+                ++nextBatchCompiler;
+            } else {
+                compile(*jobIterator);
+            }
+        }
+    }
+
+
+    void CompilerPool::Private::waitComplete() {
+        for (  QList<QSharedPointer<Compiler>>::const_iterator compilerIterator    = currentCompilers.constBegin(),
+                                                               compilerEndIterator = currentCompilers.constEnd()
+             ; compilerIterator != compilerEndIterator
+             ; ++compilerIterator
+            ) {
+            (*compilerIterator)->waitComplete();
+        }
+    }
+
+
+    bool CompilerPool::Private::waitComplete(unsigned long maximumTimeInMilliseconds) {
+        QElapsedTimer timer;
+        timer.start();
+
+        bool success = true;
+        QList<QSharedPointer<Compiler>>::const_iterator it  = currentCompilers.constBegin();
+        QList<QSharedPointer<Compiler>>::const_iterator end = currentCompilers.constEnd();
+        while (success && it != end) {
+            unsigned long elapsedTime = static_cast<unsigned long>(timer.elapsed());
+            if (elapsedTime < maximumTimeInMilliseconds) {
+                success = (*it)->waitComplete(maximumTimeInMilliseconds - elapsedTime);
+            } else {
+                success = !(*it)->active();
+            }
+
+            ++it;
+        }
+
+        return success;
+    }
+
+
+    bool CompilerPool::Private::active() const {
+        bool isActive = false;
+
+        QList<QSharedPointer<Compiler>>::const_iterator it  = currentCompilers.constBegin();
+        QList<QSharedPointer<Compiler>>::const_iterator end = currentCompilers.constEnd();
+        while (!isActive && it != end) {
+            isActive = (*it)->active();
+            ++it;
+        }
+
+        return isActive;
+    }
+
+
+    void CompilerPool::Private::startIdleCompiler() {
+        // A compiler that is already running will check the shared queue again before terminating so we only need to
+        // start a single idle compiler for each newly enqueued job.
+        bool started = false;
+
+        QList<QSharedPointer<Compiler>>::const_iterator it  = currentCompilers.constBegin();
+        QList<QSharedPointer<Compiler>>::const_iterator end = currentCompilers.constEnd();
+        while (!started && it != end) {
+            started = (*it)->impl->startIfIdle();
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref Cbe::CompilerPool::Private class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_COMPILER_POOL_PRIVATE_H
+#define CBE_COMPILER_POOL_PRIVATE_H
+
+#include <QList>
+#include <QSharedPointer>
+#include <QMutex>
+
+#include "cbe_common.h"
+#include "cbe_compiler_context.h"
+#include "cbe_job_queue.h"
+#include "cbe_compiler.h"
+#include "cbe_compiler_pool.h"
+
+namespace Cbe {
+    /**
+     * Class that provides the implementation of the \ref Cbe::CompilerPool class.
+     */
+    class CBE_PUBLIC_API CompilerPool::Private {
+        public:
+            Private();
+
+            virtual ~Private();
+
+            /**
+             * Method you can use to add a compiler to the pool.
+             *
+             * \param[in] compiler The compiler to be added to the pool.
+             */
+            void addCompiler(QSharedPointer<Compiler> compiler);
+
+            /**
+             * Method you can use to obtain the compilers in the pool.
+             *
+             * \return Returns a list of the compilers in the pool.
+             */
+            const QList<QSharedPointer<Compiler>>& compilers() const;
+
+            /**
+             * Template method you can use to apply a \ref Cbe::Compiler method to every compiler in the pool.
+             *
+             * \param[in] method    The compiler method to be called.
+             *
+             * \param[in] arguments The arguments to pass to each call.
+             */
+            template<typename... P, typename... A> void forEachCompiler(
+                    void (Compiler::*method)(P...),
+                    const A&...       arguments
+                ) const {
+                for (  QList<QSharedPointer<Compiler>>::const_iterator
+                           compilerIterator    = currentCompilers.constBegin(),
+                           compilerEndIterator = currentCompilers.constEnd()
+                     ; compilerIterator != compilerEndIterator
+                     ; ++compilerIterator
+                    ) {
+                    (compilerIterator->data()->*method)(arguments...);
+                }
+            }
+
+            /**
+             * Method you can use to change the job queue shared by the compilers in the pool.
+             *
+             * \param[in] newJobQueue The new job queue used to track jobs.
+             */
+            void setJobQueue(QSharedPointer<JobQueue<CompilerContext>> newJobQueue);
+
+            /**
+             * Method that can be called to queue a context for compilation.
+             *
+             * \param[in] context The compile context to be executed.
+             */
+            void compile(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Method that can be called to queue batch jobs.  The jobs are spread across the compilers in the pool and
+             * are placed on each compiler's private batch queue so every job is kept regardless of the policy of the
+             * shared job queue.  If the pool has no compilers, the jobs are placed on the shared job queue.
+             *
+             * \param[in] jobs The jobs to be executed.
+             */
+            void compileBatch(const QList<QSharedPointer<CompilerContext>>& jobs);
+
+            /**
+             * Method that can be called to stall this thread until every compiler in the pool finishes.
+             */
+            void waitComplete();
+
+            /**
+             * Method that can be called to stall this thread until every compiler in the pool finishes.
+             *
+             * \param[in] maximumTimeInMilliseconds The maximum time to wait, in milliseconds.
+             *
+             * \return Returns true on success, returns false if the pool timed out.
+             */
+            bool waitComplete(unsigned long maximumTimeInMilliseconds);
+
+            /**
+             * Method you can call to determine if any compiler in the pool is running in the background.
+             *
+             * \return Returns true if the pool is active.  Returns false if the pool is not active.
+             */
+            bool active() const;
+
+        private:
+            /**
+             * Method that starts the first idle compiler in the pool.
+             */
+            void startIdleCompiler();
+
+            /**
+             * The compilers in the pool.
+             */
+            QList<QSharedPointer<Compiler>> currentCompilers;
+
+            /**
+             * The job queue shared by every compiler in the pool.
+             */
+            QSharedPointer<JobQueue<CompilerContext>> jobQueue;
+
+            /**
+             * Mutex used to guard the shared job queue.  Every compiler in the pool uses this mutex.
+             */
+            QSharedPointer<QMutex> jobQueueMutex;
+
+            /**
+             * The index of the compiler to receive the next batch job.
+             */
+            unsigned nextBatchCompiler;
+    };
+};
+
+#endif
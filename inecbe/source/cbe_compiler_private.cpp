@@ -27,11 +27,14 @@
 
 #include <QString>
 #include <QList>
+#include <QByteArray>
+#include <QSharedPointer>
 
 #include "cbe_compiler_notifier.h"
 #include "cbe_compiler_diagnostic.h"
 #include "cbe_compiler.h"
 #include "compiler_impl.h"
+#include "batch_context.h"
 #include "cbe_compiler_private.h"
 
 namespace Cbe {
@@ -49,12 +52,23 @@ namespace Cbe {
 
 
     void Compiler::Private::compilerStarted(QSharedPointer<CompilerContext> context) {
-        iface->compilerStarted(context);
+        if (context.dynamicCast<BatchContext>().isNull()) {
+            iface->compilerStarted(context);
+        }
     }
 
 
     void Compiler::Private::compilerFinished(QSharedPointer<CompilerContext> context, bool successful) {
-        iface->compilerFinished(context, successful);
+        QSharedPointer<BatchContext> batch = context.dynamicCast<BatchContext>();
+        if (batch.isNull()) {
+            reportFinished(context, successful);
+        } else if (successful || batch->cancelled()) {
+            reportBatch(batch, successful);
+        } else {
+            // The members are compiled individually by this compiler, ahead of the job queue, so errors are reported
+            // against only the members containing them.
+            enqueueBatchJobs(batch->members());
+        }
     }
 
 
@@ -69,16 +83,96 @@ namespace Cbe {
             unsigned                        lineNumber,
             unsigned                        columnNumber
         ) {
-        iface->processDiagnostic(
-            notifier,
-            context,
-            diagnosticLevel,
-            diagnosticCode,
-            diagnosticMessage,
-            filename,
-            byteOffset,
-            lineNumber,
-            columnNumber
-        );
+        QSharedPointer<BatchContext> batch = context.dynamicCast<BatchContext>();
+        if (batch.isNull()) {
+            iface->processDiagnostic(
+                notifier,
+                context,
+                diagnosticLevel,
+                diagnosticCode,
+                diagnosticMessage,
+                filename,
+                byteOffset,
+                lineNumber,
+                columnNumber
+            );
+        } else {
+            batch->addDiagnostic(
+                diagnosticLevel,
+                diagnosticCode,
+                diagnosticMessage,
+                filename,
+                byteOffset,
+                lineNumber,
+                columnNumber
+            );
+        }
+    }
+
+
+    void Compiler::Private::reportBatch(QSharedPointer<BatchContext> batch, bool successful) {
+        const QList<QSharedPointer<CompilerContext>>& members       = batch->members();
+        const QList<BatchContext::Diagnostic>&        diagnostics   = batch->diagnostics();
+        unsigned                                      numberMembers = static_cast<unsigned>(members.size());
+
+        for (unsigned memberIndex=0 ; memberIndex<numberMembers ; ++memberIndex) {
+            const QSharedPointer<CompilerContext>& member        = members.at(memberIndex);
+            bool                                   memberSuccess = successful && !member->cancelled();
+
+            member->clearQueued();
+
+            // The combined object is delivered through the first member, the context whose object file and
+            // destination the batch used.
+            if (memberIndex == 0                                                           &&
+                member->objectDestination() == CompilerContext::ObjectDestination::MEMORY &&
+                memberSuccess                                                                 ) {
+                member->setObjectData(batch->objectData());
+            } else {
+                member->setObjectData(QByteArray());
+            }
+
+            member->setTiming(batch->timing());
+
+            iface->compilerStarted(member);
+
+            if (!member->cancelled()) {
+                for (  QList<BatchContext::Diagnostic>::const_iterator diagnosticIterator    = diagnostics.constBegin(),
+                                                                       diagnosticEndIterator = diagnostics.constEnd()
+                     ; diagnosticIterator != diagnosticEndIterator
+                     ; ++diagnosticIterator
+                    ) {
+                    if (diagnosticIterator->memberIndex == memberIndex) {
+                        iface->processDiagnostic(
+                            notifier(),
+                            member,
+                            diagnosticIterator->level,
+                            diagnosticIterator->code,
+                            diagnosticIterator->message,
+                            diagnosticIterator->filename,
+                            diagnosticIterator->byteOffset,
+                            diagnosticIterator->lineNumber,
+                            diagnosticIterator->columnNumber
+                        );
+                    }
+                }
+            }
+
+            reportFinished(member, memberSuccess);
+        }
+    }
+
+
+    void Compiler::Private::reportFinished(QSharedPointer<CompilerContext> context, bool successful) {
+        if (!successful && context->cancelled()) {
+            context->compilerCancelled();
+
+            CompilerNotifier* currentNotifier = notifier();
+            if (currentNotifier != nullptr) {
+                currentNotifier->compilerCancelled(context);
+            }
+        }
+
+        iface->compilerFinished(context, successful);
+        context->clearCancellation();
     }
 }
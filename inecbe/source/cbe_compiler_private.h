@@ -32,6 +32,7 @@
 
 #include <QString>
 #include <QList>
+#include <QSharedPointer>
 
 #include "cbe_common.h"
 #include "cbe_source_range.h"
@@ -39,6 +40,8 @@
 #include "cbe_compiler_diagnostic.h"
 #include "compiler_impl.h"
 
+class BatchContext;
+
 namespace Cbe {
     class CompilerNotifier;
 
@@ -73,7 +76,7 @@ namespace Cbe {
 
             /**
              * Method that is called when the compiler is started.  This method forwards the notification to the
-             * interface.
+             * interface.  Members of a batch are notified once the batch finishes.
              *
              * Note that this method may be called from a different thread than was used to invoke the compiler.
              *
@@ -85,6 +88,9 @@ namespace Cbe {
              * Pure virtual method that is called when the compiler has completed processing a context.  This method
              * forwards the notification to the interface.
              *
+             * A batch that fails is split and each member is queued to be compiled individually.  Errors are then
+             * reported against only the contexts containing them and the remaining contexts still produce objects.
+             *
              * Note that this method may be called from a different thread than was used to invoke the compiler.
              *
              * \param[in] context    The context that is being executed.
@@ -97,7 +103,7 @@ namespace Cbe {
             /**
              * Method that reports errors and other diagnostics information, ideally to a \ref Cbe::CompilerNotifier
              * class.  Classes should overload this method to provide proper reporting or errors, warnings, and similar
-             * notifications.
+             * notifications.  Diagnostics reported against a batch are held by the batch until it finishes.
              *
              * \param[in] notifier          A pointer to the notifier that should receive the notification.  Note that
              *                              this method will be called even if the supplied notifier pointer is null.
@@ -136,6 +142,26 @@ namespace Cbe {
             ) final;
 
         private:
+            /**
+             * Method that reports the outcome of a successful or cancelled batch to each member of the batch.
+             *
+             * \param[in] batch      The batch that finished.
+             *
+             * \param[in] successful Holds true if the batch compiled with no reported errors.
+             */
+            void reportBatch(QSharedPointer<BatchContext> batch, bool successful);
+
+            /**
+             * Method that reports a finished context.  Cancelled contexts are reported as cancelled before they are
+             * reported as finished.  The cancellation request is cleared once the context is reported so the context
+             * can be submitted again.
+             *
+             * \param[in] context    The context that finished.
+             *
+             * \param[in] successful Holds true if the context compiled with no reported errors.
+             */
+            void reportFinished(QSharedPointer<CompilerContext> context, bool successful);
+
             Compiler* iface;
     };
 };
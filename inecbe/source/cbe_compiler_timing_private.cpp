@@ -0,0 +1,87 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::CompilerTiming::Private class.
+***********************************************************************************************************************/
+
+#include <QSharedData>
+
+#include "cbe_compiler_timing.h"
+#include "cbe_compiler_timing_private.h"
+
+namespace Cbe {
+    CompilerTiming::Private::Private() {
+        for (unsigned phaseIndex=0 ; phaseIndex<numberPhases ; ++phaseIndex) {
+            currentWallTimes[phaseIndex] = 0;
+            currentCpuTimes[phaseIndex]  = 0;
+        }
+    }
+
+
+    CompilerTiming::Private::Private(const CompilerTiming::Private& other):QSharedData(other) {
+        for (unsigned phaseIndex=0 ; phaseIndex<numberPhases ; ++phaseIndex) {
+            currentWallTimes[phaseIndex] = other.currentWallTimes[phaseIndex];
+            currentCpuTimes[phaseIndex]  = other.currentCpuTimes[phaseIndex];
+        }
+    }
+
+
+    CompilerTiming::Private::~Private() {}
+
+
+    double CompilerTiming::Private::wallTime(CompilerTiming::Phase phase) const {
+        return currentWallTimes[static_cast<unsigned>(phase)];
+    }
+
+
+    double CompilerTiming::Private::cpuTime(CompilerTiming::Phase phase) const {
+        return currentCpuTimes[static_cast<unsigned>(phase)];
+    }
+
+
+    double CompilerTiming::Private::totalWallTime() const {
+        double result = 0;
+        for (unsigned phaseIndex=0 ; phaseIndex<numberPhases ; ++phaseIndex) {
+            result += currentWallTimes[phaseIndex];
+        }
+
+        return result;
+    }
+
+
+    double CompilerTiming::Private::totalCpuTime() const {
+        double result = 0;
+        for (unsigned phaseIndex=0 ; phaseIndex<numberPhases ; ++phaseIndex) {
+            result += currentCpuTimes[phaseIndex];
+        }
+
+        return result;
+    }
+
+
+    void CompilerTiming::Private::setTime(CompilerTiming::Phase phase, double newWallTime, double newCpuTime) {
+        currentWallTimes[static_cast<unsigned>(phase)] = newWallTime;
+        currentCpuTimes[static_cast<unsigned>(phase)]  = newCpuTime;
+    }
+}
@@ -0,0 +1,111 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the Cbe::CompilerTiming::Private class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_COMPILER_TIMING_PRIVATE_H
+#define CBE_COMPILER_TIMING_PRIVATE_H
+
+#include <QSharedData>
+
+#include "cbe_common.h"
+#include "cbe_compiler_timing.h"
+
+namespace Cbe {
+    /**
+     * Private implementation of the \ref Cbe::CompilerTiming class.
+     */
+    class CBE_PUBLIC_API CompilerTiming::Private:public QSharedData {
+        public:
+            Private();
+
+            /**
+             * Copy constructor
+             *
+             * \param[in] other The instance to be copied.
+             */
+            Private(const CompilerTiming::Private& other);
+
+            ~Private();
+
+            /**
+             * Method you can use to obtain the wall clock time spent in a phase.
+             *
+             * \param[in] phase The phase of interest.
+             *
+             * \return Returns the wall clock time, in seconds.
+             */
+            double wallTime(Phase phase) const;
+
+            /**
+             * Method you can use to obtain the CPU time spent in a phase.
+             *
+             * \param[in] phase The phase of interest.
+             *
+             * \return Returns the CPU time, in seconds.
+             */
+            double cpuTime(Phase phase) const;
+
+            /**
+             * Method you can use to obtain the total wall clock time across all phases.
+             *
+             * \return Returns the total wall clock time, in seconds.
+             */
+            double totalWallTime() const;
+
+            /**
+             * Method you can use to obtain the total CPU time across all phases.
+             *
+             * \return Returns the total CPU time, in seconds.
+             */
+            double totalCpuTime() const;
+
+            /**
+             * Method that records the time spent in a phase.
+             *
+             * \param[in] phase       The phase of interest.
+             *
+             * \param[in] newWallTime The wall clock time, in seconds.
+             *
+             * \param[in] newCpuTime  The CPU time, in seconds.
+             */
+            void setTime(Phase phase, double newWallTime, double newCpuTime);
+
+        private:
+            /**
+             * The wall clock time for each phase, in seconds.
+             */
+            double currentWallTimes[numberPhases];
+
+            /**
+             * The CPU time for each phase, in seconds.
+             */
+            double currentCpuTimes[numberPhases];
+    };
+};
+
+#endif
@@ -0,0 +1,121 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::CompilerWorker class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+
+#include <cstdio>
+
+#if (defined(_WIN32) || defined(_WIN64))
+
+    #include <io.h>
+    #include <fcntl.h>
+
+#endif
+
+#include "cbe_compiler.h"
+#include "worker_protocol.h"
+#include "cbe_compiler_worker_private.h"
+#include "cbe_compiler_worker.h"
+
+namespace Cbe {
+    QString CompilerWorker::executableName() {
+        #if (defined(_WIN32) || defined(_WIN64))
+
+            return QString("inecbe_worker.exe");
+
+        #else
+
+            return QString("inecbe_worker");
+
+        #endif
+    }
+
+
+    int CompilerWorker::exec() {
+        #if (defined(_WIN32) || defined(_WIN64))
+
+            _setmode(_fileno(stdin), _O_BINARY);
+            _setmode(_fileno(stdout), _O_BINARY);
+
+        #endif
+
+        QFile input;
+        QFile output;
+
+        bool success = (
+               input.open(stdin, QFile::ReadOnly | QFile::Unbuffered)
+            && output.open(stdout, QFile::WriteOnly | QFile::Unbuffered)
+        );
+
+        if (success) {
+            // Each worker serves a single configuration so initializing every target would only slow startup.
+            Compiler::setTargetInitialization(Compiler::TargetInitialization::ON_DEMAND);
+
+            Private worker;
+
+            // Reads on standard input block until the requested number of bytes arrive or the host closes the pipe
+            // so each message is read as a length followed by exactly that many bytes.
+            bool finished = false;
+            do {
+                QByteArray buffer = input.read(sizeof(quint32));
+                QByteArray request;
+
+                if (buffer.size() == static_cast<int>(sizeof(quint32))) {
+                    quint32 messageLength = (
+                          (static_cast<quint32>(static_cast<quint8>(buffer.at(0))) << 24)
+                        | (static_cast<quint32>(static_cast<quint8>(buffer.at(1))) << 16)
+                        | (static_cast<quint32>(static_cast<quint8>(buffer.at(2))) <<  8)
+                        | (static_cast<quint32>(static_cast<quint8>(buffer.at(3)))      )
+                    );
+
+                    buffer.append(input.read(messageLength));
+                    if (WorkerProtocol::unframe(buffer, request)) {
+                        QByteArray response = worker.process(request);
+                        QByteArray framed   = WorkerProtocol::frame(response);
+
+                        success = (
+                               !response.isEmpty()
+                            && output.write(framed) == framed.size()
+                            && output.flush()
+                        );
+                    } else {
+                        success = false;
+                    }
+
+                    finished = !success;
+                } else {
+                    // The host closed our standard input.
+                    finished = true;
+                }
+            } while (!finished);
+        }
+
+        return success ? 0 : 1;
+    }
+}
@@ -0,0 +1,162 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref CompilerWorker::Private class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include <cstdio>
+
+#include "cbe_compiler_context.h"
+#include "cbe_cpp_compiler_context.h"
+#include "cbe_compiler_diagnostic.h"
+#include "cbe_compiler_notifier.h"
+#include "compiler_impl.h"
+#include "worker_protocol.h"
+#include "cbe_compiler_worker_private.h"
+
+namespace Cbe {
+    CompilerWorker::Private::FatalErrorNotifier::FatalErrorNotifier() {}
+
+
+    CompilerWorker::Private::FatalErrorNotifier::~FatalErrorNotifier() {}
+
+
+    void CompilerWorker::Private::FatalErrorNotifier::fatalCompilerError(const QString& reason, bool) {
+        std::fprintf(stderr, "%s\n", reason.toLocal8Bit().constData());
+        std::fflush(stderr);
+    }
+
+
+    CompilerWorker::Private::Private():CompilerImpl(nullptr) {
+        setNotifier(&fatalErrorNotifier);
+        lastSuccess = false;
+    }
+
+
+    CompilerWorker::Private::~Private() {}
+
+
+    QByteArray CompilerWorker::Private::process(const QByteArray& request) {
+        QByteArray                         response;
+        WorkerProtocol::Configuration      configuration;
+        QSharedPointer<CppCompilerContext> context;
+
+        if (WorkerProtocol::decodeRequest(request, configuration, context)) {
+            // Reconfiguring discards the warm compiler instance so we only do so when the host's configuration
+            // actually changed.
+            QByteArray encodedConfiguration = configuration.encode();
+            if (encodedConfiguration != currentConfiguration) {
+                configure(configuration);
+                currentConfiguration = encodedConfiguration;
+            }
+
+            reportedDiagnostics.clear();
+            lastSuccess = false;
+
+            unsigned long long initialHits   = compileCacheHits();
+            unsigned long long initialMisses = compileCacheMisses();
+
+            compile(context);
+            waitComplete();
+
+            WorkerProtocol::CacheAccess cacheAccess;
+            if (compileCacheHits() != initialHits) {
+                cacheAccess = WorkerProtocol::CacheAccess::HIT;
+            } else if (compileCacheMisses() != initialMisses) {
+                cacheAccess = WorkerProtocol::CacheAccess::MISS;
+            } else {
+                cacheAccess = WorkerProtocol::CacheAccess::NONE;
+            }
+
+            response = WorkerProtocol::encodeResponse(lastSuccess, cacheAccess, *context, reportedDiagnostics);
+        }
+
+        return response;
+    }
+
+
+    QList<QString> CompilerWorker::Private::setDefaultSwitches() const {
+        return QList<QString>();
+    }
+
+
+    void CompilerWorker::Private::compilerStarted(QSharedPointer<CompilerContext>) {}
+
+
+    void CompilerWorker::Private::compilerFinished(QSharedPointer<CompilerContext>, bool successful) {
+        lastSuccess = successful;
+    }
+
+
+    void CompilerWorker::Private::processDiagnostic(
+            CompilerNotifier*,
+            QSharedPointer<CompilerContext>,
+            CompilerDiagnostic::Level       diagnosticLevel,
+            CompilerDiagnostic::Code        diagnosticCode,
+            const QString&                  diagnosticMessage,
+            const QString&                  filename,
+            unsigned                        byteOffset,
+            unsigned                        lineNumber,
+            unsigned                        columnNumber
+        ) {
+        WorkerProtocol::Diagnostic diagnostic;
+
+        diagnostic.level        = diagnosticLevel;
+        diagnostic.code         = diagnosticCode;
+        diagnostic.message      = diagnosticMessage;
+        diagnostic.filename     = filename;
+        diagnostic.byteOffset   = byteOffset;
+        diagnostic.lineNumber   = lineNumber;
+        diagnostic.columnNumber = columnNumber;
+
+        reportedDiagnostics.append(diagnostic);
+    }
+
+
+    void CompilerWorker::Private::configure(const WorkerProtocol::Configuration& configuration) {
+        setCompilerSwitches(configuration.compilerSwitches);
+        setSystemRoot(configuration.systemRoot);
+        setHeaderSearchPaths(configuration.headerSearchPaths);
+        setHeaders(configuration.headers);
+        setPrecompiledHeaders(configuration.precompiledHeaders);
+        setRuntimeBitcodeModules(configuration.runtimeBitcodeModules);
+        setResourceDirectory(configuration.resourceDirectory);
+        setGccToolchain(configuration.gccToolchain);
+        setTargetTriple(configuration.targetTriple);
+        setAutomaticPchEnabled(configuration.automaticPchEnabled);
+        setPchCacheDirectory(configuration.pchCacheDirectory);
+        setModulesEnabled(configuration.modulesEnabled);
+        setModuleCacheDirectory(configuration.moduleCacheDirectory);
+        setCompileCacheEnabled(configuration.compileCacheEnabled);
+        setCompileCacheDirectory(configuration.compileCacheDirectory);
+        setCompileCacheMaximumSize(configuration.compileCacheMaximumSize);
+        setPreambleReuseEnabled(configuration.preambleReuseEnabled);
+        setDebugOutputEnabled(configuration.debugOutputEnabled);
+    }
+}
@@ -0,0 +1,174 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the Cbe::CompilerWorker::Private class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_COMPILER_WORKER_PRIVATE_H
+#define CBE_COMPILER_WORKER_PRIVATE_H
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include "cbe_common.h"
+#include "cbe_compiler_context.h"
+#include "cbe_compiler_diagnostic.h"
+#include "cbe_compiler_notifier.h"
+#include "cbe_compiler_worker.h"
+#include "compiler_impl.h"
+#include "worker_protocol.h"
+
+namespace Cbe {
+    /**
+     * Compiler used inside a worker process.  The compiler is configured from each request and records the
+     * diagnostics and outcome of each context so they can be returned to the host.
+     */
+    class CompilerWorker::Private:public CompilerImpl {
+        public:
+            Private();
+
+            ~Private() override;
+
+            /**
+             * Method that services a single request.
+             *
+             * \param[in] request The request message.
+             *
+             * \return Returns the response message.  An empty byte array is returned if the request is malformed.
+             */
+            QByteArray process(const QByteArray& request);
+
+        protected:
+            /**
+             * Method that generates the default list of command line switches.  The host always supplies the full
+             * list of switches so this method returns an empty list.
+             *
+             * \return Returns an empty list.
+             */
+            QList<QString> setDefaultSwitches() const final;
+
+            /**
+             * Method that is called when the compiler is started.
+             *
+             * \param[in] context The context that is being executed.
+             */
+            void compilerStarted(QSharedPointer<CompilerContext> context) final;
+
+            /**
+             * Method that is called when the compiler has completed processing a context.  The outcome is recorded.
+             *
+             * \param[in] context    The context that is being executed.
+             *
+             * \param[in] successful Holds true of the compilation completed with no reported errors.
+             */
+            void compilerFinished(QSharedPointer<CompilerContext> context, bool successful) final;
+
+            /**
+             * Method that records a diagnostic for the host.
+             *
+             * \param[in] notifier          The notifier.  Ignored.
+             *
+             * \param[in] context           The context the compiler is actively processing.
+             *
+             * \param[in] diagnosticLevel   The diagnostic level.
+             *
+             * \param[in] diagnosticCode    The compiler specific ID associated with the diagnostic.
+             *
+             * \param[in] diagnosticMessage A text based error message associated with the diagnostic.
+             *
+             * \param[in] filename          The filename where the error was found.
+             *
+             * \param[in] byteOffset        A zero based offset into the source data where the error was detected.
+             *
+             * \param[in] lineNumber        A one based line number into the source data where the error was detected.
+             *
+             * \param[in] columnNumber      A column number into the source data where the error was detected.
+             */
+            void processDiagnostic(
+                CompilerNotifier*               notifier,
+                QSharedPointer<CompilerContext> context,
+                CompilerDiagnostic::Level       diagnosticLevel,
+                CompilerDiagnostic::Code        diagnosticCode,
+                const QString&                  diagnosticMessage,
+                const QString&                  filename,
+                unsigned                        byteOffset,
+                unsigned                        lineNumber,
+                unsigned                        columnNumber
+            ) final;
+
+        private:
+            /**
+             * Notifier that writes fatal errors to standard error so the host can report them.  LLVM terminates the
+             * worker once the notifier returns.
+             */
+            class FatalErrorNotifier:public CompilerNotifier {
+                public:
+                    FatalErrorNotifier();
+
+                    ~FatalErrorNotifier() override;
+
+                    /**
+                     * Method that is called when LLVM reports a fatal error.
+                     *
+                     * \param[in] reason                   The reason for the error.
+                     *
+                     * \param[in] generateCrashDiagnostics Holds true if crash diagnostics were requested.
+                     */
+                    void fatalCompilerError(const QString& reason, bool generateCrashDiagnostics) final;
+            };
+
+            /**
+             * Method that applies a configuration received from the host.
+             *
+             * \param[in] configuration The new configuration.
+             */
+            void configure(const WorkerProtocol::Configuration& configuration);
+
+            /**
+             * The notifier receiving fatal errors.
+             */
+            FatalErrorNotifier fatalErrorNotifier;
+
+            /**
+             * The serialized form of the configuration currently applied.
+             */
+            QByteArray currentConfiguration;
+
+            /**
+             * The diagnostics reported for the current context.
+             */
+            QList<WorkerProtocol::Diagnostic> reportedDiagnostics;
+
+            /**
+             * Flag holding the outcome of the current context.
+             */
+            bool lastSuccess;
+    };
+};
+
+#endif
@@ -28,9 +28,12 @@
 #include <QString>
 #include <QList>
 #include <QByteArray>
+#include <QMap>
 #include <QSharedDataPointer>
 #include <QSharedData>
 
+#include <cstring>
+
 #include "cbe_common.h"
 
 #include "cbe_cpp_compiler_context_private.h"
@@ -91,6 +94,36 @@ namespace Cbe {
     }
 
 
+    unsigned long CppCompilerContext::lineNumber(unsigned long byteOffset) const {
+        return impl->lineNumber(byteOffset);
+    }
+
+
+    unsigned long CppCompilerContext::columnNumber(unsigned long byteOffset) const {
+        return impl->columnNumber(byteOffset);
+    }
+
+
+    bool CppCompilerContext::addVirtualHeader(const QString& name, const QByteArray& contents) {
+        bool success = validVirtualHeaderName(name);
+        if (success) {
+            impl->addVirtualHeader(name, contents);
+        }
+
+        return success;
+    }
+
+
+    void CppCompilerContext::removeVirtualHeader(const QString& name) {
+        impl->removeVirtualHeader(name);
+    }
+
+
+    QMap<QString, QByteArray> CppCompilerContext::virtualHeaders() const {
+        return impl->virtualHeaders();
+    }
+
+
     void CppCompilerContext::append(const std::uint8_t data) {
         impl->append(data);
     }
@@ -116,7 +149,7 @@ namespace Cbe {
 
 
     CppCompilerContext& CppCompilerContext::operator<<(const char* data) {
-        impl->append(QByteArray(data));
+        impl->append(data, static_cast<unsigned long>(std::strlen(data)));
         return *this;
     }
 
@@ -28,8 +28,30 @@
 #include <QString>
 #include <QList>
 #include <QByteArray>
+#include <QVector>
+#include <QMap>
 #include <QSharedDataPointer>
 #include <QSharedData>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#if (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+
+    #define CBE_SSE2_LINE_INDEX
+
+    #include <emmintrin.h>
+
+    #if (defined(_MSC_VER))
+
+        #include <intrin.h>
+
+    #endif
+
+#endif
 
 #include "cbe_common.h"
 
@@ -38,31 +60,38 @@
 #include "cbe_cpp_compiler_context_private.h"
 
 namespace Cbe {
+    const int CppCompilerContext::Private::chunkSize = 64 * 1024;
+
     CppCompilerContext::Private::Private(const QList<QString>& newHeaderFiles) {
-        currentHeaderFiles  = newHeaderFiles;
-        currentLineNumber   = 1;
-        currentColumnNumber = 0;
+        currentHeaderFiles = newHeaderFiles;
+        currentByteOffset  = 0;
+
+        lineStartOffsets.append(0);
     }
 
 
     CppCompilerContext::Private::Private(const QByteArray& newSourceData,const QList<QString>& newHeaderFiles) {
-        rawData             = newSourceData;
-        currentHeaderFiles  = newHeaderFiles;
+        rawData            = newSourceData;
+        currentHeaderFiles = newHeaderFiles;
+        currentByteOffset  = 0;
 
-        currentLineNumber = newSourceData.count('\n') + 1;
-        if (currentLineNumber == 1) {
-            currentColumnNumber = newSourceData.size();
-        } else {
-            currentColumnNumber = newSourceData.size() - newSourceData.lastIndexOf('\n') - 1;
-        }
+        lineStartOffsets.append(0);
+        indexLines(newSourceData.constData(), static_cast<unsigned long>(newSourceData.size()));
+
+        currentByteOffset = static_cast<unsigned long>(newSourceData.size());
     }
 
 
     CppCompilerContext::Private::Private(const CppCompilerContext::Private& other):QSharedData(other) {
-        rawData             = other.rawData;
-        currentHeaderFiles  = other.currentHeaderFiles;
-        currentLineNumber   = other.currentLineNumber;
-        currentColumnNumber = other.currentColumnNumber;
+        QMutexLocker locker(&other.flattenMutex);
+
+        rawData               = other.rawData;
+        completedChunks       = other.completedChunks;
+        currentChunk          = other.currentChunk;
+        currentHeaderFiles    = other.currentHeaderFiles;
+        currentVirtualHeaders = other.currentVirtualHeaders;
+        currentByteOffset     = other.currentByteOffset;
+        lineStartOffsets      = other.lineStartOffsets;
     }
 
 
@@ -70,46 +99,196 @@ namespace Cbe {
 
 
     const QByteArray& CppCompilerContext::Private::sourceData() const {
+        flatten();
         return rawData;
     }
 
 
     unsigned long CppCompilerContext::Private::byteOffset() const {
-        return rawData.size();
+        return currentByteOffset;
     }
 
 
     unsigned long CppCompilerContext::Private::lineNumber() const {
-        return currentLineNumber;
+        return static_cast<unsigned long>(lineStartOffsets.size());
     }
 
 
     unsigned long CppCompilerContext::Private::columnNumber() const {
-        return currentColumnNumber;
+        return currentByteOffset - lineStartOffsets.last();
+    }
+
+
+    unsigned long CppCompilerContext::Private::lineNumber(unsigned long byteOffset) const {
+        QVector<unsigned long>::const_iterator lineIterator = std::upper_bound(
+            lineStartOffsets.constBegin(),
+            lineStartOffsets.constEnd(),
+            byteOffset
+        );
+
+        return static_cast<unsigned long>(lineIterator - lineStartOffsets.constBegin());
+    }
+
+
+    unsigned long CppCompilerContext::Private::columnNumber(unsigned long byteOffset) const {
+        return byteOffset - lineStartOffsets.at(static_cast<int>(lineNumber(byteOffset) - 1));
+    }
+
+
+    void CppCompilerContext::Private::addVirtualHeader(const QString& name, const QByteArray& contents) {
+        currentVirtualHeaders.insert(name, contents);
+    }
+
+
+    void CppCompilerContext::Private::removeVirtualHeader(const QString& name) {
+        currentVirtualHeaders.remove(name);
+    }
+
+
+    const QMap<QString, QByteArray>& CppCompilerContext::Private::virtualHeaders() const {
+        return currentVirtualHeaders;
     }
 
 
     void CppCompilerContext::Private::append(const std::uint8_t data) {
-        if (data == '\n') {
-            ++currentLineNumber;
-            currentColumnNumber = 0;
-        } else {
-            ++currentColumnNumber;
+        if (currentChunk.size() >= chunkSize) {
+            closeChunk();
+        }
+
+        if (currentChunk.isEmpty()) {
+            currentChunk.reserve(chunkSize);
         }
 
-        rawData.push_back(static_cast<char>(data));
+        currentChunk.append(static_cast<char>(data));
+        ++currentByteOffset;
+
+        if (data == '\n') {
+            lineStartOffsets.append(currentByteOffset);
+        }
     }
 
 
     void CppCompilerContext::Private::append(const QByteArray& data) {
-        unsigned long numberLines = data.count('\n');
-        if (numberLines == 0) {
-            currentColumnNumber += data.size();
+        if (data.size() >= chunkSize) {
+            // Large blocks become chunks of their own.  The block is shared with the caller rather than copied.
+            indexLines(data.constData(), static_cast<unsigned long>(data.size()));
+
+            closeChunk();
+            completedChunks.append(data);
+
+            currentByteOffset += static_cast<unsigned long>(data.size());
+        } else {
+            append(data.constData(), static_cast<unsigned long>(data.size()));
+        }
+    }
+
+
+    void CppCompilerContext::Private::append(const char* data, unsigned long length) {
+        indexLines(data, length);
+
+        if (static_cast<unsigned long>(currentChunk.size()) + length > static_cast<unsigned long>(chunkSize)) {
+            closeChunk();
+        }
+
+        if (length >= static_cast<unsigned long>(chunkSize)) {
+            completedChunks.append(QByteArray(data, static_cast<int>(length)));
         } else {
-            currentLineNumber += numberLines;
-            currentColumnNumber = data.size() - data.lastIndexOf('\n') - 1;
+            if (currentChunk.isEmpty()) {
+                currentChunk.reserve(chunkSize);
+            }
+
+            currentChunk.append(data, static_cast<int>(length));
+        }
+
+        currentByteOffset += length;
+    }
+
+
+    void CppCompilerContext::Private::closeChunk() {
+        if (!currentChunk.isEmpty()) {
+            completedChunks.append(currentChunk);
+            currentChunk = QByteArray();
+        }
+    }
+
+
+    void CppCompilerContext::Private::indexLines(const char* data, unsigned long length) {
+        unsigned long index = 0;
+
+        #if (defined(CBE_SSE2_LINE_INDEX))
+
+            const __m128i newlines = _mm_set1_epi8('\n');
+            while (index + 16 <= length) {
+                __m128i  block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+                unsigned mask  = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newlines)));
+
+                while (mask != 0) {
+                    #if (defined(_MSC_VER))
+
+                        unsigned long bitIndex;
+                        _BitScanForward(&bitIndex, mask);
+
+                    #else
+
+                        unsigned long bitIndex = static_cast<unsigned long>(__builtin_ctz(mask));
+
+                    #endif
+
+                    lineStartOffsets.append(currentByteOffset + index + bitIndex + 1);
+                    mask &= mask - 1;
+                }
+
+                index += 16;
+            }
+
+        #endif
+
+        // The remaining bytes, or every byte without SSE2, are scanned with memchr which is vectorized by most C
+        // libraries.
+        const char* end      = data + length;
+        const char* position = data + index;
+        while (position < end) {
+            const char* newline = static_cast<const char*>(
+                std::memchr(position, '\n', static_cast<std::size_t>(end - position))
+            );
+
+            if (newline == nullptr) {
+                position = end;
+            } else {
+                lineStartOffsets.append(currentByteOffset + static_cast<unsigned long>(newline - data) + 1);
+                position = newline + 1;
+            }
         }
+    }
+
+
+    void CppCompilerContext::Private::flatten() const {
+        // Several threads may request the source of a shared instance at once, for example the caller and the
+        // compiler thread.  Each waits for the first to finish flattening so the returned buffer is never rebuilt
+        // while it is in use.
+        QMutexLocker locker(&flattenMutex);
 
-        rawData.append(data);
+        if (!completedChunks.isEmpty() || !currentChunk.isEmpty()) {
+            if (rawData.isEmpty() && completedChunks.size() == 1 && currentChunk.isEmpty()) {
+                rawData = completedChunks.first();
+            } else if (rawData.isEmpty() && completedChunks.isEmpty()) {
+                rawData = currentChunk;
+            } else {
+                rawData.reserve(static_cast<int>(currentByteOffset));
+
+                for (  QList<QByteArray>::const_iterator chunkIterator    = completedChunks.constBegin(),
+                                                         chunkEndIterator = completedChunks.constEnd()
+                     ; chunkIterator != chunkEndIterator
+                     ; ++chunkIterator
+                    ) {
+                    rawData.append(*chunkIterator);
+                }
+
+                rawData.append(currentChunk);
+            }
+
+            completedChunks.clear();
+            currentChunk = QByteArray();
+        }
     }
 }
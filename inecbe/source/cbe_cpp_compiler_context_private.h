@@ -33,7 +33,12 @@
 #include <QString>
 #include <QList>
 #include <QByteArray>
+#include <QVector>
+#include <QMap>
 #include <QSharedData>
+#include <QMutex>
+
+#include <cstdint>
 
 #include "cbe_common.h"
 #include "cbe_compiler_context.h"
@@ -43,6 +48,12 @@ namespace Cbe {
     /**
      * Class that provides the implementation of the \ref CppCompilerContext class.
      *
+     * Appended source is held in fixed size chunks so a growing source is never reallocated and copied.  The chunks
+     * are flattened into a single buffer the first time the source is requested, normally when the context is
+     * submitted to a compiler.  Flattening is guarded by a mutex so the source can be requested from several threads
+     * at once.  The byte offset of every line start is recorded as data is appended allowing byte
+     * offsets to be converted to line and column numbers with a binary search.
+     *
      * The class uses a pimpl implementation allowing you to pass the object, by value, with minimal overhead.
      */
     class CBE_PUBLIC_API CppCompilerContext::Private:public QSharedData {
@@ -73,7 +84,8 @@ namespace Cbe {
             ~Private();
 
             /**
-             * Method you can use to obtain access to the raw data contained in this class.
+             * Method you can use to obtain access to the raw data contained in this class.  Any chunked data is
+             * flattened into a single buffer by this call.
              *
              * \return Returns constant reference to a byte array holding the raw data.
              */
@@ -102,6 +114,47 @@ namespace Cbe {
              */
             unsigned long columnNumber() const;
 
+            /**
+             * Method you can use to determine the line number holding a byte offset into the source data.
+             *
+             * \param[in] byteOffset The zero based byte offset into the source data.
+             *
+             * \return Returns the one-based line number.
+             */
+            unsigned long lineNumber(unsigned long byteOffset) const;
+
+            /**
+             * Method you can use to determine the column number of a byte offset into the source data.
+             *
+             * \param[in] byteOffset The zero based byte offset into the source data.
+             *
+             * \return Returns the zero-based column number.
+             */
+            unsigned long columnNumber(unsigned long byteOffset) const;
+
+            /**
+             * Method you can use to attach an in-memory header to this context.
+             *
+             * \param[in] name     The header's relative path.  An existing header with the same name is replaced.
+             *
+             * \param[in] contents The header's contents.
+             */
+            void addVirtualHeader(const QString& name, const QByteArray& contents);
+
+            /**
+             * Method you can use to remove an in-memory header from this context.
+             *
+             * \param[in] name The header's relative path.
+             */
+            void removeVirtualHeader(const QString& name);
+
+            /**
+             * Method you can use to obtain the in-memory headers attached to this context.
+             *
+             * \return Returns a map of header contents keyed by the header's relative path.
+             */
+            const QMap<QString, QByteArray>& virtualHeaders() const;
+
             /**
              * Method that can be called from derived classes to append source code data to the internal buffer.
              *
@@ -116,16 +169,51 @@ namespace Cbe {
              */
             void append(const QByteArray& data);
 
+            /**
+             * Method that can be called to append source code data to the internal buffer.
+             *
+             * \param[in] data   Pointer to an array of bytes holding the data to be appended.
+             *
+             * \param[in] length The number of bytes to be appended.
+             */
+            void append(const char* data, unsigned long length);
+
         private:
             /**
-             * The current running line number.
+             * The size of each chunk, in bytes.
+             */
+            static const int chunkSize;
+
+            /**
+             * Method that moves the chunk being filled to the list of completed chunks.
+             */
+            void closeChunk();
+
+            /**
+             * Method that records the start of every line in a block of data about to be appended.  Newlines are
+             * located 16 bytes at a time when SSE2 is available.
+             *
+             * \param[in] data   Pointer to the data to be appended.
+             *
+             * \param[in] length The number of bytes to be appended.
+             */
+            void indexLines(const char* data, unsigned long length);
+
+            /**
+             * Method that flattens any chunked data into the raw data buffer.  The method holds the flatten mutex while
+             * the buffer is updated.
+             */
+            void flatten() const;
+
+            /**
+             * The total number of bytes of source data.
              */
-            unsigned long currentLineNumber;
+            unsigned long currentByteOffset;
 
             /**
-             * The current running column number.
+             * The byte offset of the start of each line.  The first entry is always zero.
              */
-            unsigned long currentColumnNumber;
+            QVector<unsigned long> lineStartOffsets;
 
             /**
              * The current list of C++ headers.
@@ -133,9 +221,29 @@ namespace Cbe {
             QList<QString> currentHeaderFiles;
 
             /**
-             * The raw data buffer.
+             * The current in-memory headers, keyed by relative path.
+             */
+            QMap<QString, QByteArray> currentVirtualHeaders;
+
+            /**
+             * The raw data buffer holding the flattened source data.
+             */
+            mutable QByteArray rawData;
+
+            /**
+             * Completed chunks holding source data appended after the data in the raw data buffer.
+             */
+            mutable QList<QByteArray> completedChunks;
+
+            /**
+             * The chunk currently being filled.
+             */
+            mutable QByteArray currentChunk;
+
+            /**
+             * Mutex used to serialize flattening of the chunked data.
              */
-            QByteArray rawData;
+            mutable QMutex flattenMutex;
     };
 };
 
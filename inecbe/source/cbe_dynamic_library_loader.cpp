@@ -45,14 +45,15 @@ namespace Cbe {
 
 
     DynamicLibraryLoader::~DynamicLibraryLoader() {
-        if (impl->notifier() != nullptr) {
+        // The notifier may have since been handed to another loader.
+        if (impl->notifier() != nullptr && impl->notifier()->currentLoader == this) {
             impl->notifier()->currentLoader = nullptr;
         }
     }
 
 
     void DynamicLibraryLoader::setNotifier(LoaderNotifier* newNotifier) {
-        if (impl->notifier() != nullptr) {
+        if (impl->notifier() != nullptr && impl->notifier()->currentLoader == this) {
             impl->notifier()->currentLoader = nullptr;
         }
 
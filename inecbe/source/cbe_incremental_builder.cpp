@@ -0,0 +1,92 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::IncrementalBuilder class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QSharedPointer>
+
+#include "cbe_cpp_compiler_pool.h"
+#include "cbe_cpp_compiler_context.h"
+#include "cbe_dynamic_library_linker.h"
+#include "cbe_incremental_builder_private.h"
+#include "cbe_incremental_builder.h"
+
+namespace Cbe {
+    IncrementalBuilder::IncrementalBuilder():impl(new IncrementalBuilder::Private) {}
+
+
+    IncrementalBuilder::~IncrementalBuilder() {}
+
+
+    CppCompilerPool& IncrementalBuilder::compilerPool() {
+        return impl->compilerPool();
+    }
+
+
+    DynamicLibraryLinker& IncrementalBuilder::linker() {
+        return impl->linker();
+    }
+
+
+    void IncrementalBuilder::setPartitioning(IncrementalBuilder::Partitioning newPartitioning) {
+        impl->setPartitioning(newPartitioning);
+    }
+
+
+    IncrementalBuilder::Partitioning IncrementalBuilder::partitioning() const {
+        return impl->partitioning();
+    }
+
+
+    void IncrementalBuilder::setTargetChunkSize(unsigned long newTargetChunkSize) {
+        impl->setTargetChunkSize(newTargetChunkSize);
+    }
+
+
+    unsigned long IncrementalBuilder::targetChunkSize() const {
+        return impl->targetChunkSize();
+    }
+
+
+    bool IncrementalBuilder::build(QSharedPointer<CppCompilerContext> context, const QString& libraryFile) {
+        return impl->build(context, libraryFile);
+    }
+
+
+    unsigned long IncrementalBuilder::numberChunks() const {
+        return impl->numberChunks();
+    }
+
+
+    unsigned long IncrementalBuilder::numberCompiledChunks() const {
+        return impl->numberCompiledChunks();
+    }
+
+
+    void IncrementalBuilder::clear() {
+        impl->clear();
+    }
+}
@@ -0,0 +1,787 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::IncrementalBuilder::Private class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QCryptographicHash>
+#include <QHash>
+
+#include <cctype>
+
+#include "cbe_compiler.h"
+#include "cbe_cpp_compiler_pool.h"
+#include "cbe_cpp_compiler_context.h"
+#include "cbe_cpp_compiler_diagnostic.h"
+#include "cbe_cpp_source_range.h"
+#include "cbe_linker_context.h"
+#include "cbe_dynamic_library_linker.h"
+#include "cbe_incremental_builder.h"
+#include "cbe_incremental_builder_private.h"
+
+namespace Cbe {
+    /*******************************************************************************************************************
+     * IncrementalBuilder::Private
+     */
+
+    IncrementalBuilder::Private::Private() {
+        currentPartitioning         = Partitioning::MARKERS;
+        currentTargetChunkSize      = IncrementalBuilder::defaultTargetChunkSize;
+        currentNumberChunks         = 0;
+        currentNumberCompiledChunks = 0;
+    }
+
+
+    IncrementalBuilder::Private::~Private() {
+        currentCompilerPool.waitComplete();
+        currentLinker.waitComplete();
+    }
+
+
+    CppCompilerPool& IncrementalBuilder::Private::compilerPool() {
+        return currentCompilerPool;
+    }
+
+
+    DynamicLibraryLinker& IncrementalBuilder::Private::linker() {
+        return currentLinker;
+    }
+
+
+    void IncrementalBuilder::Private::setPartitioning(IncrementalBuilder::Partitioning newPartitioning) {
+        QMutexLocker locker(&builderMutex);
+        currentPartitioning = newPartitioning;
+    }
+
+
+    IncrementalBuilder::Partitioning IncrementalBuilder::Private::partitioning() const {
+        QMutexLocker locker(&builderMutex);
+        return currentPartitioning;
+    }
+
+
+    void IncrementalBuilder::Private::setTargetChunkSize(unsigned long newTargetChunkSize) {
+        QMutexLocker locker(&builderMutex);
+        currentTargetChunkSize = newTargetChunkSize;
+    }
+
+
+    unsigned long IncrementalBuilder::Private::targetChunkSize() const {
+        QMutexLocker locker(&builderMutex);
+        return currentTargetChunkSize;
+    }
+
+
+    bool IncrementalBuilder::Private::build(QSharedPointer<CppCompilerContext> context, const QString& libraryFile) {
+        QMutexLocker locker(&builderMutex);
+
+        QByteArray                sourceData     = context->sourceData();
+        QMap<QString, QByteArray> virtualHeaders = context->virtualHeaders();
+        unsigned long             prologueBytes  = prologueLength(sourceData);
+        QByteArray                prologue       = sourceData.left(static_cast<int>(prologueBytes));
+
+        QList<Chunk> chunks;
+        if (currentPartitioning == Partitioning::MARKERS) {
+            chunks = partitionAtMarkers(sourceData, prologueBytes);
+        } else {
+            chunks = partitionAtDeclarations(sourceData, prologueBytes);
+        }
+
+        unsigned long lineNumber = 1;
+        unsigned long lineOffset = 0;
+        for (  QList<Chunk>::iterator chunkIterator    = chunks.begin(),
+                                      chunkEndIterator = chunks.end()
+             ; chunkIterator != chunkEndIterator
+             ; ++chunkIterator
+            ) {
+            while (lineOffset < chunkIterator->byteOffset) {
+                if (sourceData.at(static_cast<int>(lineOffset)) == '\n') {
+                    ++lineNumber;
+                }
+
+                ++lineOffset;
+            }
+
+            chunkIterator->lineNumber = lineNumber;
+        }
+
+        QList<QString>                              objectFiles;
+        QMap<QByteArray, QString>                   buildObjects;
+        QList<QSharedPointer<ChunkCompilerContext>> chunkContexts;
+        QSet<QByteArray>                            usedKeys;
+
+        // Chunk diagnostics are held back with declaration partitioning as a failed chunk may only be missing a
+        // declaration from another chunk.
+        bool defersDiagnostics = (currentPartitioning == Partitioning::TOP_LEVEL_DECLARATIONS);
+
+        for (  QList<Chunk>::const_iterator chunkIterator    = chunks.constBegin(),
+                                            chunkEndIterator = chunks.constEnd()
+             ; chunkIterator != chunkEndIterator
+             ; ++chunkIterator
+            ) {
+            QByteArray baseKey = chunkKey(prologue, *chunkIterator, virtualHeaders);
+            QByteArray key     = baseKey;
+
+            // Identical chunks must still produce distinct objects.
+            unsigned duplicateIndex = 0;
+            while (usedKeys.contains(key)) {
+                ++duplicateIndex;
+                key = baseKey + "_" + QByteArray::number(duplicateIndex);
+            }
+
+            usedKeys.insert(key);
+
+            QString objectFile = availableObjects.value(key);
+            if (objectFile.isEmpty() || !QFile::exists(objectFile)) {
+                objectFile = objectFilename(key);
+                // Diagnostics in the prologue and in headers would be repeated by every chunk so only the first
+                // compiled chunk reports them.
+                bool reportsPrologue = chunkContexts.isEmpty();
+                chunkContexts.append(
+                    QSharedPointer<ChunkCompilerContext>(
+                        new ChunkCompilerContext(
+                            this,
+                            context,
+                            prologue,
+                            *chunkIterator,
+                            objectFile,
+                            reportsPrologue,
+                            defersDiagnostics
+                        )
+                    )
+                );
+            }
+
+            objectFiles.append(objectFile);
+            buildObjects.insert(key, objectFile);
+        }
+
+        currentNumberChunks         = static_cast<unsigned long>(chunks.size());
+        currentNumberCompiledChunks = static_cast<unsigned long>(chunkContexts.size());
+
+        context->compilerStarted();
+
+        for (  QList<QSharedPointer<ChunkCompilerContext>>::const_iterator
+                   contextIterator    = chunkContexts.constBegin(),
+                   contextEndIterator = chunkContexts.constEnd()
+             ; contextIterator != contextEndIterator
+             ; ++contextIterator
+            ) {
+            currentCompilerPool.compile(*contextIterator);
+        }
+
+        currentCompilerPool.waitComplete();
+
+        bool success = !chunks.isEmpty();
+        for (  QList<QSharedPointer<ChunkCompilerContext>>::const_iterator
+                   contextIterator    = chunkContexts.constBegin(),
+                   contextEndIterator = chunkContexts.constEnd()
+             ; contextIterator != contextEndIterator
+             ; ++contextIterator
+            ) {
+            success = success && (*contextIterator)->succeeded();
+        }
+
+        if (!success && defersDiagnostics && chunks.size() > 1) {
+            // Chunks are compiled with only the prologue so a chunk using an entity declared in another chunk fails.
+            // Compiling the source as a single unit tells these failures apart from errors in the source itself.
+            QList<Chunk> singleUnit;
+            addChunk(singleUnit, sourceData, prologueBytes, static_cast<unsigned long>(sourceData.size()));
+            singleUnit.first().lineNumber = static_cast<unsigned long>(prologue.count('\n')) + 1;
+
+            success = buildSingleUnit(context, prologue, singleUnit.first(), virtualHeaders, buildObjects);
+            if (success) {
+                objectFiles         = buildObjects.values();
+                currentNumberChunks = 1;
+
+                // We point the user at the first chunk error, typically the use of an entity declared in another
+                // chunk, so they can move the declaration into the prologue.
+                CompilerDiagnostic::Code code = 0;
+                CppSourceRange           sourceRange;
+                QString                  firstError;
+
+                QList<QSharedPointer<ChunkCompilerContext>>::const_iterator
+                    contextIterator = chunkContexts.constBegin();
+
+                while (firstError.isEmpty() && contextIterator != chunkContexts.constEnd()) {
+                    const QList<CppCompilerDiagnostic>& diagnostics = (*contextIterator)->deferredDiagnostics();
+
+                    QList<CppCompilerDiagnostic>::const_iterator diagnosticIterator = diagnostics.constBegin();
+                    while (firstError.isEmpty() && diagnosticIterator != diagnostics.constEnd()) {
+                        if (diagnosticIterator->level() == CompilerDiagnostic::Level::ERROR) {
+                            code        = diagnosticIterator->code();
+                            sourceRange = diagnosticIterator->sourceRange();
+                            firstError  = diagnosticIterator->message();
+                        }
+
+                        ++diagnosticIterator;
+                    }
+
+                    ++contextIterator;
+                }
+
+                reportDiagnostic(
+                    context,
+                    CppCompilerDiagnostic(
+                        context,
+                        CompilerDiagnostic::Level::WARNING,
+                        code,
+                        QString(
+                            "source does not compile as separate chunks and was compiled as a single unit; declare "
+                            "entities shared between top-level declarations in the prologue: %1"
+                        ).arg(firstError),
+                        sourceRange
+                    )
+                );
+            }
+        } else {
+            for (  QList<QSharedPointer<ChunkCompilerContext>>::const_iterator
+                       contextIterator    = chunkContexts.constBegin(),
+                       contextEndIterator = chunkContexts.constEnd()
+                 ; contextIterator != contextEndIterator
+                 ; ++contextIterator
+                ) {
+                (*contextIterator)->reportDeferredDiagnostics();
+            }
+        }
+
+        context->compilerFinished(success);
+
+        if (success) {
+            QSharedPointer<ChunkLinkerContext> linkerContext(new ChunkLinkerContext(libraryFile, objectFiles));
+            currentLinker.link(linkerContext);
+            currentLinker.waitComplete();
+
+            success = linkerContext->succeeded();
+        }
+
+        if (success) {
+            // Objects not used by this build are unlikely to be needed again.
+            for (  QMap<QByteArray, QString>::const_iterator objectIterator    = availableObjects.constBegin(),
+                                                             objectEndIterator = availableObjects.constEnd()
+                 ; objectIterator != objectEndIterator
+                 ; ++objectIterator
+                ) {
+                if (!buildObjects.contains(objectIterator.key())) {
+                    QFile::remove(objectIterator.value());
+                }
+            }
+
+            availableObjects = buildObjects;
+        } else {
+            // Keep the chunks that did compile so they can be reused once the errors are corrected.
+            for (  QMap<QByteArray, QString>::const_iterator objectIterator    = buildObjects.constBegin(),
+                                                             objectEndIterator = buildObjects.constEnd()
+                 ; objectIterator != objectEndIterator
+                 ; ++objectIterator
+                ) {
+                if (QFile::exists(objectIterator.value())) {
+                    availableObjects.insert(objectIterator.key(), objectIterator.value());
+                }
+            }
+        }
+
+        return success;
+    }
+
+
+    unsigned long IncrementalBuilder::Private::numberChunks() const {
+        QMutexLocker locker(&builderMutex);
+        return currentNumberChunks;
+    }
+
+
+    unsigned long IncrementalBuilder::Private::numberCompiledChunks() const {
+        QMutexLocker locker(&builderMutex);
+        return currentNumberCompiledChunks;
+    }
+
+
+    void IncrementalBuilder::Private::clear() {
+        QMutexLocker locker(&builderMutex);
+
+        for (  QMap<QByteArray, QString>::const_iterator objectIterator    = availableObjects.constBegin(),
+                                                         objectEndIterator = availableObjects.constEnd()
+             ; objectIterator != objectEndIterator
+             ; ++objectIterator
+            ) {
+            QFile::remove(objectIterator.value());
+        }
+
+        availableObjects.clear();
+    }
+
+
+    unsigned long IncrementalBuilder::Private::prologueLength(const QByteArray& source) {
+        QByteArray    marker(IncrementalBuilder::chunkMarker);
+        unsigned long sourceLength = static_cast<unsigned long>(source.size());
+        unsigned long lineStart    = 0;
+        unsigned long result       = 0;
+
+        while (result == 0 && lineStart < sourceLength) {
+            int           newline = source.indexOf('\n', static_cast<int>(lineStart));
+            unsigned long lineEnd = newline < 0 ? sourceLength : static_cast<unsigned long>(newline);
+
+            QByteArray line = source.mid(static_cast<int>(lineStart), static_cast<int>(lineEnd - lineStart));
+            if (line.trimmed() == marker) {
+                result = newline < 0 ? sourceLength : lineEnd + 1;
+            }
+
+            lineStart = lineEnd + 1;
+        }
+
+        return result;
+    }
+
+
+    QList<IncrementalBuilder::Private::Chunk> IncrementalBuilder::Private::partitionAtMarkers(
+            const QByteArray& source,
+            unsigned long     startOffset
+        ) {
+        QList<Chunk>  chunks;
+        QByteArray    marker(IncrementalBuilder::chunkMarker);
+        unsigned long sourceLength = static_cast<unsigned long>(source.size());
+        unsigned long chunkStart   = startOffset;
+        unsigned long lineStart    = startOffset;
+
+        while (lineStart < sourceLength) {
+            int           newline  = source.indexOf('\n', static_cast<int>(lineStart));
+            unsigned long lineEnd  = newline < 0 ? sourceLength : static_cast<unsigned long>(newline);
+            unsigned long nextLine = newline < 0 ? sourceLength : lineEnd + 1;
+
+            QByteArray line = source.mid(static_cast<int>(lineStart), static_cast<int>(lineEnd - lineStart));
+            if (line.trimmed() == marker) {
+                addChunk(chunks, source, chunkStart, lineStart);
+                chunkStart = nextLine;
+            }
+
+            lineStart = nextLine;
+        }
+
+        addChunk(chunks, source, chunkStart, sourceLength);
+        return chunks;
+    }
+
+
+    QList<IncrementalBuilder::Private::Chunk> IncrementalBuilder::Private::partitionAtDeclarations(
+            const QByteArray& source,
+            unsigned long     startOffset
+        ) const {
+        QList<Chunk>  chunks;
+        const char*   data             = source.constData();
+        unsigned long sourceLength     = static_cast<unsigned long>(source.size());
+        unsigned long chunkStart       = startOffset;
+        unsigned long declarationStart = startOffset;
+        unsigned long depth            = 0;
+        bool          atLineStart      = true;
+        bool          declarationEnds  = false;
+        unsigned long offset           = startOffset;
+
+        // Chunk boundaries depend only on the declaration just completed and the size of the chunk so far.  An edit
+        // that moves a boundary changes the following chunks too, but only until a later boundary is reached at the
+        // same declaration as before, which usually happens within a chunk or two.
+        unsigned long minimumChunkSize = currentTargetChunkSize / 2;
+        unsigned long maximumChunkSize = currentTargetChunkSize * 2;
+
+        while (offset < sourceLength) {
+            char c    = data[offset];
+            char next = offset + 1 < sourceLength ? data[offset + 1] : '\0';
+
+            // A quote following a letter or digit is treated as a digit separator.
+            bool startsLiteral = (
+                   c == '"'
+                || (c == '\'' && (offset == 0 || !std::isalnum(static_cast<unsigned char>(data[offset - 1]))))
+            );
+
+            if (c == '/' && next == '/') {
+                while (offset < sourceLength && data[offset] != '\n') {
+                    ++offset;
+                }
+            } else if (c == '/' && next == '*') {
+                offset += 2;
+                while (offset + 1 < sourceLength && (data[offset] != '*' || data[offset + 1] != '/')) {
+                    ++offset;
+                }
+
+                offset += 2;
+                atLineStart = false;
+            } else if (startsLiteral) {
+                ++offset;
+                while (offset < sourceLength && data[offset] != c && data[offset] != '\n') {
+                    if (data[offset] == '\\') {
+                        ++offset;
+                    }
+
+                    ++offset;
+                }
+
+                if (offset < sourceLength && data[offset] == c) {
+                    ++offset;
+                }
+
+                atLineStart = false;
+            } else if (c == '#' && atLineStart) {
+                // Preprocessor directives, including continuation lines, are complete declarations at the top level.
+                while (offset < sourceLength && data[offset] != '\n') {
+                    if (data[offset] == '\\' && offset + 1 < sourceLength && data[offset + 1] == '\n') {
+                        ++offset;
+                    }
+
+                    ++offset;
+                }
+
+                declarationEnds = (depth == 0);
+            } else {
+                if (c == '{' || c == '(') {
+                    ++depth;
+                } else if ((c == '}' || c == ')') && depth > 0) {
+                    --depth;
+                    declarationEnds = declarationEnds || (c == '}' && depth == 0);
+                } else if (c == ';' && depth == 0) {
+                    declarationEnds = true;
+                }
+
+                if (c == '\n') {
+                    if (declarationEnds) {
+                        unsigned long declarationEnd = offset + 1;
+                        unsigned long chunkSize      = declarationEnd - chunkStart;
+
+                        uint declarationHash = qHash(
+                            QByteArray::fromRawData(
+                                data + declarationStart,
+                                static_cast<int>(declarationEnd - declarationStart)
+                            )
+                        );
+
+                        if (   chunkSize >= maximumChunkSize
+                            || (chunkSize >= minimumChunkSize && (declarationHash & 3) == 0)
+                           ) {
+                            addChunk(chunks, source, chunkStart, declarationEnd);
+                            chunkStart = declarationEnd;
+                        }
+
+                        declarationStart = declarationEnd;
+                        declarationEnds  = false;
+                    }
+
+                    atLineStart = true;
+                } else if (c != ' ' && c != '\t' && c != '\r') {
+                    atLineStart = false;
+                }
+
+                ++offset;
+            }
+        }
+
+        addChunk(chunks, source, chunkStart, sourceLength);
+        return chunks;
+    }
+
+
+    void IncrementalBuilder::Private::addChunk(
+            QList<IncrementalBuilder::Private::Chunk>& chunks,
+            const QByteArray&                          source,
+            unsigned long                              startOffset,
+            unsigned long                              endOffset
+        ) {
+        if (endOffset > startOffset) {
+            QByteArray text = source.mid(static_cast<int>(startOffset), static_cast<int>(endOffset - startOffset));
+            if (!text.trimmed().isEmpty()) {
+                Chunk chunk;
+                chunk.byteOffset = startOffset;
+                chunk.lineNumber = 0;
+                chunk.text       = text;
+
+                chunks.append(chunk);
+            }
+        }
+    }
+
+
+    QByteArray IncrementalBuilder::Private::chunkKey(
+            const QByteArray&                          prologue,
+            const IncrementalBuilder::Private::Chunk& chunk,
+            const QMap<QString, QByteArray>&           virtualHeaders
+        ) {
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+
+        hash.addData(QByteArray::number(prologue.size()));
+        hash.addData(prologue);
+        hash.addData(QByteArray::number(chunk.text.size()));
+        hash.addData(chunk.text);
+
+        for (  QMap<QString, QByteArray>::const_iterator headerIterator    = virtualHeaders.constBegin(),
+                                                         headerEndIterator = virtualHeaders.constEnd()
+             ; headerIterator != headerEndIterator
+             ; ++headerIterator
+            ) {
+            QByteArray name = headerIterator.key().toUtf8();
+            hash.addData(QByteArray::number(name.size()));
+            hash.addData(name);
+            hash.addData(QByteArray::number(headerIterator.value().size()));
+            hash.addData(headerIterator.value());
+        }
+
+        return hash.result().toHex();
+    }
+
+
+    QString IncrementalBuilder::Private::objectFilename(const QByteArray& key) const {
+        #if (defined(_WIN32) || defined(_WIN64))
+
+            QString extension("obj");
+
+        #else
+
+            QString extension("o");
+
+        #endif
+
+        return workingDirectory.filePath(QString("chunk_%1.%2").arg(QString::fromLatin1(key), extension));
+    }
+
+
+    bool IncrementalBuilder::Private::buildSingleUnit(
+            QSharedPointer<CppCompilerContext>        context,
+            const QByteArray&                         prologue,
+            const IncrementalBuilder::Private::Chunk& chunk,
+            const QMap<QString, QByteArray>&          virtualHeaders,
+            QMap<QByteArray, QString>&                buildObjects
+        ) {
+        bool       success;
+        QByteArray key        = chunkKey(prologue, chunk, virtualHeaders);
+        QString    objectFile = availableObjects.value(key);
+
+        if (!objectFile.isEmpty() && QFile::exists(objectFile)) {
+            success = true;
+        } else {
+            objectFile = objectFilename(key);
+
+            QSharedPointer<ChunkCompilerContext> chunkContext(
+                new ChunkCompilerContext(this, context, prologue, chunk, objectFile, true, false)
+            );
+
+            currentCompilerPool.compile(chunkContext);
+            currentCompilerPool.waitComplete();
+
+            success = chunkContext->succeeded();
+            ++currentNumberCompiledChunks;
+        }
+
+        if (success) {
+            buildObjects.clear();
+            buildObjects.insert(key, objectFile);
+        }
+
+        return success;
+    }
+
+
+    void IncrementalBuilder::Private::reportDiagnostic(
+            QSharedPointer<CppCompilerContext> userContext,
+            const CppCompilerDiagnostic&       diagnostic
+        ) {
+        QMutexLocker locker(&diagnosticMutex);
+        userContext->handleCompilerDiagnostic(diagnostic);
+    }
+
+    /*******************************************************************************************************************
+     * IncrementalBuilder::Private::ChunkCompilerContext
+     */
+
+    IncrementalBuilder::Private::ChunkCompilerContext::ChunkCompilerContext(
+            IncrementalBuilder::Private*              newBuilder,
+            QSharedPointer<CppCompilerContext>        newUserContext,
+            const QByteArray&                         prologue,
+            const IncrementalBuilder::Private::Chunk& chunk,
+            const QString&                            newObjectFile,
+            bool                                      newReportsPrologue,
+            bool                                      newDefersDiagnostics
+        ):CppCompilerContext(
+            newObjectFile,
+            prologue + chunk.text
+        ),builder(
+            newBuilder
+        ),userContext(
+            newUserContext
+        ),prologueBytes(
+            static_cast<unsigned long>(prologue.size())
+        ),prologueLines(
+            static_cast<unsigned long>(prologue.count('\n'))
+        ),chunkOffset(
+            chunk.byteOffset
+        ),chunkLine(
+            chunk.lineNumber
+        ),reportsPrologue(
+            newReportsPrologue
+        ),defersDiagnostics(
+            newDefersDiagnostics
+        ),currentSucceeded(
+            false
+        ) {
+        QMap<QString, QByteArray> virtualHeaders = newUserContext->virtualHeaders();
+        for (  QMap<QString, QByteArray>::const_iterator headerIterator    = virtualHeaders.constBegin(),
+                                                         headerEndIterator = virtualHeaders.constEnd()
+             ; headerIterator != headerEndIterator
+             ; ++headerIterator
+            ) {
+            addVirtualHeader(headerIterator.key(), headerIterator.value());
+        }
+    }
+
+
+    IncrementalBuilder::Private::ChunkCompilerContext::~ChunkCompilerContext() {}
+
+
+    bool IncrementalBuilder::Private::ChunkCompilerContext::succeeded() const {
+        return currentSucceeded;
+    }
+
+
+    void IncrementalBuilder::Private::ChunkCompilerContext::compilerFinished(bool success) {
+        currentSucceeded = success;
+    }
+
+
+    void IncrementalBuilder::Private::ChunkCompilerContext::handleCompilerDiagnostic(
+            const CppCompilerDiagnostic& diagnostic
+        ) {
+        const CppSourceRange& sourceRange = diagnostic.sourceRange();
+
+        bool inChunk = (
+               sourceRange.filename().isEmpty()
+            && sourceRange.byteOffset() != SourceRange::invalidByteOffset
+            && sourceRange.byteOffset() >= prologueBytes
+        );
+
+        if (inChunk) {
+            CppSourceRange userSourceRange(
+                static_cast<unsigned>(chunkOffset + (sourceRange.byteOffset() - prologueBytes)),
+                userLineNumber(sourceRange.startLineNumber()),
+                sourceRange.startColumnNumber(),
+                userLineNumber(sourceRange.endLineNumber()),
+                sourceRange.endColumnNumber()
+            );
+
+            forwardDiagnostic(
+                CppCompilerDiagnostic(
+                    userContext,
+                    diagnostic.level(),
+                    diagnostic.code(),
+                    diagnostic.message(),
+                    userSourceRange
+                )
+            );
+        } else if (reportsPrologue) {
+            // The prologue is at the start of both sources so locations in it, or in headers, need no translation.
+            forwardDiagnostic(
+                CppCompilerDiagnostic(
+                    userContext,
+                    diagnostic.level(),
+                    diagnostic.code(),
+                    diagnostic.message(),
+                    sourceRange
+                )
+            );
+        }
+    }
+
+
+    const QList<CppCompilerDiagnostic>& IncrementalBuilder::Private::ChunkCompilerContext::deferredDiagnostics() const {
+        return currentDeferredDiagnostics;
+    }
+
+
+    void IncrementalBuilder::Private::ChunkCompilerContext::reportDeferredDiagnostics() {
+        for (  QList<CppCompilerDiagnostic>::const_iterator
+                   diagnosticIterator    = currentDeferredDiagnostics.constBegin(),
+                   diagnosticEndIterator = currentDeferredDiagnostics.constEnd()
+             ; diagnosticIterator != diagnosticEndIterator
+             ; ++diagnosticIterator
+            ) {
+            builder->reportDiagnostic(userContext, *diagnosticIterator);
+        }
+
+        currentDeferredDiagnostics.clear();
+    }
+
+
+    void IncrementalBuilder::Private::ChunkCompilerContext::forwardDiagnostic(const CppCompilerDiagnostic& diagnostic) {
+        if (defersDiagnostics) {
+            currentDeferredDiagnostics.append(diagnostic);
+        } else {
+            builder->reportDiagnostic(userContext, diagnostic);
+        }
+    }
+
+
+    unsigned IncrementalBuilder::Private::ChunkCompilerContext::userLineNumber(unsigned lineNumber) const {
+        unsigned result;
+
+        if (lineNumber == Compiler::badLineNumber || lineNumber <= prologueLines) {
+            result = lineNumber;
+        } else {
+            result = static_cast<unsigned>(chunkLine + (lineNumber - prologueLines - 1));
+        }
+
+        return result;
+    }
+
+    /*******************************************************************************************************************
+     * IncrementalBuilder::Private::ChunkLinkerContext
+     */
+
+    IncrementalBuilder::Private::ChunkLinkerContext::ChunkLinkerContext(
+            const QString&        outputFile,
+            const QList<QString>& objectFiles
+        ):LinkerContext(
+            outputFile,
+            objectFiles
+        ),currentSucceeded(
+            false
+        ) {}
+
+
+    IncrementalBuilder::Private::ChunkLinkerContext::~ChunkLinkerContext() {}
+
+
+    bool IncrementalBuilder::Private::ChunkLinkerContext::succeeded() const {
+        return currentSucceeded;
+    }
+
+
+    void IncrementalBuilder::Private::ChunkLinkerContext::linkerFinished(bool success) {
+        currentSucceeded = success;
+    }
+}
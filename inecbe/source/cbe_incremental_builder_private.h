@@ -0,0 +1,457 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the Cbe::IncrementalBuilder::Private class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_INCREMENTAL_BUILDER_PRIVATE_H
+#define CBE_INCREMENTAL_BUILDER_PRIVATE_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QTemporaryDir>
+
+#include "cbe_common.h"
+#include "cbe_cpp_compiler_pool.h"
+#include "cbe_cpp_compiler_context.h"
+#include "cbe_cpp_compiler_diagnostic.h"
+#include "cbe_linker_context.h"
+#include "cbe_dynamic_library_linker.h"
+#include "cbe_incremental_builder.h"
+
+namespace Cbe {
+    /**
+     * Class that provides the implementation of the \ref Cbe::IncrementalBuilder class.
+     */
+    class CBE_PUBLIC_API IncrementalBuilder::Private {
+        public:
+            Private();
+
+            ~Private();
+
+            /**
+             * Method you can use to access the compiler pool used to compile the chunks.
+             *
+             * \return Returns a reference to the compiler pool.
+             */
+            CppCompilerPool& compilerPool();
+
+            /**
+             * Method you can use to access the linker used to generate the libraries.
+             *
+             * \return Returns a reference to the linker.
+             */
+            DynamicLibraryLinker& linker();
+
+            /**
+             * Method you can use to set how the source is split into chunks.
+             *
+             * \param[in] newPartitioning The new partitioning.
+             */
+            void setPartitioning(Partitioning newPartitioning);
+
+            /**
+             * Method you can use to determine how the source is split into chunks.
+             *
+             * \return Returns the current partitioning.
+             */
+            Partitioning partitioning() const;
+
+            /**
+             * Method you can use to set the approximate chunk size used with top-level declaration partitioning.
+             *
+             * \param[in] newTargetChunkSize The new target chunk size, in bytes.
+             */
+            void setTargetChunkSize(unsigned long newTargetChunkSize);
+
+            /**
+             * Method you can use to determine the approximate chunk size used with top-level declaration
+             * partitioning.
+             *
+             * \return Returns the target chunk size, in bytes.
+             */
+            unsigned long targetChunkSize() const;
+
+            /**
+             * Method you can use to build a library.
+             *
+             * \param[in] context     The context holding the source to be built.
+             *
+             * \param[in] libraryFile The library to be generated.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool build(QSharedPointer<CppCompilerContext> context, const QString& libraryFile);
+
+            /**
+             * Method you can use to determine the number of chunks in the most recent build.
+             *
+             * \return Returns the number of chunks.
+             */
+            unsigned long numberChunks() const;
+
+            /**
+             * Method you can use to determine the number of chunks compiled by the most recent build.
+             *
+             * \return Returns the number of compiled chunks.
+             */
+            unsigned long numberCompiledChunks() const;
+
+            /**
+             * Method you can use to discard the objects kept from previous builds.
+             */
+            void clear();
+
+        private:
+            class ChunkCompilerContext;
+            class ChunkLinkerContext;
+
+            /**
+             * Class that tracks one chunk of the source.
+             */
+            class Chunk {
+                public:
+                    /**
+                     * The byte offset of the chunk in the source.
+                     */
+                    unsigned long byteOffset;
+
+                    /**
+                     * The one based line number of the first line of the chunk in the source.
+                     */
+                    unsigned long lineNumber;
+
+                    /**
+                     * The text of the chunk.
+                     */
+                    QByteArray text;
+            };
+
+            /**
+             * Method that locates the end of the prologue.
+             *
+             * \param[in] source The source to be built.
+             *
+             * \return Returns the length of the prologue, in bytes.  A value of 0 is returned if the source has no
+             *         chunk marker.
+             */
+            static unsigned long prologueLength(const QByteArray& source);
+
+            /**
+             * Method that splits the source following the prologue into chunks at chunk markers.
+             *
+             * \param[in] source      The source to be built.
+             *
+             * \param[in] startOffset The byte offset of the first byte following the prologue.
+             *
+             * \return Returns a list of chunks.
+             */
+            static QList<Chunk> partitionAtMarkers(const QByteArray& source, unsigned long startOffset);
+
+            /**
+             * Method that splits the source following the prologue into chunks at top-level declaration boundaries.
+             *
+             * \param[in] source      The source to be built.
+             *
+             * \param[in] startOffset The byte offset of the first byte following the prologue.
+             *
+             * \return Returns a list of chunks.
+             */
+            QList<Chunk> partitionAtDeclarations(const QByteArray& source, unsigned long startOffset) const;
+
+            /**
+             * Method that adds a chunk to a list of chunks.  Chunks holding only whitespace are ignored.
+             *
+             * \param[in,out] chunks      The list of chunks.
+             *
+             * \param[in]     source      The source to be built.
+             *
+             * \param[in]     startOffset The byte offset of the start of the chunk.
+             *
+             * \param[in]     endOffset   The byte offset just past the end of the chunk.
+             */
+            static void addChunk(
+                QList<Chunk>&     chunks,
+                const QByteArray& source,
+                unsigned long     startOffset,
+                unsigned long     endOffset
+            );
+
+            /**
+             * Method that calculates the key used to identify a chunk's object.
+             *
+             * \param[in] prologue       The prologue.
+             *
+             * \param[in] chunk          The chunk.
+             *
+             * \param[in] virtualHeaders The virtual headers supplied by the context.
+             *
+             * \return Returns the key.
+             */
+            static QByteArray chunkKey(
+                const QByteArray&                prologue,
+                const Chunk&                     chunk,
+                const QMap<QString, QByteArray>& virtualHeaders
+            );
+
+            /**
+             * Method that generates the object file name for a chunk.
+             *
+             * \param[in] key The chunk's key.
+             *
+             * \return Returns the object file name.
+             */
+            QString objectFilename(const QByteArray& key) const;
+
+            /**
+             * Method that compiles the source following the prologue as a single unit.  Used when a source does not
+             * compile as chunks to distinguish errors in the source from dependencies between chunks.
+             *
+             * \param[in]     context        The context supplied to \ref IncrementalBuilder::build.
+             *
+             * \param[in]     prologue       The prologue.
+             *
+             * \param[in]     chunk          A chunk holding the entire source following the prologue.
+             *
+             * \param[in]     virtualHeaders The virtual headers supplied by the context.
+             *
+             * \param[in,out] buildObjects   The objects used by this build, keyed by chunk key.  On success, holds only
+             *                               the single unit's object.
+             *
+             * \return Returns true if the source compiled as a single unit.
+             */
+            bool buildSingleUnit(
+                QSharedPointer<CppCompilerContext> context,
+                const QByteArray&                  prologue,
+                const Chunk&                       chunk,
+                const QMap<QString, QByteArray>&   virtualHeaders,
+                QMap<QByteArray, QString>&         buildObjects
+            );
+
+            /**
+             * Method that reports a chunk diagnostic to the context supplied by the user.  Diagnostics are serialized
+             * as chunks are compiled concurrently.
+             *
+             * \param[in] userContext The context supplied to \ref IncrementalBuilder::build.
+             *
+             * \param[in] diagnostic  The diagnostic, relative to the user's source.
+             */
+            void reportDiagnostic(
+                QSharedPointer<CppCompilerContext> userContext,
+                const CppCompilerDiagnostic&       diagnostic
+            );
+
+            /**
+             * Directory holding the generated objects.
+             */
+            QTemporaryDir workingDirectory;
+
+            /**
+             * Compiler pool used to compile the chunks.
+             */
+            CppCompilerPool currentCompilerPool;
+
+            /**
+             * Linker used to generate the libraries.
+             */
+            DynamicLibraryLinker currentLinker;
+
+            /**
+             * Mutex used to serialize builds.
+             */
+            mutable QMutex builderMutex;
+
+            /**
+             * Mutex used to serialize diagnostics reported to the user's context.
+             */
+            QMutex diagnosticMutex;
+
+            /**
+             * The current partitioning.
+             */
+            Partitioning currentPartitioning;
+
+            /**
+             * The current target chunk size.
+             */
+            unsigned long currentTargetChunkSize;
+
+            /**
+             * Objects available for reuse, keyed by chunk key.
+             */
+            QMap<QByteArray, QString> availableObjects;
+
+            /**
+             * The number of chunks in the most recent build.
+             */
+            unsigned long currentNumberChunks;
+
+            /**
+             * The number of chunks compiled by the most recent build.
+             */
+            unsigned long currentNumberCompiledChunks;
+    };
+
+    /**
+     * Compiler context used to compile one chunk.  The chunk is compiled with the prologue prepended.  Diagnostics are
+     * translated back to the user's source before being forwarded.
+     */
+    class IncrementalBuilder::Private::ChunkCompilerContext:public CppCompilerContext {
+        public:
+            /**
+             * Constructor
+             *
+             * \param[in] newBuilder         The builder.
+             *
+             * \param[in] newUserContext     The context supplied by the user.
+             *
+             * \param[in] prologue           The prologue.
+             *
+             * \param[in] chunk              The chunk to be compiled.
+             *
+             * \param[in] newObjectFile      The object file to be generated.
+             *
+             * \param[in] newReportsPrologue If true, diagnostics in the prologue and in headers are forwarded.  Only
+             *                               one chunk per build forwards these diagnostics.
+             *
+             * \param[in] newDefersDiagnostics If true, diagnostics are held until
+             *                                 \ref ChunkCompilerContext::reportDeferredDiagnostics is called.
+             */
+            ChunkCompilerContext(
+                IncrementalBuilder::Private*       newBuilder,
+                QSharedPointer<CppCompilerContext> newUserContext,
+                const QByteArray&                  prologue,
+                const Chunk&                       chunk,
+                const QString&                     newObjectFile,
+                bool                               newReportsPrologue,
+                bool                               newDefersDiagnostics
+            );
+
+            ~ChunkCompilerContext() override;
+
+            /**
+             * Method you can use to determine if the chunk compiled successfully.
+             *
+             * \return Returns true if the chunk compiled successfully.
+             */
+            bool succeeded() const;
+
+            /**
+             * Method that is called when the compiler finishes.
+             *
+             * \param[in] success Holds true if the compiler completed successfully.
+             */
+            void compilerFinished(bool success) override;
+
+            /**
+             * Method that is called to report a compiler diagnostic.
+             *
+             * \param[in] diagnostic The reported diagnostic.
+             */
+            void handleCompilerDiagnostic(const CppCompilerDiagnostic& diagnostic) override;
+
+            /**
+             * Method you can use to obtain the diagnostics held by this context.
+             *
+             * \return Returns the held diagnostics, relative to the user's source.
+             */
+            const QList<CppCompilerDiagnostic>& deferredDiagnostics() const;
+
+            /**
+             * Method that forwards the diagnostics held by this context to the user's context.
+             */
+            void reportDeferredDiagnostics();
+
+        private:
+            /**
+             * Method that forwards a diagnostic, relative to the user's source, or holds it if diagnostics are
+             * deferred.
+             *
+             * \param[in] diagnostic The diagnostic.
+             */
+            void forwardDiagnostic(const CppCompilerDiagnostic& diagnostic);
+
+            /**
+             * Method that translates a line number in the chunk's source to a line number in the user's source.
+             *
+             * \param[in] lineNumber The line number in the chunk's source.
+             *
+             * \return Returns the line number in the user's source.
+             */
+            unsigned userLineNumber(unsigned lineNumber) const;
+
+            IncrementalBuilder::Private*       builder;
+            QSharedPointer<CppCompilerContext> userContext;
+            unsigned long                      prologueBytes;
+            unsigned long                      prologueLines;
+            unsigned long                      chunkOffset;
+            unsigned long                      chunkLine;
+            bool                               reportsPrologue;
+            bool                               defersDiagnostics;
+            bool                               currentSucceeded;
+            QList<CppCompilerDiagnostic>       currentDeferredDiagnostics;
+    };
+
+    /**
+     * Linker context used to link the chunk objects.  The result is recorded for the builder.
+     */
+    class IncrementalBuilder::Private::ChunkLinkerContext:public LinkerContext {
+        public:
+            /**
+             * Constructor
+             *
+             * \param[in] outputFile  The library to be generated.
+             *
+             * \param[in] objectFiles The object files to be linked.
+             */
+            ChunkLinkerContext(const QString& outputFile, const QList<QString>& objectFiles);
+
+            ~ChunkLinkerContext() override;
+
+            /**
+             * Method you can use to determine if the library was linked successfully.
+             *
+             * \return Returns true if the library was linked successfully.
+             */
+            bool succeeded() const;
+
+            /**
+             * Method that is called when the linker finishes.
+             *
+             * \param[in] success Holds true if the linker completed successfully.
+             */
+            void linkerFinished(bool success) override;
+
+        private:
+            bool currentSucceeded;
+    };
+};
+
+#endif
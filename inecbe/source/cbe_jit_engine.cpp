@@ -0,0 +1,86 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::JitEngine class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include "cbe_compiler_context.h"
+#include "cbe_jit_engine_private.h"
+#include "cbe_jit_engine.h"
+
+namespace Cbe {
+    JitEngine::JitEngine(JitEngine::Compilation compilation):impl(new JitEngine::Private(compilation)) {}
+
+
+    JitEngine::~JitEngine() {}
+
+
+    bool JitEngine::isValid() const {
+        return impl->isValid();
+    }
+
+
+    QString JitEngine::errorString() const {
+        return impl->errorString();
+    }
+
+
+    JitEngine::Compilation JitEngine::compilation() const {
+        return impl->compilation();
+    }
+
+
+    bool JitEngine::addLibrary(const QString& libraryFilename) {
+        return impl->addLibrary(libraryFilename);
+    }
+
+
+    bool JitEngine::add(QSharedPointer<CompilerContext> context) {
+        return impl->add(context);
+    }
+
+
+    bool JitEngine::addObject(const QByteArray& objectData) {
+        return impl->addObject(objectData);
+    }
+
+
+    bool JitEngine::addBitcode(const QByteArray& bitcodeData) {
+        return impl->addBitcode(bitcodeData);
+    }
+
+
+    void* JitEngine::resolve(const QString& symbolName) const {
+        return impl->resolve(symbolName);
+    }
+
+
+    bool JitEngine::reset() {
+        return impl->reset();
+    }
+}
@@ -0,0 +1,396 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::JitEngine::Private class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QFile>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "warnings.h"
+
+SUPPRESS_LLVM_WARNINGS
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/ExecutionEngine/JITSymbol.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h>
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/TargetSelect.h>
+
+RESTORE_LLVM_WARNINGS
+
+#include "cbe_compiler_context.h"
+#include "cbe_jit_engine.h"
+#include "cbe_jit_engine_private.h"
+
+#if (defined(_WIN32) || defined(_WIN64))
+
+    /**
+     * Function that creates the object linking layer used on Windows.  COFF objects do not carry the symbol flags
+     * ORC expects so the layer is told to take them from the materialization responsibility.
+     *
+     * \param[in] executionSession The JIT's execution session.
+     *
+     * \return Returns the object linking layer.
+     */
+    static std::unique_ptr<llvm::orc::ObjectLayer> createObjectLinkingLayer(
+            llvm::orc::ExecutionSession& executionSession,
+            const llvm::Triple&
+        ) {
+        std::unique_ptr<llvm::orc::RTDyldObjectLinkingLayer> objectLinkingLayer(
+            new llvm::orc::RTDyldObjectLinkingLayer(
+                executionSession,
+                []() {
+                    return std::unique_ptr<llvm::RuntimeDyld::MemoryManager>(new llvm::SectionMemoryManager);
+                }
+            )
+        );
+
+        objectLinkingLayer->setOverrideObjectFlagsWithResponsibilityFlags(true);
+        objectLinkingLayer->setAutoClaimResponsibilityForObjectSymbols(true);
+
+        return std::move(objectLinkingLayer);
+    }
+
+#endif
+
+namespace Cbe {
+    JitEngine::Private::Private(JitEngine::Compilation compilation) {
+        currentCompilation = compilation;
+        numberModules      = 0;
+
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+
+        createJit();
+    }
+
+
+    JitEngine::Private::~Private() {
+        QMutexLocker locker(&jitMutex);
+        destroyJit();
+    }
+
+
+    bool JitEngine::Private::isValid() const {
+        QMutexLocker locker(&jitMutex);
+        return jit != nullptr;
+    }
+
+
+    QString JitEngine::Private::errorString() const {
+        QMutexLocker locker(&jitMutex);
+        return currentErrorString;
+    }
+
+
+    JitEngine::Compilation JitEngine::Private::compilation() const {
+        return currentCompilation;
+    }
+
+
+    bool JitEngine::Private::addLibrary(const QString& libraryFilename) {
+        QMutexLocker locker(&jitMutex);
+
+        bool success = addLibrarySearchGenerator(libraryFilename);
+        if (success) {
+            currentLibraries.append(libraryFilename);
+        }
+
+        return success;
+    }
+
+
+    bool JitEngine::Private::add(QSharedPointer<CompilerContext> context) {
+        QByteArray data;
+
+        if (context->objectDestination() == CompilerContext::ObjectDestination::MEMORY) {
+            data = context->objectData();
+        } else {
+            QFile objectFile(context->objectFile());
+            if (objectFile.open(QFile::ReadOnly)) {
+                data = objectFile.readAll();
+            }
+        }
+
+        bool success;
+        if (data.isEmpty()) {
+            QMutexLocker locker(&jitMutex);
+            currentErrorString = QString("No object available for %1").arg(context->objectFile());
+            success = false;
+        } else if (context->objectFormat() != CompilerContext::ObjectFormat::NATIVE) {
+            success = addBitcode(data);
+        } else {
+            success = addObject(data);
+        }
+
+        return success;
+    }
+
+
+    bool JitEngine::Private::addObject(const QByteArray& objectData) {
+        QMutexLocker locker(&jitMutex);
+
+        bool success;
+        if (jit != nullptr) {
+            success = checkError(
+                jit->addObjectFile(
+                    llvm::MemoryBuffer::getMemBufferCopy(
+                        llvm::StringRef(objectData.constData(), static_cast<std::size_t>(objectData.size())),
+                        "inecbe_object"
+                    )
+                )
+            );
+        } else {
+            success = false;
+        }
+
+        return success;
+    }
+
+
+    bool JitEngine::Private::addBitcode(const QByteArray& bitcodeData) {
+        QMutexLocker locker(&jitMutex);
+
+        bool success = false;
+        if (jit != nullptr) {
+            std::unique_ptr<llvm::LLVMContext> llvmContext(new llvm::LLVMContext);
+
+            llvm::Expected<std::unique_ptr<llvm::Module>> moduleOrError = llvm::parseBitcodeFile(
+                llvm::MemoryBufferRef(
+                    llvm::StringRef(bitcodeData.constData(), static_cast<std::size_t>(bitcodeData.size())),
+                    "inecbe_bitcode"
+                ),
+                *llvmContext
+            );
+
+            if (moduleOrError) {
+                std::unique_ptr<llvm::Module> module = std::move(*moduleOrError);
+
+                // Clang names static constructors after the main file, which is the same for every context.  The
+                // runner exports the constructors so they are renamed to keep them unique across modules.
+                std::string moduleSuffix = "." + std::to_string(++numberModules);
+
+                llvm::iterator_range<llvm::orc::CtorDtorIterator> constructors = llvm::orc::getConstructors(*module);
+                for (  llvm::orc::CtorDtorIterator constructorIterator    = constructors.begin(),
+                                                   constructorEndIterator = constructors.end()
+                     ; constructorIterator != constructorEndIterator
+                     ; ++constructorIterator
+                    ) {
+                    llvm::Function* function = (*constructorIterator).Func;
+                    if (function != nullptr && function->hasLocalLinkage()) {
+                        function->setName(function->getName() + moduleSuffix);
+                    }
+                }
+
+                llvm::iterator_range<llvm::orc::CtorDtorIterator> destructors = llvm::orc::getDestructors(*module);
+                for (  llvm::orc::CtorDtorIterator destructorIterator    = destructors.begin(),
+                                                   destructorEndIterator = destructors.end()
+                     ; destructorIterator != destructorEndIterator
+                     ; ++destructorIterator
+                    ) {
+                    llvm::Function* function = (*destructorIterator).Func;
+                    if (function != nullptr && function->hasLocalLinkage()) {
+                        function->setName(function->getName() + moduleSuffix);
+                    }
+                }
+
+                constructorRunner->add(constructors);
+                destructorRunner->add(destructors);
+
+                llvm::orc::ThreadSafeModule threadSafeModule(std::move(module), std::move(llvmContext));
+                if (currentCompilation == JitEngine::Compilation::LAZY) {
+                    llvm::orc::LLLazyJIT* lazyJit = static_cast<llvm::orc::LLLazyJIT*>(jit.get());
+                    success = checkError(lazyJit->addLazyIRModule(std::move(threadSafeModule)));
+                } else {
+                    success = checkError(jit->addIRModule(std::move(threadSafeModule)));
+                }
+
+                if (success) {
+                    success = checkError(constructorRunner->run());
+                }
+            } else {
+                checkError(moduleOrError.takeError());
+            }
+        }
+
+        return success;
+    }
+
+
+    void* JitEngine::Private::resolve(const QString& symbolName) {
+        QMutexLocker locker(&jitMutex);
+
+        void* result = nullptr;
+        if (jit != nullptr) {
+            llvm::Expected<llvm::JITEvaluatedSymbol> symbolOrError = jit->lookup(symbolName.toStdString());
+            if (symbolOrError) {
+                result = reinterpret_cast<void*>(static_cast<std::uintptr_t>(symbolOrError->getAddress()));
+            } else {
+                checkError(symbolOrError.takeError());
+            }
+        }
+
+        return result;
+    }
+
+
+    bool JitEngine::Private::reset() {
+        QMutexLocker locker(&jitMutex);
+
+        destroyJit();
+        return createJit();
+    }
+
+
+    bool JitEngine::Private::createJit() {
+        if (currentCompilation == JitEngine::Compilation::LAZY) {
+            llvm::orc::LLLazyJITBuilder jitBuilder;
+
+            #if (defined(_WIN32) || defined(_WIN64))
+
+                jitBuilder.setObjectLinkingLayerCreator(createObjectLinkingLayer);
+
+            #endif
+
+            llvm::Expected<std::unique_ptr<llvm::orc::LLLazyJIT>> jitOrError = jitBuilder.create();
+            if (jitOrError) {
+                // By default the whole module is compiled on the first call into it.  Compile only the function
+                // that was called.
+                (*jitOrError)->setPartitionFunction(llvm::orc::CompileOnDemandLayer::compileRequested);
+                jit = std::move(*jitOrError);
+            } else {
+                checkError(jitOrError.takeError());
+            }
+        } else {
+            llvm::orc::LLJITBuilder jitBuilder;
+
+            #if (defined(_WIN32) || defined(_WIN64))
+
+                jitBuilder.setObjectLinkingLayerCreator(createObjectLinkingLayer);
+
+            #endif
+
+            llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>> jitOrError = jitBuilder.create();
+            if (jitOrError) {
+                jit = std::move(*jitOrError);
+            } else {
+                checkError(jitOrError.takeError());
+            }
+        }
+
+        bool success = false;
+        if (jit != nullptr) {
+            llvm::orc::JITDylib& mainLibrary  = jit->getMainJITDylib();
+            char                 globalPrefix = jit->getDataLayout().getGlobalPrefix();
+
+            llvm::Expected<std::unique_ptr<llvm::orc::DynamicLibrarySearchGenerator>> generatorOrError =
+                llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(globalPrefix);
+
+            if (generatorOrError) {
+                mainLibrary.addGenerator(std::move(*generatorOrError));
+                success = true;
+            } else {
+                checkError(generatorOrError.takeError());
+            }
+
+            QList<QString>::const_iterator libraryIterator    = currentLibraries.constBegin();
+            QList<QString>::const_iterator libraryEndIterator = currentLibraries.constEnd();
+            while (success && libraryIterator != libraryEndIterator) {
+                success = addLibrarySearchGenerator(*libraryIterator);
+                ++libraryIterator;
+            }
+
+            constructorRunner.reset(new llvm::orc::CtorDtorRunner(mainLibrary));
+            destructorRunner.reset(new llvm::orc::CtorDtorRunner(mainLibrary));
+        }
+
+        return success;
+    }
+
+
+    void JitEngine::Private::destroyJit() {
+        if (destructorRunner) {
+            checkError(destructorRunner->run());
+        }
+
+        constructorRunner.reset();
+        destructorRunner.reset();
+        jit.reset();
+    }
+
+
+    bool JitEngine::Private::addLibrarySearchGenerator(const QString& libraryFilename) {
+        bool success = false;
+
+        if (jit != nullptr) {
+            llvm::Expected<std::unique_ptr<llvm::orc::DynamicLibrarySearchGenerator>> generatorOrError =
+                llvm::orc::DynamicLibrarySearchGenerator::Load(
+                    libraryFilename.toLocal8Bit().constData(),
+                    jit->getDataLayout().getGlobalPrefix()
+                );
+
+            if (generatorOrError) {
+                jit->getMainJITDylib().addGenerator(std::move(*generatorOrError));
+                success = true;
+            } else {
+                checkError(generatorOrError.takeError());
+            }
+        }
+
+        return success;
+    }
+
+
+    bool JitEngine::Private::checkError(llvm::Error error) {
+        bool success = !error;
+
+        if (!success) {
+            currentErrorString = QString::fromStdString(llvm::toString(std::move(error)));
+        }
+
+        return success;
+    }
+}
@@ -0,0 +1,220 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the Cbe::JitEngine::Private class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_JIT_ENGINE_PRIVATE_H
+#define CBE_JIT_ENGINE_PRIVATE_H
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QMutex>
+
+#include <memory>
+
+#include "cbe_common.h"
+#include "cbe_jit_engine.h"
+
+namespace llvm {
+    class Error;
+
+    namespace orc {
+        class LLJIT;
+        class CtorDtorRunner;
+    }
+}
+
+namespace Cbe {
+    class CompilerContext;
+
+    /**
+     * Class that provides the implementation of the \ref Cbe::JitEngine class.
+     */
+    class CBE_PUBLIC_API JitEngine::Private {
+        public:
+            /**
+             * Constructor.
+             *
+             * \param[in] compilation The compilation mode used for bitcode modules.
+             */
+            Private(JitEngine::Compilation compilation);
+
+            ~Private();
+
+            /**
+             * Method you can use to determine if the JIT was successfully created.
+             *
+             * \return Returns true if the JIT is usable.
+             */
+            bool isValid() const;
+
+            /**
+             * Method you can use to obtain a description of the most recent error.
+             *
+             * \return Returns a description of the most recent error.
+             */
+            QString errorString() const;
+
+            /**
+             * Method you can use to determine the compilation mode used for bitcode modules.
+             *
+             * \return Returns the compilation mode.
+             */
+            JitEngine::Compilation compilation() const;
+
+            /**
+             * Method you can use to make the symbols exported by a dynamic library visible to JIT compiled code.
+             *
+             * \param[in] libraryFilename The dynamic library to be searched.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool addLibrary(const QString& libraryFilename);
+
+            /**
+             * Method you can use to add the output of a successful compilation to the JIT.
+             *
+             * \param[in] context The compiled context.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool add(QSharedPointer<CompilerContext> context);
+
+            /**
+             * Method you can use to add a native object to the JIT.
+             *
+             * \param[in] objectData The object to be added.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool addObject(const QByteArray& objectData);
+
+            /**
+             * Method you can use to add an LLVM bitcode module to the JIT.
+             *
+             * \param[in] bitcodeData The bitcode to be added.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool addBitcode(const QByteArray& bitcodeData);
+
+            /**
+             * Method you can use to obtain the address of a symbol.
+             *
+             * \param[in] symbolName The unmangled name of the symbol.
+             *
+             * \return Returns the address of the symbol.  A null pointer is returned if the symbol could not be
+             *         found.
+             */
+            void* resolve(const QString& symbolName);
+
+            /**
+             * Method you can use to discard everything added to the JIT.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool reset();
+
+        private:
+            /**
+             * Method that creates the JIT and adds the host process and any added libraries to the symbol search
+             * order.  The caller must hold the JIT mutex.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool createJit();
+
+            /**
+             * Method that runs static destructors and releases the JIT.  The caller must hold the JIT mutex.
+             */
+            void destroyJit();
+
+            /**
+             * Method that adds a dynamic library to the JIT's symbol search order.  The caller must hold the JIT
+             * mutex.
+             *
+             * \param[in] libraryFilename The dynamic library to be searched.
+             *
+             * \return Returns true on success, returns false on error.
+             */
+            bool addLibrarySearchGenerator(const QString& libraryFilename);
+
+            /**
+             * Method that records an LLVM error as the most recent error.  The error is consumed.
+             *
+             * \param[in] error The error to be recorded.
+             *
+             * \return Returns true if the error indicates success.  Returns false if an error was recorded.
+             */
+            bool checkError(llvm::Error error);
+
+            /**
+             * The compilation mode used for bitcode modules.
+             */
+            JitEngine::Compilation currentCompilation;
+
+            /**
+             * Mutex used to serialize access to the JIT.
+             */
+            mutable QMutex jitMutex;
+
+            /**
+             * The JIT.  A null pointer indicates the JIT could not be created.  In lazy mode this will point to an
+             * instance of llvm::orc::LLLazyJIT.
+             */
+            std::unique_ptr<llvm::orc::LLJIT> jit;
+
+            /**
+             * Runner used to run static constructors of added bitcode modules.
+             */
+            std::unique_ptr<llvm::orc::CtorDtorRunner> constructorRunner;
+
+            /**
+             * Runner used to run static destructors of added bitcode modules.
+             */
+            std::unique_ptr<llvm::orc::CtorDtorRunner> destructorRunner;
+
+            /**
+             * The libraries added to the symbol search order.  The libraries are added again when the JIT is reset.
+             */
+            QList<QString> currentLibraries;
+
+            /**
+             * The number of bitcode modules added.  Used to give each module's static constructors a unique name.
+             */
+            unsigned long long numberModules;
+
+            /**
+             * Description of the most recent error.
+             */
+            QString currentErrorString;
+    };
+};
+
+#endif
@@ -202,6 +202,16 @@ namespace Cbe {
     }
 
 
+    void Linker::setLtoCacheDirectory(const QString& newLtoCacheDirectory) {
+        impl->setLtoCacheDirectory(newLtoCacheDirectory);
+    }
+
+
+    QString Linker::ltoCacheDirectory() const {
+        return impl->ltoCacheDirectory();
+    }
+
+
     void Linker::link(QSharedPointer<LinkerContext> context) {
         impl->link(context);
     }
@@ -127,4 +127,7 @@ namespace Cbe {
 
 
     void LinkerContext::handleLinkerDiagnostic(const QString &) {}
+
+
+    void LinkerContext::linkerJobSuperseded() {}
 }
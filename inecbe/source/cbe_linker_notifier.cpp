@@ -57,4 +57,7 @@ namespace Cbe {
 
 
     void LinkerNotifier::handleLinkerDiagnostic(QSharedPointer<LinkerContext>, const QString&) {}
+
+
+    void LinkerNotifier::linkerJobSuperseded(QSharedPointer<LinkerContext>, QSharedPointer<LinkerContext>) {}
 }
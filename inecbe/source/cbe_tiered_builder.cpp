@@ -0,0 +1,115 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::TieredBuilder class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QSharedPointer>
+
+#include "cbe_cpp_compiler.h"
+#include "cbe_cpp_compiler_context.h"
+#include "cbe_dynamic_library_linker.h"
+#include "cbe_dynamic_library_loader.h"
+#include "cbe_tiered_builder_notifier.h"
+#include "cbe_tiered_builder_private.h"
+#include "cbe_tiered_builder.h"
+
+namespace Cbe {
+    TieredBuilder::TieredBuilder(TieredBuilderNotifier* newNotifier):impl(new TieredBuilder::Private(newNotifier)) {
+        if (newNotifier != nullptr) {
+            newNotifier->currentBuilder = this;
+        }
+    }
+
+
+    TieredBuilder::~TieredBuilder() {
+        if (impl->notifier() != nullptr) {
+            impl->notifier()->currentBuilder = nullptr;
+        }
+    }
+
+
+    void TieredBuilder::setNotifier(TieredBuilderNotifier* newNotifier) {
+        if (impl->notifier() != nullptr) {
+            impl->notifier()->currentBuilder = nullptr;
+        }
+
+        impl->setNotifier(newNotifier);
+
+        if (newNotifier != nullptr) {
+            newNotifier->currentBuilder = this;
+        }
+    }
+
+
+    TieredBuilderNotifier* TieredBuilder::notifier() const {
+        return impl->notifier();
+    }
+
+
+    CppCompiler& TieredBuilder::quickCompiler() {
+        return impl->quickCompiler();
+    }
+
+
+    CppCompiler& TieredBuilder::optimizingCompiler() {
+        return impl->optimizingCompiler();
+    }
+
+
+    DynamicLibraryLinker& TieredBuilder::linker() {
+        return impl->linker();
+    }
+
+
+    DynamicLibraryLoader& TieredBuilder::loader() {
+        return impl->loader();
+    }
+
+
+    void TieredBuilder::releasePrevious() {
+        impl->releasePrevious();
+    }
+
+
+    void TieredBuilder::build(QSharedPointer<CppCompilerContext> context) {
+        impl->build(context);
+    }
+
+
+    void TieredBuilder::waitComplete() {
+        impl->waitComplete();
+    }
+
+
+    bool TieredBuilder::isLoaded() const {
+        return impl->isLoaded();
+    }
+
+
+    TieredBuilder::Tier TieredBuilder::loadedTier() const {
+        return impl->loadedTier();
+    }
+}
@@ -0,0 +1,423 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref Cbe::TieredBuilder::Private class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "cbe_cpp_compiler.h"
+#include "cbe_cpp_compiler_context.h"
+#include "cbe_cpp_compiler_diagnostic.h"
+#include "cbe_linker_context.h"
+#include "cbe_dynamic_library_linker.h"
+#include "cbe_dynamic_library_loader.h"
+#include "cbe_tiered_builder_notifier.h"
+#include "cbe_tiered_builder.h"
+#include "cbe_tiered_builder_private.h"
+
+namespace Cbe {
+    /*******************************************************************************************************************
+     * TieredBuilder::Private
+     */
+
+    TieredBuilder::Private::Private(TieredBuilderNotifier* newNotifier) {
+        currentNotifier   = newNotifier;
+        currentGeneration = 0;
+        loadedGeneration  = 0;
+        currentLoadedTier = Tier::QUICK;
+
+        currentLoader.reset(new DynamicLibraryLoader);
+
+        QList<QString> quickSwitches = currentQuickCompiler.compilerSwitches();
+        for (  QList<QString>::iterator switchIterator    = quickSwitches.begin(),
+                                        switchEndIterator = quickSwitches.end()
+             ; switchIterator != switchEndIterator
+             ; ++switchIterator
+            ) {
+            if (switchIterator->startsWith("-O")) {
+                *switchIterator = QString("-O0");
+            }
+        }
+
+        currentQuickCompiler.setCompilerSwitches(quickSwitches);
+        currentOptimizingCompiler.setThreadPriority(QThread::LowPriority);
+    }
+
+
+    TieredBuilder::Private::~Private() {
+        waitComplete();
+        releasePrevious();
+        currentLoader->unload();
+    }
+
+
+    void TieredBuilder::Private::setNotifier(TieredBuilderNotifier* newNotifier) {
+        currentNotifier = newNotifier;
+    }
+
+
+    TieredBuilderNotifier* TieredBuilder::Private::notifier() const {
+        return currentNotifier;
+    }
+
+
+    CppCompiler& TieredBuilder::Private::quickCompiler() {
+        return currentQuickCompiler;
+    }
+
+
+    CppCompiler& TieredBuilder::Private::optimizingCompiler() {
+        return currentOptimizingCompiler;
+    }
+
+
+    DynamicLibraryLinker& TieredBuilder::Private::linker() {
+        return currentLinker;
+    }
+
+
+    DynamicLibraryLoader& TieredBuilder::Private::loader() {
+        QMutexLocker locker(&builderMutex);
+        return *currentLoader;
+    }
+
+
+    void TieredBuilder::Private::releasePrevious() {
+        builderMutex.lock();
+        QList<QSharedPointer<DynamicLibraryLoader>> releasedLoaders = previousLoaders;
+        previousLoaders.clear();
+        builderMutex.unlock();
+
+        for (  QList<QSharedPointer<DynamicLibraryLoader>>::const_iterator
+                   loaderIterator    = releasedLoaders.constBegin(),
+                   loaderEndIterator = releasedLoaders.constEnd()
+             ; loaderIterator != loaderEndIterator
+             ; ++loaderIterator
+            ) {
+            QString libraryFilename = (*loaderIterator)->filename();
+            if ((*loaderIterator)->isLoaded() && (*loaderIterator)->unload()) {
+                QFile::remove(libraryFilename);
+            }
+        }
+    }
+
+
+    void TieredBuilder::Private::build(QSharedPointer<CppCompilerContext> context) {
+        unsigned long long generation;
+
+        builderMutex.lock();
+
+        generation = ++currentGeneration;
+
+        if (!pendingOptimizedContext.isNull()) {
+            pendingOptimizedContext->cancel();
+            pendingOptimizedContext.clear();
+        }
+
+        builderMutex.unlock();
+
+        currentQuickCompiler.compile(
+            QSharedPointer<CppCompilerContext>(
+                new TierCompilerContext(this, Tier::QUICK, generation, context, objectFilename(generation, Tier::QUICK))
+            )
+        );
+    }
+
+
+    void TieredBuilder::Private::waitComplete() {
+        // Each stage queues the next stage before its thread exits so waiting on the stages in order is sufficient.
+        currentQuickCompiler.waitComplete();
+        currentOptimizingCompiler.waitComplete();
+        currentLinker.waitComplete();
+    }
+
+
+    bool TieredBuilder::Private::isLoaded() const {
+        QMutexLocker locker(&builderMutex);
+        return currentLoader->isLoaded();
+    }
+
+
+    TieredBuilder::Tier TieredBuilder::Private::loadedTier() const {
+        QMutexLocker locker(&builderMutex);
+        return currentLoadedTier;
+    }
+
+
+    void TieredBuilder::Private::compilerFinished(
+            TieredBuilder::Tier                tier,
+            unsigned long long                 generation,
+            QSharedPointer<CppCompilerContext> userContext,
+            const QString&                     objectFile,
+            bool                               cancelled,
+            bool                               success
+        ) {
+        if (success) {
+            QSharedPointer<CppCompilerContext> optimizedContext;
+
+            builderMutex.lock();
+
+            bool isCurrent = (generation == currentGeneration);
+            if (isCurrent && tier == Tier::QUICK && !userContext->cancelled()) {
+                optimizedContext.reset(
+                    new TierCompilerContext(
+                        this,
+                        Tier::OPTIMIZED,
+                        generation,
+                        userContext,
+                        objectFilename(generation, Tier::OPTIMIZED)
+                    )
+                );
+
+                pendingOptimizedContext = optimizedContext;
+            } else if (isCurrent && tier == Tier::OPTIMIZED) {
+                pendingOptimizedContext.clear();
+            }
+
+            builderMutex.unlock();
+
+            if (isCurrent) {
+                currentLinker.link(
+                    QSharedPointer<LinkerContext>(
+                        new TierLinkerContext(this, tier, generation, libraryFilename(generation, tier), objectFile)
+                    )
+                );
+
+                if (!optimizedContext.isNull()) {
+                    currentOptimizingCompiler.compile(optimizedContext);
+                }
+            } else {
+                QFile::remove(objectFile);
+            }
+        } else if (!cancelled && currentNotifier != nullptr) {
+            currentNotifier->tierFailed(tier);
+        }
+    }
+
+
+    void TieredBuilder::Private::linkerFinished(
+            TieredBuilder::Tier tier,
+            unsigned long long  generation,
+            const QString&      libraryFile,
+            const QString&      objectFile,
+            bool                success
+        ) {
+        QFile::remove(objectFile);
+
+        if (success) {
+            bool loaded = false;
+            bool failed = false;
+
+            builderMutex.lock();
+
+            // A quick library must never replace the optimized library of the same build and a superseded build must
+            // never replace a newer build.
+            bool supersedes = (
+                   generation == currentGeneration
+                && (   !currentLoader->isLoaded()
+                    || generation != loadedGeneration
+                    || currentLoadedTier == Tier::QUICK
+                   )
+            );
+
+            if (supersedes) {
+                // The new library is loaded on the side so the current library stays usable if loading fails.  The
+                // user's loader notifier follows the current library.  Replaced libraries are released silently by
+                // releasePrevious since the notifier may no longer exist by then.
+                QSharedPointer<DynamicLibraryLoader> newLoader(new DynamicLibraryLoader(currentLoader->notifier()));
+
+                loaded = newLoader->load(libraryFile);
+                if (loaded) {
+                    currentLoader->setNotifier(nullptr);
+                    previousLoaders.append(currentLoader);
+
+                    currentLoader     = newLoader;
+                    loadedGeneration  = generation;
+                    currentLoadedTier = tier;
+                } else {
+                    // Hand the notifier back to the loader still holding the current library.
+                    newLoader.clear();
+                    if (currentLoader->notifier() != nullptr) {
+                        currentLoader->setNotifier(currentLoader->notifier());
+                    }
+
+                    QFile::remove(libraryFile);
+                    failed = true;
+                }
+            } else {
+                QFile::remove(libraryFile);
+            }
+
+            builderMutex.unlock();
+
+            if (currentNotifier != nullptr) {
+                if (loaded) {
+                    currentNotifier->tierLoaded(tier, libraryFile);
+                } else if (failed) {
+                    currentNotifier->tierFailed(tier);
+                }
+            }
+        } else if (currentNotifier != nullptr) {
+            currentNotifier->tierFailed(tier);
+        }
+    }
+
+
+    QString TieredBuilder::Private::objectFilename(unsigned long long generation, TieredBuilder::Tier tier) const {
+        #if (defined(_WIN32) || defined(_WIN64))
+
+            QString extension("obj");
+
+        #else
+
+            QString extension("o");
+
+        #endif
+
+        QString tierName = tier == Tier::QUICK ? QString("quick") : QString("optimized");
+        return workingDirectory.filePath(QString("build_%1_%2.%3").arg(generation).arg(tierName, extension));
+    }
+
+
+    QString TieredBuilder::Private::libraryFilename(unsigned long long generation, TieredBuilder::Tier tier) const {
+        #if (defined(_WIN32) || defined(_WIN64))
+
+            QString extension("dll");
+
+        #elif (defined(__APPLE__))
+
+            QString extension("dylib");
+
+        #else
+
+            QString extension("so");
+
+        #endif
+
+        // Each library is given a unique name.  Dynamic loaders cache libraries by name so reusing a name would
+        // return the previously loaded library.
+        QString tierName = tier == Tier::QUICK ? QString("quick") : QString("optimized");
+        return workingDirectory.filePath(QString("build_%1_%2.%3").arg(generation).arg(tierName, extension));
+    }
+
+    /*******************************************************************************************************************
+     * TieredBuilder::Private::TierCompilerContext
+     */
+
+    TieredBuilder::Private::TierCompilerContext::TierCompilerContext(
+            TieredBuilder::Private*            newBuilder,
+            TieredBuilder::Tier                newTier,
+            unsigned long long                 newGeneration,
+            QSharedPointer<CppCompilerContext> newUserContext,
+            const QString&                     newObjectFile
+        ):CppCompilerContext(
+            newObjectFile,
+            newUserContext->sourceData()
+        ),builder(
+            newBuilder
+        ),tier(
+            newTier
+        ),generation(
+            newGeneration
+        ),userContext(
+            newUserContext
+        ) {
+        QMap<QString, QByteArray> virtualHeaders = newUserContext->virtualHeaders();
+        for (  QMap<QString, QByteArray>::const_iterator headerIterator    = virtualHeaders.constBegin(),
+                                                         headerEndIterator = virtualHeaders.constEnd()
+             ; headerIterator != headerEndIterator
+             ; ++headerIterator
+            ) {
+            addVirtualHeader(headerIterator.key(), headerIterator.value());
+        }
+    }
+
+
+    TieredBuilder::Private::TierCompilerContext::~TierCompilerContext() {}
+
+
+    void TieredBuilder::Private::TierCompilerContext::compilerStarted() {
+        if (tier == Tier::QUICK) {
+            userContext->compilerStarted();
+        }
+    }
+
+
+    void TieredBuilder::Private::TierCompilerContext::compilerFinished(bool success) {
+        if (tier == Tier::QUICK) {
+            userContext->setTiming(timing());
+            userContext->compilerFinished(success);
+        }
+
+        builder->compilerFinished(tier, generation, userContext, objectFile(), cancelled(), success);
+    }
+
+
+    void TieredBuilder::Private::TierCompilerContext::handleCompilerDiagnostic(
+            const CppCompilerDiagnostic& diagnostic
+        ) {
+        if (tier == Tier::QUICK) {
+            userContext->handleCompilerDiagnostic(diagnostic);
+        }
+    }
+
+    /*******************************************************************************************************************
+     * TieredBuilder::Private::TierLinkerContext
+     */
+
+    TieredBuilder::Private::TierLinkerContext::TierLinkerContext(
+            TieredBuilder::Private* newBuilder,
+            TieredBuilder::Tier     newTier,
+            unsigned long long      newGeneration,
+            const QString&          outputFile,
+            const QString&          objectFile
+        ):LinkerContext(
+            outputFile,
+            objectFile
+        ),builder(
+            newBuilder
+        ),tier(
+            newTier
+        ),generation(
+            newGeneration
+        ) {}
+
+
+    TieredBuilder::Private::TierLinkerContext::~TierLinkerContext() {}
+
+
+    void TieredBuilder::Private::TierLinkerContext::linkerFinished(bool success) {
+        builder->linkerFinished(tier, generation, outputFile(), objectFiles().first(), success);
+    }
+}
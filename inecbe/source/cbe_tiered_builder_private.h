@@ -0,0 +1,370 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the Cbe::TieredBuilder::Private class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef CBE_TIERED_BUILDER_PRIVATE_H
+#define CBE_TIERED_BUILDER_PRIVATE_H
+
+#include <QString>
+#include <QList>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QTemporaryDir>
+
+#include "cbe_common.h"
+#include "cbe_cpp_compiler.h"
+#include "cbe_cpp_compiler_context.h"
+#include "cbe_cpp_compiler_diagnostic.h"
+#include "cbe_linker_context.h"
+#include "cbe_dynamic_library_linker.h"
+#include "cbe_dynamic_library_loader.h"
+#include "cbe_tiered_builder.h"
+
+namespace Cbe {
+    class TieredBuilderNotifier;
+
+    /**
+     * Class that provides the implementation of the \ref Cbe::TieredBuilder class.
+     */
+    class CBE_PUBLIC_API TieredBuilder::Private {
+        public:
+            /**
+             * Constructor
+             *
+             * \param[in] newNotifier A pointer to the notifier instance this builder should send notification data
+             *                        to.  A null pointer will disable notifications.
+             */
+            Private(TieredBuilderNotifier* newNotifier);
+
+            ~Private();
+
+            /**
+             * Method you can use to change the notifier receiving notifications from this builder.
+             *
+             * \param[in] newNotifier A pointer to the notifier instance.
+             */
+            void setNotifier(TieredBuilderNotifier* newNotifier);
+
+            /**
+             * Method you can use to determine the current notifier receiving notifications from this builder.
+             *
+             * \return Returns a pointer to the notifier.
+             */
+            TieredBuilderNotifier* notifier() const;
+
+            /**
+             * Method you can use to access the compiler used to generate unoptimized libraries.
+             *
+             * \return Returns a reference to the quick compiler.
+             */
+            CppCompiler& quickCompiler();
+
+            /**
+             * Method you can use to access the compiler used to generate optimized libraries.
+             *
+             * \return Returns a reference to the optimizing compiler.
+             */
+            CppCompiler& optimizingCompiler();
+
+            /**
+             * Method you can use to access the linker used to generate the libraries.
+             *
+             * \return Returns a reference to the linker.
+             */
+            DynamicLibraryLinker& linker();
+
+            /**
+             * Method you can use to access the loader holding the most recently loaded library.
+             *
+             * \return Returns a reference to the loader.
+             */
+            DynamicLibraryLoader& loader();
+
+            /**
+             * Method you can use to unload every replaced library and remove the library files.
+             */
+            void releasePrevious();
+
+            /**
+             * Method you can use to start a tiered build.
+             *
+             * \param[in] context The context holding the source to be built.
+             */
+            void build(QSharedPointer<CppCompilerContext> context);
+
+            /**
+             * Method you can use to wait until all pending builds have been loaded or discarded.
+             */
+            void waitComplete();
+
+            /**
+             * Method you can use to determine if a library is loaded.
+             *
+             * \return Returns true if a library is loaded.
+             */
+            bool isLoaded() const;
+
+            /**
+             * Method you can use to determine the tier of the currently loaded library.
+             *
+             * \return Returns the tier of the currently loaded library.
+             */
+            Tier loadedTier() const;
+
+        private:
+            class TierCompilerContext;
+            class TierLinkerContext;
+
+            /**
+             * Method that is called when a tier has been compiled.  On success the object is linked and, for the
+             * quick tier, the optimized build is started.
+             *
+             * \param[in] tier        The tier that was compiled.
+             *
+             * \param[in] generation  The build generation.
+             *
+             * \param[in] userContext The context supplied to \ref TieredBuilder::build.
+             *
+             * \param[in] objectFile  The generated object file.
+             *
+             * \param[in] cancelled   Flag indicating if the build was cancelled.
+             *
+             * \param[in] success     Flag indicating if compilation succeeded.
+             */
+            void compilerFinished(
+                Tier                               tier,
+                unsigned long long                 generation,
+                QSharedPointer<CppCompilerContext> userContext,
+                const QString&                     objectFile,
+                bool                               cancelled,
+                bool                               success
+            );
+
+            /**
+             * Method that is called when a tier has been linked.  The library is loaded by a new loader if it is newer
+             * than the currently loaded library and replaces the current library only if it loads.
+             *
+             * \param[in] tier        The tier that was linked.
+             *
+             * \param[in] generation  The build generation.
+             *
+             * \param[in] libraryFile The generated library.
+             *
+             * \param[in] objectFile  The object file used to generate the library.
+             *
+             * \param[in] success     Flag indicating if linking succeeded.
+             */
+            void linkerFinished(
+                Tier               tier,
+                unsigned long long generation,
+                const QString&     libraryFile,
+                const QString&     objectFile,
+                bool               success
+            );
+
+            /**
+             * Method that generates the object file name for a build.
+             *
+             * \param[in] generation The build generation.
+             *
+             * \param[in] tier       The build tier.
+             *
+             * \return Returns the object file name.
+             */
+            QString objectFilename(unsigned long long generation, Tier tier) const;
+
+            /**
+             * Method that generates the library file name for a build.
+             *
+             * \param[in] generation The build generation.
+             *
+             * \param[in] tier       The build tier.
+             *
+             * \return Returns the library file name.
+             */
+            QString libraryFilename(unsigned long long generation, Tier tier) const;
+
+            /**
+             * The notifier receiving notifications from this builder.
+             */
+            TieredBuilderNotifier* currentNotifier;
+
+            /**
+             * Directory holding the generated objects and libraries.
+             */
+            QTemporaryDir workingDirectory;
+
+            /**
+             * Compiler used for the quick tier.
+             */
+            CppCompiler currentQuickCompiler;
+
+            /**
+             * Compiler used for the optimized tier.
+             */
+            CppCompiler currentOptimizingCompiler;
+
+            /**
+             * Linker used for both tiers.
+             */
+            DynamicLibraryLinker currentLinker;
+
+            /**
+             * Loader holding the most recently loaded library.
+             */
+            QSharedPointer<DynamicLibraryLoader> currentLoader;
+
+            /**
+             * Loaders holding replaced libraries.  The libraries remain loaded until released by the user.
+             */
+            QList<QSharedPointer<DynamicLibraryLoader>> previousLoaders;
+
+            /**
+             * Mutex used to serialize access to the build state from the compiler and linker threads.
+             */
+            mutable QMutex builderMutex;
+
+            /**
+             * The generation of the most recently requested build.
+             */
+            unsigned long long currentGeneration;
+
+            /**
+             * The generation of the currently loaded library.
+             */
+            unsigned long long loadedGeneration;
+
+            /**
+             * The tier of the currently loaded library.
+             */
+            Tier currentLoadedTier;
+
+            /**
+             * The optimized build for the current generation.  The build is cancelled if it is superseded.
+             */
+            QSharedPointer<CppCompilerContext> pendingOptimizedContext;
+    };
+
+    /**
+     * Compiler context used to build one tier.  Callbacks are forwarded to the builder and, for the quick tier, to the
+     * context supplied by the user.
+     */
+    class TieredBuilder::Private::TierCompilerContext:public CppCompilerContext {
+        public:
+            /**
+             * Constructor
+             *
+             * \param[in] newBuilder     The builder.
+             *
+             * \param[in] newTier        The tier being built.
+             *
+             * \param[in] newGeneration  The build generation.
+             *
+             * \param[in] newUserContext The context supplied by the user.
+             *
+             * \param[in] newObjectFile  The object file to be generated.
+             */
+            TierCompilerContext(
+                TieredBuilder::Private*            newBuilder,
+                Tier                               newTier,
+                unsigned long long                 newGeneration,
+                QSharedPointer<CppCompilerContext> newUserContext,
+                const QString&                     newObjectFile
+            );
+
+            ~TierCompilerContext() override;
+
+            /**
+             * Method that is called when the compiler is started.
+             */
+            void compilerStarted() override;
+
+            /**
+             * Method that is called when the compiler finishes.
+             *
+             * \param[in] success Holds true if the compiler completed successfully.
+             */
+            void compilerFinished(bool success) override;
+
+            /**
+             * Method that is called to report a compiler diagnostic.
+             *
+             * \param[in] diagnostic The reported diagnostic.
+             */
+            void handleCompilerDiagnostic(const CppCompilerDiagnostic& diagnostic) override;
+
+        private:
+            TieredBuilder::Private*            builder;
+            Tier                               tier;
+            unsigned long long                 generation;
+            QSharedPointer<CppCompilerContext> userContext;
+    };
+
+    /**
+     * Linker context used to link one tier.  Completion is forwarded to the builder.
+     */
+    class TieredBuilder::Private::TierLinkerContext:public LinkerContext {
+        public:
+            /**
+             * Constructor
+             *
+             * \param[in] newBuilder    The builder.
+             *
+             * \param[in] newTier       The tier being linked.
+             *
+             * \param[in] newGeneration The build generation.
+             *
+             * \param[in] outputFile    The library to be generated.
+             *
+             * \param[in] objectFile    The object file to be linked.
+             */
+            TierLinkerContext(
+                TieredBuilder::Private* newBuilder,
+                Tier                    newTier,
+                unsigned long long      newGeneration,
+                const QString&          outputFile,
+                const QString&          objectFile
+            );
+
+            ~TierLinkerContext() override;
+
+            /**
+             * Method that is called when the linker finishes.
+             *
+             * \param[in] success Holds true if the linker completed successfully.
+             */
+            void linkerFinished(bool success) override;
+
+        private:
+            TieredBuilder::Private* builder;
+            Tier                    tier;
+            unsigned long long      generation;
+    };
+};
+
+#endif
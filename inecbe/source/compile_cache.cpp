@@ -0,0 +1,475 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref CompileCache class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+#include <QDir>
+#include <QDirIterator>
+#include <QStringList>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QLockFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+#include <algorithm>
+
+#include "compile_cache.h"
+
+const quint32 CompileCache::manifestMagic           = 0x43424543; // "CBEC"
+const quint32 CompileCache::manifestVersion         = 1;
+const int     CompileCache::maximumManifestEntries  = 16;
+const double  CompileCache::evictionTargetFraction  = 0.9;
+const quint32 CompileCache::indexMagic              = 0x43424549; // "CBEI"
+const quint32 CompileCache::indexVersion            = 1;
+
+CompileCache::Dependency::Dependency() {
+    size         = -1;
+    lastModified = -1;
+}
+
+
+CompileCache::CompileCache(const QString& newDirectory, unsigned long long newMaximumSize) {
+    currentDirectory   = newDirectory;
+    currentMaximumSize = newMaximumSize;
+}
+
+
+CompileCache::~CompileCache() {}
+
+
+QString CompileCache::directory() const {
+    return currentDirectory;
+}
+
+
+unsigned long long CompileCache::maximumSize() const {
+    return currentMaximumSize;
+}
+
+
+QByteArray CompileCache::calculateLookupKey(const QByteArray& source, const QByteArray& commandLine) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+
+    hash.addData(QByteArray::number(source.size()));
+    hash.addData("\n", 1);
+    hash.addData(source);
+    hash.addData(QByteArray::number(commandLine.size()));
+    hash.addData("\n", 1);
+    hash.addData(commandLine);
+
+    return hash.result().toHex();
+}
+
+
+QByteArray CompileCache::lookup(const QByteArray& lookupKey) {
+    QByteArray   result;
+    QList<Entry> entries = readManifest(lookupKey);
+
+    QList<Entry>::const_iterator entryIterator    = entries.constBegin();
+    QList<Entry>::const_iterator entryEndIterator = entries.constEnd();
+    while (result.isNull() && entryIterator != entryEndIterator) {
+        const Entry& entry     = *entryIterator;
+        bool         unchanged = true;
+
+        QList<Dependency>::const_iterator dependencyIterator    = entry.dependencies.constBegin();
+        QList<Dependency>::const_iterator dependencyEndIterator = entry.dependencies.constEnd();
+        while (unchanged && dependencyIterator != dependencyEndIterator) {
+            unchanged = dependencyUnchanged(*dependencyIterator);
+            ++dependencyIterator;
+        }
+
+        if (unchanged) {
+            QFile objectFile(cacheFilename(entry.objectKey, QString(".o")));
+            if (objectFile.open(QFile::ReadOnly)) {
+                QByteArray objectData = objectFile.readAll();
+                objectFile.close();
+
+                if (!objectData.isEmpty()) {
+                    // Objects are evicted oldest first by modification time so we touch the object on every hit.
+                    if (objectFile.open(QFile::ReadWrite)) {
+                        objectFile.setFileTime(QDateTime::currentDateTimeUtc(), QFile::FileModificationTime);
+                        objectFile.close();
+                    }
+
+                    result = objectData;
+                }
+            }
+        }
+
+        ++entryIterator;
+    }
+
+    return result;
+}
+
+
+bool CompileCache::store(
+        const QByteArray&     lookupKey,
+        const QList<QString>& dependencies,
+        const QByteArray&     objectData
+    ) {
+    bool success = !objectData.isEmpty();
+
+    unsigned long long addedSize = 0;
+    Entry              entry;
+    QCryptographicHash objectHash(QCryptographicHash::Sha256);
+    objectHash.addData(lookupKey);
+
+    QList<QString>::const_iterator filenameIterator    = dependencies.constBegin();
+    QList<QString>::const_iterator filenameEndIterator = dependencies.constEnd();
+    while (success && filenameIterator != filenameEndIterator) {
+        QFileInfo  fileInformation(*filenameIterator);
+        Dependency dependency;
+
+        dependency.filename     = *filenameIterator;
+        dependency.size         = fileInformation.size();
+        dependency.lastModified = fileInformation.lastModified().toMSecsSinceEpoch();
+        dependency.contentHash  = hashFile(dependency.filename);
+
+        if (dependency.contentHash.isNull()) {
+            success = false;
+        } else {
+            objectHash.addData(dependency.filename.toUtf8());
+            objectHash.addData("\n", 1);
+            objectHash.addData(dependency.contentHash);
+
+            entry.dependencies.append(dependency);
+        }
+
+        ++filenameIterator;
+    }
+
+    if (success) {
+        entry.objectKey = objectHash.result().toHex();
+
+        QString objectFilename = cacheFilename(entry.objectKey, QString(".o"));
+        success = QDir().mkpath(QFileInfo(objectFilename).absolutePath());
+
+        if (success && !QFileInfo(objectFilename).exists()) {
+            QSaveFile objectFile(objectFilename);
+            success = (
+                   objectFile.open(QFile::WriteOnly)
+                && objectFile.write(objectData) == objectData.size()
+                && objectFile.commit()
+            );
+
+            if (success) {
+                addedSize = static_cast<unsigned long long>(objectData.size());
+            }
+        }
+    }
+
+    if (success) {
+        QLockFile lockFile(currentDirectory + QString("/lock"));
+        success = lockFile.lock();
+
+        if (success) {
+            QList<Entry> entries = readManifest(lookupKey);
+
+            QList<Entry>::iterator entryIterator = entries.begin();
+            while (entryIterator != entries.end()) {
+                if (entryIterator->objectKey == entry.objectKey) {
+                    entryIterator = entries.erase(entryIterator);
+                } else {
+                    ++entryIterator;
+                }
+            }
+
+            entries.prepend(entry);
+            while (entries.size() > maximumManifestEntries) {
+                entries.removeLast();
+            }
+
+            success = writeManifest(lookupKey, entries);
+
+            // Two processes storing the same object can both count it.  Over counting only brings the next scan
+            // forward; the scan recalculates the total from the objects actually present.
+            unsigned long long totalSize;
+            if (!readIndex(totalSize) || totalSize + addedSize > currentMaximumSize) {
+                totalSize = evict();
+            } else {
+                totalSize += addedSize;
+            }
+
+            writeIndex(totalSize);
+
+            lockFile.unlock();
+        }
+    }
+
+    return success;
+}
+
+
+QString CompileCache::cacheFilename(const QByteArray& key, const QString& extension) const {
+    QString keyString = QString::fromLatin1(key);
+    return QString("%1/%2/%3%4").arg(currentDirectory, keyString.left(2), keyString, extension);
+}
+
+
+QByteArray CompileCache::hashFile(const QString& filename) {
+    QByteArray result;
+    QFile      file(filename);
+
+    if (file.open(QFile::ReadOnly)) {
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+        if (hash.addData(&file)) {
+            result = hash.result();
+        }
+
+        file.close();
+    }
+
+    return result;
+}
+
+
+bool CompileCache::dependencyUnchanged(const Dependency& dependency) {
+    bool      result;
+    QFileInfo fileInformation(dependency.filename);
+
+    if (!fileInformation.exists() || fileInformation.size() != dependency.size) {
+        result = false;
+    } else if (fileInformation.lastModified().toMSecsSinceEpoch() == dependency.lastModified) {
+        result = true;
+    } else {
+        // The file was touched but may be unchanged.  Fall back to the contents.
+        result = (hashFile(dependency.filename) == dependency.contentHash);
+    }
+
+    return result;
+}
+
+
+QList<CompileCache::Entry> CompileCache::readManifest(const QByteArray& lookupKey) const {
+    QList<Entry> entries;
+    QFile        manifestFile(cacheFilename(lookupKey, QString(".manifest")));
+
+    if (manifestFile.open(QFile::ReadOnly)) {
+        QDataStream stream(&manifestFile);
+        stream.setVersion(QDataStream::Qt_5_0);
+
+        quint32 magic;
+        quint32 version;
+        quint32 numberEntries;
+        stream >> magic >> version >> numberEntries;
+
+        if (magic == manifestMagic && version == manifestVersion && stream.status() == QDataStream::Ok) {
+            for (quint32 entryIndex=0 ; entryIndex<numberEntries && stream.status() == QDataStream::Ok ; ++entryIndex) {
+                Entry   entry;
+                quint32 numberDependencies;
+                stream >> entry.objectKey >> numberDependencies;
+
+                for (  quint32 dependencyIndex = 0
+                     ; dependencyIndex < numberDependencies && stream.status() == QDataStream::Ok
+                     ; ++dependencyIndex
+                    ) {
+                    Dependency dependency;
+                    stream >> dependency.filename
+                           >> dependency.size
+                           >> dependency.lastModified
+                           >> dependency.contentHash;
+
+                    entry.dependencies.append(dependency);
+                }
+
+                entries.append(entry);
+            }
+
+            if (stream.status() != QDataStream::Ok) {
+                entries.clear();
+            }
+        }
+
+        manifestFile.close();
+    }
+
+    return entries;
+}
+
+
+bool CompileCache::writeManifest(const QByteArray& lookupKey, const QList<Entry>& entries) const {
+    QString manifestFilename = cacheFilename(lookupKey, QString(".manifest"));
+    bool    success          = QDir().mkpath(QFileInfo(manifestFilename).absolutePath());
+
+    if (success) {
+        QSaveFile manifestFile(manifestFilename);
+        success = manifestFile.open(QFile::WriteOnly);
+
+        if (success) {
+            QDataStream stream(&manifestFile);
+            stream.setVersion(QDataStream::Qt_5_0);
+
+            stream << manifestMagic << manifestVersion << static_cast<quint32>(entries.size());
+
+            for (  QList<Entry>::const_iterator entryIterator    = entries.constBegin(),
+                                                entryEndIterator = entries.constEnd()
+                 ; entryIterator != entryEndIterator
+                 ; ++entryIterator
+                ) {
+                stream << entryIterator->objectKey << static_cast<quint32>(entryIterator->dependencies.size());
+
+                for (  QList<Dependency>::const_iterator dependencyIterator    = entryIterator->dependencies.constBegin(),
+                                                         dependencyEndIterator = entryIterator->dependencies.constEnd()
+                     ; dependencyIterator != dependencyEndIterator
+                     ; ++dependencyIterator
+                    ) {
+                    stream << dependencyIterator->filename
+                           << dependencyIterator->size
+                           << dependencyIterator->lastModified
+                           << dependencyIterator->contentHash;
+                }
+            }
+
+            success = (stream.status() == QDataStream::Ok && manifestFile.commit());
+        }
+    }
+
+    return success;
+}
+
+
+bool CompileCache::readIndex(unsigned long long& totalSize) const {
+    bool  success = false;
+    QFile indexFile(currentDirectory + QString("/index"));
+
+    if (indexFile.open(QFile::ReadOnly)) {
+        QDataStream stream(&indexFile);
+        stream.setVersion(QDataStream::Qt_5_0);
+
+        quint32 magic;
+        quint32 version;
+        quint64 size;
+        stream >> magic >> version >> size;
+
+        if (magic == indexMagic && version == indexVersion && stream.status() == QDataStream::Ok) {
+            totalSize = static_cast<unsigned long long>(size);
+            success   = true;
+        }
+
+        indexFile.close();
+    }
+
+    return success;
+}
+
+
+bool CompileCache::writeIndex(unsigned long long totalSize) const {
+    QSaveFile indexFile(currentDirectory + QString("/index"));
+    bool      success = indexFile.open(QFile::WriteOnly);
+
+    if (success) {
+        QDataStream stream(&indexFile);
+        stream.setVersion(QDataStream::Qt_5_0);
+
+        stream << indexMagic << indexVersion << static_cast<quint64>(totalSize);
+        success = (stream.status() == QDataStream::Ok && indexFile.commit());
+    }
+
+    return success;
+}
+
+
+unsigned long long CompileCache::evict() {
+    QList<QFileInfo>   objects;
+    unsigned long long totalSize = 0;
+
+    QDirIterator objectIterator(
+        currentDirectory,
+        QStringList() << QString("*.o"),
+        QDir::Files,
+        QDirIterator::Subdirectories
+    );
+
+    while (objectIterator.hasNext()) {
+        objectIterator.next();
+        QFileInfo fileInformation = objectIterator.fileInfo();
+
+        objects.append(fileInformation);
+        totalSize += static_cast<unsigned long long>(fileInformation.size());
+    }
+
+    if (totalSize > currentMaximumSize) {
+        std::sort(
+            objects.begin(),
+            objects.end(),
+            [](const QFileInfo& a, const QFileInfo& b) {
+                return a.lastModified() < b.lastModified();
+            }
+        );
+
+        unsigned long long targetSize = static_cast<unsigned long long>(currentMaximumSize * evictionTargetFraction);
+
+        bool removedObjects = false;
+
+        // Manifest entries referencing evicted objects are left in place; lookup treats a missing object as a miss.
+        QList<QFileInfo>::const_iterator fileIterator    = objects.constBegin();
+        QList<QFileInfo>::const_iterator fileEndIterator = objects.constEnd();
+        while (totalSize > targetSize && fileIterator != fileEndIterator) {
+            if (QFile::remove(fileIterator->absoluteFilePath())) {
+                totalSize      -= static_cast<unsigned long long>(fileIterator->size());
+                removedObjects  = true;
+            }
+
+            ++fileIterator;
+        }
+
+        if (removedObjects) {
+            QDirIterator manifestIterator(
+                currentDirectory,
+                QStringList() << QString("*.manifest"),
+                QDir::Files,
+                QDirIterator::Subdirectories
+            );
+
+            while (manifestIterator.hasNext()) {
+                manifestIterator.next();
+
+                QByteArray   lookupKey = manifestIterator.fileInfo().completeBaseName().toLatin1();
+                QList<Entry> entries   = readManifest(lookupKey);
+                bool         orphaned  = true;
+
+                QList<Entry>::const_iterator entryIterator    = entries.constBegin();
+                QList<Entry>::const_iterator entryEndIterator = entries.constEnd();
+                while (orphaned && entryIterator != entryEndIterator) {
+                    orphaned = !QFileInfo(cacheFilename(entryIterator->objectKey, QString(".o"))).exists();
+                    ++entryIterator;
+                }
+
+                if (orphaned) {
+                    QFile::remove(manifestIterator.filePath());
+                }
+            }
+        }
+    }
+
+    return totalSize;
+}
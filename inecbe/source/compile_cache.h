@@ -0,0 +1,274 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref CompileCache class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+
+/**
+ * Content addressed cache of compiled objects.  The cache is modelled on the "direct mode" used by ccache:
+ *
+ *     * A lookup key is calculated from the source and the effective compiler command line.
+ *
+ *     * Each lookup key has a manifest listing previously compiled results along with every file the compilation
+ *       depended on and a hash of each file's contents.  A result is used only if all of its dependencies are
+ *       unchanged.
+ *
+ * Files are written atomically and manifest updates and eviction are serialized using a lock file so several
+ * processes on a host can safely share a cache directory.  A running total of the object sizes is kept in an index
+ * file, updated under the same lock, so the cache directory is only scanned once the total exceeds the maximum size.
+ * The least recently used objects are then evicted, along with any manifest whose objects were all evicted.
+ */
+class CompileCache {
+    public:
+        /**
+         * Constructor
+         *
+         * \param[in] newDirectory   The directory holding the cache.  The directory will be created if needed.
+         *
+         * \param[in] newMaximumSize The maximum size of the cached objects, in bytes.
+         */
+        CompileCache(const QString& newDirectory, unsigned long long newMaximumSize);
+
+        ~CompileCache();
+
+        /**
+         * Method you can use to determine the cache directory.
+         *
+         * \return Returns the cache directory.
+         */
+        QString directory() const;
+
+        /**
+         * Method you can use to determine the maximum cache size.
+         *
+         * \return Returns the maximum size of the cached objects, in bytes.
+         */
+        unsigned long long maximumSize() const;
+
+        /**
+         * Method that calculates a lookup key.
+         *
+         * \param[in] source      The source being compiled.
+         *
+         * \param[in] commandLine A serialized form of the effective compiler command line and configuration.
+         *
+         * \return Returns the lookup key as a hexadecimal string.
+         */
+        static QByteArray calculateLookupKey(const QByteArray& source, const QByteArray& commandLine);
+
+        /**
+         * Method that locates a cached object.
+         *
+         * \param[in] lookupKey The lookup key calculated by \ref CompileCache::calculateLookupKey.
+         *
+         * \return Returns the cached object.  A null byte array is returned on a cache miss.
+         */
+        QByteArray lookup(const QByteArray& lookupKey);
+
+        /**
+         * Method that adds an object to the cache.
+         *
+         * \param[in] lookupKey    The lookup key calculated by \ref CompileCache::calculateLookupKey.
+         *
+         * \param[in] dependencies The files the compilation depended on, excluding the source itself.
+         *
+         * \param[in] objectData   The generated object.
+         *
+         * \return Returns true on success, returns false on error.
+         */
+        bool store(const QByteArray& lookupKey, const QList<QString>& dependencies, const QByteArray& objectData);
+
+    private:
+        /**
+         * Value placed at the start of every manifest.
+         */
+        static const quint32 manifestMagic;
+
+        /**
+         * Manifest format version.
+         */
+        static const quint32 manifestVersion;
+
+        /**
+         * The maximum number of results tracked per manifest.
+         */
+        static const int maximumManifestEntries;
+
+        /**
+         * The fraction of the maximum size to trim the cache to when evicting objects.
+         */
+        static const double evictionTargetFraction;
+
+        /**
+         * Value placed at the start of the index file.
+         */
+        static const quint32 indexMagic;
+
+        /**
+         * Index file format version.
+         */
+        static const quint32 indexVersion;
+
+        /**
+         * Class that tracks a single dependency in a manifest.
+         */
+        class Dependency {
+            public:
+                Dependency();
+
+                /**
+                 * The dependency's filename.
+                 */
+                QString filename;
+
+                /**
+                 * The dependency's size, in bytes, when the result was stored.
+                 */
+                qint64 size;
+
+                /**
+                 * The dependency's modification time, in mSec since the epoch, when the result was stored.
+                 */
+                qint64 lastModified;
+
+                /**
+                 * The hash of the dependency's contents when the result was stored.
+                 */
+                QByteArray contentHash;
+        };
+
+        /**
+         * Class that tracks a single result in a manifest.
+         */
+        class Entry {
+            public:
+                /**
+                 * The key used to locate the cached object.
+                 */
+                QByteArray objectKey;
+
+                /**
+                 * The dependencies of the result.
+                 */
+                QList<Dependency> dependencies;
+        };
+
+        /**
+         * Method that determines the path to a file in the cache.
+         *
+         * \param[in] key       The key of the file.
+         *
+         * \param[in] extension The file extension, including the leading period.
+         *
+         * \return Returns the absolute path to the file.
+         */
+        QString cacheFilename(const QByteArray& key, const QString& extension) const;
+
+        /**
+         * Method that calculates the hash of a file's contents.
+         *
+         * \param[in] filename The file to be hashed.
+         *
+         * \return Returns the hash.  A null byte array is returned if the file can not be read.
+         */
+        static QByteArray hashFile(const QString& filename);
+
+        /**
+         * Method that determines if a dependency is unchanged.
+         *
+         * \param[in] dependency The dependency to be checked.
+         *
+         * \return Returns true if the dependency is unchanged.
+         */
+        static bool dependencyUnchanged(const Dependency& dependency);
+
+        /**
+         * Method that reads a manifest.
+         *
+         * \param[in] lookupKey The lookup key of the manifest.
+         *
+         * \return Returns the manifest entries, newest first.  An empty list is returned if the manifest is missing or
+         *         invalid.
+         */
+        QList<Entry> readManifest(const QByteArray& lookupKey) const;
+
+        /**
+         * Method that writes a manifest.
+         *
+         * \param[in] lookupKey The lookup key of the manifest.
+         *
+         * \param[in] entries   The manifest entries, newest first.
+         *
+         * \return Returns true on success, returns false on error.
+         */
+        bool writeManifest(const QByteArray& lookupKey, const QList<Entry>& entries) const;
+
+        /**
+         * Method that reads the running total of the object sizes from the index file.
+         *
+         * \param[out] totalSize The total size of the cached objects, in bytes.
+         *
+         * \return Returns true on success.  Returns false if the index file is missing or invalid.
+         */
+        bool readIndex(unsigned long long& totalSize) const;
+
+        /**
+         * Method that writes the running total of the object sizes to the index file.
+         *
+         * \param[in] totalSize The total size of the cached objects, in bytes.
+         *
+         * \return Returns true on success, returns false on error.
+         */
+        bool writeIndex(unsigned long long totalSize) const;
+
+        /**
+         * Method that scans the cache and removes the least recently used objects until the cache is below its
+         * maximum size.  Manifests whose objects were all removed are also removed.  The cache lock must be held by
+         * the caller.
+         *
+         * \return Returns the total size of the remaining objects, in bytes.
+         */
+        unsigned long long evict();
+
+        /**
+         * The cache directory.
+         */
+        QString currentDirectory;
+
+        /**
+         * The maximum cache size, in bytes.
+         */
+        unsigned long long currentMaximumSize;
+};
+
+#endif
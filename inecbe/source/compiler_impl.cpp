@@ -27,20 +27,29 @@
 
 #include <QString>
 #include <QList>
+#include <QMap>
 #include <QSet>
 #include <QThread>
 #include <QScopedPointer>
-#include <QTemporaryFile>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QStringList>
+#include <QCryptographicHash>
 #include <QCoreApplication>
+#include <QReadWriteLock>
 
 #include <QDebug> // Debug
 
 #include <memory>
 #include <string>
 #include <cstring>
+#include <vector>
+#include <algorithm>
 #include <system_error>
 
 #include "warnings.h"
@@ -53,10 +62,15 @@ SUPPRESS_LLVM_WARNINGS
 #include <clang/Basic/DiagnosticOptions.h>
 #include <clang/Basic/LangOptions.h>
 #include <clang/Basic/TargetOptions.h>
+#include <clang/Basic/CodeGenOptions.h>
 #include <clang/Basic/FileManager.h>
 #include <clang/Basic/SourceManager.h>
 #include <clang/Basic/SourceLocation.h>
+#include <clang/Basic/Version.h>
 #include <clang/Frontend/CompilerInvocation.h>
+#include <clang/Frontend/FrontendAction.h>
+#include <clang/Frontend/PrecompiledPreamble.h>
+#include <clang/Lex/Lexer.h>
 #include <clang/FrontendTool/Utils.h>
 #include <clang/Lex/PreprocessorOptions.h>
 #include <clang/Driver/Driver.h>
@@ -67,6 +81,12 @@ SUPPRESS_LLVM_WARNINGS
 #include <clang/CodeGen/ObjectFilePCHContainerOperations.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/Host.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/VirtualFileSystem.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/PassRegistry.h>
 #include <llvm/ADT/APInt.h>
@@ -77,20 +97,40 @@ RESTORE_LLVM_WARNINGS
 #include "cbe_compiler_context.h"
 #include "cbe_job_queue.h"
 #include "diagnostic_consumer.h"
+#include "dependency_collector.h"
+#include "masked_file_system.h"
+#include "compile_cache.h"
+#include "phase_timer.h"
+#include "instrumented_action.h"
+#include "worker_protocol.h"
+#include "worker_process.h"
 #include "cbe_compiler_notifier.h"
+#include "cbe_compiler_worker.h"
 #include "compiler_impl.h"
 
-const unsigned long CompilerImpl::requiredStackSpace = 512 * 1024;
+const unsigned long      CompilerImpl::requiredStackSpace             = 512 * 1024;
+const unsigned long long CompilerImpl::defaultCompileCacheMaximumSize = 1024ULL * 1024ULL * 1024ULL;
 
 bool CompilerImpl::backendInitializationNeeded = true;
+
+Cbe::Compiler::TargetInitialization CompilerImpl::currentTargetInitialization =
+    Cbe::Compiler::TargetInitialization::ALL;
+
+QList<QString> CompilerImpl::currentInitialTargets;
+QMutex         CompilerImpl::targetInitializationMutex;
+bool           CompilerImpl::allTargetsInitialized = false;
+QSet<QString>  CompilerImpl::initializedTargets;
 QSet<CompilerImpl*> CompilerImpl::compilers;
+QReadWriteLock      CompilerImpl::timeTraceLock;
 
 CompilerImpl::CompilerImpl(
         Cbe::CompilerNotifier* newNotifier
     ):jobQueue(
         new Cbe::SimpleJobQueue<Cbe::CompilerContext>()
-    ),temporaryInputFile(
-        QDir::tempPath() + "/Inesonic." + QCoreApplication::applicationName() + ".XXXXXX"
+    ),jobQueueMutex(
+        new QMutex
+    ),inMemoryFileSystem(
+        new llvm::vfs::InMemoryFileSystem
     ),mainFileEntry(
         std::error_code()
     ),currentNotifier(
@@ -99,11 +139,43 @@ CompilerImpl::CompilerImpl(
     setStackSize(requiredStackSpace);
     configureCompilerBackend();
 
+    // The main file and virtual headers live under a fixed directory name so the command line, and therefore the
+    // compile cache keys, stay identical across compilers and processes.  The directory is masked in the real file
+    // system so nothing under it can be read from disk; files placed in a like named directory on disk, such as one
+    // created under the shared temporary directory, can never shadow a header.
+    virtualHeaderDirectory = QDir::temp().absoluteFilePath("inecbe.virtual");
+    mainFilename           = (virtualHeaderDirectory + "/inecbe_main.cpp").toLocal8Bit();
+
+    overlayFileSystem = new llvm::vfs::OverlayFileSystem(
+        new MaskedFileSystem(llvm::vfs::getRealFileSystem(), virtualHeaderDirectory.toLocal8Bit().toStdString())
+    );
+
+    inMemoryFileSystem->addFile(
+        llvm::StringRef(mainFilename.constData()),
+        0,
+        llvm::MemoryBuffer::getMemBuffer(llvm::StringRef())
+    );
+    overlayFileSystem->pushOverlay(inMemoryFileSystem);
+
     currentSystemRoot = QString("/");
 
     generateDefaultSwitches = true;
     isTerminatingThread = false;
+    warmUpRequested = false;
+    virtualHeaderDirectoryIncluded = false;
     currentDebugOutputEnabled = false;
+    currentAutomaticPchEnabled = false;
+    automaticPchLoadFailed = false;
+    currentModulesEnabled = false;
+    currentCompileCacheEnabled = false;
+    currentCompileCacheMaximumSize = defaultCompileCacheMaximumSize;
+    currentCompileCacheHits = 0;
+    currentCompileCacheMisses = 0;
+    currentPreambleReuseEnabled = true;
+    preambleApplicable = false;
+    currentThreadPriority = QThread::InheritPriority;
+    currentWorkerProcessEnabled = false;
+    workerRestartNeeded = false;
 
     compilers.insert(this);
 }
@@ -112,6 +184,7 @@ CompilerImpl::CompilerImpl(
 CompilerImpl::~CompilerImpl() {
     clearUserFriendlyCommandLine();
     waitComplete();
+    workerProcess.reset();
     compilers.remove(this);
 }
 
@@ -138,21 +211,55 @@ Cbe::CompilerNotifier* CompilerImpl::notifier() const {
 
 
 void CompilerImpl::setJobQueue(QSharedPointer<Cbe::JobQueue<Cbe::CompilerContext>> newJobQueue) {
+    setJobQueue(newJobQueue, QSharedPointer<QMutex>(new QMutex));
+}
+
+
+void CompilerImpl::setJobQueue(
+        QSharedPointer<Cbe::JobQueue<Cbe::CompilerContext>> newJobQueue,
+        QSharedPointer<QMutex>                              newJobQueueMutex
+    ) {
     QMutexLocker mutexLocker(&compilerAccessMutex);
-    jobQueue = newJobQueue;
+
+    jobQueue      = newJobQueue;
+    jobQueueMutex = newJobQueueMutex;
 }
 
 
 bool CompilerImpl::isInternal() const {
-    return true;
+    return !currentWorkerProcessEnabled;
+}
+
+
+void CompilerImpl::setWorkerProcessEnabled(bool nowEnabled) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+    currentWorkerProcessEnabled = nowEnabled;
+}
+
+
+bool CompilerImpl::workerProcessEnabled() const {
+    return currentWorkerProcessEnabled;
 }
 
 
-void CompilerImpl::setExecutableDirectory(const QString&) {}
+void CompilerImpl::setExecutableDirectory(const QString& newExecutableDirectory) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentExecutableDirectory = newExecutableDirectory;
+    workerRestartNeeded = true;
+}
 
 
 QString CompilerImpl::executableDirectory() const {
-    return QString();
+    QString result;
+
+    if (currentExecutableDirectory.isEmpty()) {
+        result = QCoreApplication::applicationDirPath();
+    } else {
+        result = currentExecutableDirectory;
+    }
+
+    return result;
 }
 
 
@@ -233,6 +340,20 @@ void CompilerImpl::setPrecompiledHeaders(const QList<QString>& newPrecompiledHea
 }
 
 
+QList<QString> CompilerImpl::runtimeBitcodeModules() const {
+    return currentRuntimeBitcodeModules;
+}
+
+
+void CompilerImpl::setRuntimeBitcodeModules(const QList<QString>& newRuntimeBitcodeModules) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentRuntimeBitcodeModules = newRuntimeBitcodeModules;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
 QString CompilerImpl::resourceDirectory() const {
     return currentResourceDirectory;
 }
@@ -275,10 +396,187 @@ void CompilerImpl::setTargetTriple(const QString& newTargetTriple) {
 }
 
 
+void CompilerImpl::setAutomaticPchEnabled(bool nowEnabled) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentAutomaticPchEnabled = nowEnabled;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
+bool CompilerImpl::automaticPchEnabled() const {
+    return currentAutomaticPchEnabled;
+}
+
+
+void CompilerImpl::setPchCacheDirectory(const QString& newPchCacheDirectory) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentPchCacheDirectory = newPchCacheDirectory;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
+QString CompilerImpl::pchCacheDirectory() const {
+    QString result;
+
+    if (currentPchCacheDirectory.isEmpty()) {
+        result = QDir::tempPath() + "/Inesonic." + QCoreApplication::applicationName() + ".pch";
+    } else {
+        result = currentPchCacheDirectory;
+    }
+
+    return result;
+}
+
+
+void CompilerImpl::setModulesEnabled(bool nowEnabled) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentModulesEnabled = nowEnabled;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
+bool CompilerImpl::modulesEnabled() const {
+    return currentModulesEnabled;
+}
+
+
+void CompilerImpl::setModuleCacheDirectory(const QString& newModuleCacheDirectory) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentModuleCacheDirectory = newModuleCacheDirectory;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
+QString CompilerImpl::moduleCacheDirectory() const {
+    QString result;
+
+    if (currentModuleCacheDirectory.isEmpty()) {
+        result = QDir::tempPath() + "/Inesonic." + QCoreApplication::applicationName() + ".modules";
+    } else {
+        result = currentModuleCacheDirectory;
+    }
+
+    return result;
+}
+
+
+void CompilerImpl::setCompileCacheEnabled(bool nowEnabled) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentCompileCacheEnabled = nowEnabled;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
+bool CompilerImpl::compileCacheEnabled() const {
+    return currentCompileCacheEnabled;
+}
+
+
+void CompilerImpl::setCompileCacheDirectory(const QString& newCompileCacheDirectory) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentCompileCacheDirectory = newCompileCacheDirectory;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
+QString CompilerImpl::compileCacheDirectory() const {
+    QString result;
+
+    if (currentCompileCacheDirectory.isEmpty()) {
+        result = QDir::tempPath() + "/Inesonic.inecbe.cache";
+    } else {
+        result = currentCompileCacheDirectory;
+    }
+
+    return result;
+}
+
+
+void CompilerImpl::setCompileCacheMaximumSize(unsigned long long newMaximumSize) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentCompileCacheMaximumSize = newMaximumSize;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
+unsigned long long CompilerImpl::compileCacheMaximumSize() const {
+    return currentCompileCacheMaximumSize;
+}
+
+
+unsigned long long CompilerImpl::compileCacheHits() const {
+    return currentCompileCacheHits;
+}
+
+
+unsigned long long CompilerImpl::compileCacheMisses() const {
+    return currentCompileCacheMisses;
+}
+
+
+void CompilerImpl::setPreambleReuseEnabled(bool nowEnabled) {
+    QMutexLocker mutexLocker(&compilerAccessMutex);
+
+    currentPreambleReuseEnabled = nowEnabled;
+    compilerInstance.reset();
+    diagnosticsEngine.reset();
+}
+
+
+bool CompilerImpl::preambleReuseEnabled() const {
+    return currentPreambleReuseEnabled;
+}
+
+
+void CompilerImpl::setThreadPriority(QThread::Priority newThreadPriority) {
+    currentThreadPriority = newThreadPriority;
+
+    if (isRunning()) {
+        setPriority(newThreadPriority);
+    }
+}
+
+
+QThread::Priority CompilerImpl::threadPriority() const {
+    return currentThreadPriority;
+}
+
+
 void CompilerImpl::compile(QSharedPointer<Cbe::CompilerContext> context) {
-    jobQueueMutex.lock();
-    jobQueue->enqueue(context);
-    jobQueueMutex.unlock();
+    // Contexts may build their source in chunks.  We flatten the source here, on the submitting thread, so the copy is
+    // paid by the caller rather than the compiler thread.  Flattening is thread safe so this is an optimization only.
+    context->sourceData();
+
+    if (jobQueue->threadSafe()) {
+        jobQueue->enqueue(context);
+    } else {
+        jobQueueMutex->lock();
+        jobQueue->enqueue(context);
+        jobQueueMutex->unlock();
+    }
+
+    jobQueue->deliverNotifications();
+
+    startIfIdle();
+}
+
+
+bool CompilerImpl::startIfIdle() {
+    bool started = false;
 
     // The background thread might check the queue right before we enqueue a new job and then attempt to terminate.  We
     // use the isTerminatingThread sentinel to work around this race condition.
@@ -287,8 +585,35 @@ void CompilerImpl::compile(QSharedPointer<Cbe::CompilerContext> context) {
     }
 
     if (!isRunning()) {
-        start();
+        start(currentThreadPriority);
+        started = true;
+    }
+
+    return started;
+}
+
+
+void CompilerImpl::enqueueBatchJobs(const QList<QSharedPointer<Cbe::CompilerContext>>& jobs) {
+    for (  QList<QSharedPointer<Cbe::CompilerContext>>::const_iterator jobIterator    = jobs.constBegin(),
+                                                                       jobEndIterator = jobs.constEnd()
+         ; jobIterator != jobEndIterator
+         ; ++jobIterator
+        ) {
+        // See CompilerImpl::compile.
+        (*jobIterator)->sourceData();
     }
+
+    batchJobsMutex.lock();
+    batchJobs += jobs;
+    batchJobsMutex.unlock();
+
+    startIfIdle();
+}
+
+
+void CompilerImpl::warmUp() {
+    warmUpRequested = true;
+    startIfIdle();
 }
 
 
@@ -355,8 +680,14 @@ void CompilerImpl::reportDiagnostic(
     }
 
     QString filename;
-    if (!badBuffer && QString(rawFilename) != temporaryInputFile.fileName()) {
+    if (!badBuffer && QString(rawFilename) != QString::fromLocal8Bit(mainFilename)) {
         filename = QString(rawFilename);
+
+        // Virtual headers are reported using the name supplied by the context.
+        QString virtualHeaderPrefix = virtualHeaderDirectory + "/";
+        if (filename.startsWith(virtualHeaderPrefix)) {
+            filename = filename.mid(virtualHeaderPrefix.size());
+        }
     }
 
     llvm::SmallString<100> messageBuffer;
@@ -364,6 +695,16 @@ void CompilerImpl::reportDiagnostic(
     QString diagnosticMessage = QString(messageBuffer.c_str());
 
     Cbe::CompilerDiagnostic::Code diagnosticCode = diagnosticInformation.getID();
+
+    // Errors from clang's serialization component indicate that a precompiled header could not be loaded.  The preamble
+    // is never used alongside the automatic precompiled header so the error can only apply to it.
+    if (diagnosticLevel >= clang::DiagnosticsEngine::Error      &&
+        diagnosticCode >= clang::diag::DIAG_START_SERIALIZATION &&
+        diagnosticCode < clang::diag::DIAG_START_LEX            &&
+        !currentAutomaticPchFile.isEmpty()                         ) {
+        automaticPchLoadFailed = true;
+    }
+
     currentDiagnostics.append(
         DiagnosticData(
             reportedLevel,
@@ -382,14 +723,56 @@ void CompilerImpl::run() {
     QMutexLocker mutexLocker(&compilerAccessMutex);
 
     do {
-        jobQueueMutex.lock();
-        activeContext = jobQueue->dequeue();
-        isTerminatingThread = activeContext.isNull();
-        jobQueueMutex.unlock();
+        if (warmUpRequested.exchange(false)) {
+            warmUpCompiler();
+        }
+
+        activeContext = dequeueJob();
+
+        phaseTimer.reset();
+        phaseTimer.enter(Cbe::CompilerTiming::Phase::PREPARATION);
+
+        if (!workerProcess.isNull() && (workerRestartNeeded || !currentWorkerProcessEnabled)) {
+            workerProcess.reset();
+        }
+
+        workerRestartNeeded = false;
+
+        if (!isTerminatingThread && activeContext->cancelled()) {
+            // Contexts cancelled while queued are reported without invoking the compiler.
+            activeContext->setTiming(Cbe::CompilerTiming());
+            compilerStarted(activeContext);
+            compilerFinished(activeContext, false);
+
+            activeContext.clear();
+        } else if (!isTerminatingThread && currentWorkerProcessEnabled) {
+            compileInWorkerProcess();
+            activeContext.clear();
+        } else if (!isTerminatingThread) {
+            QMap<QString, QByteArray> virtualHeaders = activeContext->virtualHeaders();
+
+            // Clang may record time trace events while building PCH files and preambles so the lock is held for the
+            // entire job.
+            bool timeTraceRequested = (
+                activeContext->timeTraceDestination() != Cbe::CompilerContext::TimeTraceDestination::NONE
+            );
+
+            if (timeTraceRequested) {
+                timeTraceLock.lockForWrite();
+            } else {
+                timeTraceLock.lockForRead();
+            }
+
+            // The virtual header directory is only placed on the search path when the context supplies virtual
+            // headers.
+            bool includeVirtualHeaderDirectory = !virtualHeaders.isEmpty();
 
-        if (!isTerminatingThread) {
             bool success;
-            if (compilerInstance.isNull()) {
+            if (compilerInstance.isNull()                                       ||
+                automaticPchStale()                                             ||
+                virtualHeadersRemoved(virtualHeaders)                           ||
+                includeVirtualHeaderDirectory != virtualHeaderDirectoryIncluded    ) {
+                virtualHeaderDirectoryIncluded = includeVirtualHeaderDirectory;
                 success = reconfigureCompiler();
             } else {
                 compilerInstance->getDiagnosticClient().clear();
@@ -397,38 +780,80 @@ void CompilerImpl::run() {
                 success = true;
             }
 
-            if (success) {
-                // Source files are ultimately managed under the compiler invocation by the clang::SourceCodeManager.
-                // This class uses the clang::FileManager class to perform the actual read operations.  An implicit
-                // assumption throughout the CLang code is that all source comes from either a named pipe or a real
-                // file.  We can not hand an instance of clang::FrontendInputFile with a memory buffer to the compiler
-                // and have it accept it.
-                //
-                // Hacking the compiler to accept a buffer in a FIF (as the underlying compiler implementation calls
-                // it), would be extremely ugly as the assumption of a file devices is very heavily baked into the
-                // structure.
-                //
-                // To work around this constraint, we forcibly create a source code manager and file manager here before
-                // the compiler creates one and then use the method clang::SourceCodeManager::overrideFileContents
-                // method to insert a memory buffer.  This works because the underlying compiler only creates the
-                // file amanager and source code managers if they do not already exist.  Luckily the CLang code relies
-                // on a std::unique_ptr to provide garbage collection allowing us to repeatedly recreate these classes
-                // to embed new data each time we invoke the compiler.
-
-                currentDiagnostics.clear();
-
-                compilerInstance->getFrontendOpts().OutputFile = activeContext->objectFile().toStdString();
-
-                clang::SourceManager& sourceManager = compilerInstance->getSourceManager();
-                const char*           sourceBuffer  = activeContext->sourceData().data();
-                sourceManager.overrideFileContents(
-                    mainFileEntry.get(),
-                    llvm::MemoryBuffer::getMemBuffer(sourceBuffer)
+            bool checkOnly = (activeContext->action() == Cbe::CompilerContext::Action::CHECK);
+
+            bool       cacheHit = false;
+            QByteArray compileCacheKey;
+            // A context requesting a time trace is always compiled so the trace reflects a real compilation.  Checked
+            // contexts produce no object so there is nothing to look up or store.
+            if (success                    &&
+                currentCompileCacheEnabled &&
+                !compileCache.isNull()     &&
+                !timeTraceRequested        &&
+                !checkOnly                    ) {
+                compileCacheKey = CompileCache::calculateLookupKey(
+                    activeContext->sourceData(),
+                    compileCacheCommandLine(virtualHeaders)
                 );
 
+                cacheHit = compileFromCache(compileCacheKey);
+            }
+
+            if (success && !cacheHit) {
+                bool objectInMemory = (
+                       !checkOnly
+                    && activeContext->objectDestination() == Cbe::CompilerContext::ObjectDestination::MEMORY
+                );
+
+                if (checkOnly) {
+                    activeContext->setObjectData(QByteArray());
+                }
+
+                llvm::SmallVector<char, 0> objectBuffer;
+                prepareFrontendAction(virtualHeaders, objectInMemory ? &objectBuffer : nullptr);
+
                 compilerStarted(activeContext);
 
-                success = clang::ExecuteCompilerInvocation(compilerInstance.data());
+                phaseTimer.leave();
+                phaseTimer.enter(Cbe::CompilerTiming::Phase::FRONTEND);
+
+                success = executeFrontendAction();
+
+                if (!success && automaticPchLoadFailed && !activeContext->cancelled()) {
+                    // Clang could not load the automatic PCH, typically because a file it read changed after we
+                    // validated it.  We discard the PCH and compile again, which either rebuilds the PCH or falls back
+                    // to including the headers directly.
+                    if (objectInMemory) {
+                        compilerInstance->takeOutputStream();
+                    }
+
+                    discardAutomaticPch();
+                    success = reconfigureCompiler();
+                    if (success) {
+                        objectBuffer.clear();
+                        prepareFrontendAction(virtualHeaders, objectInMemory ? &objectBuffer : nullptr);
+                        success = executeFrontendAction();
+                    }
+                }
+
+                phaseTimer.leave();
+
+                if (!success && activeContext->cancelled()) {
+                    currentDiagnostics.clear();
+                }
+
+                if (objectInMemory) {
+                    // Discard the stream if the compiler never claimed it, for example due to an early error.
+                    compilerInstance->takeOutputStream();
+
+                    if (success) {
+                        activeContext->setObjectData(
+                            QByteArray(objectBuffer.data(), static_cast<int>(objectBuffer.size()))
+                        );
+                    } else {
+                        activeContext->setObjectData(QByteArray());
+                    }
+                }
 
                 unsigned numberDiagnostics = static_cast<unsigned>(currentDiagnostics.size());
                 unsigned diagnosticIndex   = 0;
@@ -497,12 +922,21 @@ void CompilerImpl::run() {
                     }
                 }
 
+                if (!compileCacheKey.isNull()) {
+                    storeInCompileCache(compileCacheKey, success);
+                }
+
+                activeContext->setTiming(phaseTimer.timing());
                 compilerFinished(activeContext, success);
             }
 
+            timeTraceLock.unlock();
             activeContext.clear();
         }
-    } while (!isTerminatingThread);
+
+        // A warm-up requested after the queue was found empty would otherwise be lost if the caller saw the thread
+        // still running.
+    } while (!isTerminatingThread || warmUpRequested);
 }
 
 
@@ -522,12 +956,64 @@ void CompilerImpl::fatalErrorHandlerCallback(void* /*userData */, const char* re
 }
 
 
+void CompilerImpl::setTargetInitialization(Cbe::Compiler::TargetInitialization newTargetInitialization) {
+    QMutexLocker locker(&targetInitializationMutex);
+    currentTargetInitialization = newTargetInitialization;
+}
+
+
+Cbe::Compiler::TargetInitialization CompilerImpl::targetInitialization() {
+    QMutexLocker locker(&targetInitializationMutex);
+    return currentTargetInitialization;
+}
+
+
+void CompilerImpl::setInitialTargets(const QList<QString>& newInitialTargets) {
+    QMutexLocker locker(&targetInitializationMutex);
+    currentInitialTargets = newInitialTargets;
+}
+
+
+QList<QString> CompilerImpl::initialTargets() {
+    QMutexLocker locker(&targetInitializationMutex);
+    return currentInitialTargets;
+}
+
+
 void CompilerImpl::configureCompilerBackend() {
     if (backendInitializationNeeded) {
-        llvm::InitializeAllTargets();
-        llvm::InitializeAllTargetMCs();
-        llvm::InitializeAllAsmPrinters();
-        llvm::InitializeAllAsmParsers();
+        QMutexLocker locker(&targetInitializationMutex);
+
+        if (currentTargetInitialization == Cbe::Compiler::TargetInitialization::ALL) {
+            llvm::InitializeAllTargets();
+            llvm::InitializeAllTargetMCs();
+            llvm::InitializeAllAsmPrinters();
+            llvm::InitializeAllAsmParsers();
+
+            allTargetsInitialized = true;
+        } else {
+            // Target info registration is cheap and lets the target registry resolve any triple to a backend name,
+            // which is all we need to initialize the remaining targets on demand.
+            llvm::InitializeAllTargetInfos();
+
+            std::string errorMessage;
+            const llvm::Target* nativeTarget = llvm::TargetRegistry::lookupTarget(
+                llvm::sys::getDefaultTargetTriple(),
+                errorMessage
+            );
+
+            if (nativeTarget != nullptr) {
+                initializeTarget(QString::fromLatin1(nativeTarget->getBackendName()));
+            }
+
+            for (  QList<QString>::const_iterator it  = currentInitialTargets.constBegin(),
+                                                  end = currentInitialTargets.constEnd()
+                 ; it != end
+                 ; ++it
+                ) {
+                initializeTarget(*it);
+            }
+        }
 
         #if (defined(LINK_POLLY_INTO_TOOLS))
 
@@ -543,6 +1029,54 @@ void CompilerImpl::configureCompilerBackend() {
 }
 
 
+bool CompilerImpl::initializeTarget(const QString& backendName) {
+    bool available = allTargetsInitialized || initializedTargets.contains(backendName);
+    if (!available) {
+        #define LLVM_TARGET(TargetName)                                                                               \
+            if (backendName == QLatin1String(#TargetName)) {                                                          \
+                LLVMInitialize##TargetName##Target();                                                                 \
+                LLVMInitialize##TargetName##TargetMC();                                                               \
+                available = true;                                                                                     \
+            }
+        #include <llvm/Config/Targets.def>
+
+        #define LLVM_ASM_PRINTER(TargetName)                                                                          \
+            if (backendName == QLatin1String(#TargetName)) {                                                          \
+                LLVMInitialize##TargetName##AsmPrinter();                                                             \
+            }
+        #include <llvm/Config/AsmPrinters.def>
+
+        #define LLVM_ASM_PARSER(TargetName)                                                                           \
+            if (backendName == QLatin1String(#TargetName)) {                                                          \
+                LLVMInitialize##TargetName##AsmParser();                                                              \
+            }
+        #include <llvm/Config/AsmParsers.def>
+
+        if (available) {
+            initializedTargets.insert(backendName);
+        }
+    }
+
+    return available;
+}
+
+
+bool CompilerImpl::initializeTargetForTriple(const std::string& triple) {
+    QMutexLocker locker(&targetInitializationMutex);
+
+    bool available = allTargetsInitialized;
+    if (!available) {
+        std::string         errorMessage;
+        const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple, errorMessage);
+        if (target != nullptr) {
+            available = initializeTarget(QString::fromLatin1(target->getBackendName()));
+        }
+    }
+
+    return available;
+}
+
+
 QList<QString> CompilerImpl::addOptions(
         QList<QString>&       switchList,
         const QList<QString>& parameters,
@@ -572,28 +1106,52 @@ bool CompilerImpl::buildUserFriendlyCommandLine() {
         switches << QString("--gcc-toolchain=\"%1\"").arg(currentGccToolchainPrefix);
     }
 
+    if (virtualHeaderDirectoryIncluded) {
+        switches << QString("-I") << virtualHeaderDirectory;
+    }
+
     addOptions(switches, currentHeaderSearchPaths, QString("-I"));
 
+    if (currentModulesEnabled) {
+        // Clang keys each cached module by its configuration and locks modules while building them so the cache can
+        // be shared by every compiler, in this or any other process.
+        switches << QString("-fmodules")
+                 << QString("-fimplicit-module-maps")
+                 << QString("-fmodules-cache-path=%1").arg(moduleCacheDirectory());
+    }
+
     addOptions(switches, currentPrecompiledHeaders, QString("-include-pch"));
-    addOptions(switches, currentHeaders, QString("-include"));
 
-    bool success = true;
-    if (!temporaryInputFile.isOpen()) {
-        success = temporaryInputFile.open();
+    currentAutomaticPchFile.clear();
+    if (automaticPchApplicable()) {
+        currentAutomaticPchFile = buildAutomaticPch();
     }
 
-    if (success) {
-        temporaryInputFilename = temporaryInputFile.fileName().toLocal8Bit();
-        for (QList<QString>::const_iterator it=switches.begin(),end=switches.end() ; it!=end ; ++it) {
-            currentUserCompilerSwitches.push_back(strdup(it->toLocal8Bit().constData()));
-        }
+    if (currentAutomaticPchFile.isEmpty()) {
+        addOptions(switches, currentHeaders, QString("-include"));
+    } else {
+        switches << QString("-include-pch") << currentAutomaticPchFile;
+    }
 
-        // clang driver apparently needs a filename when it sets up the compilation even if we just override it
-        // afterwords.  We add this here to make clang happy.
-        currentUserCompilerSwitches.push_back(strdup(temporaryInputFilename.constData()));
+    // The driver does not expose -mlink-builtin-bitcode so we pass it directly to the frontend.
+    for (  QList<QString>::const_iterator moduleIterator    = currentRuntimeBitcodeModules.constBegin(),
+                                          moduleEndIterator = currentRuntimeBitcodeModules.constEnd()
+         ; moduleIterator != moduleEndIterator
+         ; ++moduleIterator
+        ) {
+        switches << QString("-Xclang") << QString("-mlink-builtin-bitcode")
+                 << QString("-Xclang") << *moduleIterator;
     }
 
-    return success;
+    for (QList<QString>::const_iterator it=switches.begin(),end=switches.end() ; it!=end ; ++it) {
+        currentUserCompilerSwitches.push_back(strdup(it->toLocal8Bit().constData()));
+    }
+
+    // clang driver apparently needs a filename when it sets up the compilation even if we just override it
+    // afterwords.  We add this here to make clang happy.  The file only exists in our in-memory file system.
+    currentUserCompilerSwitches.push_back(strdup(mainFilename.constData()));
+
+    return true;
 }
 
 
@@ -617,23 +1175,82 @@ bool CompilerImpl::reconfigureCompiler() {
     DiagnosticConsumer* diagnosticConsumer = new DiagnosticConsumer(this);
     diagnosticsEngine.reset(new clang::DiagnosticsEngine(diagnosticIds, &*diagnosticOptions, diagnosticConsumer));
 
-    std::string driverPath = "clang++"; // The driver class uses this to determine if we're ANSI-C or C++ mode.
-    std::string triple =   currentTargetTripleOverride.isEmpty()
-                         ? llvm::sys::getDefaultTargetTriple()
-                         : currentTargetTripleOverride.toStdString();
-
-    std::unique_ptr<clang::driver::Compilation> compilation;
-
     bool success = buildUserFriendlyCommandLine();
     if (success) {
-        clang::driver::Driver driver(driverPath, triple, *diagnosticsEngine);
+        compilerInstance.reset(new clang::CompilerInstance());
+        success = createCompilerInstance(*compilerInstance, currentUserCompilerSwitches, *diagnosticsEngine);
+    }
 
-        char**   compilerOptions = currentUserCompilerSwitches.data();
-        unsigned numberSwitches  = static_cast<unsigned>(currentUserCompilerSwitches.size());
-        compilation.reset(driver.BuildCompilation(llvm::makeArrayRef(compilerOptions, numberSwitches)));
-        success = (compilation && !compilation->containsError());
+    if (success) {
+        diagnosticConsumer = new DiagnosticConsumer(this);
+        compilerInstance->createDiagnostics(diagnosticConsumer, true);
+        success = compilerInstance->hasDiagnostics();
     }
 
+    if (success) {
+        if (!compilerInstance->hasFileManager()) {
+            compilerInstance->createFileManager(overlayFileSystem);
+        }
+
+        clang::FileManager& fileManager = compilerInstance->getFileManager();
+
+        if (!compilerInstance->hasSourceManager()) {
+            compilerInstance->createSourceManager(fileManager);
+        }
+
+        clang::SourceManager& sourceManager = compilerInstance->getSourceManager();
+
+        mainFileEntry = fileManager.getFile(llvm::StringRef(mainFilename.constData()), true);
+        assert(mainFileEntry);
+
+        clang::FileID mainFileId = sourceManager.createFileID(
+            mainFileEntry.get(),
+            clang::SourceLocation(),
+            clang::SrcMgr::C_User
+        );
+        sourceManager.setMainFileID(mainFileId);
+
+        if (currentCompileCacheEnabled) {
+            compileCache.reset(new CompileCache(compileCacheDirectory(), currentCompileCacheMaximumSize));
+            dependencyCollector = std::make_shared<DependencyCollector>();
+            compilerInstance->addDependencyCollector(dependencyCollector);
+        } else {
+            compileCache.reset();
+            dependencyCollector.reset();
+        }
+
+        preamble.reset();
+        previousPreambleSource.clear();
+        failedPreambleSource.clear();
+        currentVirtualHeaderNames.clear();
+        virtualHeaderBuffers.clear();
+        preambleApplicable = (
+               currentPreambleReuseEnabled
+            && compilerInstance->getPreprocessorOpts().ImplicitPCHInclude.empty()
+        );
+    }
+
+    return success;
+}
+
+
+bool CompilerImpl::createCompilerInstance(
+        clang::CompilerInstance&  instance,
+        const QVector<char*>&     switches,
+        clang::DiagnosticsEngine& driverDiagnostics
+    ) {
+    std::string driverPath = "clang++"; // The driver class uses this to determine if we're ANSI-C or C++ mode.
+    std::string triple =   currentTargetTripleOverride.isEmpty()
+                         ? llvm::sys::getDefaultTargetTriple()
+                         : currentTargetTripleOverride.toStdString();
+
+    clang::driver::Driver driver(driverPath, triple, driverDiagnostics, overlayFileSystem);
+
+    std::unique_ptr<clang::driver::Compilation> compilation(
+        driver.BuildCompilation(llvm::makeArrayRef(switches.data(), static_cast<std::size_t>(switches.size())))
+    );
+
+    bool success = (compilation && !compilation->containsError());
     if (success) {
         const clang::driver::JobList& jobList = compilation->getJobs();
         unsigned jobListSize = static_cast<unsigned>(jobList.size());
@@ -643,9 +1260,7 @@ bool CompilerImpl::reconfigureCompiler() {
         const clang::driver::Command&   command   = *jobList.begin();
         const llvm::opt::ArgStringList& arguments = command.getArguments();
 
-        compilerInstance.reset(new clang::CompilerInstance());
-
-        std::shared_ptr<clang::PCHContainerOperations> pchOperations = compilerInstance->getPCHContainerOperations();
+        std::shared_ptr<clang::PCHContainerOperations> pchOperations = instance.getPCHContainerOperations();
         pchOperations->registerWriter(
             std::unique_ptr<clang::PCHContainerWriter>(new clang::ObjectFilePCHContainerWriter())
         );
@@ -654,12 +1269,18 @@ bool CompilerImpl::reconfigureCompiler() {
         );
 
         success = clang::CompilerInvocation::CreateFromArgs(
-            compilerInstance->getInvocation(),
+            instance.getInvocation(),
             llvm::opt::ArgStringList(arguments.begin() + 1, arguments.end()),
-            *diagnosticsEngine
+            driverDiagnostics
         );
 
-        compilerInstance->getInvocation().getFrontendOpts().LLVMArgs.clear();
+        instance.getInvocation().getFrontendOpts().LLVMArgs.clear();
+    }
+
+    if (success) {
+        // With on-demand target initialization, the target selected by the triple or the command line switches may
+        // not have been initialized yet.  Code generation would fail to find it in the target registry.
+        initializeTargetForTriple(instance.getTargetOpts().Triple);
     }
 
     if (success) {
@@ -668,46 +1289,938 @@ bool CompilerImpl::reconfigureCompiler() {
         // leaks can be ignored because the OS will clean up for us.  For this application, the memory leaks rapidly
         // become an issue.  Rather than remove the "-disable-free", we override it here.
 
-        compilerInstance->getFrontendOpts().DisableFree = 0;
-        compilerInstance->getCodeGenOpts().DisableFree = 0;
+        instance.getFrontendOpts().DisableFree = 0;
+        instance.getCodeGenOpts().DisableFree = 0;
 
-        compilerInstance->getHeaderSearchOpts().Sysroot = currentSystemRoot.toStdString();
+        instance.getHeaderSearchOpts().Sysroot = currentSystemRoot.toStdString();
 
         if (currentResourceDirectory.isEmpty()) {
-            compilerInstance->getHeaderSearchOptsPtr()->UseBuiltinIncludes = 0;
+            instance.getHeaderSearchOptsPtr()->UseBuiltinIncludes = 0;
         } else {
-            compilerInstance->getHeaderSearchOptsPtr()->UseBuiltinIncludes = 1;
-            compilerInstance->getHeaderSearchOptsPtr()->ResourceDir = currentResourceDirectory.toStdString();
+            instance.getHeaderSearchOptsPtr()->UseBuiltinIncludes = 1;
+            instance.getHeaderSearchOptsPtr()->ResourceDir = currentResourceDirectory.toStdString();
         }
+    }
 
-        diagnosticConsumer = new DiagnosticConsumer(this);
-        compilerInstance->createDiagnostics(diagnosticConsumer, true);
-        success = compilerInstance->hasDiagnostics();
+    return success;
+}
+
+
+bool CompilerImpl::automaticPchApplicable() const {
+    // Clang only accepts a single PCH per translation unit so we defer to any user supplied precompiled headers.  With
+    // modules enabled, the headers are imported from the module cache instead.
+    return (
+           currentAutomaticPchEnabled
+        && !currentModulesEnabled
+        && !currentHeaders.isEmpty()
+        && currentPrecompiledHeaders.isEmpty()
+    );
+}
+
+
+bool CompilerImpl::automaticPchStale() const {
+    return (
+           automaticPchApplicable()
+        && (calculateAutomaticPchKey() != currentAutomaticPchKey || automaticPchInputsChanged())
+    );
+}
+
+
+QString CompilerImpl::locateHeader(const QString& header) const {
+    QString result;
+
+    QFileInfo headerInformation(header);
+    if (headerInformation.isFile()) {
+        result = headerInformation.absoluteFilePath();
+    } else if (headerInformation.isRelative()) {
+        QList<QString>::const_iterator searchPathIterator    = currentHeaderSearchPaths.constBegin();
+        QList<QString>::const_iterator searchPathEndIterator = currentHeaderSearchPaths.constEnd();
+        while (result.isEmpty() && searchPathIterator != searchPathEndIterator) {
+            QFileInfo candidateInformation(QDir(*searchPathIterator).filePath(header));
+            if (candidateInformation.isFile()) {
+                result = candidateInformation.absoluteFilePath();
+            }
+
+            ++searchPathIterator;
+        }
     }
 
+    return result;
+}
+
+
+QByteArray CompilerImpl::calculateAutomaticPchKey() const {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+
+    hash.addData(QByteArray::fromStdString(clang::getClangFullVersion()));
+    hash.addData(QStringList(currentSwitches).join(QChar('\n')).toUtf8());
+    hash.addData(QStringList(currentHeaderSearchPaths).join(QChar('\n')).toUtf8());
+    hash.addData(currentSystemRoot.toUtf8());
+    hash.addData(currentResourceDirectory.toUtf8());
+    hash.addData(currentGccToolchainPrefix.toUtf8());
+    hash.addData(currentTargetTripleOverride.toUtf8());
+
+    // Headers we can locate are keyed by size and modification time so edits trigger a rebuild.  Headers found
+    // through the system include paths are assumed to be stable.
+    for (  QList<QString>::const_iterator headerIterator    = currentHeaders.constBegin(),
+                                          headerEndIterator = currentHeaders.constEnd()
+         ; headerIterator != headerEndIterator
+         ; ++headerIterator
+        ) {
+        hash.addData(headerIterator->toUtf8());
+
+        QString headerPath = locateHeader(*headerIterator);
+        if (!headerPath.isEmpty()) {
+            QFileInfo headerInformation(headerPath);
+            hash.addData(
+                QString("%1:%2:%3").arg(headerPath)
+                                   .arg(headerInformation.size())
+                                   .arg(headerInformation.lastModified().toMSecsSinceEpoch())
+                                   .toUtf8()
+            );
+        }
+    }
+
+    return hash.result().toHex();
+}
+
+
+QString CompilerImpl::buildAutomaticPch() {
+    currentAutomaticPchKey = calculateAutomaticPchKey();
+    currentAutomaticPchInputs.clear();
+
+    QDir    cacheDirectory(pchCacheDirectory());
+    QString baseFilename   = QString("inecbe_%1").arg(QString::fromLatin1(currentAutomaticPchKey));
+    QString pchFilename    = cacheDirectory.absoluteFilePath(baseFilename + ".pch");
+    QString inputsFilename = pchFilename + ".inputs";
+
+    bool success = QFileInfo(pchFilename).isFile();
     if (success) {
-        if (!compilerInstance->hasFileManager()) {
-            compilerInstance->createFileManager();
+        // The key only covers the headers we were given so we also check every header they pulled in.
+        success = readAutomaticPchInputs(inputsFilename) && !automaticPchInputsChanged();
+        if (!success) {
+            currentAutomaticPchInputs.clear();
+            QFile::remove(pchFilename);
+            QFile::remove(inputsFilename);
         }
+    }
 
-        clang::FileManager& fileManager = compilerInstance->getFileManager();
+    if (!success && cacheDirectory.mkpath(".")) {
+        QString  umbrellaFilename = cacheDirectory.absoluteFilePath(baseFilename + ".h");
+        QSaveFile umbrellaFile(umbrellaFilename);
+
+        success = umbrellaFile.open(QIODevice::WriteOnly);
+        if (success) {
+            for (  QList<QString>::const_iterator headerIterator    = currentHeaders.constBegin(),
+                                                  headerEndIterator = currentHeaders.constEnd()
+                 ; headerIterator != headerEndIterator
+                 ; ++headerIterator
+                ) {
+                QString headerPath = locateHeader(*headerIterator);
+                if (headerPath.isEmpty()) {
+                    headerPath = *headerIterator;
+                }
 
-        if (!compilerInstance->hasSourceManager()) {
-            compilerInstance->createSourceManager(fileManager);
+                umbrellaFile.write(QString("#include \"%1\"\n").arg(QDir::fromNativeSeparators(headerPath)).toUtf8());
+            }
+
+            success = umbrellaFile.commit();
         }
 
-        clang::SourceManager& sourceManager = compilerInstance->getSourceManager();
+        if (success) {
+            // We build into a private file and then rename it so other compilers sharing the cache directory never
+            // observe a partially written PCH.
+            QString partialFilename = QString("%1.%2.partial").arg(pchFilename)
+                                                              .arg(reinterpret_cast<quintptr>(this), 0, 16);
 
-        mainFileEntry = fileManager.getFile(llvm::StringRef(temporaryInputFilename.constData()), true);
-        assert(mainFileEntry);
+            QList<QString> switches;
+            switches << "";
+            switches += currentSwitches;
 
-        clang::FileID mainFileId = sourceManager.createFileID(
-            mainFileEntry.get(),
-            clang::SourceLocation(),
-            clang::SrcMgr::C_User
+            if (!currentGccToolchainPrefix.isEmpty()) {
+                switches << QString("--gcc-toolchain=\"%1\"").arg(currentGccToolchainPrefix);
+            }
+
+            addOptions(switches, currentHeaderSearchPaths, QString("-I"));
+            switches << "-x" << "c++-header" << umbrellaFilename << "-o" << partialFilename;
+
+            QVector<char*> pchSwitches;
+            for (QList<QString>::const_iterator it=switches.begin(),end=switches.end() ; it!=end ; ++it) {
+                pchSwitches.push_back(strdup(it->toLocal8Bit().constData()));
+            }
+
+            // Diagnostics from the PCH build are discarded.  On failure we fall back to including the headers
+            // directly so the user sees the diagnostics against their own translation unit.
+            llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs> diagnosticIds(new clang::DiagnosticIDs());
+            llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> diagnosticOptions = new clang::DiagnosticOptions();
+            clang::DiagnosticsEngine pchDiagnostics(
+                diagnosticIds,
+                &*diagnosticOptions,
+                new clang::IgnoringDiagConsumer()
+            );
+
+            std::shared_ptr<DependencyCollector> pchDependencyCollector = std::make_shared<DependencyCollector>();
+
+            clang::CompilerInstance pchInstance;
+            success = createCompilerInstance(pchInstance, pchSwitches, pchDiagnostics);
+            if (success) {
+                pchInstance.createDiagnostics(new clang::IgnoringDiagConsumer(), true);
+                pchInstance.addDependencyCollector(pchDependencyCollector);
+                success = (
+                       clang::ExecuteCompilerInvocation(&pchInstance)
+                    && !pchInstance.getDiagnostics().hasErrorOccurred()
+                );
+            }
+
+            for (QVector<char*>::iterator it=pchSwitches.begin(),end=pchSwitches.end() ; it!=end ; ++it) {
+                std::free(*it);
+            }
+
+            if (success) {
+                for (  QList<QString>::const_iterator
+                           dependencyIterator    = pchDependencyCollector->dependencies().constBegin(),
+                           dependencyEndIterator = pchDependencyCollector->dependencies().constEnd()
+                     ; dependencyIterator != dependencyEndIterator
+                     ; ++dependencyIterator
+                    ) {
+                    currentAutomaticPchInputs.insert(*dependencyIterator, fileStamp(*dependencyIterator));
+                }
+
+                // The input list is written first so a PCH is never visible without the list used to validate it.
+                success = writeAutomaticPchInputs(inputsFilename);
+            }
+
+            if (success) {
+                success = QFile::rename(partialFilename, pchFilename) || QFileInfo(pchFilename).isFile();
+            }
+
+            QFile::remove(partialFilename);
+        }
+    }
+
+    if (!success) {
+        currentAutomaticPchInputs.clear();
+    }
+
+    return success ? pchFilename : QString();
+}
+
+
+void CompilerImpl::discardAutomaticPch() {
+    if (!currentAutomaticPchFile.isEmpty()) {
+        QFile::remove(currentAutomaticPchFile);
+        QFile::remove(currentAutomaticPchFile + ".inputs");
+    }
+
+    currentAutomaticPchFile.clear();
+    currentAutomaticPchKey.clear();
+    currentAutomaticPchInputs.clear();
+}
+
+
+bool CompilerImpl::automaticPchInputsChanged() const {
+    bool changed = false;
+
+    QMap<QString, QString>::const_iterator inputIterator    = currentAutomaticPchInputs.constBegin();
+    QMap<QString, QString>::const_iterator inputEndIterator = currentAutomaticPchInputs.constEnd();
+    while (!changed && inputIterator != inputEndIterator) {
+        changed = (fileStamp(inputIterator.key()) != inputIterator.value());
+        ++inputIterator;
+    }
+
+    return changed;
+}
+
+
+bool CompilerImpl::readAutomaticPchInputs(const QString& filename) {
+    QFile inputsFile(filename);
+    bool  success = inputsFile.open(QIODevice::ReadOnly);
+
+    if (success) {
+        // Each line holds the stamp and the filename, separated by a tab.
+        while (success && !inputsFile.atEnd()) {
+            QString line = QString::fromUtf8(inputsFile.readLine());
+            line.chop(1);
+
+            int separatorIndex = line.indexOf(QChar('\t'));
+
+            if (separatorIndex > 0) {
+                currentAutomaticPchInputs.insert(line.mid(separatorIndex + 1), line.left(separatorIndex));
+            } else {
+                success = false;
+            }
+        }
+
+        inputsFile.close();
+    }
+
+    // An empty list can only come from a damaged file since the PCH always reads its umbrella header.
+    return success && !currentAutomaticPchInputs.isEmpty();
+}
+
+
+bool CompilerImpl::writeAutomaticPchInputs(const QString& filename) const {
+    QSaveFile inputsFile(filename);
+    bool      success = inputsFile.open(QIODevice::WriteOnly);
+
+    if (success) {
+        for (  QMap<QString, QString>::const_iterator inputIterator    = currentAutomaticPchInputs.constBegin(),
+                                                      inputEndIterator = currentAutomaticPchInputs.constEnd()
+             ; inputIterator != inputEndIterator
+             ; ++inputIterator
+            ) {
+            inputsFile.write(QString("%1\t%2\n").arg(inputIterator.value(), inputIterator.key()).toUtf8());
+        }
+
+        success = inputsFile.commit();
+    }
+
+    return success;
+}
+
+
+QString CompilerImpl::fileStamp(const QString& filename) {
+    QString   result;
+    QFileInfo fileInformation(filename);
+
+    if (fileInformation.exists()) {
+        result = QString("%1:%2").arg(fileInformation.size())
+                                 .arg(fileInformation.lastModified().toMSecsSinceEpoch());
+    }
+
+    return result;
+}
+
+
+QByteArray CompilerImpl::compileCacheCommandLine(const QMap<QString, QByteArray>& virtualHeaders) const {
+    QByteArray result = QByteArray::fromStdString(clang::getClangFullVersion());
+
+    result += '\n';
+    result +=   currentTargetTripleOverride.isEmpty()
+              ? QByteArray::fromStdString(llvm::sys::getDefaultTargetTriple())
+              : currentTargetTripleOverride.toUtf8();
+
+    result += '\n';
+    result += currentSystemRoot.toUtf8();
+    result += '\n';
+    result += currentResourceDirectory.toUtf8();
+
+    // The first entry is the empty executable name and the last entry is our main file.
+    int numberSwitches = currentUserCompilerSwitches.size();
+    for (int switchIndex=1 ; switchIndex<numberSwitches-1 ; ++switchIndex) {
+        result += '\n';
+        result += currentUserCompilerSwitches.at(switchIndex);
+    }
+
+    result += '\n';
+    switch (activeContext->objectFormat()) {
+        case Cbe::CompilerContext::ObjectFormat::NATIVE:   { result += "native";   break; }
+        case Cbe::CompilerContext::ObjectFormat::BITCODE:  { result += "bitcode";  break; }
+        case Cbe::CompilerContext::ObjectFormat::THIN_LTO: { result += "thin-lto"; break; }
+        default: {
+            Q_ASSERT(false);
+            break;
+        }
+    }
+
+    // Virtual headers never reach the dependency list so their contents are folded into the key.
+    for (  QMap<QString, QByteArray>::const_iterator headerIterator    = virtualHeaders.constBegin(),
+                                                     headerEndIterator = virtualHeaders.constEnd()
+         ; headerIterator != headerEndIterator
+         ; ++headerIterator
+        ) {
+        result += '\n';
+        result += headerIterator.key().toUtf8();
+        result += '\n';
+        result += QByteArray::number(headerIterator.value().size());
+        result += '\n';
+        result += headerIterator.value();
+    }
+
+    return result;
+}
+
+
+bool CompilerImpl::compileFromCache(const QByteArray& lookupKey) {
+    QByteArray cachedObject = compileCache->lookup(lookupKey);
+    bool       cacheHit     = !cachedObject.isNull();
+
+    if (cacheHit) {
+        bool success;
+
+        compilerStarted(activeContext);
+
+        if (activeContext->objectDestination() == Cbe::CompilerContext::ObjectDestination::MEMORY) {
+            activeContext->setObjectData(cachedObject);
+            success = true;
+        } else {
+            QSaveFile objectFile(activeContext->objectFile());
+            success = (
+                   objectFile.open(QFile::WriteOnly)
+                && objectFile.write(cachedObject) == cachedObject.size()
+                && objectFile.commit()
+            );
+        }
+
+        ++currentCompileCacheHits;
+        if (currentNotifier != nullptr) {
+            currentNotifier->compileCacheAccessed(true, currentCompileCacheHits, currentCompileCacheMisses);
+        }
+
+        phaseTimer.leave();
+        activeContext->setTiming(phaseTimer.timing());
+
+        compilerFinished(activeContext, success);
+    }
+
+    return cacheHit;
+}
+
+
+void CompilerImpl::prepareFrontendAction(
+        const QMap<QString, QByteArray>& virtualHeaders,
+        llvm::SmallVector<char, 0>*      objectBuffer
+    ) {
+    // Source files are ultimately managed under the compiler invocation by the clang::SourceCodeManager.  This class
+    // uses the clang::FileManager class to perform the actual read operations.  An implicit assumption throughout the
+    // CLang code is that all source comes from either a named pipe or a real file.  We can not hand an instance of
+    // clang::FrontendInputFile with a memory buffer to the compiler and have it accept it.
+    //
+    // Hacking the compiler to accept a buffer in a FIF (as the underlying compiler implementation calls it), would be
+    // extremely ugly as the assumption of a file devices is very heavily baked into the structure.
+    //
+    // To work around this constraint, we forcibly create a source code manager and file manager here before the
+    // compiler creates one and then use the method clang::SourceCodeManager::overrideFileContents method to insert a
+    // memory buffer.  This works because the underlying compiler only creates the file amanager and source code
+    // managers if they do not already exist.  Luckily the CLang code relies on a std::unique_ptr to provide garbage
+    // collection allowing us to repeatedly recreate these classes to embed new data each time we invoke the compiler.
+
+    currentDiagnostics.clear();
+    automaticPchLoadFailed = false;
+
+    compilerInstance->getFrontendOpts().OutputFile = activeContext->objectFile().toStdString();
+
+    // When the object is to remain memory resident, we hand the compiler an output stream.  The code generator will
+    // use a supplied stream in preference to opening the output file.  The stream is unbuffered so the object is fully
+    // in our buffer once the code generator releases the stream.
+
+    if (objectBuffer != nullptr) {
+        compilerInstance->setOutputStream(
+            std::unique_ptr<llvm::raw_pwrite_stream>(new llvm::raw_svector_ostream(*objectBuffer))
         );
-        sourceManager.setMainFileID(mainFileId);
+    }
+
+    clang::SourceManager& sourceManager = compilerInstance->getSourceManager();
+    const char*           sourceBuffer  = activeContext->sourceData().data();
+    sourceManager.overrideFileContents(
+        mainFileEntry.get(),
+        llvm::MemoryBuffer::getMemBuffer(sourceBuffer)
+    );
+
+    configureVirtualHeaders(virtualHeaders);
+
+    if (preambleApplicable) {
+        configurePreamble(activeContext->sourceData());
+    }
+
+    if (dependencyCollector) {
+        dependencyCollector->clear();
+    }
+}
+
+
+bool CompilerImpl::executeFrontendAction() {
+    bool success;
+    bool timeTraceEnabled = (
+        activeContext->timeTraceDestination() != Cbe::CompilerContext::TimeTraceDestination::NONE
+    );
+
+    clang::FrontendOptions&     frontendOptions   = compilerInstance->getFrontendOpts();
+    clang::CodeGenOptions&      codeGenOptions    = compilerInstance->getCodeGenOpts();
+    clang::frontend::ActionKind configuredAction  = frontendOptions.ProgramAction;
+    bool                        configuredLto     = codeGenOptions.PrepareForLTO;
+    bool                        configuredThinLto = codeGenOptions.PrepareForThinLTO;
+
+    Cbe::CompilerContext::ObjectFormat objectFormat = activeContext->objectFormat();
+    if (activeContext->action() == Cbe::CompilerContext::Action::CHECK) {
+        // Equivalent to -fsyntax-only.  The frontend stops after semantic analysis so no output is ever opened.
+        frontendOptions.ProgramAction = clang::frontend::ParseSyntaxOnly;
+    } else if (objectFormat == Cbe::CompilerContext::ObjectFormat::BITCODE) {
+        frontendOptions.ProgramAction = clang::frontend::EmitBC;
+    } else if (objectFormat == Cbe::CompilerContext::ObjectFormat::THIN_LTO) {
+        // Equivalent to -flto=thin.  The pre-link pipeline is run and a summary is written with the bitcode.
+        frontendOptions.ProgramAction    = clang::frontend::EmitBC;
+        codeGenOptions.PrepareForLTO     = true;
+        codeGenOptions.PrepareForThinLTO = true;
+    }
+
+    if (timeTraceEnabled) {
+        frontendOptions.TimeTrace            = true;
+        frontendOptions.TimeTraceGranularity = activeContext->timeTraceGranularity();
+
+        llvm::timeTraceProfilerInitialize(frontendOptions.TimeTraceGranularity, "inecbe");
+    }
+
+    // We run the action selected by the invocation ourselves, rather than through clang::ExecuteCompilerInvocation,
+    // so we can wrap it with a check of the context's cancellation flag and with markers used to time the code
+    // generator.  Time not spent in the code generator is charged to the frontend.
+    std::unique_ptr<clang::FrontendAction> frontendAction = clang::CreateFrontendAction(*compilerInstance);
+    if (frontendAction) {
+        llvm::TimeTraceScope timeTraceScope("ExecuteCompiler", llvm::StringRef(""));
+
+        InstrumentedAction instrumentedAction(std::move(frontendAction), activeContext, phaseTimer);
+        success = compilerInstance->ExecuteAction(instrumentedAction);
+    } else {
+        success = false;
+    }
+
+    frontendOptions.ProgramAction    = configuredAction;
+    codeGenOptions.PrepareForLTO     = configuredLto;
+    codeGenOptions.PrepareForThinLTO = configuredThinLto;
+
+    if (timeTraceEnabled) {
+        llvm::SmallVector<char, 0> timeTraceBuffer;
+        llvm::raw_svector_ostream  timeTraceStream(timeTraceBuffer);
+
+        llvm::timeTraceProfilerWrite(timeTraceStream);
+        llvm::timeTraceProfilerCleanup();
+
+        frontendOptions.TimeTrace = false;
+
+        saveTimeTrace(QByteArray(timeTraceBuffer.data(), static_cast<int>(timeTraceBuffer.size())));
     }
 
     return success;
 }
+
+
+void CompilerImpl::saveTimeTrace(const QByteArray& timeTrace) {
+    if (activeContext->timeTraceDestination() == Cbe::CompilerContext::TimeTraceDestination::MEMORY) {
+        activeContext->setTimeTraceData(timeTrace);
+    } else {
+        activeContext->setTimeTraceData(QByteArray());
+
+        QSaveFile timeTraceFile(activeContext->timeTraceFile());
+        if (timeTraceFile.open(QFile::WriteOnly) && timeTraceFile.write(timeTrace) == timeTrace.size()) {
+            timeTraceFile.commit();
+        } else {
+            timeTraceFile.cancelWriting();
+        }
+    }
+}
+
+
+void CompilerImpl::storeInCompileCache(const QByteArray& lookupKey, bool success) {
+    if (success && currentDiagnostics.isEmpty()) {
+        QByteArray objectData;
+        if (activeContext->objectDestination() == Cbe::CompilerContext::ObjectDestination::MEMORY) {
+            objectData = activeContext->objectData();
+        } else {
+            QFile objectFile(activeContext->objectFile());
+            if (objectFile.open(QFile::ReadOnly)) {
+                objectData = objectFile.readAll();
+                objectFile.close();
+            }
+        }
+
+        QString        virtualHeaderPrefix = virtualHeaderDirectory + "/";
+        QList<QString> dependencies;
+        for (  QList<QString>::const_iterator dependencyIterator    = dependencyCollector->dependencies().constBegin(),
+                                              dependencyEndIterator = dependencyCollector->dependencies().constEnd()
+             ; dependencyIterator != dependencyEndIterator
+             ; ++dependencyIterator
+            ) {
+            if (!dependencyIterator->startsWith(virtualHeaderPrefix)) {
+                dependencies.append(*dependencyIterator);
+            }
+        }
+
+        // Explicit precompiled headers are loaded directly by the AST reader rather than through the preprocessor.
+        for (  QList<QString>::const_iterator pchIterator    = currentPrecompiledHeaders.constBegin(),
+                                              pchEndIterator = currentPrecompiledHeaders.constEnd()
+             ; pchIterator != pchEndIterator
+             ; ++pchIterator
+            ) {
+            if (!dependencies.contains(*pchIterator)) {
+                dependencies.append(*pchIterator);
+            }
+        }
+
+        // Runtime bitcode modules are read by the code generator and are never seen by the preprocessor.
+        for (  QList<QString>::const_iterator moduleIterator    = currentRuntimeBitcodeModules.constBegin(),
+                                              moduleEndIterator = currentRuntimeBitcodeModules.constEnd()
+             ; moduleIterator != moduleEndIterator
+             ; ++moduleIterator
+            ) {
+            if (!dependencies.contains(*moduleIterator)) {
+                dependencies.append(*moduleIterator);
+            }
+        }
+
+        compileCache->store(lookupKey, dependencies, objectData);
+    }
+
+    ++currentCompileCacheMisses;
+    if (currentNotifier != nullptr) {
+        currentNotifier->compileCacheAccessed(false, currentCompileCacheHits, currentCompileCacheMisses);
+    }
+}
+
+
+bool CompilerImpl::virtualHeadersRemoved(const QMap<QString, QByteArray>& virtualHeaders) const {
+    bool removed = false;
+
+    QList<QString>::const_iterator nameIterator    = currentVirtualHeaderNames.constBegin();
+    QList<QString>::const_iterator nameEndIterator = currentVirtualHeaderNames.constEnd();
+    while (!removed && nameIterator != nameEndIterator) {
+        removed = !virtualHeaders.contains(*nameIterator);
+        ++nameIterator;
+    }
+
+    return removed;
+}
+
+
+void CompilerImpl::configureVirtualHeaders(const QMap<QString, QByteArray>& virtualHeaders) {
+    clang::PreprocessorOptions& preprocessorOptions = compilerInstance->getPreprocessorOpts();
+
+    // We own the buffers so they remain valid if the compiler bails out before the source manager claims them.
+    preprocessorOptions.clearRemappedFiles();
+    preprocessorOptions.RetainRemappedFileBuffers = true;
+    virtualHeaderBuffers.clear();
+
+    QDir virtualDirectory(virtualHeaderDirectory);
+    for (  QMap<QString, QByteArray>::const_iterator headerIterator    = virtualHeaders.constBegin(),
+                                                     headerEndIterator = virtualHeaders.constEnd()
+         ; headerIterator != headerEndIterator
+         ; ++headerIterator
+        ) {
+        if (Cbe::CompilerContext::validVirtualHeaderName(headerIterator.key())) {
+            std::string headerPath = QDir::cleanPath(virtualDirectory.absoluteFilePath(headerIterator.key()))
+                                     .toLocal8Bit()
+                                     .toStdString();
+
+            std::unique_ptr<llvm::MemoryBuffer> headerBuffer = llvm::MemoryBuffer::getMemBufferCopy(
+                llvm::StringRef(
+                    headerIterator.value().constData(),
+                    static_cast<std::size_t>(headerIterator.value().size())
+                ),
+                headerPath
+            );
+
+            preprocessorOptions.addRemappedFile(headerPath, headerBuffer.get());
+            virtualHeaderBuffers.push_back(std::move(headerBuffer));
+
+            if (!currentVirtualHeaderNames.contains(headerIterator.key())) {
+                currentVirtualHeaderNames.append(headerIterator.key());
+            }
+        } else {
+            // Names escaping the virtual header directory could shadow real files and bypass the dependency filter.
+            clang::DiagnosticsEngine& diagnostics  = compilerInstance->getDiagnostics();
+            unsigned                  diagnosticId = diagnostics.getCustomDiagID(
+                clang::DiagnosticsEngine::Warning,
+                "virtual header '%0' ignored, names must be relative paths inside the virtual header directory"
+            );
+
+            diagnostics.Report(diagnosticId) << headerIterator.key().toStdString();
+        }
+    }
+}
+
+
+void CompilerImpl::configurePreamble(const QByteArray& source) {
+    clang::CompilerInvocation&  invocation          = compilerInstance->getInvocation();
+    clang::PreprocessorOptions& preprocessorOptions = invocation.getPreprocessorOpts();
+
+    preprocessorOptions.ImplicitPCHInclude.clear();
+    preprocessorOptions.PrecompiledPreambleBytes = std::make_pair(0U, false);
+    preprocessorOptions.DisablePCHValidation     = false;
+
+    std::unique_ptr<llvm::MemoryBuffer> mainBuffer = llvm::MemoryBuffer::getMemBuffer(
+        llvm::StringRef(source.constData(), static_cast<std::size_t>(source.size())),
+        llvm::StringRef(mainFilename.constData())
+    );
+
+    clang::PreambleBounds bounds = clang::ComputePreambleBounds(*invocation.getLangOpts(), mainBuffer.get(), 0);
+    if (bounds.Size > 0) {
+        llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fileSystem = overlayFileSystem;
+
+        if (preamble.isNull() || !preamble->CanReuse(invocation, mainBuffer.get(), bounds, fileSystem.get())) {
+            preamble.reset();
+
+            // Building a preamble costs about as much as a compile so we wait until the same preamble region shows up
+            // twice in a row before we assume it is stable.  A region that already failed to build is not retried.
+            QByteArray preambleSource = source.left(static_cast<int>(bounds.Size));
+            if (preambleSource == previousPreambleSource && preambleSource != failedPreambleSource) {
+                llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs> diagnosticIds(new clang::DiagnosticIDs());
+                llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> diagnosticOptions = new clang::DiagnosticOptions();
+                clang::DiagnosticsEngine preambleDiagnostics(
+                    diagnosticIds,
+                    &*diagnosticOptions,
+                    new clang::IgnoringDiagConsumer()
+                );
+
+                // Diagnostics from the preamble build are discarded.  Any problems in the preamble will be reported
+                // when the translation unit is compiled without it.
+                clang::PreambleCallbacks preambleCallbacks;
+                llvm::ErrorOr<clang::PrecompiledPreamble> newPreamble = clang::PrecompiledPreamble::Build(
+                    invocation,
+                    mainBuffer.get(),
+                    bounds,
+                    preambleDiagnostics,
+                    fileSystem,
+                    compilerInstance->getPCHContainerOperations(),
+                    false,
+                    preambleCallbacks
+                );
+
+                if (newPreamble) {
+                    preamble.reset(new clang::PrecompiledPreamble(std::move(newPreamble.get())));
+                    failedPreambleSource.clear();
+                } else {
+                    failedPreambleSource = preambleSource;
+                }
+            } else {
+                previousPreambleSource = preambleSource;
+            }
+        }
+
+        if (!preamble.isNull()) {
+            preamble->AddImplicitPreamble(invocation, fileSystem, mainBuffer.get());
+
+            // The preamble remaps the main file to the supplied buffer.  We already override the main file contents
+            // through the source manager so the remapping is discarded.  Virtual header remappings are kept.
+            std::vector<std::pair<std::string, llvm::MemoryBuffer*>>& remappedBuffers =
+                preprocessorOptions.RemappedFileBuffers;
+
+            remappedBuffers.erase(
+                std::remove_if(
+                    remappedBuffers.begin(),
+                    remappedBuffers.end(),
+                    [&mainBuffer](const std::pair<std::string, llvm::MemoryBuffer*>& remappedBuffer) {
+                        return remappedBuffer.second == mainBuffer.get();
+                    }
+                ),
+                remappedBuffers.end()
+            );
+        }
+    } else {
+        previousPreambleSource.clear();
+    }
+}
+
+
+QSharedPointer<Cbe::CompilerContext> CompilerImpl::dequeueJob() {
+    QSharedPointer<Cbe::CompilerContext> result;
+
+    bool checkQueues = true;
+    while (checkQueues) {
+        batchJobsMutex.lock();
+        if (!batchJobs.isEmpty()) {
+            result = batchJobs.takeFirst();
+        }
+        batchJobsMutex.unlock();
+
+        if (result.isNull()) {
+            if (jobQueue->threadSafe()) {
+                result = jobQueue->dequeue();
+            } else {
+                jobQueueMutex->lock();
+                result = jobQueue->dequeue();
+                jobQueueMutex->unlock();
+            }
+        }
+
+        if (result.isNull()) {
+            // A job can be enqueued between our dequeue and setting the sentinel.  We publish the sentinel first and
+            // then re-check both queues so either the caller sees the sentinel and restarts us or we see the job.
+            isTerminatingThread = true;
+
+            batchJobsMutex.lock();
+            checkQueues = !batchJobs.isEmpty();
+            batchJobsMutex.unlock();
+
+            if (!checkQueues) {
+                if (jobQueue->threadSafe()) {
+                    checkQueues = (jobQueue->numberPendingJobs() > 0);
+                } else {
+                    jobQueueMutex->lock();
+                    checkQueues = (jobQueue->numberPendingJobs() > 0);
+                    jobQueueMutex->unlock();
+                }
+            }
+
+            if (checkQueues) {
+                isTerminatingThread = false;
+            }
+        } else {
+            isTerminatingThread = false;
+            checkQueues = false;
+
+            result->clearQueued();
+        }
+    }
+
+    return result;
+}
+
+
+void CompilerImpl::warmUpCompiler() {
+    if (currentWorkerProcessEnabled) {
+        if (!workerProcess.isNull() && workerRestartNeeded) {
+            workerProcess.reset();
+        }
+
+        workerRestartNeeded = false;
+
+        if (workerProcess.isNull()) {
+            workerProcess.reset(new WorkerProcess);
+        }
+
+        workerProcess->start(workerExecutable());
+    } else if (compilerInstance.isNull() || automaticPchStale()) {
+        // Building the automatic PCH can record time trace events.
+        timeTraceLock.lockForRead();
+
+        bool success = reconfigureCompiler();
+        if (!success) {
+            // The next context reconfigures the compiler and reports the problem against itself.
+            compilerInstance.reset();
+            diagnosticsEngine.reset();
+        }
+
+        currentDiagnostics.clear();
+        timeTraceLock.unlock();
+    }
+}
+
+
+void CompilerImpl::compileInWorkerProcess() {
+    if (workerProcess.isNull()) {
+        workerProcess.reset(new WorkerProcess);
+    }
+
+    compilerStarted(activeContext);
+
+    QByteArray request = WorkerProtocol::encodeRequest(workerConfiguration(), *activeContext);
+    QByteArray response;
+
+    workerProcess->start(workerExecutable());
+    WorkerProcess::Status status  = workerProcess->execute(request, activeContext, response);
+    bool                  success = false;
+
+    if (status == WorkerProcess::Status::SUCCESS) {
+        WorkerProtocol::CacheAccess       cacheAccess;
+        QByteArray                        objectData;
+        QByteArray                        timeTraceData;
+        Cbe::CompilerTiming               timing;
+        QList<WorkerProtocol::Diagnostic> diagnostics;
+
+        bool decoded = WorkerProtocol::decodeResponse(
+            response,
+            success,
+            cacheAccess,
+            objectData,
+            timeTraceData,
+            timing,
+            diagnostics
+        );
+
+        if (decoded) {
+            for (  QList<WorkerProtocol::Diagnostic>::const_iterator diagnosticIterator    = diagnostics.constBegin(),
+                                                                     diagnosticEndIterator = diagnostics.constEnd()
+                 ; diagnosticIterator != diagnosticEndIterator
+                 ; ++diagnosticIterator
+                ) {
+                processDiagnostic(
+                    currentNotifier,
+                    activeContext,
+                    diagnosticIterator->level,
+                    diagnosticIterator->code,
+                    diagnosticIterator->message,
+                    diagnosticIterator->filename,
+                    diagnosticIterator->byteOffset,
+                    diagnosticIterator->lineNumber,
+                    diagnosticIterator->columnNumber
+                );
+            }
+
+            if (activeContext->objectDestination() == Cbe::CompilerContext::ObjectDestination::MEMORY) {
+                activeContext->setObjectData(success ? objectData : QByteArray());
+            }
+
+            if (activeContext->timeTraceDestination() != Cbe::CompilerContext::TimeTraceDestination::NONE) {
+                saveTimeTrace(timeTraceData);
+            }
+
+            if (cacheAccess != WorkerProtocol::CacheAccess::NONE) {
+                bool cacheHit = (cacheAccess == WorkerProtocol::CacheAccess::HIT);
+                if (cacheHit) {
+                    ++currentCompileCacheHits;
+                } else {
+                    ++currentCompileCacheMisses;
+                }
+
+                if (currentNotifier != nullptr) {
+                    currentNotifier->compileCacheAccessed(cacheHit, currentCompileCacheHits, currentCompileCacheMisses);
+                }
+            }
+
+            activeContext->setTiming(timing);
+        } else {
+            // A worker that sends a malformed response can not be trusted with further requests.
+            workerProcess->stop();
+
+            success = false;
+            if (currentNotifier != nullptr) {
+                currentNotifier->fatalCompilerError(tr("Malformed response from compiler worker"), false);
+            }
+
+            activeContext->setTiming(Cbe::CompilerTiming());
+        }
+    } else {
+        if (status == WorkerProcess::Status::FAILED && currentNotifier != nullptr) {
+            currentNotifier->fatalCompilerError(workerProcess->errorString(), false);
+        }
+
+        activeContext->setTiming(Cbe::CompilerTiming());
+    }
+
+    if (!workerProcess->running()) {
+        // Start the replacement now so the next context does not pay for process startup.
+        workerProcess->start(workerExecutable());
+    }
+
+    compilerFinished(activeContext, success);
+}
+
+
+WorkerProtocol::Configuration CompilerImpl::workerConfiguration() {
+    WorkerProtocol::Configuration configuration;
+
+    configuration.compilerSwitches        = compilerSwitches();
+    configuration.systemRoot              = currentSystemRoot;
+    configuration.headerSearchPaths       = currentHeaderSearchPaths;
+    configuration.headers                 = currentHeaders;
+    configuration.precompiledHeaders      = currentPrecompiledHeaders;
+    configuration.runtimeBitcodeModules   = currentRuntimeBitcodeModules;
+    configuration.resourceDirectory       = currentResourceDirectory;
+    configuration.gccToolchain            = currentGccToolchainPrefix;
+    configuration.targetTriple            = currentTargetTripleOverride;
+    configuration.automaticPchEnabled     = currentAutomaticPchEnabled;
+    configuration.pchCacheDirectory       = pchCacheDirectory();
+    configuration.modulesEnabled          = currentModulesEnabled;
+    configuration.moduleCacheDirectory    = moduleCacheDirectory();
+    configuration.compileCacheEnabled     = currentCompileCacheEnabled;
+    configuration.compileCacheDirectory   = compileCacheDirectory();
+    configuration.compileCacheMaximumSize = currentCompileCacheMaximumSize;
+    configuration.preambleReuseEnabled    = currentPreambleReuseEnabled;
+    configuration.debugOutputEnabled      = currentDebugOutputEnabled;
+
+    return configuration;
+}
+
+
+QString CompilerImpl::workerExecutable() const {
+    return QDir(executableDirectory()).absoluteFilePath(Cbe::CompilerWorker::executableName());
+}
@@ -36,11 +36,16 @@
 #include <QThread>
 #include <QScopedPointer>
 #include <QSharedPointer>
-#include <QTemporaryFile>
 #include <QMutex>
+#include <QReadWriteLock>
 #include <QVector>
+#include <QMap>
 #include <QSet>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "warnings.h"
 
 SUPPRESS_LLVM_WARNINGS
@@ -48,6 +53,10 @@ SUPPRESS_LLVM_WARNINGS
 #include <clang/Basic/Diagnostic.h>
 #include <clang/Basic/FileEntry.h>
 #include <llvm/Support/ErrorOr.h>
+#include <llvm/Support/VirtualFileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/ADT/IntrusiveRefCntPtr.h>
+#include <llvm/ADT/SmallVector.h>
 
 RESTORE_LLVM_WARNINGS
 
@@ -57,6 +66,8 @@ RESTORE_LLVM_WARNINGS
 #include "cbe_compiler_diagnostic.h"
 #include "cbe_job_queue.h"
 #include "cbe_compiler.h"
+#include "phase_timer.h"
+#include "worker_protocol.h"
 
 namespace Cbe {
     class CompilerNotifier;
@@ -64,8 +75,13 @@ namespace Cbe {
 
 namespace clang {
     class CompilerInstance;
+    class PrecompiledPreamble;
 }
 
+class CompileCache;
+class DependencyCollector;
+class WorkerProcess;
+
 /**
  * Underlying implementation for the \ref Cbe::Compiler class.
  */
@@ -81,6 +97,34 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
 
         ~CompilerImpl() override;
 
+        /**
+         * Method you can use to select how LLVM code generation targets are initialized.
+         *
+         * \param[in] newTargetInitialization The new target initialization policy.
+         */
+        static void setTargetInitialization(Cbe::Compiler::TargetInitialization newTargetInitialization);
+
+        /**
+         * Method you can use to determine how LLVM code generation targets are initialized.
+         *
+         * \return Returns the target initialization policy.
+         */
+        static Cbe::Compiler::TargetInitialization targetInitialization();
+
+        /**
+         * Method you can use to list targets to be initialized along with the native target.
+         *
+         * \param[in] newInitialTargets The LLVM backend names of the targets.
+         */
+        static void setInitialTargets(const QList<QString>& newInitialTargets);
+
+        /**
+         * Method you can use to obtain the targets to be initialized along with the native target.
+         *
+         * \return Returns the LLVM backend names of the targets.
+         */
+        static QList<QString> initialTargets();
+
         /**
          * Method you can use to enable or disable debug output.
          *
@@ -125,6 +169,22 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         void setJobQueue(QSharedPointer<Cbe::JobQueue<Cbe::CompilerContext>> newJobQueue);
 
+        /**
+         * Method you can use to change the underlying job queue along with the mutex used to guard it.  This method
+         * allows several compilers to drain a single, shared, job queue.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] newJobQueue      The new job queue used to track jobs.
+         *
+         * \param[in] newJobQueueMutex The mutex used to guard the job queue.  All compilers sharing a job queue must
+         *                             also share the same mutex.
+         */
+        void setJobQueue(
+            QSharedPointer<Cbe::JobQueue<Cbe::CompilerContext>> newJobQueue,
+            QSharedPointer<QMutex>                              newJobQueueMutex
+        );
+
         /**
          * Method you can call to determine if the compiler is an internal function or an external executable.
          *
@@ -134,21 +194,34 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
         bool isInternal() const;
 
         /**
-         * Method you can use to set the executable directory.  Call to this function will be ignored if the
-         * compiler is an internal function.  If the compiler is external, you must call this function prior to
-         * invoking the compiler.
+         * Method you can use to enable or disable worker processes.
+         *
+         * \param[in] nowEnabled If true, worker processes will be used.  If false, contexts will be compiled in
+         *                       this process.
+         */
+        void setWorkerProcessEnabled(bool nowEnabled);
+
+        /**
+         * Method you can use to determine if worker processes are enabled.
+         *
+         * \return Returns true if worker processes are enabled.
+         */
+        bool workerProcessEnabled() const;
+
+        /**
+         * Method you can use to set the directory holding the worker executable.
          *
          * This method may block until all pending contexts have been processed by the compiler.
          *
-         * \param[in] newExecutableDirectory The directory where the compiler executable is expected to be found.
+         * \param[in] newExecutableDirectory The directory where the worker executable is expected to be found.  An
+         *                                   empty string selects the directory holding the application executable.
          */
         void setExecutableDirectory(const QString& newExecutableDirectory);
 
         /**
          * Method you can use to determine the current executable directory.
          *
-         * \return Returns the path to the executable directory.  An empty string will be returned if the compiler
-         *         is an internal function.
+         * \return Returns the path to the executable directory.
          */
         QString executableDirectory() const;
 
@@ -246,6 +319,24 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         void setPrecompiledHeaders(const QList<QString>& newPrecompiledHeaders);
 
+        /**
+         * Method you can use to obtain the current list of runtime bitcode modules.
+         *
+         * \return Returns a list of the runtime bitcode modules linked into each compiled module.
+         */
+        QList<QString> runtimeBitcodeModules() const;
+
+        /**
+         * Method you can use to change the list of runtime bitcode modules.  Each module is linked into every compiled
+         * module before optimization.  Only functions referenced by the compiled module are linked and linked
+         * functions are internalized.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] newRuntimeBitcodeModules the new list of runtime bitcode modules.
+         */
+        void setRuntimeBitcodeModules(const QList<QString>& newRuntimeBitcodeModules);
+
         /**
          * Method you can use to obtain the current resource directory.
          *
@@ -296,6 +387,176 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         void setTargetTriple(const QString& newTargetTriple);
 
+        /**
+         * Method you can use to enable or disable automatic precompiled headers.  When enabled, the headers supplied
+         * through \ref CompilerImpl::setHeaders are compiled into a precompiled header the first time they are used.
+         * The precompiled header is reused until the configuration or any of the headers change.  Automatic
+         * precompiled headers are not used if explicit precompiled headers have been supplied.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] nowEnabled If true, automatic precompiled headers will be enabled.  If false, automatic
+         *                       precompiled headers will be disabled.
+         */
+        void setAutomaticPchEnabled(bool nowEnabled);
+
+        /**
+         * Method you can use to determine if automatic precompiled headers are enabled.
+         *
+         * \return Returns true if automatic precompiled headers are enabled.  Returns false if automatic precompiled
+         *         headers are disabled.
+         */
+        bool automaticPchEnabled() const;
+
+        /**
+         * Method you can use to set the directory used to cache automatically generated precompiled headers.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] newPchCacheDirectory The new cache directory.  An empty string will select a directory under the
+         *                                 system temporary directory.
+         */
+        void setPchCacheDirectory(const QString& newPchCacheDirectory);
+
+        /**
+         * Method you can use to determine the directory used to cache automatically generated precompiled headers.
+         *
+         * \return Returns the cache directory.
+         */
+        QString pchCacheDirectory() const;
+
+        /**
+         * Method you can use to enable or disable implicit clang modules.  Module maps are located through the header
+         * search paths and compiled modules are kept in the module cache directory.  Automatic precompiled headers
+         * are not used while modules are enabled.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] nowEnabled If true, modules will be enabled.  If false, modules will be disabled.
+         */
+        void setModulesEnabled(bool nowEnabled);
+
+        /**
+         * Method you can use to determine if implicit clang modules are enabled.
+         *
+         * \return Returns true if modules are enabled.  Returns false if modules are disabled.
+         */
+        bool modulesEnabled() const;
+
+        /**
+         * Method you can use to set the directory used to cache compiled modules.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] newModuleCacheDirectory The new cache directory.  An empty string will select a directory under
+         *                                    the system temporary directory.
+         */
+        void setModuleCacheDirectory(const QString& newModuleCacheDirectory);
+
+        /**
+         * Method you can use to determine the directory used to cache compiled modules.
+         *
+         * \return Returns the cache directory.
+         */
+        QString moduleCacheDirectory() const;
+
+        /**
+         * Method you can use to enable or disable the compile cache.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] nowEnabled If true, the compile cache will be enabled.  If false, the compile cache will be
+         *                       disabled.
+         */
+        void setCompileCacheEnabled(bool nowEnabled);
+
+        /**
+         * Method you can use to determine if the compile cache is enabled.
+         *
+         * \return Returns true if the compile cache is enabled.  Returns false if the compile cache is disabled.
+         */
+        bool compileCacheEnabled() const;
+
+        /**
+         * Method you can use to set the directory holding the compile cache.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] newCompileCacheDirectory The new cache directory.  An empty string will select a directory under
+         *                                     the system temporary directory.
+         */
+        void setCompileCacheDirectory(const QString& newCompileCacheDirectory);
+
+        /**
+         * Method you can use to determine the directory holding the compile cache.
+         *
+         * \return Returns the cache directory.
+         */
+        QString compileCacheDirectory() const;
+
+        /**
+         * Method you can use to set the maximum size of the compile cache.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] newMaximumSize The new maximum cache size, in bytes.
+         */
+        void setCompileCacheMaximumSize(unsigned long long newMaximumSize);
+
+        /**
+         * Method you can use to determine the maximum size of the compile cache.
+         *
+         * \return Returns the maximum cache size, in bytes.
+         */
+        unsigned long long compileCacheMaximumSize() const;
+
+        /**
+         * Method you can use to determine the number of contexts satisfied from the compile cache.
+         *
+         * \return Returns the number of compile cache hits.
+         */
+        unsigned long long compileCacheHits() const;
+
+        /**
+         * Method you can use to determine the number of contexts compiled while the compile cache was enabled.
+         *
+         * \return Returns the number of compile cache misses.
+         */
+        unsigned long long compileCacheMisses() const;
+
+        /**
+         * Method you can use to enable or disable preamble reuse.  When enabled, a stable leading block of
+         * preprocessor directives in the source is compiled into a precompiled preamble and reused by later contexts.
+         *
+         * This method will block until all pending contexts have been processed by the compiler.
+         *
+         * \param[in] nowEnabled If true, preamble reuse will be enabled.  If false, preamble reuse will be
+         *                       disabled.
+         */
+        void setPreambleReuseEnabled(bool nowEnabled);
+
+        /**
+         * Method you can use to determine if preamble reuse is enabled.
+         *
+         * \return Returns true if preamble reuse is enabled.  Returns false if preamble reuse is disabled.
+         */
+        bool preambleReuseEnabled() const;
+
+        /**
+         * Method you can use to set the priority of the compiler thread.  The priority is applied immediately if the
+         * compiler is running and each time the compiler thread is started.
+         *
+         * \param[in] newThreadPriority The new thread priority.
+         */
+        void setThreadPriority(QThread::Priority newThreadPriority);
+
+        /**
+         * Method you can use to obtain the priority of the compiler thread.
+         *
+         * \return Returns the thread priority.
+         */
+        QThread::Priority threadPriority() const;
+
         /**
          * Convenience method that can be called to run the compiler on a context.
          *
@@ -303,6 +564,29 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         void compile(QSharedPointer<Cbe::CompilerContext> context);
 
+        /**
+         * Method that starts the compiler background thread if the thread is idle or is in the process of
+         * terminating.  Used when jobs are enqueued directly into a shared job queue.
+         *
+         * \return Returns true if the background thread was started.  Returns false if the background thread was
+         *         already running and will check the job queue again.
+         */
+        bool startIfIdle();
+
+        /**
+         * Method that queues jobs on this compiler's private batch queue.  The batch queue is drained before the job
+         * queue and keeps every job it is given, regardless of the job queue's policy.  Used for batches and for the
+         * members of failed batches.  This method can be called from the compiler background thread.
+         *
+         * \param[in] jobs The jobs to be queued, in order.
+         */
+        void enqueueBatchJobs(const QList<QSharedPointer<Cbe::CompilerContext>>& jobs);
+
+        /**
+         * Method that requests the background thread prepare the compiler before processing further contexts.
+         */
+        void warmUp();
+
         /**
          * Method that can be called to stall this thread until the compiler finishes.
          */
@@ -424,6 +708,11 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         static const unsigned long requiredStackSpace;
 
+        /**
+         * The default maximum compile cache size, in bytes.
+         */
+        static const unsigned long long defaultCompileCacheMaximumSize;
+
         /**
          * Class used to store diagnostic information.
          */
@@ -708,6 +997,25 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         static void configureCompilerBackend();
 
+        /**
+         * Method that initializes a single LLVM code generation target, including its assembly printer and parser.
+         * The caller must hold \ref CompilerImpl::targetInitializationMutex.
+         *
+         * \param[in] backendName The LLVM backend name of the target, for example "X86".
+         *
+         * \return Returns true if the target is available.  Returns false if the target is not built into LLVM.
+         */
+        static bool initializeTarget(const QString& backendName);
+
+        /**
+         * Method that initializes the LLVM code generation target used for a target triple, if needed.
+         *
+         * \param[in] triple The target triple.
+         *
+         * \return Returns true if the target is available.  Returns false if no target supports the triple.
+         */
+        static bool initializeTargetForTriple(const std::string& triple);
+
         /**
          * Method that adds a group of files or paths, with associated switches to a list of switches.
          *
@@ -745,6 +1053,229 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         bool reconfigureCompiler();
 
+        /**
+         * Method that configures a compiler instance from a set of clang++ command line switches.  The method also
+         * applies the system root and resource directory.  Diagnostics are not created on the instance.
+         *
+         * \param[in] instance          The compiler instance to be configured.
+         *
+         * \param[in] switches          The command line switches, including a leading executable name.
+         *
+         * \param[in] driverDiagnostics The diagnostics engine used to report problems with the switches.
+         *
+         * \return Returns true on success, returns false on error.
+         */
+        bool createCompilerInstance(
+            clang::CompilerInstance&  instance,
+            const QVector<char*>&     switches,
+            clang::DiagnosticsEngine& driverDiagnostics
+        );
+
+        /**
+         * Method that determines if an automatic precompiled header should be used with the current configuration.
+         *
+         * \return Returns true if an automatic precompiled header should be used.
+         */
+        bool automaticPchApplicable() const;
+
+        /**
+         * Method that determines if the automatic precompiled header in use no longer matches the configuration or
+         * headers.
+         *
+         * \return Returns true if the compiler must be reconfigured to rebuild the automatic precompiled header.
+         */
+        bool automaticPchStale() const;
+
+        /**
+         * Method that locates a header file using the current directory and header search paths.
+         *
+         * \param[in] header The header to be located.
+         *
+         * \return Returns the absolute path to the header.  An empty string is returned if the header could not be
+         *         found.
+         */
+        QString locateHeader(const QString& header) const;
+
+        /**
+         * Method that calculates the key identifying an automatic precompiled header.  The key covers the compiler
+         * version, switches, search paths, and the size and modification time of each listed header.  Headers those
+         * headers include are not covered by the key; they are validated against the precompiled header's input list.
+         *
+         * \return Returns the key as a hexadecimal string.
+         */
+        QByteArray calculateAutomaticPchKey() const;
+
+        /**
+         * Method that locates or builds the automatic precompiled header for the current configuration.  A cached
+         * precompiled header is only reused if none of the files it read have changed since it was built.
+         *
+         * \return Returns the path to the precompiled header.  An empty string is returned if the precompiled header
+         *         could not be built.
+         */
+        QString buildAutomaticPch();
+
+        /**
+         * Method that removes the automatic precompiled header in use so that the next reconfiguration rebuilds it.
+         */
+        void discardAutomaticPch();
+
+        /**
+         * Method that determines if any file read while building the automatic precompiled header has changed.
+         *
+         * \return Returns true if an input file was changed or removed.
+         */
+        bool automaticPchInputsChanged() const;
+
+        /**
+         * Method that reads the list of files read while building an automatic precompiled header.
+         *
+         * \param[in] filename The file holding the input list.
+         *
+         * \return Returns true on success, returns false if the list could not be read.
+         */
+        bool readAutomaticPchInputs(const QString& filename);
+
+        /**
+         * Method that writes the list of files read while building an automatic precompiled header.
+         *
+         * \param[in] filename The file to hold the input list.
+         *
+         * \return Returns true on success, returns false on error.
+         */
+        bool writeAutomaticPchInputs(const QString& filename) const;
+
+        /**
+         * Method that calculates a stamp used to detect changes to a file.
+         *
+         * \param[in] filename The file to be stamped.
+         *
+         * \return Returns the stamp, built from the file's size and modification time.  An empty string is returned
+         *         if the file does not exist.
+         */
+        static QString fileStamp(const QString& filename);
+
+        /**
+         * Method that serializes the effective command line and configuration, including the active context's object
+         * format, for use in compile cache lookup keys.  The main filename is excluded so that caches can be shared
+         * across compiler instances.
+         *
+         * \param[in] virtualHeaders The virtual headers supplied by the active context.
+         *
+         * \return Returns the serialized command line.
+         */
+        QByteArray compileCacheCommandLine(const QMap<QString, QByteArray>& virtualHeaders) const;
+
+        /**
+         * Method that attempts to satisfy the active context from the compile cache.  On a hit, the cached object is
+         * written to the context's object destination and the context is reported as started and finished.
+         *
+         * \param[in] lookupKey The compile cache lookup key for the active context.
+         *
+         * \return Returns true if the active context was satisfied from the cache.  Returns false on a cache miss.
+         */
+        bool compileFromCache(const QByteArray& lookupKey);
+
+        /**
+         * Method that adds the object generated for the active context to the compile cache.  The object is only
+         * added if compilation succeeded without diagnostics.
+         *
+         * \param[in] lookupKey The compile cache lookup key for the active context.
+         *
+         * \param[in] success   Flag indicating if compilation succeeded.
+         */
+        void storeInCompileCache(const QByteArray& lookupKey, bool success);
+
+        /**
+         * Method that loads the active context's source, virtual headers, and preamble into the compiler instance ahead
+         * of running the frontend action.
+         *
+         * \param[in] virtualHeaders The virtual headers supplied by the active context.
+         *
+         * \param[in] objectBuffer   Buffer to receive the generated object.  A null pointer indicates that the object
+         *                           should be written to the context's object file.
+         */
+        void prepareFrontendAction(
+            const QMap<QString, QByteArray>& virtualHeaders,
+            llvm::SmallVector<char, 0>*      objectBuffer
+        );
+
+        /**
+         * Method that executes the frontend action selected by the compiler invocation for the active context.  The
+         * method also generates the context's time trace, if requested.
+         *
+         * \return Returns true on success, returns false on error.
+         */
+        bool executeFrontendAction();
+
+        /**
+         * Method that delivers a time trace to the active context.
+         *
+         * \param[in] timeTrace The time trace JSON document.
+         */
+        void saveTimeTrace(const QByteArray& timeTrace);
+
+        /**
+         * Method that determines if a virtual header used by a previous context is missing from the supplied set.
+         * The file manager remembers every virtual header it has seen so the compiler must be reconfigured to hide
+         * removed headers.
+         *
+         * \param[in] virtualHeaders The virtual headers supplied by the active context.
+         *
+         * \return Returns true if a previously used virtual header was removed.
+         */
+        bool virtualHeadersRemoved(const QMap<QString, QByteArray>& virtualHeaders) const;
+
+        /**
+         * Method that makes the virtual headers supplied by the active context visible to the compiler.  Headers from
+         * the previous context are replaced.
+         *
+         * \param[in] virtualHeaders The virtual headers supplied by the active context.
+         */
+        void configureVirtualHeaders(const QMap<QString, QByteArray>& virtualHeaders);
+
+        /**
+         * Method that configures the compiler instance to use a precompiled preamble for the supplied source, if
+         * possible.  A preamble is built once the same leading block of preprocessor directives is seen in two
+         * consecutive contexts.  Any preamble settings from the previous context are removed.
+         *
+         * \param[in] source The source about to be compiled.
+         */
+        void configurePreamble(const QByteArray& source);
+
+        /**
+         * Method that dequeues the next job and updates the isTerminatingThread sentinel.  Jobs on the private batch
+         * queue are returned before jobs on the job queue.  The queue mutex is only used if the job queue is not
+         * thread safe.
+         *
+         * \return Returns the next job.  A null pointer is returned if the background thread should terminate.
+         */
+        QSharedPointer<Cbe::CompilerContext> dequeueJob();
+
+        /**
+         * Method that compiles the active context in the worker process, starting the worker if needed.
+         */
+        void compileInWorkerProcess();
+
+        /**
+         * Method that prepares the compiler instance, including any automatic precompiled header, or starts the worker
+         * process, ahead of the next context.
+         */
+        void warmUpCompiler();
+
+        /**
+         * Method that builds the configuration sent to the worker process.
+         *
+         * \return Returns the worker configuration.
+         */
+        WorkerProtocol::Configuration workerConfiguration();
+
+        /**
+         * Method that determines the full path to the worker executable.
+         *
+         * \return Returns the path to the worker executable.
+         */
+        QString workerExecutable() const;
+
         /**
          * Shared pointer to the compiler's job queue.
          */
@@ -753,12 +1284,27 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
         /**
          * Mutex used to protect the job queue during enqueue and dequeue operations.
          */
-        QMutex jobQueueMutex;
+        QSharedPointer<QMutex> jobQueueMutex;
+
+        /**
+         * Jobs on the private batch queue, oldest first.
+         */
+        QList<QSharedPointer<Cbe::CompilerContext>> batchJobs;
+
+        /**
+         * Mutex used to protect the private batch queue.
+         */
+        QMutex batchJobsMutex;
 
         /**
          * Flag used by the compiler background thread to indicate that it's in the process of terminating.
          */
-        volatile bool isTerminatingThread;
+        std::atomic<bool> isTerminatingThread;
+
+        /**
+         * Flag indicating that the background thread should prepare the compiler before processing further contexts.
+         */
+        std::atomic<bool> warmUpRequested;
 
         /**
          * The compiler context that is actively being processed by the compiler.  Used to assist with error reporting.
@@ -781,16 +1327,44 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
         QMutex compilerAccessMutex;
 
         /**
-         * A temporary file used to trick the compiler into not erroring out before we can get it property configured.
-         * The temporary file will be empty and remain alive from the first compilation attempt until the class instance
-         * is destroyed.
+         * In-memory file system holding the compiler's main file.  The clang driver requires an input file before we
+         * can configure the compiler.  The main file only exists in this file system and is empty.  The contents of
+         * each context are supplied through the source manager.  The main file's directory also serves as the
+         * directory holding virtual headers.
+         */
+        llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> inMemoryFileSystem;
+
+        /**
+         * File system used by the compiler.  The in-memory file system is layered over the real file system.  The
+         * virtual header directory is masked in the real file system so lookups under it are only served from memory.
+         */
+        llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> overlayFileSystem;
+
+        /**
+         * Buffer holding the main filename.  The name is unique to this compiler instance.
+         */
+        QByteArray mainFilename;
+
+        /**
+         * The directory that virtual headers appear under.  The directory only exists in the in-memory file system.
+         */
+        QString virtualHeaderDirectory;
+
+        /**
+         * Flag indicating if the virtual header directory is on the header search path of the current compiler
+         * instance.  The directory is only added when the context supplies virtual headers.
+         */
+        bool virtualHeaderDirectoryIncluded;
+
+        /**
+         * The names of the virtual headers known to the current compiler instance.
          */
-        QTemporaryFile temporaryInputFile;
+        QList<QString> currentVirtualHeaderNames;
 
         /**
-         * Buffer holding the current temporary input filename.
+         * Buffers holding the virtual headers for the active context.
          */
-        QByteArray temporaryInputFilename;
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> virtualHeaderBuffers;
 
         /**
          * Set pointing to all the defined instances of \ref CompilerImpl.  This set is used for fatal error
@@ -798,6 +1372,13 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         static QSet<CompilerImpl*> compilers;
 
+        /**
+         * Lock used to keep other compilers from running while a time trace is being generated.  The LLVM time trace
+         * profiler is a single, process wide, instance that is not thread safe.  Compilers hold the lock for the
+         * duration of each job, for writing when generating a time trace and for reading otherwise.
+         */
+        static QReadWriteLock timeTraceLock;
+
         /**
          * The compiler's main file instance.
          */
@@ -839,6 +1420,11 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         QList<QString> currentPrecompiledHeaders;
 
+        /**
+         * The current list of runtime bitcode modules to be linked into each compiled module.
+         */
+        QList<QString> currentRuntimeBitcodeModules;
+
         /**
          * The current resource directory.
          */
@@ -854,6 +1440,120 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         QString currentTargetTripleOverride;
 
+        /**
+         * Flag indicating if automatic precompiled headers are enabled.
+         */
+        bool currentAutomaticPchEnabled;
+
+        /**
+         * The directory used to cache automatic precompiled headers.  An empty string indicates the default.
+         */
+        QString currentPchCacheDirectory;
+
+        /**
+         * The key of the automatic precompiled header used by the current compiler instance.
+         */
+        QByteArray currentAutomaticPchKey;
+
+        /**
+         * The automatic precompiled header used by the current compiler instance.  An empty string indicates that the
+         * headers are included directly.
+         */
+        QString currentAutomaticPchFile;
+
+        /**
+         * Stamps of every file read while building the automatic precompiled header, keyed by filename.
+         */
+        QMap<QString, QString> currentAutomaticPchInputs;
+
+        /**
+         * Flag set when clang reports that it could not load the automatic precompiled header.
+         */
+        bool automaticPchLoadFailed;
+
+        /**
+         * Flag indicating if implicit clang modules are enabled.
+         */
+        bool currentModulesEnabled;
+
+        /**
+         * The directory used to cache compiled modules.  An empty string indicates the default.
+         */
+        QString currentModuleCacheDirectory;
+
+        /**
+         * Flag indicating if the compile cache is enabled.
+         */
+        bool currentCompileCacheEnabled;
+
+        /**
+         * The directory holding the compile cache.  An empty string indicates the default.
+         */
+        QString currentCompileCacheDirectory;
+
+        /**
+         * The maximum compile cache size, in bytes.
+         */
+        unsigned long long currentCompileCacheMaximumSize;
+
+        /**
+         * The number of compile cache hits.
+         */
+        std::atomic<unsigned long long> currentCompileCacheHits;
+
+        /**
+         * The number of compile cache misses.
+         */
+        std::atomic<unsigned long long> currentCompileCacheMisses;
+
+        /**
+         * The compile cache used by the current compiler instance.
+         */
+        QScopedPointer<CompileCache> compileCache;
+
+        /**
+         * Dependency collector used to record the files read while compiling.  Only used with the compile cache.
+         */
+        std::shared_ptr<DependencyCollector> dependencyCollector;
+
+        /**
+         * Flag indicating if preamble reuse is enabled.
+         */
+        bool currentPreambleReuseEnabled;
+
+        /**
+         * Flag indicating if the current compiler instance can use a preamble.  Preambles can not be combined with
+         * a precompiled header.
+         */
+        bool preambleApplicable;
+
+        /**
+         * The preamble used by the current compiler instance.
+         */
+        QScopedPointer<clang::PrecompiledPreamble> preamble;
+
+        /**
+         * The preamble region of the previously compiled source.  Used to detect a stable preamble before one is
+         * built.
+         */
+        QByteArray previousPreambleSource;
+
+        /**
+         * The preamble region that most recently failed to build.  The region is not rebuilt until the preamble region
+         * changes or the compiler instance is reconfigured.
+         */
+        QByteArray failedPreambleSource;
+
+        /**
+         * Timer used to track the time spent in each phase of the active compilation.
+         */
+        PhaseTimer phaseTimer;
+
+        /**
+         * The priority used for the compiler thread.
+         */
+        QThread::Priority currentThreadPriority;
+
         /**
          * Vector holding the user's command line switches.  The compiler maintains a lot of string values by reference
          * forcing us to maintain persistent copies of the data.
@@ -865,6 +1565,31 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          */
         static bool backendInitializationNeeded;
 
+        /**
+         * The target initialization policy.
+         */
+        static Cbe::Compiler::TargetInitialization currentTargetInitialization;
+
+        /**
+         * The targets to be initialized along with the native target.
+         */
+        static QList<QString> currentInitialTargets;
+
+        /**
+         * Mutex used to serialize target initialization across compiler threads.
+         */
+        static QMutex targetInitializationMutex;
+
+        /**
+         * Flag indicating that every target has been initialized.
+         */
+        static bool allTargetsInitialized;
+
+        /**
+         * The LLVM backend names of the targets initialized on demand.
+         */
+        static QSet<QString> initializedTargets;
+
         /**
          * The notifier that receives information about the compilation operation.
          */
@@ -874,6 +1599,26 @@ class CBE_PUBLIC_API CompilerImpl:public QThread {
          * The current list of reported diagnostics.
          */
         QList<DiagnosticData> currentDiagnostics;
+
+        /**
+         * Flag indicating if contexts are compiled in a worker process.
+         */
+        bool currentWorkerProcessEnabled;
+
+        /**
+         * The directory holding the worker executable.  An empty string indicates the default.
+         */
+        QString currentExecutableDirectory;
+
+        /**
+         * Flag indicating that the worker process must be replaced before the next context is compiled.
+         */
+        bool workerRestartNeeded;
+
+        /**
+         * The worker process.  The worker is created and used by the compiler's background thread.
+         */
+        QScopedPointer<WorkerProcess> workerProcess;
 };
 
 #endif
@@ -0,0 +1,96 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref DependencyCollector class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef DEPENDENCY_COLLECTOR_H
+#define DEPENDENCY_COLLECTOR_H
+
+#include <QString>
+#include <QList>
+
+#include <llvm/ADT/StringRef.h>
+#include <clang/Frontend/Utils.h>
+
+/**
+ * This class is a custom dependency collector used to record every file read while compiling a translation unit.
+ * The compile cache uses the recorded files to determine if a cached result is still valid.
+ */
+class DependencyCollector:public clang::DependencyCollector {
+    public:
+        DependencyCollector();
+
+        ~DependencyCollector() override;
+
+        /**
+         * Method you can call to discard the recorded dependencies.  You should call this method before each
+         * compilation.
+         */
+        void clear();
+
+        /**
+         * Method you can call to obtain the recorded dependencies.
+         *
+         * \return Returns a list of files the last compilation depended on.  Each file is listed once.
+         */
+        const QList<QString>& dependencies() const;
+
+        /**
+         * Method called by the compiler to report a dependency.
+         *
+         * \param[in] filename     The name of the file.
+         *
+         * \param[in] fromModule   If true, the file was referenced by a module.
+         *
+         * \param[in] isSystem     If true, the file is a system header.
+         *
+         * \param[in] isModuleFile If true, the file is a module file.
+         *
+         * \param[in] isMissing    If true, the file could not be found.
+         *
+         * \return Returns false so the base class does not also track the file.
+         */
+        bool sawDependency(
+            llvm::StringRef filename,
+            bool            fromModule,
+            bool            isSystem,
+            bool            isModuleFile,
+            bool            isMissing
+        ) final;
+
+        /**
+         * Method called by the compiler to determine if system headers should be reported.
+         *
+         * \return Returns true.  System headers can change between runs and must be tracked.
+         */
+        bool needSystemDependencies() final;
+
+    private:
+        QList<QString> currentDependencies;
+};
+
+#endif
@@ -0,0 +1,204 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref InstrumentedAction, \ref CancellationConsumer, and \ref PhaseMarkerConsumer classes.
+***********************************************************************************************************************/
+
+#include <QSharedPointer>
+
+#include <memory>
+#include <vector>
+
+#include "warnings.h"
+
+SUPPRESS_LLVM_WARNINGS
+
+#include <llvm/ADT/StringRef.h>
+#include <clang/AST/ASTConsumer.h>
+#include <clang/AST/DeclGroup.h>
+#include <clang/AST/Decl.h>
+#include <clang/AST/DeclCXX.h>
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/FrontendAction.h>
+#include <clang/Frontend/MultiplexConsumer.h>
+
+RESTORE_LLVM_WARNINGS
+
+#include "cbe_compiler_context.h"
+#include "cbe_compiler_timing.h"
+#include "phase_timer.h"
+#include "instrumented_action.h"
+
+/***********************************************************************************************************************
+ * CancellationConsumer
+ */
+
+CancellationConsumer::CancellationConsumer(
+        QSharedPointer<Cbe::CompilerContext> newContext,
+        clang::DiagnosticsEngine&            newDiagnostics
+    ):context(
+        newContext
+    ),diagnostics(
+        newDiagnostics
+    ) {
+    cancellationReported = false;
+}
+
+
+CancellationConsumer::~CancellationConsumer() {}
+
+
+bool CancellationConsumer::HandleTopLevelDecl(clang::DeclGroupRef) {
+    return !checkCancelled();
+}
+
+
+void CancellationConsumer::HandleTranslationUnit(clang::ASTContext&) {
+    // The code generator discards the module if an error was reported so this is our last chance to avoid the
+    // optimizer and code generator.
+    checkCancelled();
+}
+
+
+bool CancellationConsumer::checkCancelled() {
+    bool cancelled = context->cancelled();
+
+    if (cancelled && !cancellationReported) {
+        unsigned diagnosticId = diagnostics.getCustomDiagID(clang::DiagnosticsEngine::Error, "compilation cancelled");
+        diagnostics.Report(diagnosticId);
+
+        cancellationReported = true;
+    }
+
+    return cancelled;
+}
+
+/***********************************************************************************************************************
+ * PhaseMarkerConsumer
+ */
+
+PhaseMarkerConsumer::PhaseMarkerConsumer(PhaseTimer& newTimer, Role newRole):timer(newTimer),role(newRole) {}
+
+
+PhaseMarkerConsumer::~PhaseMarkerConsumer() {}
+
+
+bool PhaseMarkerConsumer::HandleTopLevelDecl(clang::DeclGroupRef) {
+    mark(Cbe::CompilerTiming::Phase::IR_GENERATION);
+    return true;
+}
+
+
+void PhaseMarkerConsumer::HandleInlineFunctionDefinition(clang::FunctionDecl*) {
+    mark(Cbe::CompilerTiming::Phase::IR_GENERATION);
+}
+
+
+void PhaseMarkerConsumer::HandleInterestingDecl(clang::DeclGroupRef) {
+    // The default implementation forwards to HandleTopLevelDecl which would mark the phase twice.
+    mark(Cbe::CompilerTiming::Phase::IR_GENERATION);
+}
+
+
+void PhaseMarkerConsumer::HandleTagDeclDefinition(clang::TagDecl*) {
+    mark(Cbe::CompilerTiming::Phase::IR_GENERATION);
+}
+
+
+void PhaseMarkerConsumer::CompleteTentativeDefinition(clang::VarDecl*) {
+    mark(Cbe::CompilerTiming::Phase::IR_GENERATION);
+}
+
+
+void PhaseMarkerConsumer::HandleVTable(clang::CXXRecordDecl*) {
+    mark(Cbe::CompilerTiming::Phase::IR_GENERATION);
+}
+
+
+void PhaseMarkerConsumer::HandleTranslationUnit(clang::ASTContext&) {
+    mark(Cbe::CompilerTiming::Phase::BACKEND);
+}
+
+
+void PhaseMarkerConsumer::mark(Cbe::CompilerTiming::Phase phase) {
+    if (role == Role::ENTER) {
+        timer.enter(phase);
+    } else {
+        timer.leave();
+    }
+}
+
+/***********************************************************************************************************************
+ * InstrumentedAction
+ */
+
+InstrumentedAction::InstrumentedAction(
+        std::unique_ptr<clang::FrontendAction> wrappedAction,
+        QSharedPointer<Cbe::CompilerContext>   newContext,
+        PhaseTimer&                            newTimer
+    ):clang::WrapperFrontendAction(
+        std::move(wrappedAction)
+    ),context(
+        newContext
+    ),timer(
+        newTimer
+    ) {}
+
+
+InstrumentedAction::~InstrumentedAction() {}
+
+
+std::unique_ptr<clang::ASTConsumer> InstrumentedAction::CreateASTConsumer(
+        clang::CompilerInstance& compilerInstance,
+        llvm::StringRef          inputFile
+    ) {
+    std::unique_ptr<clang::ASTConsumer> result;
+    std::unique_ptr<clang::ASTConsumer> wrappedConsumer = clang::WrapperFrontendAction::CreateASTConsumer(
+        compilerInstance,
+        inputFile
+    );
+
+    if (wrappedConsumer) {
+        // The multiplexer calls consumers in order.  The cancellation check must precede the markers so a cancelled
+        // declaration never enters a phase it will not leave.
+        std::vector<std::unique_ptr<clang::ASTConsumer>> consumers;
+        consumers.push_back(
+            std::unique_ptr<clang::ASTConsumer>(
+                new CancellationConsumer(context, compilerInstance.getDiagnostics())
+            )
+        );
+        consumers.push_back(
+            std::unique_ptr<clang::ASTConsumer>(new PhaseMarkerConsumer(timer, PhaseMarkerConsumer::Role::ENTER))
+        );
+        consumers.push_back(std::move(wrappedConsumer));
+        consumers.push_back(
+            std::unique_ptr<clang::ASTConsumer>(new PhaseMarkerConsumer(timer, PhaseMarkerConsumer::Role::LEAVE))
+        );
+
+        result.reset(new clang::MultiplexConsumer(std::move(consumers)));
+    }
+
+    return result;
+}
@@ -0,0 +1,248 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref InstrumentedAction, \ref CancellationConsumer, and \ref PhaseMarkerConsumer classes.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef INSTRUMENTED_ACTION_H
+#define INSTRUMENTED_ACTION_H
+
+#include <QSharedPointer>
+
+#include <memory>
+
+#include <llvm/ADT/StringRef.h>
+#include <clang/AST/ASTConsumer.h>
+#include <clang/AST/DeclGroup.h>
+#include <clang/Frontend/FrontendAction.h>
+
+#include "cbe_compiler_timing.h"
+
+namespace clang {
+    class ASTContext;
+    class CXXRecordDecl;
+    class FunctionDecl;
+    class TagDecl;
+    class VarDecl;
+    class CompilerInstance;
+    class DiagnosticsEngine;
+}
+
+namespace Cbe {
+    class CompilerContext;
+}
+
+class PhaseTimer;
+
+/**
+ * AST consumer that checks a context's cancellation flag.  The consumer is placed ahead of the consumer performing
+ * code generation.  When cancellation is requested the consumer stops the parser and reports an error so the code
+ * generator discards the translation unit.
+ */
+class CancellationConsumer:public clang::ASTConsumer {
+    public:
+        /**
+         * Constructor
+         *
+         * \param[in] newContext     The context being compiled.
+         *
+         * \param[in] newDiagnostics The diagnostics engine used to flag the translation unit as failed.
+         */
+        CancellationConsumer(QSharedPointer<Cbe::CompilerContext> newContext, clang::DiagnosticsEngine& newDiagnostics);
+
+        ~CancellationConsumer() override;
+
+        /**
+         * Method called by the parser for each top level declaration.
+         *
+         * \param[in] declarationGroup The declarations.
+         *
+         * \return Returns false if the parser should stop.
+         */
+        bool HandleTopLevelDecl(clang::DeclGroupRef declarationGroup) final;
+
+        /**
+         * Method called once the translation unit has been parsed, before code generation.
+         *
+         * \param[in] astContext The AST context for the translation unit.
+         */
+        void HandleTranslationUnit(clang::ASTContext& astContext) final;
+
+    private:
+        /**
+         * Method that checks the cancellation flag and reports the cancellation once.
+         *
+         * \return Returns true if the context was cancelled.
+         */
+        bool checkCancelled();
+
+        QSharedPointer<Cbe::CompilerContext> context;
+        clang::DiagnosticsEngine&            diagnostics;
+        bool                                 cancellationReported;
+};
+
+/**
+ * AST consumer that marks the start or end of the code generator's work.  One marker is placed immediately ahead of
+ * the code generator's consumer and one immediately after it so the time spent generating IR for each declaration,
+ * and the time spent optimizing and emitting the module, can be separated from the time spent parsing.
+ */
+class PhaseMarkerConsumer:public clang::ASTConsumer {
+    public:
+        /**
+         * Enumeration of marker roles.
+         */
+        enum class Role {
+            /**
+             * The marker precedes the code generator and enters the phase.
+             */
+            ENTER,
+
+            /**
+             * The marker follows the code generator and leaves the phase.
+             */
+            LEAVE
+        };
+
+        /**
+         * Constructor
+         *
+         * \param[in] newTimer The timer used to track the phases.
+         *
+         * \param[in] newRole  The role of this marker.
+         */
+        PhaseMarkerConsumer(PhaseTimer& newTimer, Role newRole);
+
+        ~PhaseMarkerConsumer() override;
+
+        /**
+         * Method called by the parser for each top level declaration.
+         *
+         * \param[in] declarationGroup The declarations.
+         *
+         * \return Returns true so the parser continues.
+         */
+        bool HandleTopLevelDecl(clang::DeclGroupRef declarationGroup) final;
+
+        /**
+         * Method called by the parser for each inline function definition.
+         *
+         * \param[in] functionDeclaration The function declaration.
+         */
+        void HandleInlineFunctionDefinition(clang::FunctionDecl* functionDeclaration) final;
+
+        /**
+         * Method called for declarations deserialized from a PCH or preamble.
+         *
+         * \param[in] declarationGroup The declarations.
+         */
+        void HandleInterestingDecl(clang::DeclGroupRef declarationGroup) final;
+
+        /**
+         * Method called for each completed tag definition.
+         *
+         * \param[in] tagDeclaration The tag declaration.
+         */
+        void HandleTagDeclDefinition(clang::TagDecl* tagDeclaration) final;
+
+        /**
+         * Method called for each tentative definition remaining at the end of the translation unit.
+         *
+         * \param[in] variableDeclaration The variable declaration.
+         */
+        void CompleteTentativeDefinition(clang::VarDecl* variableDeclaration) final;
+
+        /**
+         * Method called when a class requires a vtable.
+         *
+         * \param[in] recordDeclaration The class declaration.
+         */
+        void HandleVTable(clang::CXXRecordDecl* recordDeclaration) final;
+
+        /**
+         * Method called once the translation unit has been parsed.  The code generator's work from this point is
+         * charged to the backend.
+         *
+         * \param[in] astContext The AST context for the translation unit.
+         */
+        void HandleTranslationUnit(clang::ASTContext& astContext) final;
+
+    private:
+        /**
+         * Method that enters or leaves a phase based on the role of this marker.
+         *
+         * \param[in] phase The phase to be entered.
+         */
+        void mark(Cbe::CompilerTiming::Phase phase);
+
+        PhaseTimer& timer;
+        Role        role;
+};
+
+/**
+ * Frontend action that wraps the action selected by the compiler invocation.  The action inserts a
+ * \ref CancellationConsumer ahead of the wrapped action's consumer and brackets the wrapped action's consumer with
+ * \ref PhaseMarkerConsumer instances.
+ */
+class InstrumentedAction:public clang::WrapperFrontendAction {
+    public:
+        /**
+         * Constructor
+         *
+         * \param[in] wrappedAction The action to be wrapped.
+         *
+         * \param[in] newContext    The context being compiled.
+         *
+         * \param[in] newTimer      The timer used to track the compilation phases.
+         */
+        InstrumentedAction(
+            std::unique_ptr<clang::FrontendAction> wrappedAction,
+            QSharedPointer<Cbe::CompilerContext>   newContext,
+            PhaseTimer&                            newTimer
+        );
+
+        ~InstrumentedAction() override;
+
+    protected:
+        /**
+         * Method called by the frontend to create the AST consumer.
+         *
+         * \param[in] compilerInstance The compiler instance.
+         *
+         * \param[in] inputFile        The input filename.
+         *
+         * \return Returns the consumer.
+         */
+        std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(
+            clang::CompilerInstance& compilerInstance,
+            llvm::StringRef          inputFile
+        ) final;
+
+    private:
+        QSharedPointer<Cbe::CompilerContext> context;
+        PhaseTimer&                          timer;
+};
+
+#endif
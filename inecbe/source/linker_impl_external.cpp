@@ -307,10 +307,27 @@ void LinkerImplExternal::setRunTimeSearchPaths(const QList<QString>& newRunTimeS
 }
 
 
+void LinkerImplExternal::setLtoCacheDirectory(const QString& newLtoCacheDirectory) {
+    QMutexLocker mutexLocker(&linkerAccessMutex);
+    currentLtoCacheDirectory = newLtoCacheDirectory;
+}
+
+
+QString LinkerImplExternal::ltoCacheDirectory() const {
+    return currentLtoCacheDirectory;
+}
+
+
 void LinkerImplExternal::link(QSharedPointer<Cbe::LinkerContext> context) {
-    jobQueueMutex.lock();
-    jobQueue->enqueue(context);
-    jobQueueMutex.unlock();
+    if (jobQueue->threadSafe()) {
+        jobQueue->enqueue(context);
+    } else {
+        jobQueueMutex.lock();
+        jobQueue->enqueue(context);
+        jobQueueMutex.unlock();
+    }
+
+    jobQueue->deliverNotifications();
 
     if (isTerminatingThread) {
         wait();
@@ -378,10 +395,7 @@ void LinkerImplExternal::run() {
     linkerExecutable.setProcessChannelMode(QProcess::MergedChannels);
 
     do {
-        jobQueueMutex.lock();
-        activeContext = jobQueue->dequeue();
-        isTerminatingThread = activeContext.isNull();
-        jobQueueMutex.unlock();
+        activeContext = dequeueJob();
 
         if (!isTerminatingThread) {
             QStringList switches = buildLinkerCommandLine(activeContext);
@@ -661,6 +675,26 @@ QStringList LinkerImplExternal::buildLinkerCommandLine(QSharedPointer<Cbe::Linke
 
     #endif
 
+    if (!currentLtoCacheDirectory.isEmpty()) {
+        #if (defined(_WIN32) || defined(_WIN64))
+
+            switches << QString("/lldltocache:%1").arg(currentLtoCacheDirectory);
+
+        #elif (defined(__APPLE__))
+
+            switches << QString("-Wl,-cache_path_lto,%1").arg(currentLtoCacheDirectory);
+
+        #elif (defined(__linux__))
+
+            switches << QString("--thinlto-cache-dir=%1").arg(currentLtoCacheDirectory);
+
+        #else
+
+            #error Unknown platform
+
+        #endif
+    }
+
     return switches;
 }
 
@@ -701,3 +735,35 @@ QStringList LinkerImplExternal::locateLibraries(
 
     return result;
 }
+
+
+QSharedPointer<Cbe::LinkerContext> LinkerImplExternal::dequeueJob() {
+    QSharedPointer<Cbe::LinkerContext> result;
+
+    if (jobQueue->threadSafe()) {
+        bool checkQueue = true;
+        while (checkQueue) {
+            result = jobQueue->dequeue();
+            if (result.isNull()) {
+                // Publish the sentinel before re-checking the queue so a job enqueued concurrently is either seen here
+                // or causes the caller to restart the thread.
+                isTerminatingThread = true;
+                checkQueue = (jobQueue->numberPendingJobs() > 0);
+
+                if (checkQueue) {
+                    isTerminatingThread = false;
+                }
+            } else {
+                isTerminatingThread = false;
+                checkQueue = false;
+            }
+        }
+    } else {
+        jobQueueMutex.lock();
+        result = jobQueue->dequeue();
+        isTerminatingThread = result.isNull();
+        jobQueueMutex.unlock();
+    }
+
+    return result;
+}
@@ -37,6 +37,8 @@
 #include <QSharedPointer>
 #include <QMutex>
 
+#include <atomic>
+
 #include "cbe_common.h"
 #include "cbe_job_queue.h"
 #include "cbe_linker_context.h"
@@ -281,6 +283,20 @@ class CBE_PUBLIC_API LinkerImplExternal:public QThread {
          */
         void setRunTimeSearchPaths(const QList<QString>& newRunTimeSearchPaths);
 
+        /**
+         * Method you can use to set the directory used to cache ThinLTO results.
+         *
+         * \param[in] newLtoCacheDirectory The new cache directory.  An empty string disables the cache.
+         */
+        void setLtoCacheDirectory(const QString& newLtoCacheDirectory);
+
+        /**
+         * Method you can use to determine the directory used to cache ThinLTO results.
+         *
+         * \return Returns the cache directory.  An empty string is returned if the cache is disabled.
+         */
+        QString ltoCacheDirectory() const;
+
         /**
          * Method that can be called to run the linker.
          *
@@ -423,6 +439,14 @@ class CBE_PUBLIC_API LinkerImplExternal:public QThread {
             const QString&     extension
         );
 
+        /**
+         * Method that dequeues the next job and updates the isTerminatingThread sentinel.  The queue mutex is only
+         * used if the job queue is not thread safe.
+         *
+         * \return Returns the next job.  A null pointer is returned if the background thread should terminate.
+         */
+        QSharedPointer<Cbe::LinkerContext> dequeueJob();
+
         /**
          * Shared pointer to the linker's job queue.
          */
@@ -436,7 +460,7 @@ class CBE_PUBLIC_API LinkerImplExternal:public QThread {
         /**
          * Flag used by the linker background thread to indicate that it's in the process of terminating.
          */
-        volatile bool isTerminatingThread;
+        std::atomic<bool> isTerminatingThread;
 
         /**
          * Mutex used to keep linker invocations safe across threads.
@@ -499,6 +523,11 @@ class CBE_PUBLIC_API LinkerImplExternal:public QThread {
          */
         QList<QString> currentSystemLibraries;
 
+        /**
+         * The directory used to cache ThinLTO results.  An empty string indicates no cache.
+         */
+        QString currentLtoCacheDirectory;
+
         /**
          * The notifier that receives information about the link operation.
          */
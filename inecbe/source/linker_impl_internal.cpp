@@ -292,10 +292,27 @@ void LinkerImplInternal::setRunTimeSearchPaths(const QList<QString>& newRunTimeS
 }
 
 
+void LinkerImplInternal::setLtoCacheDirectory(const QString& newLtoCacheDirectory) {
+    QMutexLocker mutexLocker(&linkerAccessMutex);
+    currentLtoCacheDirectory = newLtoCacheDirectory;
+}
+
+
+QString LinkerImplInternal::ltoCacheDirectory() const {
+    return currentLtoCacheDirectory;
+}
+
+
 void LinkerImplInternal::link(QSharedPointer<Cbe::LinkerContext> context) {
-    jobQueueMutex.lock();
-    jobQueue->enqueue(context);
-    jobQueueMutex.unlock();
+    if (jobQueue->threadSafe()) {
+        jobQueue->enqueue(context);
+    } else {
+        jobQueueMutex.lock();
+        jobQueue->enqueue(context);
+        jobQueueMutex.unlock();
+    }
+
+    jobQueue->deliverNotifications();
 
     if (isTerminatingThread) {
         wait();
@@ -360,10 +377,7 @@ void LinkerImplInternal::run() {
     QMutexLocker mutexLocker(&linkerAccessMutex);
 
     do {
-        jobQueueMutex.lock();
-        activeContext = jobQueue->dequeue();
-        isTerminatingThread = activeContext.isNull();
-        jobQueueMutex.unlock();
+        activeContext = dequeueJob();
 
         if (!isTerminatingThread) {
             buildUserFriendlyCommandLine(activeContext);
@@ -588,6 +602,22 @@ void LinkerImplInternal::buildUserFriendlyCommandLine(QSharedPointer<Cbe::Linker
 
     #endif
 
+    if (!currentLtoCacheDirectory.isEmpty()) {
+        #if (defined(_WIN32) || defined(_WIN64))
+
+            switches << QString("/lldltocache:%1").arg(currentLtoCacheDirectory);
+
+        #elif (defined(__linux__))
+
+            switches << QString("--thinlto-cache-dir=%1").arg(currentLtoCacheDirectory);
+
+        #elif (!defined(__APPLE__))
+
+            #error Unknown platform
+
+        #endif
+    }
+
     for (QList<QString>::const_iterator it=switches.begin(),end=switches.end() ; it!=end ; ++it) {
         currentLinkerSwitches.push_back(strdup(it->toLocal8Bit().data()));
     }
@@ -605,3 +635,35 @@ void LinkerImplInternal::clearUserFriendlyCommandLine() {
 
     currentLinkerSwitches.clear();
 }
+
+
+QSharedPointer<Cbe::LinkerContext> LinkerImplInternal::dequeueJob() {
+    QSharedPointer<Cbe::LinkerContext> result;
+
+    if (jobQueue->threadSafe()) {
+        bool checkQueue = true;
+        while (checkQueue) {
+            result = jobQueue->dequeue();
+            if (result.isNull()) {
+                // Publish the sentinel before re-checking the queue so a job enqueued concurrently is either seen here
+                // or causes the caller to restart the thread.
+                isTerminatingThread = true;
+                checkQueue = (jobQueue->numberPendingJobs() > 0);
+
+                if (checkQueue) {
+                    isTerminatingThread = false;
+                }
+            } else {
+                isTerminatingThread = false;
+                checkQueue = false;
+            }
+        }
+    } else {
+        jobQueueMutex.lock();
+        result = jobQueue->dequeue();
+        isTerminatingThread = result.isNull();
+        jobQueueMutex.unlock();
+    }
+
+    return result;
+}
@@ -37,6 +37,8 @@
 #include <QSharedPointer>
 #include <QMutex>
 
+#include <atomic>
+
 #include "cbe_common.h"
 #include "cbe_job_queue.h"
 #include "cbe_linker_context.h"
@@ -271,6 +273,20 @@ class CBE_PUBLIC_API LinkerImplInternal:public QThread {
          */
         void setRunTimeSearchPaths(const QList<QString>& newRunTimeSearchPaths);
 
+        /**
+         * Method you can use to set the directory used to cache ThinLTO results.
+         *
+         * \param[in] newLtoCacheDirectory The new cache directory.  An empty string disables the cache.
+         */
+        void setLtoCacheDirectory(const QString& newLtoCacheDirectory);
+
+        /**
+         * Method you can use to determine the directory used to cache ThinLTO results.
+         *
+         * \return Returns the cache directory.  An empty string is returned if the cache is disabled.
+         */
+        QString ltoCacheDirectory() const;
+
         /**
          * Method that can be called to run the linker.
          *
@@ -396,6 +412,14 @@ class CBE_PUBLIC_API LinkerImplInternal:public QThread {
          */
         void clearUserFriendlyCommandLine();
 
+        /**
+         * Method that dequeues the next job and updates the isTerminatingThread sentinel.  The queue mutex is only
+         * used if the job queue is not thread safe.
+         *
+         * \return Returns the next job.  A null pointer is returned if the background thread should terminate.
+         */
+        QSharedPointer<Cbe::LinkerContext> dequeueJob();
+
         /**
          * Shared pointer to the linker's job queue.
          */
@@ -414,7 +438,7 @@ class CBE_PUBLIC_API LinkerImplInternal:public QThread {
         /**
          * Flag used by the linker background thread to indicate that it's in the process of terminating.
          */
-        volatile bool isTerminatingThread;
+        std::atomic<bool> isTerminatingThread;
 
         /**
          * Flag indicating if debug output should be enabled.
@@ -462,6 +486,11 @@ class CBE_PUBLIC_API LinkerImplInternal:public QThread {
          */
         QList<QString> currentSystemLibraries;
 
+        /**
+         * The directory used to cache ThinLTO results.  An empty string indicates no cache.
+         */
+        QString currentLtoCacheDirectory;
+
         /**
          * The input object files to be fed to the linker backend.
          */
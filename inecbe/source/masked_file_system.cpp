@@ -0,0 +1,122 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref MaskedFileSystem class.
+***********************************************************************************************************************/
+
+#include <string>
+#include <memory>
+#include <system_error>
+
+#include "warnings.h"
+
+SUPPRESS_LLVM_WARNINGS
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/Twine.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/IntrusiveRefCntPtr.h>
+#include <llvm/Support/ErrorOr.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/VirtualFileSystem.h>
+
+RESTORE_LLVM_WARNINGS
+
+#include "masked_file_system.h"
+
+MaskedFileSystem::MaskedFileSystem(
+        llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> underlyingFileSystem,
+        const std::string&                             maskedDirectory
+    ):llvm::vfs::ProxyFileSystem(
+        underlyingFileSystem
+    ),currentMaskedDirectory(
+        maskedDirectory
+    ) {}
+
+
+MaskedFileSystem::~MaskedFileSystem() {}
+
+
+llvm::ErrorOr<llvm::vfs::Status> MaskedFileSystem::status(const llvm::Twine& path) {
+    llvm::ErrorOr<llvm::vfs::Status> result = std::make_error_code(std::errc::no_such_file_or_directory);
+
+    if (!masked(path)) {
+        result = llvm::vfs::ProxyFileSystem::status(path);
+    }
+
+    return result;
+}
+
+
+llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> MaskedFileSystem::openFileForRead(const llvm::Twine& path) {
+    llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> result = std::make_error_code(
+        std::errc::no_such_file_or_directory
+    );
+
+    if (!masked(path)) {
+        result = llvm::vfs::ProxyFileSystem::openFileForRead(path);
+    }
+
+    return result;
+}
+
+
+llvm::vfs::directory_iterator MaskedFileSystem::dir_begin(const llvm::Twine& directory, std::error_code& errorCode) {
+    llvm::vfs::directory_iterator result;
+
+    if (masked(directory)) {
+        errorCode = std::make_error_code(std::errc::no_such_file_or_directory);
+    } else {
+        result = llvm::vfs::ProxyFileSystem::dir_begin(directory, errorCode);
+    }
+
+    return result;
+}
+
+
+std::error_code MaskedFileSystem::getRealPath(const llvm::Twine& path, llvm::SmallVectorImpl<char>& output) const {
+    std::error_code result = std::make_error_code(std::errc::no_such_file_or_directory);
+
+    if (!masked(path)) {
+        result = llvm::vfs::ProxyFileSystem::getRealPath(path, output);
+    }
+
+    return result;
+}
+
+
+bool MaskedFileSystem::masked(const llvm::Twine& path) const {
+    llvm::SmallString<256> normalizedPath;
+    path.toVector(normalizedPath);
+    llvm::sys::path::remove_dots(normalizedPath, true);
+
+    llvm::StringRef pathString(normalizedPath);
+    return (
+           pathString.startswith(currentMaskedDirectory)
+        && (   pathString.size() == currentMaskedDirectory.size()
+            || llvm::sys::path::is_separator(pathString[currentMaskedDirectory.size()])
+           )
+    );
+}
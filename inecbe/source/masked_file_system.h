@@ -0,0 +1,127 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref MaskedFileSystem class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef MASKED_FILE_SYSTEM_H
+#define MASKED_FILE_SYSTEM_H
+
+#include <string>
+#include <system_error>
+
+#include "warnings.h"
+
+SUPPRESS_LLVM_WARNINGS
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/Twine.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/IntrusiveRefCntPtr.h>
+#include <llvm/Support/ErrorOr.h>
+#include <llvm/Support/VirtualFileSystem.h>
+
+RESTORE_LLVM_WARNINGS
+
+/**
+ * File system that forwards to an underlying file system but hides a single directory and everything below it.  The
+ * compiler places its main file and virtual headers under a directory that only exists in an in-memory file system.
+ * Layering the in-memory file system over a masked real file system guarantees that lookups under that directory are
+ * never satisfied from disk, even if a directory with the same name exists.
+ */
+class MaskedFileSystem:public llvm::vfs::ProxyFileSystem {
+    public:
+        /**
+         * Constructor
+         *
+         * \param[in] underlyingFileSystem The file system to forward to.
+         *
+         * \param[in] maskedDirectory      The absolute path of the directory to hide.
+         */
+        MaskedFileSystem(
+            llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> underlyingFileSystem,
+            const std::string&                             maskedDirectory
+        );
+
+        ~MaskedFileSystem() override;
+
+        /**
+         * Method called to obtain the status of a file or directory.
+         *
+         * \param[in] path The path to the file or directory.
+         *
+         * \return Returns the status.  An error is returned for masked paths.
+         */
+        llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine& path) override;
+
+        /**
+         * Method called to open a file.
+         *
+         * \param[in] path The path to the file.
+         *
+         * \return Returns the opened file.  An error is returned for masked paths.
+         */
+        llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> openFileForRead(const llvm::Twine& path) override;
+
+        /**
+         * Method called to iterate over a directory.
+         *
+         * \param[in]  directory The directory to iterate over.
+         *
+         * \param[out] errorCode Receives an error for masked paths.
+         *
+         * \return Returns the directory iterator.  An end iterator is returned for masked paths.
+         */
+        llvm::vfs::directory_iterator dir_begin(const llvm::Twine& directory, std::error_code& errorCode) override;
+
+        /**
+         * Method called to resolve a path to a real path.
+         *
+         * \param[in]  path   The path to resolve.
+         *
+         * \param[out] output Receives the resolved path.
+         *
+         * \return Returns the error code.  An error is returned for masked paths.
+         */
+        std::error_code getRealPath(const llvm::Twine& path, llvm::SmallVectorImpl<char>& output) const override;
+
+    private:
+        /**
+         * Method that determines if a path lies within the masked directory.
+         *
+         * \param[in] path The path to check.
+         *
+         * \return Returns true if the path is masked.
+         */
+        bool masked(const llvm::Twine& path) const;
+
+        /**
+         * The masked directory.
+         */
+        std::string currentMaskedDirectory;
+};
+
+#endif
@@ -0,0 +1,154 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref PhaseTimer class.
+***********************************************************************************************************************/
+
+#include <QVector>
+
+#include <chrono>
+
+#if (defined(_WIN32) || defined(_WIN64))
+
+    #include <windows.h>
+
+#else
+
+    #include <time.h>
+
+#endif
+
+#include "cbe_compiler_timing.h"
+#include "phase_timer.h"
+
+PhaseTimer::PhaseTimer() {
+    reset();
+}
+
+
+PhaseTimer::~PhaseTimer() {}
+
+
+void PhaseTimer::reset() {
+    phaseStack.clear();
+
+    for (unsigned phaseIndex=0 ; phaseIndex<Cbe::CompilerTiming::numberPhases ; ++phaseIndex) {
+        wallTimes[phaseIndex] = 0;
+        cpuTimes[phaseIndex]  = 0;
+    }
+
+    lastWallTime = 0;
+    lastCpuTime  = 0;
+}
+
+
+void PhaseTimer::enter(Cbe::CompilerTiming::Phase phase) {
+    accumulate();
+    phaseStack.append(phase);
+}
+
+
+void PhaseTimer::leave() {
+    if (!phaseStack.isEmpty()) {
+        accumulate();
+        phaseStack.removeLast();
+    }
+}
+
+
+Cbe::CompilerTiming PhaseTimer::timing() const {
+    Cbe::CompilerTiming result;
+
+    for (unsigned phaseIndex=0 ; phaseIndex<Cbe::CompilerTiming::numberPhases ; ++phaseIndex) {
+        result.setTime(
+            static_cast<Cbe::CompilerTiming::Phase>(phaseIndex),
+            wallTimes[phaseIndex],
+            cpuTimes[phaseIndex]
+        );
+    }
+
+    return result;
+}
+
+
+void PhaseTimer::accumulate() {
+    double currentWallTime = wallClockTime();
+    double currentCpuTime  = threadCpuTime();
+
+    if (!phaseStack.isEmpty()) {
+        unsigned phaseIndex = static_cast<unsigned>(phaseStack.last());
+        wallTimes[phaseIndex] += currentWallTime - lastWallTime;
+        cpuTimes[phaseIndex]  += currentCpuTime - lastCpuTime;
+    }
+
+    lastWallTime = currentWallTime;
+    lastCpuTime  = currentCpuTime;
+}
+
+
+double PhaseTimer::wallClockTime() {
+    std::chrono::duration<double> sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+    return sinceEpoch.count();
+}
+
+
+double PhaseTimer::threadCpuTime() {
+    double result;
+
+    #if (defined(_WIN32) || defined(_WIN64))
+
+        FILETIME creationTime;
+        FILETIME exitTime;
+        FILETIME kernelTime;
+        FILETIME userTime;
+
+        if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+            unsigned long long kernelTicks = (
+                  (static_cast<unsigned long long>(kernelTime.dwHighDateTime) << 32)
+                | kernelTime.dwLowDateTime
+            );
+            unsigned long long userTicks = (
+                  (static_cast<unsigned long long>(userTime.dwHighDateTime) << 32)
+                | userTime.dwLowDateTime
+            );
+
+            // FILETIME values are in 100ns ticks.
+            result = (kernelTicks + userTicks) * 1.0E-7;
+        } else {
+            result = 0;
+        }
+
+    #else
+
+        struct timespec currentTime;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &currentTime) == 0) {
+            result = currentTime.tv_sec + currentTime.tv_nsec * 1.0E-9;
+        } else {
+            result = 0;
+        }
+
+    #endif
+
+    return result;
+}
@@ -0,0 +1,122 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref PhaseTimer class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include <QVector>
+
+#include "cbe_compiler_timing.h"
+
+/**
+ * Class that accumulates wall clock and thread CPU time for each compilation phase.  Phases nest.  Entering a phase
+ * suspends the enclosing phase until the nested phase is left so each phase reports only its own, exclusive, time.
+ *
+ * The class is used only by the compiler thread and is not thread safe.
+ */
+class PhaseTimer {
+    public:
+        PhaseTimer();
+
+        ~PhaseTimer();
+
+        /**
+         * Method that clears all accumulated time and leaves any phases that were entered.
+         */
+        void reset();
+
+        /**
+         * Method that enters a new phase, suspending the current phase, if any.
+         *
+         * \param[in] phase The phase being entered.
+         */
+        void enter(Cbe::CompilerTiming::Phase phase);
+
+        /**
+         * Method that leaves the current phase, resuming the enclosing phase, if any.  The method does nothing if
+         * no phase was entered.
+         */
+        void leave();
+
+        /**
+         * Method you can use to obtain the accumulated time.  Time spent in a phase that has not been left is not
+         * included.
+         *
+         * \return Returns the accumulated time for each phase.
+         */
+        Cbe::CompilerTiming timing() const;
+
+    private:
+        /**
+         * Method that charges the time since the last phase change to the current phase.
+         */
+        void accumulate();
+
+        /**
+         * Method that obtains the current monotonic wall clock time.
+         *
+         * \return Returns the wall clock time, in seconds.
+         */
+        static double wallClockTime();
+
+        /**
+         * Method that obtains the CPU time consumed by the calling thread.
+         *
+         * \return Returns the thread CPU time, in seconds.  A value of zero is returned on platforms where thread CPU
+         *         time is unavailable.
+         */
+        static double threadCpuTime();
+
+        /**
+         * Stack of entered phases.  The last entry is the current phase.
+         */
+        QVector<Cbe::CompilerTiming::Phase> phaseStack;
+
+        /**
+         * The wall clock time at the last phase change.
+         */
+        double lastWallTime;
+
+        /**
+         * The thread CPU time at the last phase change.
+         */
+        double lastCpuTime;
+
+        /**
+         * The accumulated wall clock time for each phase.
+         */
+        double wallTimes[Cbe::CompilerTiming::numberPhases];
+
+        /**
+         * The accumulated thread CPU time for each phase.
+         */
+        double cpuTimes[Cbe::CompilerTiming::numberPhases];
+};
+
+#endif
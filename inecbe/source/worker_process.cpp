@@ -0,0 +1,166 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref WorkerProcess class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QScopedPointer>
+#include <QProcess>
+
+#include "cbe_compiler_context.h"
+#include "worker_protocol.h"
+#include "worker_process.h"
+
+const int WorkerProcess::startTimeout       = 30000;
+const int WorkerProcess::stopTimeout        = 1000;
+const int WorkerProcess::pollInterval       = 50;
+const int WorkerProcess::maximumErrorOutput = 4096;
+
+WorkerProcess::WorkerProcess() {}
+
+
+WorkerProcess::~WorkerProcess() {
+    stop();
+}
+
+
+bool WorkerProcess::start(const QString& executable) {
+    if (!running()) {
+        process.reset(new QProcess);
+        receiveBuffer.clear();
+        errorOutput.clear();
+        currentErrorString.clear();
+
+        process->setProgram(executable);
+        process->start(QProcess::ReadWrite);
+
+        if (!process->waitForStarted(startTimeout)) {
+            fail(QString("Compiler worker %1 failed to start").arg(executable));
+        }
+    }
+
+    return running();
+}
+
+
+void WorkerProcess::stop() {
+    if (!process.isNull()) {
+        if (process->state() != QProcess::NotRunning) {
+            // Closing the worker's standard input asks the worker to exit.
+            process->closeWriteChannel();
+
+            if (!process->waitForFinished(stopTimeout)) {
+                process->kill();
+                process->waitForFinished(stopTimeout);
+            }
+        }
+
+        process.reset();
+    }
+}
+
+
+bool WorkerProcess::running() const {
+    return !process.isNull() && process->state() == QProcess::Running;
+}
+
+
+WorkerProcess::Status WorkerProcess::execute(
+        const QByteArray&                    request,
+        QSharedPointer<Cbe::CompilerContext> context,
+        QByteArray&                          response
+    ) {
+    Status status = Status::FAILED;
+
+    if (running()) {
+        errorOutput.clear();
+        process->write(WorkerProtocol::frame(request));
+
+        // Waiting for data to read also drains our pending writes so large requests can not dead-lock against the
+        // worker's response.
+        bool waiting = true;
+        do {
+            if (process->waitForReadyRead(pollInterval)) {
+                receiveBuffer.append(process->readAllStandardOutput());
+                if (WorkerProtocol::unframe(receiveBuffer, response)) {
+                    status  = Status::SUCCESS;
+                    waiting = false;
+                }
+            } else if (process->state() != QProcess::Running) {
+                fail(QString("Compiler worker terminated unexpectedly"));
+
+                status  = Status::FAILED;
+                waiting = false;
+            }
+
+            collectErrorOutput();
+
+            if (waiting && context->cancelled()) {
+                // Cancellation is cooperative within a worker so the only way to abort a compilation immediately is
+                // to stop the worker.  A replacement is started by the next request.
+                stop();
+
+                status  = Status::CANCELLED;
+                waiting = false;
+            }
+        } while (waiting);
+    } else {
+        if (currentErrorString.isEmpty()) {
+            currentErrorString = QString("Compiler worker is not running");
+        }
+    }
+
+    return status;
+}
+
+
+QString WorkerProcess::errorString() const {
+    return currentErrorString;
+}
+
+
+void WorkerProcess::collectErrorOutput() {
+    if (!process.isNull()) {
+        errorOutput.append(process->readAllStandardError());
+        if (errorOutput.size() > maximumErrorOutput) {
+            errorOutput = errorOutput.right(maximumErrorOutput);
+        }
+    }
+}
+
+
+void WorkerProcess::fail(const QString& reason) {
+    collectErrorOutput();
+    stop();
+
+    QString workerOutput = QString::fromLocal8Bit(errorOutput).trimmed();
+    if (workerOutput.isEmpty()) {
+        currentErrorString = reason;
+    } else {
+        currentErrorString = QString("%1\n%2").arg(reason, workerOutput);
+    }
+}
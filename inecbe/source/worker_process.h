@@ -0,0 +1,178 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref WorkerProcess class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef WORKER_PROCESS_H
+#define WORKER_PROCESS_H
+
+#include <QString>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QScopedPointer>
+
+#include "cbe_common.h"
+#include "cbe_compiler_context.h"
+
+class QProcess;
+
+/**
+ * Class that manages a single compiler worker process on behalf of a compiler.  The process is started once and then
+ * services requests, one at a time, over its standard input and output until it is stopped or dies.  A worker that
+ * dies only fails the request it was servicing.  The next request starts a replacement.
+ *
+ * The class is not thread safe.  All methods should be called from the compiler's background thread.
+ */
+class WorkerProcess {
+    public:
+        /**
+         * Enumeration of request outcomes.
+         */
+        enum class Status {
+            /**
+             * Indicates a response was received.
+             */
+            SUCCESS,
+
+            /**
+             * Indicates the context was cancelled.  The worker was stopped to abort the compilation.
+             */
+            CANCELLED,
+
+            /**
+             * Indicates the worker could not be started or died before responding.  The reason is available from
+             * \ref WorkerProcess::errorString.
+             */
+            FAILED
+        };
+
+        WorkerProcess();
+
+        ~WorkerProcess();
+
+        /**
+         * Method that starts the worker if it is not already running.
+         *
+         * \param[in] executable The worker executable.
+         *
+         * \return Returns true if the worker is running.  Returns false if the worker could not be started.
+         */
+        bool start(const QString& executable);
+
+        /**
+         * Method that stops the worker.  The worker is asked to exit and is killed if it does not exit promptly.
+         */
+        void stop();
+
+        /**
+         * Method you can use to determine if the worker is running.
+         *
+         * \return Returns true if the worker is running.
+         */
+        bool running() const;
+
+        /**
+         * Method that sends a request to the worker and waits for the response.  The context's cancellation flag is
+         * polled while waiting.
+         *
+         * \param[in]  request  The request message.
+         *
+         * \param[in]  context  The context being compiled.
+         *
+         * \param[out] response The response message.
+         *
+         * \return Returns the outcome of the request.
+         */
+        Status execute(
+            const QByteArray&                    request,
+            QSharedPointer<Cbe::CompilerContext> context,
+            QByteArray&                          response
+        );
+
+        /**
+         * Method you can use to obtain a description of the most recent failure.  Any output the worker wrote to its
+         * standard error is included.
+         *
+         * \return Returns the error description.
+         */
+        QString errorString() const;
+
+    private:
+        /**
+         * The maximum time to wait for the worker to start, in milliseconds.
+         */
+        static const int startTimeout;
+
+        /**
+         * The maximum time to wait for the worker to exit once asked, in milliseconds.
+         */
+        static const int stopTimeout;
+
+        /**
+         * The interval used to check for cancellation while waiting for a response, in milliseconds.
+         */
+        static const int pollInterval;
+
+        /**
+         * The maximum number of bytes of the worker's standard error output retained for error reporting.
+         */
+        static const int maximumErrorOutput;
+
+        /**
+         * Method that records the tail of the worker's standard error output.
+         */
+        void collectErrorOutput();
+
+        /**
+         * Method that records a failure, stops the worker, and builds the error description.
+         *
+         * \param[in] reason A description of the failure.
+         */
+        void fail(const QString& reason);
+
+        /**
+         * The worker process.
+         */
+        QScopedPointer<QProcess> process;
+
+        /**
+         * Buffer holding data received from the worker but not yet consumed.
+         */
+        QByteArray receiveBuffer;
+
+        /**
+         * The tail of the worker's standard error output.
+         */
+        QByteArray errorOutput;
+
+        /**
+         * The description of the most recent failure.
+         */
+        QString currentErrorString;
+};
+
+#endif
@@ -0,0 +1,340 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref WorkerProtocol class.
+***********************************************************************************************************************/
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QDataStream>
+
+#include "cbe_compiler_context.h"
+#include "cbe_compiler_diagnostic.h"
+#include "cbe_compiler_timing.h"
+#include "cbe_cpp_compiler_context.h"
+#include "worker_protocol.h"
+
+const quint32 WorkerProtocol::messageMagic    = 0x49435757; // "ICWW"
+const quint32 WorkerProtocol::protocolVersion = 2;
+
+WorkerProtocol::Configuration::Configuration() {
+    automaticPchEnabled     = false;
+    modulesEnabled          = false;
+    compileCacheEnabled     = false;
+    compileCacheMaximumSize = 0;
+    preambleReuseEnabled    = true;
+    debugOutputEnabled      = false;
+}
+
+
+QByteArray WorkerProtocol::Configuration::encode() const {
+    QByteArray  result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << compilerSwitches
+           << systemRoot
+           << headerSearchPaths
+           << headers
+           << precompiledHeaders
+           << runtimeBitcodeModules
+           << resourceDirectory
+           << gccToolchain
+           << targetTriple
+           << automaticPchEnabled
+           << pchCacheDirectory
+           << modulesEnabled
+           << moduleCacheDirectory
+           << compileCacheEnabled
+           << compileCacheDirectory
+           << compileCacheMaximumSize
+           << preambleReuseEnabled
+           << debugOutputEnabled;
+
+    return result;
+}
+
+
+bool WorkerProtocol::Configuration::decode(const QByteArray& encoded) {
+    QDataStream stream(encoded);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream >> compilerSwitches
+           >> systemRoot
+           >> headerSearchPaths
+           >> headers
+           >> precompiledHeaders
+           >> runtimeBitcodeModules
+           >> resourceDirectory
+           >> gccToolchain
+           >> targetTriple
+           >> automaticPchEnabled
+           >> pchCacheDirectory
+           >> modulesEnabled
+           >> moduleCacheDirectory
+           >> compileCacheEnabled
+           >> compileCacheDirectory
+           >> compileCacheMaximumSize
+           >> preambleReuseEnabled
+           >> debugOutputEnabled;
+
+    return stream.status() == QDataStream::Ok;
+}
+
+
+WorkerProtocol::Diagnostic::Diagnostic() {
+    level        = Cbe::CompilerDiagnostic::Level::UNKNOWN;
+    code         = 0;
+    byteOffset   = 0;
+    lineNumber   = 0;
+    columnNumber = 0;
+}
+
+
+QByteArray WorkerProtocol::frame(const QByteArray& message) {
+    QByteArray  result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << static_cast<quint32>(message.size());
+    result.append(message);
+
+    return result;
+}
+
+
+bool WorkerProtocol::unframe(QByteArray& buffer, QByteArray& message) {
+    bool success = false;
+
+    if (buffer.size() >= static_cast<int>(sizeof(quint32))) {
+        QDataStream stream(buffer);
+        stream.setVersion(QDataStream::Qt_5_0);
+
+        quint32 messageLength;
+        stream >> messageLength;
+
+        int frameLength = static_cast<int>(sizeof(quint32) + messageLength);
+        if (buffer.size() >= frameLength) {
+            message = buffer.mid(static_cast<int>(sizeof(quint32)), static_cast<int>(messageLength));
+            buffer.remove(0, frameLength);
+
+            success = true;
+        }
+    }
+
+    return success;
+}
+
+
+QByteArray WorkerProtocol::encodeRequest(const Configuration& configuration, const Cbe::CompilerContext& context) {
+    QByteArray  result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    bool timeTraceRequested = (
+        context.timeTraceDestination() != Cbe::CompilerContext::TimeTraceDestination::NONE
+    );
+
+    stream << messageMagic
+           << protocolVersion
+           << configuration.encode()
+           << context.objectFile()
+           << static_cast<quint8>(context.objectDestination())
+           << static_cast<quint8>(context.objectFormat())
+           << static_cast<quint8>(context.action())
+           << timeTraceRequested
+           << static_cast<quint32>(context.timeTraceGranularity())
+           << context.virtualHeaders()
+           << context.sourceData();
+
+    return result;
+}
+
+
+bool WorkerProtocol::decodeRequest(
+        const QByteArray&                        request,
+        Configuration&                           configuration,
+        QSharedPointer<Cbe::CppCompilerContext>& context
+    ) {
+    bool        success = false;
+    QDataStream stream(request);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32                   magic;
+    quint32                   version;
+    QByteArray                encodedConfiguration;
+    QString                   objectFile;
+    quint8                    objectDestination;
+    quint8                    objectFormat;
+    quint8                    action;
+    bool                      timeTraceRequested;
+    quint32                   timeTraceGranularity;
+    QMap<QString, QByteArray> virtualHeaders;
+    QByteArray                sourceData;
+
+    stream >> magic >> version;
+    if (magic == messageMagic && version == protocolVersion) {
+        stream >> encodedConfiguration
+               >> objectFile
+               >> objectDestination
+               >> objectFormat
+               >> action
+               >> timeTraceRequested
+               >> timeTraceGranularity
+               >> virtualHeaders
+               >> sourceData;
+
+        if (stream.status() == QDataStream::Ok && configuration.decode(encodedConfiguration)) {
+            context.reset(new Cbe::CppCompilerContext(objectFile, sourceData));
+            context->setObjectDestination(static_cast<Cbe::CompilerContext::ObjectDestination>(objectDestination));
+            context->setObjectFormat(static_cast<Cbe::CompilerContext::ObjectFormat>(objectFormat));
+            context->setAction(static_cast<Cbe::CompilerContext::Action>(action));
+
+            if (timeTraceRequested) {
+                context->setTimeTraceDestination(Cbe::CompilerContext::TimeTraceDestination::MEMORY);
+                context->setTimeTraceGranularity(timeTraceGranularity);
+            }
+
+            for (  QMap<QString, QByteArray>::const_iterator headerIterator    = virtualHeaders.constBegin(),
+                                                             headerEndIterator = virtualHeaders.constEnd()
+                 ; headerIterator != headerEndIterator
+                 ; ++headerIterator
+                ) {
+                context->addVirtualHeader(headerIterator.key(), headerIterator.value());
+            }
+
+            success = true;
+        }
+    }
+
+    return success;
+}
+
+
+QByteArray WorkerProtocol::encodeResponse(
+        bool                        success,
+        CacheAccess                 cacheAccess,
+        const Cbe::CompilerContext& context,
+        const QList<Diagnostic>&    diagnostics
+    ) {
+    QByteArray  result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << messageMagic
+           << protocolVersion
+           << success
+           << static_cast<quint8>(cacheAccess)
+           << context.objectData()
+           << context.timeTraceData();
+
+    Cbe::CompilerTiming timing = context.timing();
+    for (unsigned phaseIndex=0 ; phaseIndex<Cbe::CompilerTiming::numberPhases ; ++phaseIndex) {
+        Cbe::CompilerTiming::Phase phase = static_cast<Cbe::CompilerTiming::Phase>(phaseIndex);
+        stream << timing.wallTime(phase) << timing.cpuTime(phase);
+    }
+
+    stream << static_cast<quint32>(diagnostics.size());
+    for (  QList<Diagnostic>::const_iterator diagnosticIterator    = diagnostics.constBegin(),
+                                             diagnosticEndIterator = diagnostics.constEnd()
+         ; diagnosticIterator != diagnosticEndIterator
+         ; ++diagnosticIterator
+        ) {
+        stream << static_cast<quint8>(diagnosticIterator->level)
+               << static_cast<quint32>(diagnosticIterator->code)
+               << diagnosticIterator->message
+               << diagnosticIterator->filename
+               << diagnosticIterator->byteOffset
+               << diagnosticIterator->lineNumber
+               << diagnosticIterator->columnNumber;
+    }
+
+    return result;
+}
+
+
+bool WorkerProtocol::decodeResponse(
+        const QByteArray&    response,
+        bool&                success,
+        CacheAccess&         cacheAccess,
+        QByteArray&          objectData,
+        QByteArray&          timeTraceData,
+        Cbe::CompilerTiming& timing,
+        QList<Diagnostic>&   diagnostics
+    ) {
+    bool        result = false;
+    QDataStream stream(response);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic;
+    quint32 version;
+    stream >> magic >> version;
+
+    if (magic == messageMagic && version == protocolVersion) {
+        quint8 encodedCacheAccess;
+        stream >> success >> encodedCacheAccess >> objectData >> timeTraceData;
+        cacheAccess = static_cast<CacheAccess>(encodedCacheAccess);
+
+        for (unsigned phaseIndex=0 ; phaseIndex<Cbe::CompilerTiming::numberPhases ; ++phaseIndex) {
+            double wallTime;
+            double cpuTime;
+            stream >> wallTime >> cpuTime;
+
+            timing.setTime(static_cast<Cbe::CompilerTiming::Phase>(phaseIndex), wallTime, cpuTime);
+        }
+
+        quint32 numberDiagnostics;
+        stream >> numberDiagnostics;
+
+        diagnostics.clear();
+        for (  quint32 diagnosticIndex = 0
+             ; diagnosticIndex < numberDiagnostics && stream.status() == QDataStream::Ok
+             ; ++diagnosticIndex
+            ) {
+            Diagnostic diagnostic;
+            quint8     level;
+            quint32    code;
+
+            stream >> level
+                   >> code
+                   >> diagnostic.message
+                   >> diagnostic.filename
+                   >> diagnostic.byteOffset
+                   >> diagnostic.lineNumber
+                   >> diagnostic.columnNumber;
+
+            diagnostic.level = static_cast<Cbe::CompilerDiagnostic::Level>(level);
+            diagnostic.code  = static_cast<Cbe::CompilerDiagnostic::Code>(code);
+
+            diagnostics.append(diagnostic);
+        }
+
+        result = (stream.status() == QDataStream::Ok);
+    }
+
+    return result;
+}
@@ -0,0 +1,345 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref WorkerProtocol class.
+***********************************************************************************************************************/
+
+/* .. sphinx-project inecbe */
+
+#ifndef WORKER_PROTOCOL_H
+#define WORKER_PROTOCOL_H
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include "cbe_common.h"
+#include "cbe_compiler_context.h"
+#include "cbe_compiler_diagnostic.h"
+#include "cbe_compiler_timing.h"
+#include "cbe_cpp_compiler_context.h"
+
+/**
+ * Class that defines the messages exchanged between a compiler and a compiler worker process.  Messages are sent
+ * over the worker's standard input and standard output.  Each message is a 32-bit length followed by a payload
+ * serialized using QDataStream.
+ *
+ * The host sends one request per context.  Each request carries the complete compiler configuration so a freshly
+ * started worker never needs to be brought up to date.  The worker only reconfigures its compiler when the
+ * configuration differs from the previous request's configuration.  The worker responds to each request with exactly
+ * one response.
+ */
+class WorkerProtocol {
+    public:
+        /**
+         * Enumeration of compile cache outcomes reported by the worker.
+         */
+        enum class CacheAccess : quint8 {
+            /**
+             * Indicates the compile cache was not consulted.
+             */
+            NONE = 0,
+
+            /**
+             * Indicates the context was satisfied from the compile cache.
+             */
+            HIT = 1,
+
+            /**
+             * Indicates the context was compiled and the result was offered to the compile cache.
+             */
+            MISS = 2
+        };
+
+        /**
+         * Class that holds the compiler configuration sent with each request.
+         */
+        class Configuration {
+            public:
+                Configuration();
+
+                /**
+                 * Method that serializes the configuration.
+                 *
+                 * \return Returns the serialized configuration.
+                 */
+                QByteArray encode() const;
+
+                /**
+                 * Method that deserializes a configuration.
+                 *
+                 * \param[in] encoded The serialized configuration.
+                 *
+                 * \return Returns true on success.  Returns false if the configuration is malformed.
+                 */
+                bool decode(const QByteArray& encoded);
+
+                /**
+                 * The complete list of compiler switches, including the default switches.
+                 */
+                QList<QString> compilerSwitches;
+
+                /**
+                 * The system root directory.
+                 */
+                QString systemRoot;
+
+                /**
+                 * The header search paths.
+                 */
+                QList<QString> headerSearchPaths;
+
+                /**
+                 * The headers to be included into the build.
+                 */
+                QList<QString> headers;
+
+                /**
+                 * The precompiled headers to be included into the build.
+                 */
+                QList<QString> precompiledHeaders;
+
+                /**
+                 * The runtime bitcode modules to be linked into each compiled module.
+                 */
+                QList<QString> runtimeBitcodeModules;
+
+                /**
+                 * The resource directory.
+                 */
+                QString resourceDirectory;
+
+                /**
+                 * The GCC toolchain prefix.
+                 */
+                QString gccToolchain;
+
+                /**
+                 * The target triple override.
+                 */
+                QString targetTriple;
+
+                /**
+                 * Flag indicating if automatic precompiled headers are enabled.
+                 */
+                bool automaticPchEnabled;
+
+                /**
+                 * The directory used to cache automatic precompiled headers.  The host resolves the default so the
+                 * host and its workers share a single directory.
+                 */
+                QString pchCacheDirectory;
+
+                /**
+                 * Flag indicating if implicit clang modules are enabled.
+                 */
+                bool modulesEnabled;
+
+                /**
+                 * The directory used to cache compiled modules.  The host resolves the default so the host and its
+                 * workers share a single directory.
+                 */
+                QString moduleCacheDirectory;
+
+                /**
+                 * Flag indicating if the compile cache is enabled.
+                 */
+                bool compileCacheEnabled;
+
+                /**
+                 * The directory holding the compile cache.
+                 */
+                QString compileCacheDirectory;
+
+                /**
+                 * The maximum compile cache size, in bytes.
+                 */
+                quint64 compileCacheMaximumSize;
+
+                /**
+                 * Flag indicating if preamble reuse is enabled.
+                 */
+                bool preambleReuseEnabled;
+
+                /**
+                 * Flag indicating if debug output is enabled.
+                 */
+                bool debugOutputEnabled;
+        };
+
+        /**
+         * Class that holds a single diagnostic reported by the worker.
+         */
+        class Diagnostic {
+            public:
+                Diagnostic();
+
+                /**
+                 * The diagnostic level.
+                 */
+                Cbe::CompilerDiagnostic::Level level;
+
+                /**
+                 * The compiler specific diagnostic code.
+                 */
+                Cbe::CompilerDiagnostic::Code code;
+
+                /**
+                 * The diagnostic message.
+                 */
+                QString message;
+
+                /**
+                 * The file holding the diagnostic.  An empty string indicates the context's source.
+                 */
+                QString filename;
+
+                /**
+                 * The zero based byte offset of the diagnostic.
+                 */
+                quint32 byteOffset;
+
+                /**
+                 * The one based line number of the diagnostic.
+                 */
+                quint32 lineNumber;
+
+                /**
+                 * The column number of the diagnostic.
+                 */
+                quint32 columnNumber;
+        };
+
+        /**
+         * Method that wraps a message with its length.
+         *
+         * \param[in] message The message to be sent.
+         *
+         * \return Returns the framed message.
+         */
+        static QByteArray frame(const QByteArray& message);
+
+        /**
+         * Method that extracts a complete message from a receive buffer.
+         *
+         * \param[in,out] buffer  The receive buffer.  The message, and its length, are removed from the buffer.
+         *
+         * \param[out]    message The extracted message.
+         *
+         * \return Returns true if a complete message was extracted.  Returns false if more data is needed.
+         */
+        static bool unframe(QByteArray& buffer, QByteArray& message);
+
+        /**
+         * Method that builds a request.  A time trace written to a file is requested in memory.  The host writes the
+         * file once the response arrives.
+         *
+         * \param[in] configuration The compiler configuration.
+         *
+         * \param[in] context       The context to be compiled.
+         *
+         * \return Returns the request message.
+         */
+        static QByteArray encodeRequest(const Configuration& configuration, const Cbe::CompilerContext& context);
+
+        /**
+         * Method that decodes a request.
+         *
+         * \param[in]  request       The request message.
+         *
+         * \param[out] configuration The compiler configuration.
+         *
+         * \param[out] context       A new context holding the job described by the request.
+         *
+         * \return Returns true on success.  Returns false if the request is malformed.
+         */
+        static bool decodeRequest(
+            const QByteArray&                        request,
+            Configuration&                           configuration,
+            QSharedPointer<Cbe::CppCompilerContext>& context
+        );
+
+        /**
+         * Method that builds a response.
+         *
+         * \param[in] success     Holds true if the context compiled successfully.
+         *
+         * \param[in] cacheAccess The compile cache outcome.
+         *
+         * \param[in] context     The compiled context.  The generated object, time trace, and timing are sent.
+         *
+         * \param[in] diagnostics The reported diagnostics.
+         *
+         * \return Returns the response message.
+         */
+        static QByteArray encodeResponse(
+            bool                        success,
+            CacheAccess                 cacheAccess,
+            const Cbe::CompilerContext& context,
+            const QList<Diagnostic>&    diagnostics
+        );
+
+        /**
+         * Method that decodes a response.
+         *
+         * \param[in]  response      The response message.
+         *
+         * \param[out] success       Holds true if the context compiled successfully.
+         *
+         * \param[out] cacheAccess   The compile cache outcome.
+         *
+         * \param[out] objectData    The generated object, if the object was kept in memory.
+         *
+         * \param[out] timeTraceData The time trace, if one was requested.
+         *
+         * \param[out] timing        The time spent in each phase by the worker.
+         *
+         * \param[out] diagnostics   The reported diagnostics.
+         *
+         * \return Returns true on success.  Returns false if the response is malformed.
+         */
+        static bool decodeResponse(
+            const QByteArray&    response,
+            bool&                success,
+            CacheAccess&         cacheAccess,
+            QByteArray&          objectData,
+            QByteArray&          timeTraceData,
+            Cbe::CompilerTiming& timing,
+            QList<Diagnostic>&   diagnostics
+        );
+
+    private:
+        /**
+         * Value placed at the start of every message.
+         */
+        static const quint32 messageMagic;
+
+        /**
+         * Protocol version.  Hosts and workers must be built from the same version of the library.
+         */
+        static const quint32 protocolVersion;
+};
+
+#endif
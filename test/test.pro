@@ -31,6 +31,7 @@ CONFIG += testcase c++14
 
 HEADERS = process_memory.h \
           test_cpp_source_range.h \
+          test_job_queues.h \
           test_cpp_compiler_context.h \
           test_linker_context.h \
           test_cpp_compiler_diagnostic.h \
@@ -41,6 +42,7 @@ HEADERS = process_memory.h \
 SOURCES = process_memory.cpp \
           test_inecbe.cpp \
           test_cpp_source_range.cpp \
+          test_job_queues.cpp \
           test_cpp_compiler_context.cpp \
           test_linker_context.cpp \
           test_cpp_compiler_diagnostic.cpp \
@@ -59,6 +61,16 @@ win32 {
 CBE_BASE = $${OUT_PWD}/../inecbe/
 INCLUDEPATH = $${PWD}/../inecbe/include/
 
+CBE_WORKER_BASE = $${OUT_PWD}/../inecbe_worker/
+
+CONFIG(debug, debug|release) {
+    unix:DEFINES += CBE_WORKER_DIRECTORY=\\\"$${CBE_WORKER_BASE}/build/debug\\\"
+    win32:DEFINES += CBE_WORKER_DIRECTORY=\\\"$${CBE_WORKER_BASE}/build/Debug\\\"
+} else {
+    unix:DEFINES += CBE_WORKER_DIRECTORY=\\\"$${CBE_WORKER_BASE}/build/release\\\"
+    win32:DEFINES += CBE_WORKER_DIRECTORY=\\\"$${CBE_WORKER_BASE}/build/Release\\\"
+}
+
 unix {
     CONFIG(debug, debug|release) {
         LIBS += -L$${CBE_BASE}/build/debug/ -linecbe
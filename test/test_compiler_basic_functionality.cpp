@@ -32,18 +32,26 @@
 #include <QByteArray>
 #include <QList>
 #include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QDirIterator>
 
 #include <QDebug>
 
 #include <cstdint>
 
 #include <cbe_cpp_compiler.h>
+#include <cbe_cpp_compiler_pool.h>
 #include <cbe_cpp_compiler_notifier.h>
 #include <cbe_dynamic_library_linker.h>
 #include <cbe_linker_notifier.h>
 #include <cbe_dynamic_library_loader.h>
 #include <cbe_loader_notifier.h>
 #include <cbe_cpp_compiler_context.h>
+#include <cbe_compiler_timing.h>
+#include <cbe_jit_engine.h>
 
 #include "process_memory.h"
 #include "test_compiler_basic_functionality.h"
@@ -66,6 +74,8 @@ class CompilerNotifier:public Cbe::CppCompilerNotifier {
 
         bool compilerFinishedCalled() const;
 
+        bool compilerCancelledCalled() const;
+
         const QList<Cbe::CppCompilerDiagnostic>& diagnostics() const;
 
         QSharedPointer<Cbe::CppCompilerContext> context() const;
@@ -78,6 +88,8 @@ class CompilerNotifier:public Cbe::CppCompilerNotifier {
 
         void compilerFinished(QSharedPointer<Cbe::CppCompilerContext> context, bool success) final;
 
+        void compilerCancelled(QSharedPointer<Cbe::CompilerContext> context) final;
+
         void handleCompilerDiagnostic(const Cbe::CppCompilerDiagnostic& diagnostic) final;
 
         void fatalCompilerError(const QString& reason, bool generateCrashDiagnostics) final;
@@ -88,6 +100,7 @@ class CompilerNotifier:public Cbe::CppCompilerNotifier {
 
         bool compilerWasStarted;
         bool compilerHasFinished;
+        bool compilerWasCancelled;
         bool unexpectedEvent;
         bool successReported;
         bool fatalErrorReported;
@@ -109,6 +122,7 @@ void CompilerNotifier::reset() {
 
     compilerWasStarted = false;
     compilerHasFinished = false;
+    compilerWasCancelled = false;
     unexpectedEvent = false;
     successReported = false;
     fatalErrorReported = false;
@@ -132,6 +146,11 @@ bool CompilerNotifier::compilerFinishedCalled() const {
 }
 
 
+bool CompilerNotifier::compilerCancelledCalled() const {
+    return compilerWasCancelled;
+}
+
+
 const QList<Cbe::CppCompilerDiagnostic>& CompilerNotifier::diagnostics() const {
     return reportedDiagnostics;
 }
@@ -172,6 +191,15 @@ void CompilerNotifier::compilerFinished(QSharedPointer<Cbe::CppCompilerContext>
 }
 
 
+void CompilerNotifier::compilerCancelled(QSharedPointer<Cbe::CompilerContext> context) {
+    if (!compilerWasStarted || compilerHasFinished || context != activeContext || activeContext.isNull()) {
+        unexpectedEvent = true;
+    } else {
+        compilerWasCancelled = true;
+    }
+}
+
+
 void CompilerNotifier::handleCompilerDiagnostic(const Cbe::CppCompilerDiagnostic& diagnostic) {
     if (!compilerWasStarted || compilerHasFinished || activeContext.isNull()) {
         unexpectedEvent = true;
@@ -216,6 +244,8 @@ class CompilerContext:public Cbe::CppCompilerContext {
 
         bool compilerFinishedCalled() const;
 
+        bool compilerCancelledCalled() const;
+
         bool callbacksProperlyOrdered() const;
 
         const QList<Cbe::CppCompilerDiagnostic>& diagnostics() const;
@@ -228,11 +258,14 @@ class CompilerContext:public Cbe::CppCompilerContext {
 
         void compilerFinished(bool success) final;
 
+        void compilerCancelled() final;
+
         void handleCompilerDiagnostic(const Cbe::CppCompilerDiagnostic& diagnostic) final;
 
     private:
         bool compilerWasStarted;
         bool compilerHasFinished;
+        bool compilerWasCancelled;
         bool unexpectedEvent;
         bool successReported;
         bool fatalErrorReported;
@@ -275,6 +308,7 @@ CompilerContext::~CompilerContext() {}
 void CompilerContext::reset() {
     compilerWasStarted = false;
     compilerHasFinished = false;
+    compilerWasCancelled = false;
     unexpectedEvent = false;
     successReported = false;
     fatalErrorReported = false;
@@ -298,6 +332,11 @@ bool CompilerContext::compilerFinishedCalled() const {
 }
 
 
+bool CompilerContext::compilerCancelledCalled() const {
+    return compilerWasCancelled;
+}
+
+
 const QList<Cbe::CppCompilerDiagnostic>& CompilerContext::diagnostics() const {
     return reportedDiagnostics;
 }
@@ -332,6 +371,15 @@ void CompilerContext::compilerFinished(bool success) {
 }
 
 
+void CompilerContext::compilerCancelled() {
+    if (!compilerWasStarted || compilerHasFinished) {
+        unexpectedEvent = true;
+    } else {
+        compilerWasCancelled = true;
+    }
+}
+
+
 void CompilerContext::handleCompilerDiagnostic(const Cbe::CppCompilerDiagnostic& diagnostic) {
     if (!compilerWasStarted || compilerHasFinished) {
         unexpectedEvent = true;
@@ -542,6 +590,1112 @@ void TestCompilerBasicFunctionality::testErrorReporting() {
 }
 
 
+void TestCompilerBasicFunctionality::testInMemoryObject() {
+    CompilerNotifier compilerNotifier;
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_in_memory.o"));
+
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+    #if (defined(Q_OS_WIN))
+
+        *context << "extern \"C\" __declspec(dllexport) int add(int a, int b) {" << Cbe::endl;
+
+    #else
+
+        *context << "extern \"C\" int add(int a, int b) {" << Cbe::endl;
+
+    #endif
+
+    *context << "    return a + b;" << Cbe::endl
+             << "}" << Cbe::endl;
+
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QFile objectFile(context->objectFile());
+    if (objectFile.exists()) {
+        bool success = objectFile.remove();
+        QVERIFY(success);
+    }
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+    QVERIFY(compilerNotifier.compilerFinishedCalled());
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(compilerNotifier.diagnostics().isEmpty());
+
+    QVERIFY(context->success());
+    QVERIFY(!context->objectData().isEmpty());
+    QVERIFY(!objectFile.exists());
+}
+
+
+void TestCompilerBasicFunctionality::testCompilerPool() {
+    static const unsigned numberContexts = 4;
+
+    Cbe::CppCompilerPool compilerPool(2);
+    QCOMPARE(compilerPool.numberCompilers(), 2U);
+
+    configureTestCompiler(compilerPool);
+
+    QList<QSharedPointer<CompilerContext>> contexts;
+    for (unsigned contextIndex=0 ; contextIndex<numberContexts ; ++contextIndex) {
+        QSharedPointer<CompilerContext> context(new CompilerContext(QString("test_pool_%1.o").arg(contextIndex)));
+        context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+        *context << QString("extern \"C\" int add%1(int a, int b) {").arg(contextIndex) << Cbe::endl
+                 << "    return a + b;" << Cbe::endl
+                 << "}" << Cbe::endl;
+
+        contexts.append(context);
+        compilerPool.compile(context);
+    }
+
+    compilerPool.waitComplete();
+    QVERIFY(!compilerPool.active());
+
+    for (unsigned contextIndex=0 ; contextIndex<numberContexts ; ++contextIndex) {
+        QSharedPointer<CompilerContext> context = contexts.at(contextIndex);
+
+        QVERIFY(context->callbacksProperlyOrdered());
+        QVERIFY(context->compilerFinishedCalled());
+        QVERIFY(context->success());
+        QVERIFY(!context->objectData().isEmpty());
+    }
+}
+
+
+void TestCompilerBasicFunctionality::testAutomaticPch() {
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QString headerFilename       = temporaryDirectory.filePath("test_automatic_pch.h");
+    QString nestedHeaderFilename = temporaryDirectory.filePath("test_automatic_pch_nested.h");
+    QString cacheDirectory       = temporaryDirectory.filePath("pch");
+
+    QFile nestedHeaderFile(nestedHeaderFilename);
+    QVERIFY(nestedHeaderFile.open(QIODevice::WriteOnly));
+    nestedHeaderFile.write("inline int twice(int x) { return 2 * x; }\n");
+    nestedHeaderFile.close();
+
+    QFile headerFile(headerFilename);
+    QVERIFY(headerFile.open(QIODevice::WriteOnly));
+    headerFile.write("#include \"test_automatic_pch_nested.h\"\n");
+    headerFile.write("inline int triple(int x) { return 3 * x; }\n");
+    headerFile.close();
+
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QVERIFY(compiler.automaticPchDisabled());
+
+    compiler.setHeaders(QList<QString>() << headerFilename);
+    compiler.setPchCacheDirectory(cacheDirectory);
+    compiler.setAutomaticPchEnabled();
+
+    QVERIFY(compiler.automaticPchEnabled());
+    QVERIFY(compiler.pchCacheDirectory() == cacheDirectory);
+
+    QSharedPointer<CompilerContext> context1(new CompilerContext("test_automatic_pch_1.o"));
+    context1->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context1 << "extern \"C\" int f(int a) { return triple(a); }" << Cbe::endl;
+
+    compiler.compile(context1);
+    compiler.waitComplete();
+
+    QVERIFY(context1->success());
+    QVERIFY(context1->diagnostics().isEmpty());
+    QVERIFY(QDir(cacheDirectory).entryList(QStringList() << "*.pch", QDir::Files).size() == 1);
+
+    // Changing the header must cause the precompiled header to be rebuilt.
+    QVERIFY(headerFile.open(QIODevice::Append));
+    headerFile.write("inline int quadruple(int x) { return 4 * x; }\n");
+    headerFile.close();
+
+    QSharedPointer<CompilerContext> context2(new CompilerContext("test_automatic_pch_2.o"));
+    context2->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context2 << "extern \"C\" int g(int a) { return quadruple(a); }" << Cbe::endl;
+
+    compiler.compile(context2);
+    compiler.waitComplete();
+
+    QVERIFY(context2->success());
+    QVERIFY(context2->diagnostics().isEmpty());
+    QVERIFY(QDir(cacheDirectory).entryList(QStringList() << "*.pch", QDir::Files).size() == 2);
+
+    // Changing a header pulled in by a listed header must also cause the precompiled header to be rebuilt.
+    QVERIFY(nestedHeaderFile.open(QIODevice::WriteOnly));
+    nestedHeaderFile.write("inline int twice(int x) { return x + x; }\n");
+    nestedHeaderFile.write("inline int quintuple(int x) { return 5 * x; }\n");
+    nestedHeaderFile.close();
+
+    QSharedPointer<CompilerContext> context3(new CompilerContext("test_automatic_pch_3.o"));
+    context3->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context3 << "extern \"C\" int h(int a) { return quintuple(twice(a)); }" << Cbe::endl;
+
+    compiler.compile(context3);
+    compiler.waitComplete();
+
+    QVERIFY(context3->success());
+    QVERIFY(context3->diagnostics().isEmpty());
+    QVERIFY(QDir(cacheDirectory).entryList(QStringList() << "*.pch", QDir::Files).size() == 2);
+
+    // A second compiler must validate the cached precompiled header against the nested header too.
+    QVERIFY(nestedHeaderFile.open(QIODevice::WriteOnly));
+    nestedHeaderFile.write("inline int twice(int x) { return 2 * x; }\n");
+    nestedHeaderFile.write("inline int sextuple(int x) { return 6 * x; }\n");
+    nestedHeaderFile.close();
+
+    Cbe::CppCompiler secondCompiler(&compilerNotifier);
+
+    configureTestCompiler(secondCompiler);
+
+    secondCompiler.setHeaders(QList<QString>() << headerFilename);
+    secondCompiler.setPchCacheDirectory(cacheDirectory);
+    secondCompiler.setAutomaticPchEnabled();
+
+    QSharedPointer<CompilerContext> context4(new CompilerContext("test_automatic_pch_4.o"));
+    context4->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context4 << "extern \"C\" int k(int a) { return sextuple(a); }" << Cbe::endl;
+
+    secondCompiler.compile(context4);
+    secondCompiler.waitComplete();
+
+    QVERIFY(context4->success());
+    QVERIFY(context4->diagnostics().isEmpty());
+}
+
+
+void TestCompilerBasicFunctionality::testCompileCache() {
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QString headerFilename = temporaryDirectory.filePath("test_compile_cache.h");
+    QString cacheDirectory = temporaryDirectory.filePath("cache");
+
+    QFile headerFile(headerFilename);
+    QVERIFY(headerFile.open(QIODevice::WriteOnly));
+    headerFile.write("inline int triple(int x) { return 3 * x; }\n");
+    headerFile.close();
+
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QVERIFY(compiler.compileCacheDisabled());
+
+    compiler.setHeaders(QList<QString>() << headerFilename);
+    compiler.setCompileCacheDirectory(cacheDirectory);
+    compiler.setCompileCacheEnabled();
+
+    QVERIFY(compiler.compileCacheEnabled());
+    QVERIFY(compiler.compileCacheDirectory() == cacheDirectory);
+
+    QByteArray objects[3];
+    for (unsigned pass=0 ; pass<3 ; ++pass) {
+        if (pass == 2) {
+            // Changing the header contents must invalidate the cached object.
+            QVERIFY(headerFile.open(QIODevice::WriteOnly));
+            headerFile.write("inline int triple(int x) { return x + x + x; }\n");
+            headerFile.close();
+        }
+
+        compilerNotifier.reset();
+
+        QSharedPointer<CompilerContext> context(new CompilerContext("test_compile_cache.o"));
+        context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+        *context << "extern \"C\" int f(int a) { return triple(a); }" << Cbe::endl;
+
+        compiler.compile(context);
+        compiler.waitComplete();
+
+        QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+        QVERIFY(compilerNotifier.compilerFinishedCalled());
+        QVERIFY(context->success());
+        QVERIFY(!context->objectData().isEmpty());
+
+        objects[pass] = context->objectData();
+    }
+
+    QVERIFY(compiler.compileCacheHits() == 1);
+    QVERIFY(compiler.compileCacheMisses() == 2);
+    QVERIFY(objects[1] == objects[0]);
+    QVERIFY(QFileInfo(cacheDirectory + "/index").exists());
+
+    // Shrinking the cache must evict every object along with the manifests that referenced them.
+    compiler.setCompileCacheMaximumSize(1);
+
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_compile_cache.o"));
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context << "extern \"C\" int g(int a) { return triple(a) + 1; }" << Cbe::endl;
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(context->success());
+
+    QDirIterator cacheIterator(
+        cacheDirectory,
+        QStringList() << "*.o" << "*.manifest",
+        QDir::Files,
+        QDirIterator::Subdirectories
+    );
+    QVERIFY(!cacheIterator.hasNext());
+}
+
+
+void TestCompilerBasicFunctionality::testPreambleReuse() {
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QString headerFilename = temporaryDirectory.filePath("test_preamble.h");
+
+    QFile headerFile(headerFilename);
+    QVERIFY(headerFile.open(QIODevice::WriteOnly));
+    headerFile.write("inline int triple(int x) { return 3 * x; }\n");
+    headerFile.close();
+
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QVERIFY(compiler.preambleReuseEnabled());
+
+    // The first two passes establish the preamble.  Later passes must see the same results with the preamble in use,
+    // including diagnostics located in the body.
+    for (unsigned pass=0 ; pass<4 ; ++pass) {
+        compilerNotifier.reset();
+
+        QSharedPointer<CompilerContext> context(new CompilerContext("test_preamble.o"));
+        context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+        *context << QString("#include \"%1\"").arg(QDir::fromNativeSeparators(headerFilename)) << Cbe::endl
+                 << "#define SCALE 2" << Cbe::endl;
+
+        if (pass == 3) {
+            *context << "extern \"C\" int f3(int a) { return SCALE * triple(a) }" << Cbe::endl;
+        } else {
+            *context << QString("extern \"C\" int f%1(int a) { return SCALE * triple(a); }").arg(pass) << Cbe::endl;
+        }
+
+        compiler.compile(context);
+        compiler.waitComplete();
+
+        QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+        QVERIFY(compilerNotifier.compilerFinishedCalled());
+
+        if (pass == 3) {
+            QVERIFY(!context->success());
+            QVERIFY(context->diagnostics().size() == 1);
+
+            Cbe::CppCompilerDiagnostic diagnostic = context->diagnostics().at(0);
+            QVERIFY(diagnostic.level() == Cbe::CppCompilerDiagnostic::Level::ERROR);
+            QVERIFY(diagnostic.sourceRange().startLineNumber() == 3);
+        } else {
+            QVERIFY(context->success());
+            QVERIFY(context->diagnostics().isEmpty());
+            QVERIFY(!context->objectData().isEmpty());
+        }
+    }
+}
+
+
+void TestCompilerBasicFunctionality::testVirtualHeaders() {
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QSharedPointer<CompilerContext> context1(new CompilerContext("test_virtual_headers_1.o"));
+    context1->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    context1->addVirtualHeader("generated/triple.h", "inline int triple(int x) { return 3 * x; }\n");
+    context1->addVirtualHeader("scale.h", "#define SCALE 2\n");
+
+    QVERIFY(context1->virtualHeaders().size() == 2);
+
+    *context1 << "#include \"generated/triple.h\"" << Cbe::endl
+              << "#include <scale.h>" << Cbe::endl
+              << "extern \"C\" int f(int a) { return SCALE * triple(a); }" << Cbe::endl;
+
+    compiler.compile(context1);
+    compiler.waitComplete();
+
+    QVERIFY(context1->success());
+    QVERIFY(context1->diagnostics().isEmpty());
+    QVERIFY(!context1->objectData().isEmpty());
+
+    // Headers are only visible to the context that supplied them.
+    QSharedPointer<CompilerContext> context2(new CompilerContext("test_virtual_headers_2.o"));
+    context2->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    context2->addVirtualHeader("generated/triple.h", "inline int triple(int x) { return x + x + x; }\n");
+
+    *context2 << "#include \"generated/triple.h\"" << Cbe::endl
+              << "#include <scale.h>" << Cbe::endl
+              << "extern \"C\" int f(int a) { return SCALE * triple(a); }" << Cbe::endl;
+
+    compiler.compile(context2);
+    compiler.waitComplete();
+
+    QVERIFY(!context2->success());
+    QVERIFY(!context2->diagnostics().isEmpty());
+    QVERIFY(context2->diagnostics().at(0).sourceRange().startLineNumber() == 2);
+
+    // Files on disk must never shadow the virtual header directory.
+    QDir    temporaryDirectory = QDir::temp();
+    QString shadowFilename     = temporaryDirectory.absoluteFilePath("inecbe.virtual/shadow.h");
+    QVERIFY(temporaryDirectory.mkpath("inecbe.virtual"));
+
+    QFile shadowFile(shadowFilename);
+    QVERIFY(shadowFile.open(QIODevice::WriteOnly));
+    shadowFile.write("#define SHADOWED 1\n");
+    shadowFile.close();
+
+    QSharedPointer<CompilerContext> context3(new CompilerContext("test_virtual_headers_3.o"));
+    context3->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+    *context3 << "#include \"shadow.h\"" << Cbe::endl
+              << "extern \"C\" int f(int a) { return SHADOWED * a; }" << Cbe::endl;
+
+    compiler.compile(context3);
+    compiler.waitComplete();
+
+    QFile::remove(shadowFilename);
+
+    QVERIFY(!context3->success());
+    QVERIFY(!context3->diagnostics().isEmpty());
+    QVERIFY(context3->diagnostics().at(0).sourceRange().startLineNumber() == 1);
+
+    // Names that would escape the virtual header directory are rejected.
+    QSharedPointer<CompilerContext> context4(new CompilerContext("test_virtual_headers_4.o"));
+    context4->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+    QVERIFY(!context4->addVirtualHeader("../escape.h", "#define ESCAPED 1\n"));
+    QVERIFY(!context4->addVirtualHeader("generated/../../escape.h", "#define ESCAPED 1\n"));
+    QVERIFY(!context4->addVirtualHeader(temporaryDirectory.absoluteFilePath("escape.h"), "#define ESCAPED 1\n"));
+    QVERIFY(!context4->addVirtualHeader(QString(), "#define ESCAPED 1\n"));
+    QVERIFY(context4->addVirtualHeader("generated/../inside.h", "#define INSIDE 1\n"));
+    QVERIFY(context4->virtualHeaders().size() == 1);
+
+    *context4 << "#include \"inside.h\"" << Cbe::endl
+              << "extern \"C\" int f(int a) { return INSIDE * a; }" << Cbe::endl;
+
+    compiler.compile(context4);
+    compiler.waitComplete();
+
+    QVERIFY(context4->success());
+}
+
+
+void TestCompilerBasicFunctionality::testCancellation() {
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QSharedPointer<CompilerContext> context1(new CompilerContext("test_cancellation_1.o"));
+    context1->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context1 << "extern \"C\" int f(int a) { return a + 1; }" << Cbe::endl;
+
+    QVERIFY(!context1->cancelled());
+    compiler.cancel(context1);
+    QVERIFY(context1->cancelled());
+
+    compiler.compile(context1);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+    QVERIFY(compilerNotifier.compilerStartedCalled());
+    QVERIFY(compilerNotifier.compilerFinishedCalled());
+    QVERIFY(!compilerNotifier.success());
+    QVERIFY(compilerNotifier.diagnostics().isEmpty());
+
+    QVERIFY(compilerNotifier.compilerCancelledCalled());
+
+    QVERIFY(context1->callbacksProperlyOrdered());
+    QVERIFY(context1->compilerFinishedCalled());
+    QVERIFY(context1->compilerCancelledCalled());
+    QVERIFY(!context1->success());
+    QVERIFY(context1->objectData().isEmpty());
+
+    // The cancellation is cleared once reported so a resubmitted context is compiled.
+    QVERIFY(!context1->cancelled());
+
+    compilerNotifier.reset();
+    context1->reset();
+
+    compiler.compile(context1);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+    QVERIFY(!compilerNotifier.compilerCancelledCalled());
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(!context1->compilerCancelledCalled());
+    QVERIFY(context1->success());
+    QVERIFY(!context1->objectData().isEmpty());
+
+    // The compiler must remain usable after a cancellation.
+    compilerNotifier.reset();
+
+    QSharedPointer<CompilerContext> context2(new CompilerContext("test_cancellation_2.o"));
+    context2->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context2 << "extern \"C\" int f(int a) { return a + 1; }" << Cbe::endl;
+
+    compiler.compile(context2);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(context2->success());
+    QVERIFY(!context2->objectData().isEmpty());
+}
+
+
+void TestCompilerBasicFunctionality::testCompilerTiming() {
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    compiler.setCompileCacheDisabled();
+
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_compiler_timing.o"));
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+    Cbe::CompilerTiming initialTiming = context->timing();
+    QVERIFY(initialTiming.totalWallTime() == 0);
+    QVERIFY(initialTiming.totalCpuTime() == 0);
+
+    *context << "#include <cmath>" << Cbe::endl
+             << "extern \"C\" double f(double x) { return std::sqrt(x) + std::sin(x); }" << Cbe::endl;
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+    QVERIFY(compilerNotifier.success());
+
+    Cbe::CompilerTiming timing = context->timing();
+
+    double wallTimeSum = 0;
+    double cpuTimeSum  = 0;
+    for (unsigned phaseIndex=0 ; phaseIndex<Cbe::CompilerTiming::numberPhases ; ++phaseIndex) {
+        Cbe::CompilerTiming::Phase phase = static_cast<Cbe::CompilerTiming::Phase>(phaseIndex);
+        QVERIFY(timing.wallTime(phase) >= 0);
+        QVERIFY(timing.cpuTime(phase) >= 0);
+
+        wallTimeSum += timing.wallTime(phase);
+        cpuTimeSum  += timing.cpuTime(phase);
+    }
+
+    QVERIFY(timing.wallTime(Cbe::CompilerTiming::Phase::FRONTEND) > 0);
+    QVERIFY(timing.wallTime(Cbe::CompilerTiming::Phase::BACKEND) > 0);
+    QVERIFY(qAbs(timing.totalWallTime() - wallTimeSum) < 1.0E-9);
+    QVERIFY(qAbs(timing.totalCpuTime() - cpuTimeSum) < 1.0E-9);
+}
+
+
+void TestCompilerBasicFunctionality::testTimeTrace() {
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QSharedPointer<CompilerContext> context1(new CompilerContext("test_time_trace_1.o"));
+    QVERIFY(context1->timeTraceDestination() == Cbe::CompilerContext::TimeTraceDestination::NONE);
+    QVERIFY(context1->timeTraceGranularity() == Cbe::CompilerContext::defaultTimeTraceGranularity);
+
+    context1->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    context1->setTimeTraceDestination(Cbe::CompilerContext::TimeTraceDestination::MEMORY);
+    context1->setTimeTraceGranularity(0);
+
+    *context1 << "#include <vector>" << Cbe::endl
+              << "extern \"C\" int f(int a) { std::vector<int> v(a, 1); return static_cast<int>(v.size()); }"
+              << Cbe::endl;
+
+    compiler.compile(context1);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.success());
+
+    QByteArray timeTrace = context1->timeTraceData();
+    QVERIFY(timeTrace.contains("traceEvents"));
+    QVERIFY(timeTrace.contains("\"Source\""));
+    QVERIFY(timeTrace.contains("\"InstantiateClass\""));
+
+    compilerNotifier.reset();
+
+    QString objectFilename = temporaryDirectory.filePath("test_time_trace_2.o");
+    QSharedPointer<CompilerContext> context2(new CompilerContext(objectFilename));
+    context2->setTimeTraceDestination(Cbe::CompilerContext::TimeTraceDestination::FILE);
+    QVERIFY(context2->timeTraceFile() == temporaryDirectory.filePath("test_time_trace_2.json"));
+
+    *context2 << "extern \"C\" int g(int a) { return a + 1; }" << Cbe::endl;
+
+    compiler.compile(context2);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(context2->timeTraceData().isEmpty());
+
+    QFile timeTraceFile(context2->timeTraceFile());
+    QVERIFY(timeTraceFile.open(QFile::ReadOnly));
+    QVERIFY(timeTraceFile.readAll().contains("traceEvents"));
+}
+
+
+void TestCompilerBasicFunctionality::testJitEngine() {
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QSharedPointer<CompilerContext> bitcodeContext(new CompilerContext("test_jit_bitcode.bc"));
+    bitcodeContext->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    bitcodeContext->setObjectFormat(Cbe::CompilerContext::ObjectFormat::BITCODE);
+
+    *bitcodeContext << "static int initialize() {" << Cbe::endl
+                    << "    return 3;" << Cbe::endl
+                    << "}" << Cbe::endl
+                    << "static int offset = initialize();" << Cbe::endl
+                    << "extern \"C\" int add(int a, int b) {" << Cbe::endl
+                    << "    return a + b + offset;" << Cbe::endl
+                    << "}" << Cbe::endl;
+
+    QSharedPointer<CompilerContext> objectContext(new CompilerContext("test_jit_object.o"));
+    objectContext->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+    *objectContext << "extern \"C\" int multiply(int a, int b) {" << Cbe::endl
+                   << "    return a * b;" << Cbe::endl
+                   << "}" << Cbe::endl;
+
+    compiler.compile(bitcodeContext);
+    compiler.compile(objectContext);
+    compiler.waitComplete();
+
+    QVERIFY(bitcodeContext->success());
+    QVERIFY(objectContext->success());
+
+    Cbe::JitEngine jitEngine;
+    QVERIFY(jitEngine.isValid());
+
+    QVERIFY(jitEngine.add(bitcodeContext));
+    QVERIFY(jitEngine.add(objectContext));
+
+    typedef int (*Function)(int, int);
+
+    Function add = reinterpret_cast<Function>(jitEngine.resolve("add"));
+    QVERIFY(add != nullptr);
+    QCOMPARE(add(1, 2), 6);
+
+    Function multiply = reinterpret_cast<Function>(jitEngine.resolve("multiply"));
+    QVERIFY(multiply != nullptr);
+    QCOMPARE(multiply(3, 4), 12);
+
+    QVERIFY(jitEngine.resolve("subtract") == nullptr);
+    QVERIFY(!jitEngine.errorString().isEmpty());
+
+    QVERIFY(jitEngine.reset());
+    QVERIFY(jitEngine.resolve("add") == nullptr);
+}
+
+
+void TestCompilerBasicFunctionality::testLazyJitEngine() {
+    static const unsigned numberFunctions = 1000;
+
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_lazy_jit.bc"));
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    context->setObjectFormat(Cbe::CompilerContext::ObjectFormat::BITCODE);
+
+    for (unsigned functionIndex=0 ; functionIndex<numberFunctions ; ++functionIndex) {
+        *context << QString("extern \"C\" int f%1(int x) {").arg(functionIndex) << Cbe::endl
+                 << QString("    return x + %1;").arg(functionIndex) << Cbe::endl
+                 << "}" << Cbe::endl;
+    }
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(context->success());
+
+    Cbe::JitEngine jitEngine(Cbe::JitEngine::Compilation::LAZY);
+    QVERIFY(jitEngine.isValid());
+    QCOMPARE(jitEngine.compilation(), Cbe::JitEngine::Compilation::LAZY);
+
+    QVERIFY(jitEngine.add(context));
+
+    typedef int (*Function)(int);
+
+    Function f7 = reinterpret_cast<Function>(jitEngine.resolve("f7"));
+    QVERIFY(f7 != nullptr);
+    QCOMPARE(f7(1), 8);
+    QCOMPARE(f7(2), 9);
+
+    Function f999 = reinterpret_cast<Function>(jitEngine.resolve("f999"));
+    QVERIFY(f999 != nullptr);
+    QCOMPARE(f999(1), 1000);
+
+    QVERIFY(jitEngine.resolve("f1000") == nullptr);
+}
+
+
+void TestCompilerBasicFunctionality::testRuntimeBitcodeModules() {
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QString runtimeModule = QDir(temporaryDirectory.path()).filePath("runtime.bc");
+
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QSharedPointer<CompilerContext> runtimeContext(new CompilerContext(runtimeModule));
+    runtimeContext->setObjectFormat(Cbe::CompilerContext::ObjectFormat::BITCODE);
+
+    *runtimeContext << "extern \"C\" int runtimeSquare(int x) {" << Cbe::endl
+                    << "    return x * x;" << Cbe::endl
+                    << "}" << Cbe::endl
+                    << "extern \"C\" int runtimeUnused(int x) {" << Cbe::endl
+                    << "    return -x;" << Cbe::endl
+                    << "}" << Cbe::endl;
+
+    compiler.compile(runtimeContext);
+    compiler.waitComplete();
+
+    QVERIFY(runtimeContext->success());
+    QVERIFY(QFileInfo(runtimeModule).exists());
+
+    compiler.setRuntimeBitcodeModules(QList<QString>() << runtimeModule);
+    QCOMPARE(compiler.runtimeBitcodeModules(), QList<QString>() << runtimeModule);
+
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_runtime_bitcode.bc"));
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    context->setObjectFormat(Cbe::CompilerContext::ObjectFormat::BITCODE);
+
+    *context << "extern \"C\" int runtimeSquare(int x);" << Cbe::endl
+             << "extern \"C\" int sumOfSquares(int n) {" << Cbe::endl
+             << "    int sum = 0;" << Cbe::endl
+             << "    for (int i=1 ; i<=n ; ++i) {" << Cbe::endl
+             << "        sum += runtimeSquare(i);" << Cbe::endl
+             << "    }" << Cbe::endl
+             << "    return sum;" << Cbe::endl
+             << "}" << Cbe::endl;
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(context->success());
+
+    // The runtime is not otherwise available to the JIT so the call only resolves if the runtime function was linked
+    // into the module.  Linked functions are internalized so neither runtime function is exported.
+    Cbe::JitEngine jitEngine;
+    QVERIFY(jitEngine.add(context));
+
+    typedef int (*Function)(int);
+
+    Function sumOfSquares = reinterpret_cast<Function>(jitEngine.resolve("sumOfSquares"));
+    QVERIFY(sumOfSquares != nullptr);
+    QCOMPARE(sumOfSquares(3), 14);
+
+    QVERIFY(jitEngine.resolve("runtimeSquare") == nullptr);
+    QVERIFY(jitEngine.resolve("runtimeUnused") == nullptr);
+}
+
+
+void TestCompilerBasicFunctionality::testCheck() {
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QSharedPointer<CompilerContext> badContext(new CompilerContext("test_check_bad.o"));
+    *badContext << "extern \"C\" int add(int a, int b) {" << Cbe::endl
+                << "    return a + c;" << Cbe::endl
+                << "}" << Cbe::endl;
+
+    QFile::remove(badContext->objectFile());
+
+    compiler.check(badContext);
+    compiler.waitComplete();
+
+    QVERIFY(badContext->action() == Cbe::CompilerContext::Action::CHECK);
+    QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+    QVERIFY(compilerNotifier.compilerFinishedCalled());
+    QVERIFY(!compilerNotifier.success());
+    QCOMPARE(compilerNotifier.diagnostics().size(), 1);
+    QVERIFY(compilerNotifier.diagnostics().at(0).level() == Cbe::CppCompilerDiagnostic::Level::ERROR);
+    QVERIFY(compilerNotifier.diagnostics().at(0).sourceRange().startLineNumber() == 2);
+    QVERIFY(!QFileInfo(badContext->objectFile()).exists());
+
+    compilerNotifier.reset();
+
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_check.o"));
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context << "extern \"C\" int add(int a, int b) {" << Cbe::endl
+             << "    return a + b;" << Cbe::endl
+             << "}" << Cbe::endl;
+
+    compiler.check(context);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(compilerNotifier.diagnostics().isEmpty());
+    QVERIFY(context->objectData().isEmpty());
+
+    // Compiling the same context afterwards generates the object.
+    compilerNotifier.reset();
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(context->action() == Cbe::CompilerContext::Action::COMPILE);
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(!context->objectData().isEmpty());
+}
+
+
+void TestCompilerBasicFunctionality::testWorkerProcess() {
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QVERIFY(compiler.isInternal());
+
+    compiler.setExecutableDirectory(CBE_WORKER_DIRECTORY);
+    compiler.setWorkerProcessEnabled();
+
+    QVERIFY(compiler.workerProcessEnabled());
+    QVERIFY(compiler.isExternal());
+
+    QSharedPointer<CompilerContext> badContext(new CompilerContext("test_worker_bad.o"));
+    *badContext << "extern \"C\" int add(int a, int b) {" << Cbe::endl
+                << "    return a + c;" << Cbe::endl
+                << "}" << Cbe::endl;
+
+    compiler.compile(badContext);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+    QVERIFY(compilerNotifier.compilerFinishedCalled());
+    QVERIFY(!compilerNotifier.success());
+    QVERIFY(!compilerNotifier.fatalError());
+    QCOMPARE(compilerNotifier.diagnostics().size(), 1);
+    QVERIFY(compilerNotifier.diagnostics().at(0).level() == Cbe::CppCompilerDiagnostic::Level::ERROR);
+    QVERIFY(compilerNotifier.diagnostics().at(0).sourceRange().startLineNumber() == 2);
+
+    // The worker and its compiler instance are reused for the next context.
+    compilerNotifier.reset();
+
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_worker.o"));
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context << "extern \"C\" int add(int a, int b) {" << Cbe::endl
+             << "    return a + b;" << Cbe::endl
+             << "}" << Cbe::endl;
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(!compilerNotifier.fatalError());
+    QVERIFY(compilerNotifier.diagnostics().isEmpty());
+    QVERIFY(!context->objectData().isEmpty());
+    QVERIFY(context->timing().totalWallTime() > 0);
+
+    // A missing worker executable fails the context without affecting this process.
+    compilerNotifier.reset();
+
+    QTemporaryDir emptyDirectory;
+    QVERIFY(emptyDirectory.isValid());
+
+    compiler.setExecutableDirectory(emptyDirectory.path());
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.compilerFinishedCalled());
+    QVERIFY(!compilerNotifier.success());
+    QVERIFY(compilerNotifier.fatalError());
+
+    compiler.setWorkerProcessDisabled();
+    QVERIFY(compiler.isInternal());
+}
+
+
+void TestCompilerBasicFunctionality::testTargetInitialization() {
+    QVERIFY(Cbe::Compiler::targetInitialization() == Cbe::Compiler::TargetInitialization::ALL);
+    QVERIFY(Cbe::Compiler::initialTargets().isEmpty());
+
+    // Compilers already exist in this process so the policy only affects worker style startups.  We verify the
+    // settings round trip and that compiling continues to work after the policy changes.
+    Cbe::Compiler::setTargetInitialization(Cbe::Compiler::TargetInitialization::ON_DEMAND);
+    Cbe::Compiler::setInitialTargets(QList<QString>() << "X86" << "AArch64");
+
+    QVERIFY(Cbe::Compiler::targetInitialization() == Cbe::Compiler::TargetInitialization::ON_DEMAND);
+    QCOMPARE(Cbe::Compiler::initialTargets(), QList<QString>() << "X86" << "AArch64");
+
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_target_initialization.o"));
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context << "extern \"C\" int add(int a, int b) {" << Cbe::endl
+             << "    return a + b;" << Cbe::endl
+             << "}" << Cbe::endl;
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(!compilerNotifier.fatalError());
+    QVERIFY(!context->objectData().isEmpty());
+
+    Cbe::Compiler::setTargetInitialization(Cbe::Compiler::TargetInitialization::ALL);
+    Cbe::Compiler::setInitialTargets(QList<QString>());
+}
+
+
+void TestCompilerBasicFunctionality::testWarmUp() {
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QString headerFilename = temporaryDirectory.filePath("test_warm_up.h");
+    QString cacheDirectory = temporaryDirectory.filePath("pch");
+
+    QFile headerFile(headerFilename);
+    QVERIFY(headerFile.open(QIODevice::WriteOnly));
+    headerFile.write("inline int triple(int x) { return 3 * x; }\n");
+    headerFile.close();
+
+    CompilerNotifier compilerNotifier;
+    Cbe::CppCompiler compiler(&compilerNotifier);
+
+    configureTestCompiler(compiler);
+
+    compiler.setHeaders(QList<QString>() << headerFilename);
+    compiler.setPchCacheDirectory(cacheDirectory);
+    compiler.setAutomaticPchEnabled();
+
+    // Warming up builds the precompiled header without reporting anything to the notifier.
+    compiler.warmUp();
+    compiler.waitComplete();
+
+    QVERIFY(!compilerNotifier.compilerFinishedCalled());
+    QVERIFY(compilerNotifier.diagnostics().isEmpty());
+    QVERIFY(QDir(cacheDirectory).entryList(QStringList() << "*.pch", QDir::Files).size() == 1);
+
+    QSharedPointer<CompilerContext> context(new CompilerContext("test_warm_up.o"));
+    context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *context << "extern \"C\" int f(int a) { return triple(a); }" << Cbe::endl;
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.callbacksProperlyOrdered());
+    QVERIFY(compilerNotifier.success());
+    QVERIFY(context->diagnostics().isEmpty());
+    QVERIFY(!context->objectData().isEmpty());
+
+    // Warming up never reports header errors; the next context reports them.
+    compilerNotifier.reset();
+
+    QVERIFY(headerFile.open(QIODevice::Append));
+    headerFile.write("inline int broken(int x) { return x + y; }\n");
+    headerFile.close();
+
+    compiler.setAutomaticPchDisabled();
+    compiler.warmUp();
+    compiler.waitComplete();
+
+    QVERIFY(!compilerNotifier.compilerFinishedCalled());
+
+    compiler.compile(context);
+    compiler.waitComplete();
+
+    QVERIFY(compilerNotifier.compilerFinishedCalled());
+    QVERIFY(!compilerNotifier.success());
+    QVERIFY(!context->diagnostics().isEmpty());
+}
+
+
+void TestCompilerBasicFunctionality::testCompileBatch() {
+    Cbe::CppCompiler compiler;
+
+    configureTestCompiler(compiler);
+
+    QList<QSharedPointer<CompilerContext>>      contexts;
+    QList<QSharedPointer<Cbe::CompilerContext>> batch;
+    for (unsigned index=0 ; index<3 ; ++index) {
+        QSharedPointer<CompilerContext> context(new CompilerContext(QString("test_batch_%1.o").arg(index)));
+        context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+        *context << QString("extern \"C\" int f%1(int a) {").arg(index) << Cbe::endl
+                 << QString("    return a + %1;").arg(index) << Cbe::endl
+                 << "}";
+
+        contexts.append(context);
+        batch.append(context);
+    }
+
+    // The last context warns on its second line so we can verify diagnostics are routed by offset.
+    *contexts.at(2) << Cbe::endl << "int g(int a) { if (a > 0) return a; }" << Cbe::endl;
+
+    compiler.compileBatch(batch);
+    compiler.waitComplete();
+
+    for (unsigned index=0 ; index<3 ; ++index) {
+        const QSharedPointer<CompilerContext>& context = contexts.at(index);
+
+        QVERIFY(context->callbacksProperlyOrdered());
+        QVERIFY(context->compilerFinishedCalled());
+        QVERIFY(context->success());
+    }
+
+    // The combined object is delivered through the first context.
+    QVERIFY(!contexts.at(0)->objectData().isEmpty());
+    QVERIFY(contexts.at(1)->objectData().isEmpty());
+    QVERIFY(contexts.at(2)->objectData().isEmpty());
+
+    QVERIFY(contexts.at(0)->diagnostics().isEmpty());
+    QVERIFY(contexts.at(1)->diagnostics().isEmpty());
+    QCOMPARE(contexts.at(2)->diagnostics().size(), 1);
+    QVERIFY(contexts.at(2)->diagnostics().at(0).level() == Cbe::CppCompilerDiagnostic::Level::WARNING);
+    QVERIFY(contexts.at(2)->diagnostics().at(0).sourceRange().startLineNumber() == 4);
+
+    // A failing batch is split so only the context holding the error fails.
+    QSharedPointer<CompilerContext> goodContext(new CompilerContext("test_batch_good.o"));
+    goodContext->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *goodContext << "extern \"C\" int h(int a) { return a; }" << Cbe::endl;
+
+    QSharedPointer<CompilerContext> badContext(new CompilerContext("test_batch_bad.o"));
+    badContext->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *badContext << "extern \"C\" int k(int a) {" << Cbe::endl
+                << "    return a + c;" << Cbe::endl
+                << "}" << Cbe::endl;
+
+    compiler.compileBatch(QList<QSharedPointer<Cbe::CompilerContext>>() << goodContext << badContext);
+    compiler.waitComplete();
+
+    QVERIFY(goodContext->callbacksProperlyOrdered());
+    QVERIFY(goodContext->success());
+    QVERIFY(goodContext->diagnostics().isEmpty());
+    QVERIFY(!goodContext->objectData().isEmpty());
+
+    QVERIFY(badContext->callbacksProperlyOrdered());
+    QVERIFY(!badContext->success());
+    QCOMPARE(badContext->diagnostics().size(), 1);
+    QVERIFY(badContext->diagnostics().at(0).sourceRange().startLineNumber() == 2);
+
+    // Contexts writing to a file or defining macros are never combined so each produces its own object.
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QSharedPointer<CompilerContext> fileContext(new CompilerContext(temporaryDirectory.filePath("test_batch_file.o")));
+    *fileContext << "extern \"C\" int m(int a) { return a * 2; }" << Cbe::endl;
+
+    QSharedPointer<CompilerContext> macroContext(new CompilerContext("test_batch_macro.o"));
+    macroContext->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *macroContext << "#define SCALE 3" << Cbe::endl
+                  << "extern \"C\" int n(int a) { return a * SCALE; }" << Cbe::endl;
+
+    QSharedPointer<CompilerContext> memoryContext(new CompilerContext("test_batch_memory.o"));
+    memoryContext->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    *memoryContext << "extern \"C\" int p(int a) { return a * 4; }" << Cbe::endl;
+
+    compiler.compileBatch(
+        QList<QSharedPointer<Cbe::CompilerContext>>() << fileContext << macroContext << memoryContext
+    );
+    compiler.waitComplete();
+
+    QVERIFY(fileContext->success());
+    QVERIFY(QFileInfo(temporaryDirectory.filePath("test_batch_file.o")).size() > 0);
+    QVERIFY(macroContext->success());
+    QVERIFY(!macroContext->objectData().isEmpty());
+    QVERIFY(memoryContext->success());
+    QVERIFY(!memoryContext->objectData().isEmpty());
+}
+
+
+void TestCompilerBasicFunctionality::testModules() {
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QString includeDirectory = temporaryDirectory.filePath("include");
+    QString cacheDirectory   = temporaryDirectory.filePath("modules");
+    QVERIFY(QDir().mkpath(includeDirectory));
+
+    QFile headerFile(QDir(includeDirectory).filePath("test_module.h"));
+    QVERIFY(headerFile.open(QIODevice::WriteOnly));
+    headerFile.write("inline int triple(int x) { return 3 * x; }\n");
+    headerFile.close();
+
+    QFile moduleMapFile(QDir(includeDirectory).filePath("module.modulemap"));
+    QVERIFY(moduleMapFile.open(QIODevice::WriteOnly));
+    moduleMapFile.write("module TestModule {\n    header \"test_module.h\"\n    export *\n}\n");
+    moduleMapFile.close();
+
+    unsigned numberModules = 0;
+    for (unsigned compilerIndex=0 ; compilerIndex<2 ; ++compilerIndex) {
+        Cbe::CppCompiler compiler;
+
+        configureTestCompiler(compiler);
+        compiler.setHeaderSearchPaths(compiler.headerSearchPaths() << includeDirectory);
+
+        QVERIFY(compiler.modulesDisabled());
+
+        compiler.setModuleCacheDirectory(cacheDirectory);
+        compiler.setModulesEnabled();
+
+        QVERIFY(compiler.modulesEnabled());
+        QVERIFY(compiler.moduleCacheDirectory() == cacheDirectory);
+
+        QSharedPointer<CompilerContext> context(new CompilerContext(QString("test_modules_%1.o").arg(compilerIndex)));
+        context->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+        *context << "#include \"test_module.h\"" << Cbe::endl
+                 << "extern \"C\" int f(int a) { return triple(a); }" << Cbe::endl;
+
+        compiler.compile(context);
+        compiler.waitComplete();
+
+        QVERIFY(context->callbacksProperlyOrdered());
+        QVERIFY(context->success());
+        QVERIFY(context->diagnostics().isEmpty());
+        QVERIFY(!context->objectData().isEmpty());
+
+        // The second compiler must reuse the module built by the first.
+        unsigned numberCachedModules = 0;
+        QDirIterator cacheIterator(cacheDirectory, QStringList() << "*.pcm", QDir::Files, QDirIterator::Subdirectories);
+        while (cacheIterator.hasNext()) {
+            cacheIterator.next();
+            ++numberCachedModules;
+        }
+
+        QVERIFY(numberCachedModules > 0);
+
+        if (compilerIndex == 0) {
+            numberModules = numberCachedModules;
+        } else {
+            QCOMPARE(numberCachedModules, numberModules);
+        }
+    }
+}
+
+
 void TestCompilerBasicFunctionality::testForMemoryLeaks() {
     // We run the compiler multiple times and measure the memory utilization before we start and after we finish.  We
     // can then calculate an average memory lost per run.  Ideally the per run memory lost should be at or very close to
@@ -566,3 +1720,39 @@ void TestCompilerBasicFunctionality::testForMemoryLeaks() {
     qDebug() << "averageMemoryLeak = " << averageMemoryLeak;
     QVERIFY(averageMemoryLeak < 42000.0);
 }
+
+
+void TestCompilerBasicFunctionality::configureTestCompiler(Cbe::Compiler& compiler) {
+    #if (defined(Q_OS_DARWIN))
+
+        compiler.setSystemRoot(
+            "/Applications/Xcode.app/Contents/Developer/Platforms/MacOSX.platform/Developer/SDKs/MacOSX10.15.sdk"
+        );
+
+        compiler.setResourceDirectory("/opt/llvm-5.0.1/include/c++/v1/");
+        compiler.setHeaderSearchPaths(QList<QString>() << "/usr/local/include");
+
+    #else
+
+        (void) compiler;
+
+    #endif
+}
+
+
+void TestCompilerBasicFunctionality::configureTestCompiler(Cbe::CompilerPool& compilerPool) {
+    #if (defined(Q_OS_DARWIN))
+
+        compilerPool.setSystemRoot(
+            "/Applications/Xcode.app/Contents/Developer/Platforms/MacOSX.platform/Developer/SDKs/MacOSX10.15.sdk"
+        );
+
+        compilerPool.setResourceDirectory("/opt/llvm-5.0.1/include/c++/v1/");
+        compilerPool.setHeaderSearchPaths(QList<QString>() << "/usr/local/include");
+
+    #else
+
+        (void) compilerPool;
+
+    #endif
+}
@@ -32,6 +32,11 @@
 #include <QObject>
 #include <QtTest/QtTest>
 
+namespace Cbe {
+    class Compiler;
+    class CompilerPool;
+}
+
 class TestCompilerBasicFunctionality:public QObject {
     Q_OBJECT
 
@@ -47,10 +52,62 @@ class TestCompilerBasicFunctionality:public QObject {
 
         void testErrorReporting();
 
+        void testInMemoryObject();
+
+        void testCompilerPool();
+
+        void testAutomaticPch();
+
+        void testCompileCache();
+
+        void testPreambleReuse();
+
+        void testVirtualHeaders();
+
+        void testCancellation();
+
+        void testCompilerTiming();
+
+        void testTimeTrace();
+
+        void testJitEngine();
+
+        void testLazyJitEngine();
+
+        void testRuntimeBitcodeModules();
+
+        void testCheck();
+
+        void testWorkerProcess();
+
+        void testTargetInitialization();
+
+        void testWarmUp();
+
+        void testCompileBatch();
+
+        void testModules();
+
         void testForMemoryLeaks();
 
     private:
         static constexpr unsigned numberCompilerIterations = 100;
+
+        /**
+         * Method that applies the platform specific system root, resource directory, and header search paths used by
+         * the tests to a compiler.
+         *
+         * \param[in] compiler The compiler to be configured.
+         */
+        static void configureTestCompiler(Cbe::Compiler& compiler);
+
+        /**
+         * Method that applies the platform specific system root, resource directory, and header search paths used by
+         * the tests to every compiler in a compiler pool.
+         *
+         * \param[in] compilerPool The compiler pool to be configured.
+         */
+        static void configureTestCompiler(Cbe::CompilerPool& compilerPool);
 };
 
 #endif
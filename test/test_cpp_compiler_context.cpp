@@ -86,6 +86,15 @@ void TestCppCompilerContext::testObjectFileAccessors() {
 
     context.setObjectFile("output2.o");
     QVERIFY(context.objectFile() == "output2.o");
+
+    QVERIFY(context.objectDestination() == Cbe::CompilerContext::ObjectDestination::FILE);
+    QVERIFY(context.objectData().isEmpty());
+
+    context.setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    QVERIFY(context.objectDestination() == Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+    context.setObjectData(QByteArray("\x7F" "ELF"));
+    QVERIFY(context.objectData() == QByteArray("\x7F" "ELF"));
 }
 
 
@@ -118,6 +127,62 @@ void TestCppCompilerContext::testBufferOperators() {
 }
 
 
+void TestCppCompilerContext::testLargeSources() {
+    // We build a source spanning many chunks using every append path and check it against a reference buffer.
+    Cbe::CppCompilerContext context("output.o");
+    QByteArray              expected;
+
+    for (unsigned index=0 ; index<20000 ; ++index) {
+        QByteArray line = QString("int value%1 = %1;").arg(index).toLocal8Bit();
+
+        context << line.constData();
+        expected += line;
+
+        if (index % 3 == 0) {
+            context << QByteArray(" // Comment");
+            expected += " // Comment";
+        }
+
+        context << '\n';
+        expected += '\n';
+    }
+
+    QByteArray largeBlock(200000, 'x');
+    largeBlock[1000]   = '\n';
+    largeBlock[150000] = '\n';
+
+    context << largeBlock;
+    expected += largeBlock;
+
+    QVERIFY(context.byteOffset() == static_cast<unsigned long>(expected.size()));
+    QVERIFY(context.lineNumber() == static_cast<unsigned long>(expected.count('\n') + 1));
+    QVERIFY(context.columnNumber() == static_cast<unsigned long>(expected.size() - expected.lastIndexOf('\n') - 1));
+
+    // Copies made before flattening must not be affected by later appends to the original.
+    Cbe::CppCompilerContext copy(context);
+    context << "int extra;";
+
+    QVERIFY(copy.sourceData() == expected);
+    QVERIFY(context.sourceData() == expected + "int extra;");
+
+    unsigned long lineNumber   = 1;
+    unsigned long columnNumber = 0;
+    for (int offset=0 ; offset<expected.size() ; ++offset) {
+        if (offset % 997 == 0 || expected.at(offset) == '\n') {
+            QVERIFY(context.lineNumber(static_cast<unsigned long>(offset)) == lineNumber);
+            QVERIFY(context.columnNumber(static_cast<unsigned long>(offset)) == columnNumber);
+        }
+
+        if (expected.at(offset) == '\n') {
+            ++lineNumber;
+            columnNumber = 0;
+        } else {
+            ++columnNumber;
+        }
+    }
+}
+
+
 void TestCppCompilerContext::testAssignmentOperators() {
     QString testContents = "Lets\nMake\nGreat\nThings";
     Cbe::CppCompilerContext context1(
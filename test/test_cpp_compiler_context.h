@@ -47,6 +47,8 @@ class TestCppCompilerContext:public QObject {
 
         void testBufferOperators();
 
+        void testLargeSources();
+
         void testAssignmentOperators();
 };
 
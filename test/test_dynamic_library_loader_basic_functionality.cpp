@@ -32,6 +32,10 @@
 #include <QList>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDir>
+#include <QTemporaryDir>
 
 #include <cstdint>
 
@@ -41,12 +45,127 @@
 #include <cbe_cpp_compiler.h>
 #include <cbe_cpp_compiler_notifier.h>
 #include <cbe_cpp_compiler_context.h>
+#include <cbe_cpp_compiler_diagnostic.h>
 #include <cbe_loader_notifier.h>
 #include <cbe_dynamic_library_loader.h>
+#include <cbe_tiered_builder.h>
+#include <cbe_tiered_builder_notifier.h>
+#include <cbe_incremental_builder.h>
 
 #include "process_memory.h"
 #include "test_dynamic_library_loader_basic_functionality.h"
 
+/***********************************************************************************************************************
+ * TieredBuilderNotifier
+ */
+
+class TieredBuilderNotifier:public Cbe::TieredBuilderNotifier {
+    public:
+        TieredBuilderNotifier();
+
+        ~TieredBuilderNotifier() override;
+
+        QList<Cbe::TieredBuilder::Tier> loadedTiers() const;
+
+        unsigned numberFailures() const;
+
+        void tierLoaded(Cbe::TieredBuilder::Tier tier, const QString& libraryFilename) final;
+
+        void tierFailed(Cbe::TieredBuilder::Tier tier) final;
+
+    private:
+        mutable QMutex notifierMutex;
+
+        QList<Cbe::TieredBuilder::Tier> currentLoadedTiers;
+        unsigned                        currentNumberFailures;
+};
+
+
+TieredBuilderNotifier::TieredBuilderNotifier() {
+    currentNumberFailures = 0;
+}
+
+
+TieredBuilderNotifier::~TieredBuilderNotifier() {}
+
+
+QList<Cbe::TieredBuilder::Tier> TieredBuilderNotifier::loadedTiers() const {
+    QMutexLocker locker(&notifierMutex);
+    return currentLoadedTiers;
+}
+
+
+unsigned TieredBuilderNotifier::numberFailures() const {
+    QMutexLocker locker(&notifierMutex);
+    return currentNumberFailures;
+}
+
+
+void TieredBuilderNotifier::tierLoaded(Cbe::TieredBuilder::Tier tier, const QString&) {
+    QMutexLocker locker(&notifierMutex);
+    currentLoadedTiers.append(tier);
+}
+
+
+void TieredBuilderNotifier::tierFailed(Cbe::TieredBuilder::Tier) {
+    QMutexLocker locker(&notifierMutex);
+    ++currentNumberFailures;
+}
+
+/***********************************************************************************************************************
+ * DiagnosticRecordingContext
+ */
+
+class DiagnosticRecordingContext:public Cbe::CppCompilerContext {
+    public:
+        DiagnosticRecordingContext();
+
+        ~DiagnosticRecordingContext() override;
+
+        QList<QString> warnings() const;
+
+        unsigned numberErrors() const;
+
+        void handleCompilerDiagnostic(const Cbe::CppCompilerDiagnostic& diagnostic) final;
+
+    private:
+        mutable QMutex contextMutex;
+
+        QList<QString> currentWarnings;
+        unsigned       currentNumberErrors;
+};
+
+
+DiagnosticRecordingContext::DiagnosticRecordingContext():Cbe::CppCompilerContext(QString()) {
+    currentNumberErrors = 0;
+}
+
+
+DiagnosticRecordingContext::~DiagnosticRecordingContext() {}
+
+
+QList<QString> DiagnosticRecordingContext::warnings() const {
+    QMutexLocker locker(&contextMutex);
+    return currentWarnings;
+}
+
+
+unsigned DiagnosticRecordingContext::numberErrors() const {
+    QMutexLocker locker(&contextMutex);
+    return currentNumberErrors;
+}
+
+
+void DiagnosticRecordingContext::handleCompilerDiagnostic(const Cbe::CppCompilerDiagnostic& diagnostic) {
+    QMutexLocker locker(&contextMutex);
+
+    if (diagnostic.level() == Cbe::CompilerDiagnostic::Level::WARNING) {
+        currentWarnings.append(diagnostic.message());
+    } else if (diagnostic.level() == Cbe::CompilerDiagnostic::Level::ERROR) {
+        ++currentNumberErrors;
+    }
+}
+
 /***********************************************************************************************************************
  * TestDynamicLibraryLoaderBasicFunctionality
  */
@@ -95,6 +214,352 @@ void TestDynamicLibraryLoaderBasicFunctionality::testBasicFunctionality() {
 }
 
 
+void TestDynamicLibraryLoaderBasicFunctionality::testTieredBuilder() {
+    TieredBuilderNotifier notifier;
+    Cbe::TieredBuilder    builder(&notifier);
+
+    QVERIFY(builder.quickCompiler().compilerSwitches().contains("-O0"));
+    QVERIFY(!builder.quickCompiler().compilerSwitches().contains("-O3"));
+    QVERIFY(builder.optimizingCompiler().threadPriority() == QThread::LowPriority);
+    QVERIFY(!builder.isLoaded());
+
+    #if (defined(Q_OS_WIN))
+
+        builder.linker().setExecutableDirectory(QString("C:\\opt\\llvm-5.0.1\\Debug\\bin\\"));
+
+    #elif (defined(Q_OS_LINUX))
+
+        builder.linker().setExecutableDirectory(QString("/opt/llvm-5.0.1/bin/"));
+
+    #endif
+
+    QSharedPointer<Cbe::CppCompilerContext> context(new Cbe::CppCompilerContext(QString()));
+
+    #if (defined(Q_OS_WIN))
+
+        *context << "extern \"C\" __declspec(dllexport) int multiply(int a, int b) {" << Cbe::endl;
+
+    #else
+
+        *context << "extern \"C\" int multiply(int a, int b) {" << Cbe::endl;
+
+    #endif
+
+    *context << "    return a * b;" << Cbe::endl
+             << "}" << Cbe::endl;
+
+    builder.build(context);
+    builder.waitComplete();
+
+    QVERIFY(notifier.numberFailures() == 0);
+
+    // The quick tier is normally loaded first but the optimized tier may win the race on a loaded machine.  Either
+    // way the optimized tier must be the tier left loaded.
+    QList<Cbe::TieredBuilder::Tier> loadedTiers = notifier.loadedTiers();
+    QVERIFY(!loadedTiers.isEmpty());
+    QVERIFY(loadedTiers.last() == Cbe::TieredBuilder::Tier::OPTIMIZED);
+
+    QVERIFY(builder.isLoaded());
+    QVERIFY(builder.loadedTier() == Cbe::TieredBuilder::Tier::OPTIMIZED);
+
+    typedef int (*LibraryFunction)(int a, int b);
+
+    LibraryFunction libraryFunction = reinterpret_cast<LibraryFunction>(builder.loader().resolve("multiply"));
+    QVERIFY(libraryFunction != nullptr);
+    QVERIFY((*libraryFunction)(3, 4) == 12);
+
+    // Releasing the replaced quick library must leave the optimized library loaded.
+    builder.releasePrevious();
+
+    QVERIFY(builder.isLoaded());
+    QVERIFY(QFileInfo(builder.loader().filename()).exists());
+    QVERIFY((*libraryFunction)(5, 6) == 30);
+}
+
+
+void TestDynamicLibraryLoaderBasicFunctionality::testTieredBuilderLoadFailure() {
+    #if (!defined(Q_OS_LINUX))
+
+        QSKIP("Only the Linux linker leaves undefined symbols to be resolved at load time.");
+
+    #endif
+
+    TieredBuilderNotifier notifier;
+    Cbe::TieredBuilder    builder(&notifier);
+
+    builder.linker().setExecutableDirectory(QString("/opt/llvm-5.0.1/bin/"));
+
+    // Only the optimized tier references the undefined variable so only the optimized library fails to load.
+    QSharedPointer<Cbe::CppCompilerContext> context(new Cbe::CppCompilerContext(QString()));
+    *context << "#if (defined(__OPTIMIZE__))" << Cbe::endl
+             << "extern \"C\" int undefinedVariable;" << Cbe::endl
+             << "extern \"C\" int* undefinedReference = &undefinedVariable;" << Cbe::endl
+             << "#endif" << Cbe::endl
+             << "extern \"C\" int multiply(int a, int b) {" << Cbe::endl
+             << "    return a * b;" << Cbe::endl
+             << "}" << Cbe::endl;
+
+    builder.build(context);
+    builder.waitComplete();
+
+    QVERIFY(notifier.numberFailures() == 1);
+    QVERIFY(notifier.loadedTiers() == QList<Cbe::TieredBuilder::Tier>() << Cbe::TieredBuilder::Tier::QUICK);
+
+    // The quick library must still be loaded and its file must still exist.
+    QVERIFY(builder.isLoaded());
+    QVERIFY(builder.loadedTier() == Cbe::TieredBuilder::Tier::QUICK);
+    QVERIFY(QFileInfo(builder.loader().filename()).exists());
+
+    typedef int (*LibraryFunction)(int a, int b);
+
+    LibraryFunction libraryFunction = reinterpret_cast<LibraryFunction>(builder.loader().resolve("multiply"));
+    QVERIFY(libraryFunction != nullptr);
+    QVERIFY((*libraryFunction)(3, 4) == 12);
+}
+
+
+void TestDynamicLibraryLoaderBasicFunctionality::testThinLto() {
+    #if (defined(Q_OS_DARWIN))
+
+        QSKIP("ThinLTO is not supported by the MacOS linker.");
+
+    #endif
+
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QDir    directory(temporaryDirectory.path());
+    QString cacheDirectory = directory.filePath("lto_cache");
+
+    #if (defined(Q_OS_WIN))
+
+        QString libraryFile = directory.filePath("thin_lto.dll");
+        QString exportPrefix("extern \"C\" __declspec(dllexport) ");
+
+    #else
+
+        QString libraryFile = directory.filePath("thin_lto.so");
+        QString exportPrefix("extern \"C\" ");
+
+    #endif
+
+    QSharedPointer<Cbe::CppCompilerContext> calleeContext(
+        new Cbe::CppCompilerContext(directory.filePath("callee.o"))
+    );
+    calleeContext->setObjectFormat(Cbe::CompilerContext::ObjectFormat::THIN_LTO);
+
+    *calleeContext << "int square(int x) {" << Cbe::endl
+                   << "    return x * x;" << Cbe::endl
+                   << "}" << Cbe::endl;
+
+    QSharedPointer<Cbe::CppCompilerContext> callerContext(
+        new Cbe::CppCompilerContext(directory.filePath("caller.o"))
+    );
+    callerContext->setObjectFormat(Cbe::CompilerContext::ObjectFormat::THIN_LTO);
+
+    *callerContext << "int square(int x);" << Cbe::endl
+                   << exportPrefix << "int sumOfSquares(int a, int b) {" << Cbe::endl
+                   << "    return square(a) + square(b);" << Cbe::endl
+                   << "}" << Cbe::endl;
+
+    Cbe::CppCompiler compiler;
+    compiler.compile(calleeContext);
+    compiler.compile(callerContext);
+    compiler.waitComplete();
+
+    QVERIFY(QFileInfo(calleeContext->objectFile()).exists());
+    QVERIFY(QFileInfo(callerContext->objectFile()).exists());
+
+    Cbe::DynamicLibraryLinker linker;
+    linker.setLtoCacheDirectory(cacheDirectory);
+    QCOMPARE(linker.ltoCacheDirectory(), cacheDirectory);
+
+    #if (defined(Q_OS_WIN))
+
+        linker.setExecutableDirectory(QString("C:\\opt\\llvm-5.0.1\\Debug\\bin\\"));
+
+    #elif (defined(Q_OS_LINUX))
+
+        linker.setExecutableDirectory(QString("/opt/llvm-5.0.1/bin/"));
+
+    #endif
+
+    QSharedPointer<Cbe::LinkerContext> linkerContext(
+        new Cbe::LinkerContext(
+            libraryFile,
+            QList<QString>() << calleeContext->objectFile() << callerContext->objectFile()
+        )
+    );
+
+    linker.link(linkerContext);
+    linker.waitComplete();
+
+    QVERIFY(QFileInfo(libraryFile).exists());
+    QVERIFY(QDir(cacheDirectory).exists());
+
+    Cbe::DynamicLibraryLoader loader;
+    bool success = loader.load(libraryFile);
+    QVERIFY(success);
+
+    typedef int (*LibraryFunction)(int a, int b);
+
+    LibraryFunction libraryFunction = reinterpret_cast<LibraryFunction>(loader.resolve("sumOfSquares"));
+    QVERIFY(libraryFunction != nullptr);
+    QVERIFY((*libraryFunction)(3, 4) == 25);
+
+    loader.unload();
+}
+
+
+void TestDynamicLibraryLoaderBasicFunctionality::testIncrementalBuilder() {
+    Cbe::IncrementalBuilder builder;
+
+    #if (defined(Q_OS_WIN))
+
+        builder.linker().setExecutableDirectory(QString("C:\\opt\\llvm-5.0.1\\Debug\\bin\\"));
+        QString exportPrefix("extern \"C\" __declspec(dllexport) ");
+        QString extension("dll");
+
+    #elif (defined(Q_OS_DARWIN))
+
+        QString exportPrefix("extern \"C\" ");
+        QString extension("dylib");
+
+    #elif (defined(Q_OS_LINUX))
+
+        builder.linker().setExecutableDirectory(QString("/opt/llvm-5.0.1/bin/"));
+        QString exportPrefix("extern \"C\" ");
+        QString extension("so");
+
+    #else
+
+        #error Unknown platform
+
+    #endif
+
+    QTemporaryDir temporaryDirectory;
+    QVERIFY(temporaryDirectory.isValid());
+
+    QList<QByteArray> bodies;
+    bodies << "    return x + 1;" << "    return x + 2;" << "    return x + 3;";
+
+    for (unsigned buildIndex=0 ; buildIndex<2 ; ++buildIndex) {
+        if (buildIndex == 1) {
+            bodies[1] = "    return x * 20;";
+        }
+
+        QSharedPointer<Cbe::CppCompilerContext> context(new Cbe::CppCompilerContext(QString()));
+
+        *context << "int f0(int x);" << Cbe::endl
+                 << "int f1(int x);" << Cbe::endl
+                 << "int f2(int x);" << Cbe::endl
+                 << Cbe::IncrementalBuilder::chunkMarker << Cbe::endl;
+
+        for (int chunkIndex=0 ; chunkIndex<bodies.size() ; ++chunkIndex) {
+            if (chunkIndex > 0) {
+                *context << Cbe::IncrementalBuilder::chunkMarker << Cbe::endl;
+            }
+
+            *context << QString("int f%1(int x) {").arg(chunkIndex) << Cbe::endl
+                     << bodies.at(chunkIndex) << Cbe::endl
+                     << "}" << Cbe::endl;
+        }
+
+        *context << exportPrefix << "int evaluate(int x) {" << Cbe::endl
+                 << "    return f0(x) + f1(x) + f2(x);" << Cbe::endl
+                 << "}" << Cbe::endl;
+
+        // Dynamic loaders cache libraries by name so each build is given a unique name.
+        QString libraryFile = QDir(temporaryDirectory.path()).filePath(
+            QString("incremental_%1.%2").arg(buildIndex).arg(extension)
+        );
+
+        bool success = builder.build(context, libraryFile);
+        QVERIFY(success);
+
+        QCOMPARE(builder.numberChunks(), 3UL);
+        QCOMPARE(builder.numberCompiledChunks(), buildIndex == 0 ? 3UL : 1UL);
+
+        Cbe::DynamicLibraryLoader loader;
+        success = loader.load(libraryFile);
+        QVERIFY(success);
+
+        typedef int (*LibraryFunction)(int x);
+
+        LibraryFunction libraryFunction = reinterpret_cast<LibraryFunction>(loader.resolve("evaluate"));
+        QVERIFY(libraryFunction != nullptr);
+        QCOMPARE((*libraryFunction)(1), buildIndex == 0 ? 9 : 26);
+
+        loader.unload();
+    }
+
+    builder.setPartitioning(Cbe::IncrementalBuilder::Partitioning::TOP_LEVEL_DECLARATIONS);
+    builder.setTargetChunkSize(1024);
+    QVERIFY(builder.partitioning() == Cbe::IncrementalBuilder::Partitioning::TOP_LEVEL_DECLARATIONS);
+
+    // The second build edits a single function so only the chunk holding it, and possibly its neighbours, should be
+    // compiled.  The third build adds a function using a function defined in another chunk without a declaration in
+    // the prologue so the source must be compiled as a single unit.
+    for (unsigned buildIndex=0 ; buildIndex<3 ; ++buildIndex) {
+        QSharedPointer<DiagnosticRecordingContext> context(new DiagnosticRecordingContext);
+        for (unsigned functionIndex=0 ; functionIndex<200 ; ++functionIndex) {
+            QString operation = (buildIndex == 1 && functionIndex == 100) ? QString("-") : QString("+");
+
+            *context << exportPrefix << QString("int g%1(int x) {").arg(functionIndex) << Cbe::endl
+                     << QString("    return x %1 %2; // '{' \"}\"").arg(operation).arg(functionIndex) << Cbe::endl
+                     << "}" << Cbe::endl;
+        }
+
+        if (buildIndex == 2) {
+            *context << exportPrefix << "int callsFirst(int x) {" << Cbe::endl
+                     << "    return 2 * g0(x);" << Cbe::endl
+                     << "}" << Cbe::endl;
+        }
+
+        QString libraryFile = QDir(temporaryDirectory.path()).filePath(
+            QString("declarations_%1.%2").arg(buildIndex).arg(extension)
+        );
+
+        bool success = builder.build(context, libraryFile);
+        QVERIFY(success);
+        QVERIFY(context->numberErrors() == 0);
+
+        if (buildIndex == 0) {
+            QVERIFY(builder.numberChunks() > 1);
+            QCOMPARE(builder.numberCompiledChunks(), builder.numberChunks());
+            QVERIFY(context->warnings().isEmpty());
+        } else if (buildIndex == 1) {
+            QVERIFY(builder.numberChunks() > 3);
+            QVERIFY(builder.numberCompiledChunks() >= 1);
+            QVERIFY(builder.numberCompiledChunks() <= 3);
+            QVERIFY(context->warnings().isEmpty());
+        } else {
+            QCOMPARE(builder.numberChunks(), 1UL);
+            QCOMPARE(context->warnings().size(), 1);
+            QVERIFY(context->warnings().first().contains("g0"));
+        }
+
+        Cbe::DynamicLibraryLoader loader;
+        success = loader.load(libraryFile);
+        QVERIFY(success);
+
+        typedef int (*LibraryFunction)(int x);
+
+        LibraryFunction libraryFunction = reinterpret_cast<LibraryFunction>(loader.resolve("g100"));
+        QVERIFY(libraryFunction != nullptr);
+        QCOMPARE((*libraryFunction)(1), buildIndex == 1 ? -99 : 101);
+
+        if (buildIndex == 2) {
+            libraryFunction = reinterpret_cast<LibraryFunction>(loader.resolve("callsFirst"));
+            QVERIFY(libraryFunction != nullptr);
+            QCOMPARE((*libraryFunction)(3), 6);
+        }
+
+        loader.unload();
+    }
+}
+
+
 void TestDynamicLibraryLoaderBasicFunctionality::generateDynamicLibrary(const QString& libraryFile) {
     #if (defined(Q_OS_WIN))
 
@@ -44,6 +44,14 @@ class TestDynamicLibraryLoaderBasicFunctionality:public QObject {
 
         void testBasicFunctionality();
 
+        void testTieredBuilder();
+
+        void testTieredBuilderLoadFailure();
+
+        void testThinLto();
+
+        void testIncrementalBuilder();
+
     private:
         static constexpr unsigned numberLinkerIterations = 100;
 
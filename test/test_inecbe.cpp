@@ -28,6 +28,7 @@
 #include <QtTest/QtTest>
 
 #include "test_cpp_source_range.h"
+#include "test_job_queues.h"
 #include "test_cpp_compiler_context.h"
 #include "test_linker_context.h"
 #include "test_cpp_compiler_diagnostic.h"
@@ -44,6 +45,7 @@ int main(int argumentCount, char** argumentValues) {
     int testStatus = 0;
 
     TEST(TestCppSourceRange);
+    TEST(TestJobQueues);
     TEST(TestCppCompilerContext);
     TEST(TestLinkerContext);
     TEST(TestCppCompilerDiagnostic);
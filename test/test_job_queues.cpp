@@ -0,0 +1,730 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+* 
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*   
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*   
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements tests of the Cbe::JobQueue derived classes.
+***********************************************************************************************************************/
+
+#include <QtGlobal>
+#include <QDebug>
+#include <QString>
+#include <QSharedPointer>
+#include <QThread>
+#include <QList>
+
+#include <atomic>
+
+#include <cbe_job_queue.h>
+#include <cbe_lock_free_job_queue.h>
+#include <cbe_coalescing_job_queue.h>
+#include <cbe_cpp_compiler_context.h>
+#include <cbe_compiler_notifier.h>
+#include <cbe_linker_context.h>
+#include <cbe_linker_notifier.h>
+
+#include "test_job_queues.h"
+
+/***********************************************************************************************************************
+ * Job
+ */
+
+class Job {
+    public:
+        Job(unsigned newValue, unsigned newPriority = 0);
+
+        ~Job();
+
+        unsigned value() const;
+
+        unsigned priority() const;
+
+    private:
+        unsigned currentValue;
+        unsigned currentPriority;
+};
+
+
+Job::Job(unsigned newValue, unsigned newPriority) {
+    currentValue    = newValue;
+    currentPriority = newPriority;
+}
+
+
+Job::~Job() {}
+
+
+unsigned Job::value() const {
+    return currentValue;
+}
+
+
+unsigned Job::priority() const {
+    return currentPriority;
+}
+
+/***********************************************************************************************************************
+ * PriorityJobQueue
+ */
+
+class PriorityJobQueue:public Cbe::LockFreeJobQueue<Job> {
+    public:
+        PriorityJobQueue(unsigned newCapacity, unsigned newNumberPriorityLevels);
+
+        ~PriorityJobQueue() override;
+
+        const QList<unsigned>& rejectedValues() const;
+
+    protected:
+        unsigned jobPriority(const QSharedPointer<Job>& job) const override;
+
+        void jobRejected(QSharedPointer<Job> rejectedJob) override;
+
+    private:
+        QList<unsigned> currentRejectedValues;
+};
+
+
+PriorityJobQueue::PriorityJobQueue(
+        unsigned newCapacity,
+        unsigned newNumberPriorityLevels
+    ):Cbe::LockFreeJobQueue<Job>(
+        newCapacity,
+        FullPolicy::REJECT,
+        newNumberPriorityLevels
+    ) {}
+
+
+PriorityJobQueue::~PriorityJobQueue() {}
+
+
+const QList<unsigned>& PriorityJobQueue::rejectedValues() const {
+    return currentRejectedValues;
+}
+
+
+unsigned PriorityJobQueue::jobPriority(const QSharedPointer<Job>& job) const {
+    return job->priority();
+}
+
+
+void PriorityJobQueue::jobRejected(QSharedPointer<Job> rejectedJob) {
+    currentRejectedValues.append(rejectedJob->value());
+}
+
+/***********************************************************************************************************************
+ * KeyedJobQueue
+ */
+
+class KeyedJobQueue:public Cbe::CoalescingJobQueue<Job, unsigned> {
+    public:
+        KeyedJobQueue();
+
+        ~KeyedJobQueue() override;
+
+        const QList<unsigned>& supersededValues() const;
+
+    protected:
+        unsigned jobKey(const QSharedPointer<Job>& job) const override;
+
+        void jobSuperseded(QSharedPointer<Job> supersededJob, QSharedPointer<Job> newJob) override;
+
+    private:
+        QList<unsigned> currentSupersededValues;
+};
+
+
+KeyedJobQueue::KeyedJobQueue() {}
+
+
+KeyedJobQueue::~KeyedJobQueue() {}
+
+
+const QList<unsigned>& KeyedJobQueue::supersededValues() const {
+    return currentSupersededValues;
+}
+
+
+unsigned KeyedJobQueue::jobKey(const QSharedPointer<Job>& job) const {
+    // The job priority doubles as the coalescing key for these tests.
+    return job->priority();
+}
+
+
+void KeyedJobQueue::jobSuperseded(QSharedPointer<Job> supersededJob, QSharedPointer<Job>) {
+    currentSupersededValues.append(supersededJob->value());
+}
+
+/***********************************************************************************************************************
+ * CompilerContext
+ */
+
+class CompilerContext:public Cbe::CppCompilerContext {
+    public:
+        CompilerContext(const QString& newObjectFile);
+
+        ~CompilerContext() override;
+
+        bool superseded() const;
+
+        void compilerJobSuperseded() override;
+
+    private:
+        bool currentSuperseded;
+};
+
+
+CompilerContext::CompilerContext(const QString& newObjectFile):Cbe::CppCompilerContext(newObjectFile) {
+    currentSuperseded = false;
+}
+
+
+CompilerContext::~CompilerContext() {}
+
+
+bool CompilerContext::superseded() const {
+    return currentSuperseded;
+}
+
+
+void CompilerContext::compilerJobSuperseded() {
+    currentSuperseded = true;
+}
+
+/***********************************************************************************************************************
+ * SupersessionNotifier
+ */
+
+class SupersessionNotifier:public Cbe::CompilerNotifier {
+    public:
+        SupersessionNotifier();
+
+        ~SupersessionNotifier() override;
+
+        const QList<QSharedPointer<Cbe::CompilerContext>>& supersededContexts() const;
+
+        void compilerJobSuperseded(
+            QSharedPointer<Cbe::CompilerContext> supersededContext,
+            QSharedPointer<Cbe::CompilerContext> newContext
+        ) override;
+
+    private:
+        QList<QSharedPointer<Cbe::CompilerContext>> currentSupersededContexts;
+};
+
+
+SupersessionNotifier::SupersessionNotifier() {}
+
+
+SupersessionNotifier::~SupersessionNotifier() {}
+
+
+const QList<QSharedPointer<Cbe::CompilerContext>>& SupersessionNotifier::supersededContexts() const {
+    return currentSupersededContexts;
+}
+
+
+void SupersessionNotifier::compilerJobSuperseded(
+        QSharedPointer<Cbe::CompilerContext> supersededContext,
+        QSharedPointer<Cbe::CompilerContext>
+    ) {
+    currentSupersededContexts.append(supersededContext);
+}
+
+/***********************************************************************************************************************
+ * LinkerContext
+ */
+
+class LinkerContext:public Cbe::LinkerContext {
+    public:
+        LinkerContext(const QString& newOutputFile);
+
+        ~LinkerContext() override;
+
+        bool superseded() const;
+
+        void linkerJobSuperseded() override;
+
+    private:
+        bool currentSuperseded;
+};
+
+
+LinkerContext::LinkerContext(const QString& newOutputFile):Cbe::LinkerContext(newOutputFile) {
+    currentSuperseded = false;
+}
+
+
+LinkerContext::~LinkerContext() {}
+
+
+bool LinkerContext::superseded() const {
+    return currentSuperseded;
+}
+
+
+void LinkerContext::linkerJobSuperseded() {
+    currentSuperseded = true;
+}
+
+/***********************************************************************************************************************
+ * ResubmittingLinkerNotifier
+ */
+
+class ResubmittingLinkerNotifier:public Cbe::LinkerNotifier {
+    public:
+        ResubmittingLinkerNotifier(Cbe::JobQueue<Cbe::LinkerContext>* newJobQueue);
+
+        ~ResubmittingLinkerNotifier() override;
+
+        const QList<QSharedPointer<Cbe::LinkerContext>>& supersededContexts() const;
+
+        void linkerJobSuperseded(
+            QSharedPointer<Cbe::LinkerContext> supersededContext,
+            QSharedPointer<Cbe::LinkerContext> newContext
+        ) override;
+
+    private:
+        Cbe::JobQueue<Cbe::LinkerContext>*        jobQueue;
+        QList<QSharedPointer<Cbe::LinkerContext>> currentSupersededContexts;
+};
+
+
+ResubmittingLinkerNotifier::ResubmittingLinkerNotifier(
+        Cbe::JobQueue<Cbe::LinkerContext>* newJobQueue
+    ):jobQueue(
+        newJobQueue
+    ) {}
+
+
+ResubmittingLinkerNotifier::~ResubmittingLinkerNotifier() {}
+
+
+const QList<QSharedPointer<Cbe::LinkerContext>>& ResubmittingLinkerNotifier::supersededContexts() const {
+    return currentSupersededContexts;
+}
+
+
+void ResubmittingLinkerNotifier::linkerJobSuperseded(
+        QSharedPointer<Cbe::LinkerContext> supersededContext,
+        QSharedPointer<Cbe::LinkerContext>
+    ) {
+    currentSupersededContexts.append(supersededContext);
+
+    // Resubmit the superseded context under a new output file, as a client might from its notifier.
+    jobQueue->enqueue(QSharedPointer<Cbe::LinkerContext>(new LinkerContext(supersededContext->outputFile() + ".1")));
+}
+
+/***********************************************************************************************************************
+ * Producer
+ */
+
+class Producer:public QThread {
+    public:
+        Producer(Cbe::JobQueue<Job>* newJobQueue, unsigned newNumberJobs);
+
+        ~Producer() override;
+
+    protected:
+        void run() override;
+
+    private:
+        Cbe::JobQueue<Job>* jobQueue;
+        unsigned            numberJobs;
+};
+
+
+Producer::Producer(Cbe::JobQueue<Job>* newJobQueue, unsigned newNumberJobs) {
+    jobQueue   = newJobQueue;
+    numberJobs = newNumberJobs;
+}
+
+
+Producer::~Producer() {}
+
+
+void Producer::run() {
+    for (unsigned jobIndex=1 ; jobIndex<=numberJobs ; ++jobIndex) {
+        jobQueue->enqueue(QSharedPointer<Job>(new Job(jobIndex)));
+    }
+}
+
+/***********************************************************************************************************************
+ * Consumer
+ */
+
+class Consumer:public QThread {
+    public:
+        Consumer(
+            Cbe::JobQueue<Job>*              newJobQueue,
+            unsigned long long               newTotalJobs,
+            std::atomic<unsigned long long>* newJobsReceived
+        );
+
+        ~Consumer() override;
+
+        unsigned long long sum() const;
+
+    protected:
+        void run() override;
+
+    private:
+        Cbe::JobQueue<Job>*              jobQueue;
+        unsigned long long               totalJobs;
+        std::atomic<unsigned long long>* jobsReceived;
+        unsigned long long               currentSum;
+};
+
+
+Consumer::Consumer(
+        Cbe::JobQueue<Job>*              newJobQueue,
+        unsigned long long               newTotalJobs,
+        std::atomic<unsigned long long>* newJobsReceived
+    ) {
+    jobQueue     = newJobQueue;
+    totalJobs    = newTotalJobs;
+    jobsReceived = newJobsReceived;
+    currentSum   = 0;
+}
+
+
+Consumer::~Consumer() {}
+
+
+unsigned long long Consumer::sum() const {
+    return currentSum;
+}
+
+
+void Consumer::run() {
+    while (jobsReceived->load() < totalJobs) {
+        QSharedPointer<Job> job = jobQueue->dequeue();
+        if (job.isNull()) {
+            QThread::yieldCurrentThread();
+        } else {
+            currentSum += job->value();
+            ++(*jobsReceived);
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * TestJobQueues
+ */
+
+TestJobQueues::TestJobQueues() {}
+
+
+TestJobQueues::~TestJobQueues() {}
+
+
+void TestJobQueues::testSimpleJobQueue() {
+    Cbe::SimpleJobQueue<Job> jobQueue;
+    QVERIFY(!jobQueue.threadSafe());
+    QVERIFY(jobQueue.numberPendingJobs() == 0);
+
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(1)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(2)));
+    QVERIFY(jobQueue.numberPendingJobs() == 1);
+
+    QSharedPointer<Job> job = jobQueue.dequeue();
+    QVERIFY(!job.isNull());
+    QVERIFY(job->value() == 2);
+    QVERIFY(jobQueue.dequeue().isNull());
+}
+
+
+void TestJobQueues::testFifoJobQueue() {
+    Cbe::FifoJobQueue<Job> jobQueue;
+    QVERIFY(!jobQueue.threadSafe());
+
+    for (unsigned jobIndex=0 ; jobIndex<10 ; ++jobIndex) {
+        jobQueue.enqueue(QSharedPointer<Job>(new Job(jobIndex)));
+    }
+
+    QVERIFY(jobQueue.numberPendingJobs() == 10);
+
+    for (unsigned jobIndex=0 ; jobIndex<10 ; ++jobIndex) {
+        QSharedPointer<Job> job = jobQueue.dequeue();
+        QVERIFY(!job.isNull());
+        QVERIFY(job->value() == jobIndex);
+    }
+
+    QVERIFY(jobQueue.dequeue().isNull());
+}
+
+
+void TestJobQueues::testLockFreeJobQueue() {
+    Cbe::LockFreeJobQueue<Job> jobQueue(100);
+    QVERIFY(jobQueue.threadSafe());
+    QVERIFY(jobQueue.capacity() == 128);
+    QVERIFY(jobQueue.numberPriorityLevels() == 1);
+    QVERIFY(jobQueue.fullPolicy() == Cbe::LockFreeJobQueue<Job>::FullPolicy::BLOCK);
+    QVERIFY(jobQueue.dequeue().isNull());
+
+    // Cycle through the ring several times to verify slot reuse.
+    for (unsigned pass=0 ; pass<5 ; ++pass) {
+        for (unsigned jobIndex=0 ; jobIndex<100 ; ++jobIndex) {
+            jobQueue.enqueue(QSharedPointer<Job>(new Job(jobIndex)));
+        }
+
+        QVERIFY(jobQueue.numberPendingJobs() == 100);
+
+        for (unsigned jobIndex=0 ; jobIndex<100 ; ++jobIndex) {
+            QSharedPointer<Job> job = jobQueue.dequeue();
+            QVERIFY(!job.isNull());
+            QVERIFY(job->value() == jobIndex);
+        }
+
+        QVERIFY(jobQueue.numberPendingJobs() == 0);
+        QVERIFY(jobQueue.dequeue().isNull());
+    }
+}
+
+
+void TestJobQueues::testLockFreeJobQueueFullPolicy() {
+    PriorityJobQueue jobQueue(4, 1);
+    QVERIFY(jobQueue.fullPolicy() == Cbe::LockFreeJobQueue<Job>::FullPolicy::REJECT);
+
+    for (unsigned jobIndex=0 ; jobIndex<4 ; ++jobIndex) {
+        QVERIFY(jobQueue.tryEnqueue(QSharedPointer<Job>(new Job(jobIndex))));
+    }
+
+    QVERIFY(!jobQueue.tryEnqueue(QSharedPointer<Job>(new Job(4))));
+    QVERIFY(jobQueue.numberRejectedJobs() == 0);
+
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(5)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(6)));
+    QVERIFY(jobQueue.numberRejectedJobs() == 2);
+    QVERIFY(jobQueue.rejectedValues() == (QList<unsigned>() << 5 << 6));
+    QVERIFY(jobQueue.numberPendingJobs() == 4);
+
+    QSharedPointer<Job> job = jobQueue.dequeue();
+    QVERIFY(job->value() == 0);
+
+    QVERIFY(jobQueue.tryEnqueue(QSharedPointer<Job>(new Job(7))));
+
+    static const unsigned expected[] = { 1, 2, 3, 7 };
+    for (unsigned index=0 ; index<4 ; ++index) {
+        job = jobQueue.dequeue();
+        QVERIFY(!job.isNull());
+        QVERIFY(job->value() == expected[index]);
+    }
+
+    QVERIFY(jobQueue.dequeue().isNull());
+}
+
+
+void TestJobQueues::testLockFreeJobQueuePriorities() {
+    PriorityJobQueue jobQueue(8, 3);
+    QVERIFY(jobQueue.numberPriorityLevels() == 3);
+
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(1, 0)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(2, 2)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(3, 9))); // Clamped to the highest priority level.
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(4, 1)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(5, 0)));
+
+    QVERIFY(jobQueue.numberPendingJobs() == 5);
+
+    static const unsigned expected[] = { 2, 3, 4, 1, 5 };
+    for (unsigned index=0 ; index<5 ; ++index) {
+        QSharedPointer<Job> job = jobQueue.dequeue();
+        QVERIFY(!job.isNull());
+        QVERIFY(job->value() == expected[index]);
+    }
+
+    QVERIFY(jobQueue.dequeue().isNull());
+}
+
+
+void TestJobQueues::testLockFreeJobQueueConcurrency() {
+    static constexpr unsigned numberProducers = 4;
+    static constexpr unsigned numberConsumers = 4;
+    static constexpr unsigned jobsPerProducer = 20000;
+
+    Cbe::LockFreeJobQueue<Job>      jobQueue(16);
+    std::atomic<unsigned long long> jobsReceived(0);
+    unsigned long long              totalJobs = static_cast<unsigned long long>(numberProducers) * jobsPerProducer;
+
+    QList<Producer*> producers;
+    QList<Consumer*> consumers;
+
+    for (unsigned index=0 ; index<numberConsumers ; ++index) {
+        consumers.append(new Consumer(&jobQueue, totalJobs, &jobsReceived));
+        consumers.last()->start();
+    }
+
+    for (unsigned index=0 ; index<numberProducers ; ++index) {
+        producers.append(new Producer(&jobQueue, jobsPerProducer));
+        producers.last()->start();
+    }
+
+    unsigned long long sum = 0;
+    for (unsigned index=0 ; index<numberProducers ; ++index) {
+        producers.at(index)->wait();
+        delete producers.at(index);
+    }
+
+    for (unsigned index=0 ; index<numberConsumers ; ++index) {
+        consumers.at(index)->wait();
+        sum += consumers.at(index)->sum();
+        delete consumers.at(index);
+    }
+
+    unsigned long long expectedSum = numberProducers * (
+          static_cast<unsigned long long>(jobsPerProducer)
+        * (static_cast<unsigned long long>(jobsPerProducer) + 1)
+        / 2
+    );
+
+    QVERIFY(jobsReceived.load() == totalJobs);
+    QVERIFY(sum == expectedSum);
+    QVERIFY(jobQueue.dequeue().isNull());
+}
+
+
+void TestJobQueues::testCoalescingJobQueue() {
+    KeyedJobQueue jobQueue;
+    QVERIFY(!jobQueue.threadSafe());
+
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(1, 10)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(2, 20)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(3, 10)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(4, 30)));
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(5, 20)));
+
+    QVERIFY(jobQueue.numberPendingJobs() == 3);
+    QVERIFY(jobQueue.supersededValues().size() == 2);
+    QVERIFY(jobQueue.supersededValues().at(0) == 1);
+    QVERIFY(jobQueue.supersededValues().at(1) == 2);
+
+    // Newer jobs take the position of the job they replaced.
+    static const unsigned expected[] = { 3, 5, 4 };
+    for (unsigned index=0 ; index<3 ; ++index) {
+        QSharedPointer<Job> job = jobQueue.dequeue();
+        QVERIFY(!job.isNull());
+        QVERIFY(job->value() == expected[index]);
+    }
+
+    QVERIFY(jobQueue.dequeue().isNull());
+
+    jobQueue.enqueue(QSharedPointer<Job>(new Job(6, 10)));
+    QVERIFY(jobQueue.supersededValues().size() == 2);
+    QVERIFY(jobQueue.dequeue()->value() == 6);
+}
+
+
+void TestJobQueues::testCoalescingCompilerJobQueue() {
+    SupersessionNotifier            notifier;
+    Cbe::CoalescingCompilerJobQueue jobQueue(&notifier);
+
+    QSharedPointer<CompilerContext> context1(new CompilerContext("a.o"));
+    QSharedPointer<CompilerContext> context2(new CompilerContext("b.o"));
+    QSharedPointer<CompilerContext> context3(new CompilerContext("a.o"));
+
+    jobQueue.enqueue(context1);
+    jobQueue.enqueue(context2);
+    jobQueue.enqueue(context3);
+
+    QVERIFY(jobQueue.numberPendingJobs() == 2);
+    QVERIFY(!context1->superseded());
+    QVERIFY(notifier.supersededContexts().isEmpty());
+
+    jobQueue.deliverNotifications();
+
+    QVERIFY(context1->superseded());
+    QVERIFY(!context2->superseded());
+    QVERIFY(!context3->superseded());
+    QVERIFY(notifier.supersededContexts().size() == 1);
+    QVERIFY(notifier.supersededContexts().at(0) == context1);
+
+    QVERIFY(jobQueue.dequeue() == context3);
+    QVERIFY(jobQueue.dequeue() == context2);
+    QVERIFY(jobQueue.dequeue().isNull());
+
+    // A check never replaces a compilation of the same object file.
+    QSharedPointer<CompilerContext> compileContext(new CompilerContext("a.o"));
+    QSharedPointer<CompilerContext> checkContext(new CompilerContext("a.o"));
+    checkContext->setAction(Cbe::CompilerContext::Action::CHECK);
+
+    jobQueue.enqueue(compileContext);
+    jobQueue.enqueue(checkContext);
+    jobQueue.deliverNotifications();
+
+    QVERIFY(jobQueue.numberPendingJobs() == 2);
+    QVERIFY(!compileContext->superseded());
+    QVERIFY(notifier.supersededContexts().size() == 1);
+
+    QVERIFY(jobQueue.dequeue() == compileContext);
+    QVERIFY(jobQueue.dequeue() == checkContext);
+    QVERIFY(jobQueue.dequeue().isNull());
+
+    // Contexts compiled to memory are coalesced only with themselves.
+    QSharedPointer<CompilerContext> memoryContext1(new CompilerContext(QString()));
+    QSharedPointer<CompilerContext> memoryContext2(new CompilerContext(QString()));
+    memoryContext1->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+    memoryContext2->setObjectDestination(Cbe::CompilerContext::ObjectDestination::MEMORY);
+
+    jobQueue.enqueue(memoryContext1);
+    jobQueue.enqueue(memoryContext2);
+    jobQueue.enqueue(memoryContext1);
+    jobQueue.deliverNotifications();
+
+    QVERIFY(jobQueue.numberPendingJobs() == 2);
+    QVERIFY(!memoryContext1->superseded());
+    QVERIFY(!memoryContext2->superseded());
+    QVERIFY(notifier.supersededContexts().size() == 1);
+
+    QVERIFY(jobQueue.dequeue() == memoryContext1);
+    QVERIFY(jobQueue.dequeue() == memoryContext2);
+    QVERIFY(jobQueue.dequeue().isNull());
+}
+
+
+void TestJobQueues::testCoalescingLinkerJobQueue() {
+    Cbe::CoalescingLinkerJobQueue jobQueue;
+    ResubmittingLinkerNotifier    notifier(&jobQueue);
+    jobQueue.setNotifier(&notifier);
+
+    QSharedPointer<LinkerContext> context1(new LinkerContext("a.so"));
+    QSharedPointer<LinkerContext> context2(new LinkerContext("a.so"));
+
+    jobQueue.enqueue(context1);
+    jobQueue.enqueue(context2);
+
+    QVERIFY(jobQueue.numberPendingJobs() == 1);
+    QVERIFY(!context1->superseded());
+
+    // The notifier enqueues a new context; this must not happen while the enqueue above is in progress.
+    jobQueue.deliverNotifications();
+
+    QVERIFY(context1->superseded());
+    QVERIFY(!context2->superseded());
+    QVERIFY(notifier.supersededContexts().size() == 1);
+    QVERIFY(notifier.supersededContexts().at(0) == context1);
+    QVERIFY(jobQueue.numberPendingJobs() == 2);
+
+    QVERIFY(jobQueue.dequeue() == context2);
+    QVERIFY(jobQueue.dequeue()->outputFile() == QString("a.so.1"));
+    QVERIFY(jobQueue.dequeue().isNull());
+}
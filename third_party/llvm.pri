@@ -151,6 +151,11 @@ unix {
     LIBS += -lclangRewrite
     LIBS += -lclangLex
     LIBS += -lclangBasic
+    LIBS += -lLLVMOrcJIT
+    LIBS += -lLLVMOrcError
+    LIBS += -lLLVMJITLink
+    LIBS += -lLLVMExecutionEngine
+    LIBS += -lLLVMRuntimeDyld
     LIBS += -lLLVMPasses
     LIBS += -lLLVMCodeGen
     LIBS += -lLLVMTarget
@@ -311,6 +316,11 @@ win32 {
     LIBS += $${LLVM_LIBDIR}/clangRewrite.lib
     LIBS += $${LLVM_LIBDIR}/clangLex.lib
     LIBS += $${LLVM_LIBDIR}/clangBasic.lib
+    LIBS += $${LLVM_LIBDIR}/LLVMOrcJIT.lib
+    LIBS += $${LLVM_LIBDIR}/LLVMOrcError.lib
+    LIBS += $${LLVM_LIBDIR}/LLVMJITLink.lib
+    LIBS += $${LLVM_LIBDIR}/LLVMExecutionEngine.lib
+    LIBS += $${LLVM_LIBDIR}/LLVMRuntimeDyld.lib
     LIBS += $${LLVM_LIBDIR}/LLVMPasses.lib
     LIBS += $${LLVM_LIBDIR}/LLVMTarget.lib
     LIBS += $${LLVM_LIBDIR}/LLVMipo.lib